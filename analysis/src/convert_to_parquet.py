@@ -1,5 +1,7 @@
 import polars as pl
 
+from read_binary_results import read_binary_results
+
 def convert_with_polars(json_path, parquet_path):
     """Converts a large newline-delimited JSON file to Parquet."""
 
@@ -11,6 +13,7 @@ def convert_with_polars(json_path, parquet_path):
  
     try:
         schema = pl.Schema({
+            "path" : pl.Utf8,
             "bottleneckLeg" : pl.Utf8,
             "unrealisedPnl": pl.Float64,
             "tradedNotional": pl.Float64,
@@ -20,6 +23,9 @@ def convert_with_polars(json_path, parquet_path):
             "rate1": pl.Float64,
             "rate2": pl.Float64,
             "rate3": pl.Float64,
+            "optimalNotional": pl.Float64,
+            "optimalPnl": pl.Float64,
+            "breakevenNotional": pl.Float64,
             "isArbitrageOpportunity": pl.Boolean
 
         })
@@ -33,3 +39,19 @@ def convert_with_polars(json_path, parquet_path):
         print(f"An error occurred during Polars conversion: {e}")
         print("This could be due to an invalid JSON line in the source file.")
         raise
+
+
+def convert_binary_with_polars(binary_path, parquet_path):
+    """Converts a BinaryTradeFileWriter file (BINANCE_UPDATE_FILE_FORMAT=binary) to Parquet."""
+
+    if not binary_path.exists():
+        print(f"Error: Source file not found at {binary_path}")
+        return -1
+
+    print("Starting conversion...")
+
+    read_binary_results(binary_path).write_parquet(parquet_path)
+
+    print("Conversion complete!")
+    print(f"Parquet file saved to: {parquet_path}")
+    return 0
@@ -8,22 +8,35 @@ def get_number_of_arbitrage_opportunities(df: pl.LazyFrame) -> int:
     # Implement your logic to count arbitrage opportunities
     return df.filter(pl.col("isArbitrageOpportunity") == True).select(pl.len()).collect().item()
 
+def with_group_ids(lazy_df: pl.LazyFrame) -> pl.LazyFrame:
+    """
+    Numbers each run of consecutive arbitrage opportunities on a path in a 'group_id' column.
+    Runs are counted per path, so a group is identified by ("path", "group_id") together.
+    Older result files have no path, they all count as one.
+    """
+    if "path" not in lazy_df.collect_schema().names():
+        lazy_df = lazy_df.with_columns(pl.lit("").alias("path"))
+
+    starts_group = pl.col("isArbitrageOpportunity") & ~pl.col("isArbitrageOpportunity").shift(1).over("path").fill_null(False)
+    return lazy_df.with_columns(
+        starts_group.cast(pl.Int64).cum_sum().over("path").alias("group_id")
+    )
+
 def get_nth_opportunity_path_df(lazy_df: pl.LazyFrame, n: int) -> pl.LazyFrame:
     """
     Finds the nth group of consecutive arbitrage opportunities,
     returning all data points in that sequence.
+    Consecutive means consecutive results for the same path.
     """
     # 1. Identify consecutive groups of TRUE values.
-    df_with_groups = lazy_df.with_columns(
-        (pl.col("isArbitrageOpportunity") & ~pl.col("isArbitrageOpportunity").shift(1).fill_null(False))
-        .cast(pl.Int8).cum_sum().alias("group_id")
-    )
+    df_with_groups = with_group_ids(lazy_df)
 
     # 2. Collect information about each opportunity group.
     # We filter for only the arbitrage opportunities to find the groups.
+    # Groups are numbered in the order they first appear.
     nth_opportunity_info_df = df_with_groups.filter(pl.col("isArbitrageOpportunity")).select(
-        pl.col("group_id").unique().sort().alias("group_id")
-    ).collect()
+        "path", "group_id"
+    ).unique(maintain_order=True).collect()
 
     if nth_opportunity_info_df.is_empty():
         print("No arbitrage opportunities found.")
@@ -34,13 +47,14 @@ def get_nth_opportunity_path_df(lazy_df: pl.LazyFrame, n: int) -> pl.LazyFrame:
         print(f"Opportunity {n} not found. Only {nth_opportunity_info_df.height} opportunities exist.")
         return pl.LazyFrame({})
 
-    # 3. Extract group_id for the requested nth group.
+    # 3. Extract the path and group_id for the requested nth group.
+    nth_path = nth_opportunity_info_df.item(n, "path")
     nth_group_id = nth_opportunity_info_df.item(n, "group_id")
 
     # 4. Filter the original data for the correct group.
     # Ensure we take only 
     nth_group_df = df_with_groups.filter(
-        (pl.col("group_id") == nth_group_id) & (pl.col("isArbitrageOpportunity") == True)
+        (pl.col("path") == nth_path) & (pl.col("group_id") == nth_group_id) & (pl.col("isArbitrageOpportunity") == True)
     )
 
     return nth_group_df
@@ -48,13 +62,10 @@ def get_nth_opportunity_path_df(lazy_df: pl.LazyFrame, n: int) -> pl.LazyFrame:
 def get_grouped_opportunity_path_df(lazy_df: pl.LazyFrame) -> pl.LazyFrame:
     """
     Groups the DataFrame by consecutive arbitrage opportunities,
-    returning a LazyFrame with an additional 'group_id' column.
+    returning a LazyFrame with an additional 'group_id' column, numbered per path.
     """
     # 1. Identify consecutive groups of TRUE values.
-    df_with_groups = lazy_df.with_columns(
-        (pl.col("isArbitrageOpportunity") & ~pl.col("isArbitrageOpportunity").shift(1).fill_null(False))
-        .cast(pl.Int8).cum_sum().alias("group_id")
-    )
+    df_with_groups = with_group_ids(lazy_df)
 
     # 2. Cast the columns to Float64 to prevent InvalidOperationError
     df_with_correct_types = lazy_df.with_columns(
@@ -73,7 +84,7 @@ def summarise_arbitrages_by_group(grouped_df: pl.LazyFrame) -> pl.LazyFrame:
     based on the first element of each group, average % return, as well as the time duration of the whole opportunity.
     """
 
-    return grouped_df.group_by("group_id").agg(
+    return grouped_df.group_by("path", "group_id").agg(
         (pl.first("unrealisedPnl") / pl.first("tradedNotional") * 100).alias("Return"),
         (pl.last("tickReceiveTime") - pl.first("tickReceiveTime")).alias("Duration"),
         (pl.first("tradedNotional")).alias("TradedNotional"),
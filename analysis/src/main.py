@@ -33,7 +33,7 @@ def print_num_arbitrage_opportunities(lazy_df: pl.LazyFrame):
     print(f"Number of arbitrage opportunities: {num_arbitrage_opportunities}")
 
 def print_distinct_num_arbitrage_opportunities(df : pl.LazyFrame):
-    num_distinct_opportunities = df.collect().select("group_id").max().item()
+    num_distinct_opportunities = df.select("path", "group_id").unique().collect().height
     print(f"Number of distinct arbitrage opportunities: {num_distinct_opportunities}")
 
 def analyse_nth_arbitrage_opportunity(lazy_df: pl.LazyFrame, n: int):
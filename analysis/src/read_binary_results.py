@@ -0,0 +1,95 @@
+import struct
+from pathlib import Path
+
+import numpy as np
+import polars as pl
+
+# Mirrors src/file/binary_trade_file_writer.h
+MAGIC = b"TRIARES\0"
+SUPPORTED_VERSION = 2
+HEADER_FORMAT = "<8sIIIIQQIII12x"
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+NO_DICTIONARY_ENTRY = 0xFFFFFFFF
+
+WIDE_COLUMNS = [
+    ("tickReceiveTime", np.int64),
+    ("tickProcessTime", np.int64),
+    ("unrealisedPnl", np.float64),
+    ("tradedNotional", np.float64),
+    ("rate1", np.float64),
+    ("rate2", np.float64),
+    ("rate3", np.float64),
+    ("optimalNotional", np.float64),
+    ("optimalPnl", np.float64),
+    ("breakevenNotional", np.float64),
+]
+DICTIONARY_COLUMNS = ["symbol", "path", "bottleneckLeg"]
+BYTE_COLUMNS = ["isArbitrageOpportunity", "bidCount", "askCount"]
+
+
+def _read_dictionary(buffer: memoryview, count: int) -> list:
+    strings = []
+    offset = HEADER_SIZE
+    for _ in range(count):
+        (length,) = struct.unpack_from("<H", buffer, offset)
+        offset += 2
+        strings.append(bytes(buffer[offset:offset + length]).decode("utf-8"))
+        offset += length
+    return strings
+
+
+def _column(data: np.ndarray, record_count: int, block_records: int, block_bytes: int,
+            offset: int, dtype) -> np.ndarray:
+    """Gathers one column from every block into a single contiguous array."""
+    block_count = -(-record_count // block_records)
+    width = np.dtype(dtype).itemsize
+    blocks = data[:block_count * block_bytes].reshape(block_count, block_bytes)
+    values = blocks[:, offset:offset + block_records * width].copy().view(dtype).reshape(-1)
+    return values[:record_count]
+
+
+def read_binary_results(binary_path: Path) -> pl.DataFrame:
+    """
+    Loads a BinaryTradeFileWriter file into a DataFrame with the same column names as the
+    text output, minus orderBookLevels, plus symbol and the decoded top levels
+    (bidPrice0, bidQty0, askPrice0, askQty0, ...).
+    """
+    raw = np.fromfile(binary_path, dtype=np.uint8)
+    buffer = memoryview(raw)
+
+    (magic, version, level_depth, block_records, block_bytes, data_offset, record_count,
+     dictionary_count, _dictionary_bytes, _dictionary_capacity) = struct.unpack_from(HEADER_FORMAT, buffer, 0)
+    if magic != MAGIC:
+        raise ValueError(f"Not a binary result file: {binary_path}")
+    if version != SUPPORTED_VERSION:
+        raise ValueError(f"Unsupported binary result file version {version}: {binary_path}")
+
+    strings = _read_dictionary(buffer, dictionary_count)
+    data = raw[data_offset:]
+
+    def column(offset, dtype):
+        return _column(data, record_count, block_records, block_bytes, offset, dtype)
+
+    columns = {}
+    for index, (name, dtype) in enumerate(WIDE_COLUMNS):
+        columns[name] = column(index * 8 * block_records, dtype)
+
+    level_fields = ["bidPrice", "bidQty", "askPrice", "askQty"]
+    for level in range(level_depth):
+        for field_index, field in enumerate(level_fields):
+            offset = (len(WIDE_COLUMNS) + level * 4 + field_index) * 8 * block_records
+            columns[f"{field}{level}"] = column(offset, np.float64)
+
+    narrow_offset = (len(WIDE_COLUMNS) + 4 * level_depth) * 8 * block_records
+    lookup = np.array(strings + [""], dtype=object)
+    for index, name in enumerate(DICTIONARY_COLUMNS):
+        ids = column(narrow_offset + index * 4 * block_records, np.uint32)
+        ids = np.where(ids == NO_DICTIONARY_ENTRY, len(strings), ids)
+        columns[name] = pl.Series(name, lookup[ids], dtype=pl.Utf8)
+
+    byte_offset = narrow_offset + len(DICTIONARY_COLUMNS) * 4 * block_records
+    for index, name in enumerate(BYTE_COLUMNS):
+        columns[name] = column(byte_offset + index * block_records, np.uint8)
+    columns["isArbitrageOpportunity"] = columns["isArbitrageOpportunity"].astype(bool)
+
+    return pl.DataFrame(columns)
@@ -0,0 +1,53 @@
+# Run with: python test_gather_data.py (or pytest)
+import polars as pl
+
+from gather_data import *
+
+# Two paths whose results interleave, each with two runs of opportunities:
+# A: times [2, 4] then [9]    B: times [3, 5] then [8]
+def interleaved_paths_df() -> pl.LazyFrame:
+    return pl.LazyFrame({
+        "path": ["A", "B", "A", "B", "A", "B", "A", "B", "B", "A"],
+        "tickReceiveTime": [0, 1, 2, 3, 4, 5, 6, 7, 8, 9],
+        "isArbitrageOpportunity": [False, False, True, True, True, True, False, False, True, True],
+        "unrealisedPnl": [0.0, 0.0, 1.0, 3.0, 2.0, 4.0, 0.0, 0.0, 7.0, 5.0],
+        "tradedNotional": [100.0] * 10,
+    })
+
+def test_groups_are_counted_per_path():
+    grouped_df = get_grouped_opportunity_path_df(interleaved_paths_df()).collect()
+    groups = grouped_df.select("path", "group_id", "tickReceiveTime").sort("tickReceiveTime")
+
+    # A's rows at 2, 4 and B's at 3, 5 are each one run even though the other path's rows sit between them
+    assert groups.filter(pl.col("path") == "A")["group_id"].to_list() == [1, 1, 2]
+    assert groups.filter(pl.col("path") == "B")["group_id"].to_list() == [1, 1, 2]
+
+def test_summary_has_one_row_per_path_and_group():
+    grouped_df = get_grouped_opportunity_path_df(interleaved_paths_df())
+    summary = summarise_arbitrages_by_group(grouped_df).collect().sort("path", "group_id")
+
+    assert summary.select("path", "group_id").rows() == [("A", 1), ("A", 2), ("B", 1), ("B", 2)]
+    assert [round(r, 9) for r in summary["Return"].to_list()] == [1.0, 5.0, 3.0, 7.0]
+    assert summary["Duration"].to_list() == [2, 0, 2, 0]
+
+def test_nth_opportunity_is_a_single_paths_run():
+    # Groups in order of first appearance: A1 at 2, B1 at 3, B2 at 8, A2 at 9
+    nth_df = get_nth_opportunity_path_df(interleaved_paths_df(), 2).collect()
+
+    assert nth_df["path"].to_list() == ["B"]
+    assert nth_df["tickReceiveTime"].to_list() == [8]
+
+def test_results_without_a_path_count_as_one_path():
+    grouped_df = get_grouped_opportunity_path_df(interleaved_paths_df().drop("path"))
+    summary = summarise_arbitrages_by_group(grouped_df).collect().sort("group_id")
+
+    # Without paths to tell them apart, times 2 to 5 are one run and 8 to 9 another
+    assert summary.select("path", "group_id").rows() == [("", 1), ("", 2)]
+    assert summary["Duration"].to_list() == [3, 1]
+
+if __name__ == "__main__":
+    test_groups_are_counted_per_path()
+    test_summary_has_one_row_per_path_and_group()
+    test_nth_opportunity_is_a_single_paths_run()
+    test_results_without_a_path_count_as_one_path()
+    print("All gather_data tests passed")
@@ -0,0 +1,182 @@
+#include <benchmark/benchmark.h>
+#include "benchmark_data.h"
+#include "common/price_level_kernels.h"
+#include "server/arbitrage_calculator.h"
+
+namespace {
+
+enum NotionalSize { InsideFirstLevel = 0, WholeBook = 1 };
+
+const std::vector<std::int64_t> DEPTHS = {5, 20, 100};
+
+// An OrderBook holds at most ORDER_BOOK_MAX_DEPTH levels, configure with -DORDER_BOOK_DEPTH=100 to cover 100
+const std::vector<std::int64_t> BOOK_DEPTHS = [] {
+    std::vector<std::int64_t> depths;
+    for (const auto depth : DEPTHS) {
+        if (depth <= ORDER_BOOK_MAX_DEPTH) depths.push_back(depth);
+    }
+    return depths;
+}();
+
+// Deep enough for every benchmarked depth, whatever ORDER_BOOK_MAX_DEPTH is
+using BenchmarkLevels = PriceLevels<128>;
+
+BenchmarkLevels toLevels(const std::vector<PriceLevel>& levels) {
+    BenchmarkLevels out;
+    for (const auto& level : levels) out.push_back(level);
+    return out;
+}
+
+void fillBook(OrderBook& book, const std::string& symbol, std::size_t depth) {
+    book.updateId = 1;
+    book.bids.clear();
+    book.asks.clear();
+    for (const auto& level : benchmark_data::bids(symbol, depth)) book.bids.push_back(level);
+    for (const auto& level : benchmark_data::asks(symbol, depth)) book.asks.push_back(level);
+}
+
+void BM_CalculateVwapBid(benchmark::State& state) {
+    const auto depth = static_cast<std::size_t>(state.range(0));
+    const std::vector<PriceLevel> recorded = benchmark_data::bids("btcusdt", depth);
+    const BenchmarkLevels levels = toLevels(recorded);
+    // Base quantity to sell into the bids
+    const double quantity = state.range(1) == InsideFirstLevel ? recorded[0].quantity * 0.5 : benchmark_data::sideBaseQuantity(recorded);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(calculateVwapBid(levels, quantity));
+    }
+}
+BENCHMARK(BM_CalculateVwapBid)->ArgsProduct({DEPTHS, {InsideFirstLevel, WholeBook}})->ArgNames({"depth", "whole_book"});
+
+void BM_CalculateVwapAsk(benchmark::State& state) {
+    const auto depth = static_cast<std::size_t>(state.range(0));
+    const std::vector<PriceLevel> recorded = benchmark_data::asks("btcusdt", depth);
+    const BenchmarkLevels levels = toLevels(recorded);
+    // Quote currency to spend on the asks
+    const double quote = state.range(1) == InsideFirstLevel ? recorded[0].price * recorded[0].quantity * 0.5 : benchmark_data::sideQuoteValue(recorded);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(calculateVwapAsk(levels, quote));
+    }
+}
+BENCHMARK(BM_CalculateVwapAsk)->ArgsProduct({DEPTHS, {InsideFirstLevel, WholeBook}})->ArgNames({"depth", "whole_book"});
+
+const std::vector<std::int64_t> ISAS = {
+    static_cast<std::int64_t>(KernelIsa::Scalar),
+    static_cast<std::int64_t>(KernelIsa::Sse2),
+    static_cast<std::int64_t>(KernelIsa::Avx2),
+};
+
+// The kernels behind the VWAP and starting notional calculations, per instruction set
+void BM_SumLevels(benchmark::State& state) {
+    const BenchmarkLevels levels = toLevels(benchmark_data::bids("btcusdt", static_cast<std::size_t>(state.range(0))));
+    const auto isa = static_cast<KernelIsa>(state.range(1));
+    if (!isSupported(isa)) {
+        state.SkipWithError("Instruction set not supported on this CPU");
+        return;
+    }
+    const LevelKernels& kernels = levelKernels(isa);
+    state.SetLabel(to_string(isa));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels.sumOf(levels));
+    }
+}
+BENCHMARK(BM_SumLevels)->ArgsProduct({DEPTHS, ISAS})->ArgNames({"depth", "isa"});
+
+void BM_FindFillLevel(benchmark::State& state) {
+    const std::vector<PriceLevel> recorded = benchmark_data::asks("btcusdt", static_cast<std::size_t>(state.range(0)));
+    const BenchmarkLevels levels = toLevels(recorded);
+    const auto isa = static_cast<KernelIsa>(state.range(1));
+    if (!isSupported(isa)) {
+        state.SkipWithError("Instruction set not supported on this CPU");
+        return;
+    }
+    const LevelKernels& kernels = levelKernels(isa);
+    // Spend all but the last level's worth, so the scan covers the whole side
+    const double quote = benchmark_data::sideQuoteValue(recorded) - recorded.back().price * recorded.back().quantity * 0.5;
+    state.SetLabel(to_string(isa));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels.findFillOf(levels, quote, FillTarget::Notional));
+    }
+}
+BENCHMARK(BM_FindFillLevel)->ArgsProduct({DEPTHS, ISAS})->ArgNames({"depth", "isa"});
+
+void BM_GetEffectiveRate(benchmark::State& state) {
+    const auto depth = static_cast<std::size_t>(state.range(0));
+
+    OrderBook book;
+    fillBook(book, "btcusdt", depth);
+    const bool sell = state.range(2) == 1; // SELL legs spend quote on the asks, BUY legs sell base into the bids
+    const TradeLeg leg("btcusdt", sell);
+
+    const std::vector<PriceLevel> side = sell ? benchmark_data::asks("btcusdt", depth) : benchmark_data::bids("btcusdt", depth);
+    const double wholeBook = sell ? benchmark_data::sideQuoteValue(side) : benchmark_data::sideBaseQuantity(side);
+    const double firstLevel = sell ? side[0].price * side[0].quantity * 0.5 : side[0].quantity * 0.5;
+    const double notional = state.range(1) == InsideFirstLevel ? firstLevel : wholeBook;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(getEffectiveRate(leg, book, notional));
+    }
+}
+BENCHMARK(BM_GetEffectiveRate)->ArgsProduct({BOOK_DEPTHS, {InsideFirstLevel, WholeBook}, {0, 1}})->ArgNames({"depth", "whole_book", "sell"});
+
+// Every BUY/SELL combination a btc/usdt/eth triangle can take, depending on start and direction
+const std::vector<std::string> PATHS = {
+    "btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY",
+    "btc:ethbtc:SELL,ethusdt:BUY,btcusdt:SELL",
+    "usdt:btcusdt:SELL,ethbtc:SELL,ethusdt:BUY",
+    "usdt:ethusdt:SELL,ethbtc:BUY,btcusdt:BUY",
+    "eth:ethbtc:BUY,btcusdt:BUY,ethusdt:SELL",
+    "eth:ethusdt:BUY,btcusdt:SELL,ethbtc:SELL",
+};
+
+void BM_CalculateStartingNotional(benchmark::State& state) {
+    const auto depth = static_cast<std::size_t>(state.range(0));
+
+    SymbolTable symbols;
+    ArbitragePath path = ArbitragePath::from_string(PATHS[static_cast<std::size_t>(state.range(2))]);
+    path.internSymbols(symbols);
+    BookStore books(symbols.size());
+    for (const auto& leg : path.legs) {
+        fillBook(books[leg.symbolId], leg.symbol, depth);
+    }
+    const bool firstLevelOnly = state.range(1) == 1;
+    state.SetLabel(path.to_string());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(firstLevelOnly ? calculateStartingNotionalWithFirstLevelOnly(path, books)
+                                                : calculateStartingNotional(path, books));
+    }
+}
+BENCHMARK(BM_CalculateStartingNotional)
+    ->ArgsProduct({BOOK_DEPTHS, {0, 1}, benchmark::CreateDenseRange(0, static_cast<int>(PATHS.size()) - 1, 1)})
+    ->ArgNames({"depth", "first_level_only", "path"});
+
+enum SolverWalk { StopsAtTopOfBook = 0, WalksWholeBook = 1 };
+
+void BM_SolveOptimalTradeSize(benchmark::State& state) {
+    const auto depth = static_cast<std::size_t>(state.range(0));
+
+    SymbolTable symbols;
+    ArbitragePath path = ArbitragePath::from_string(PATHS[static_cast<std::size_t>(state.range(2))]);
+    path.internSymbols(symbols);
+    BookStore books(symbols.size());
+    for (const auto& leg : path.legs) {
+        fillBook(books[leg.symbolId], leg.symbol, depth);
+    }
+    // The recorded books are not profitable, so the solver stops on the first segment. A fee multiplier
+    // above 1 stands in for an edge wide enough to stay profitable across every level
+    const double feeMultiplier = state.range(1) == WalksWholeBook ? 1.01 : 0.999;
+    state.SetLabel(path.to_string());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(solveOptimalTradeSize(path, books, feeMultiplier));
+    }
+}
+BENCHMARK(BM_SolveOptimalTradeSize)
+    ->ArgsProduct({BOOK_DEPTHS, {StopsAtTopOfBook, WalksWholeBook}, benchmark::CreateDenseRange(0, static_cast<int>(PATHS.size()) - 1, 1)})
+    ->ArgNames({"depth", "whole_book", "path"});
+
+} // namespace
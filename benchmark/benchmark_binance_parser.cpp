@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+#include "benchmark_data.h"
+#include "exchange/binance/binance_client.h"
+#include "exchange/binance/binance_depth_parser.h"
+
+namespace {
+
+const std::vector<std::int64_t> DEPTHS = {5, 20, 100};
+
+// nlohmann::json parse plus to_struct, as BinanceClient does with BINANCE_DEPTH_PARSER=json
+void BM_ToStruct(benchmark::State& state) {
+    const std::string frame = benchmark_data::frame("btcusdt", static_cast<std::size_t>(state.range(0)));
+    SymbolTable symbols;
+    symbols.intern("btcusdt");
+
+    for (auto _ : state) {
+        const auto json = nlohmann::json::parse(frame);
+        benchmark::DoNotOptimize(BinanceClient::to_struct(json, frame, 0, symbols));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * frame.size()));
+}
+BENCHMARK(BM_ToStruct)->ArgsProduct({DEPTHS})->ArgNames({"depth"});
+
+// The allocation-free parser BinanceClient uses by default, for comparison
+void BM_ParseDepthFrame(benchmark::State& state) {
+    const std::string frame = benchmark_data::frame("btcusdt", static_cast<std::size_t>(state.range(0)));
+    SymbolTable symbols;
+    symbols.intern("btcusdt");
+    OrderBookTick tick;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parseDepthFrame(frame.data(), frame.data() + frame.size(), 0, symbols, tick));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * frame.size()));
+}
+BENCHMARK(BM_ParseDepthFrame)->ArgsProduct({DEPTHS})->ArgNames({"depth"});
+
+void BM_ParseBookTickerFrame(benchmark::State& state) {
+    const std::string frame = benchmark_data::bookTickerFrame("btcusdt");
+    SymbolTable symbols;
+    symbols.intern("btcusdt");
+    BookTicker ticker;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parseBookTickerFrame(frame.data(), frame.data() + frame.size(), 0, symbols, ticker));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * frame.size()));
+}
+BENCHMARK(BM_ParseBookTickerFrame);
+
+// Frame bytes to evaluated triangle in first-level-only mode, without a result writer
+const std::vector<std::string> TRIANGLE = {"btcusdt", "ethusdt", "ethbtc"};
+
+Server makeTriangleServer() {
+    return Server(ArbitragePath::list_from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY"), ServerConfig(0, 0, 1, 0, true));
+}
+
+// The replayed frame is the same every time, so each iteration gets a newer update id and a best level
+// differing from the last one's, or the server would drop it as a duplicate or skip it as unchanged
+double nudge(long long updateId) {
+    return (updateId & 1) ? 0.001 : 0.0;
+}
+
+// Evaluations per iteration, 1 when every frame reaches the triangle
+void countEvaluations(benchmark::State& state, const Server& server, long long before) {
+    state.counters["evaluations"] = benchmark::Counter(
+        static_cast<double>(server.getEvaluationStats().evaluations - before), benchmark::Counter::kAvgIterations);
+}
+
+void BM_DepthFrameToEvaluation(benchmark::State& state) {
+    Server server = makeTriangleServer();
+    OrderBookTick tick;
+    for (const auto& symbol : TRIANGLE) {
+        const std::string frame = benchmark_data::frame(symbol, 5);
+        parseDepthFrame(frame.data(), frame.data() + frame.size(), 0, server.getSymbolTable(), tick);
+        server.on_update(tick);
+    }
+    const std::string frame = benchmark_data::frame("btcusdt", 5);
+    const long long warmupEvaluations = server.getEvaluationStats().evaluations;
+    long long updateId = tick.updateId;
+
+    for (auto _ : state) {
+        parseDepthFrame(frame.data(), frame.data() + frame.size(), 0, server.getSymbolTable(), tick);
+        tick.updateId = ++updateId;
+        tick.bids[0].quantity += nudge(updateId);
+        tick.asks[0].quantity += nudge(updateId);
+        server.on_update(tick);
+    }
+    countEvaluations(state, server, warmupEvaluations);
+}
+BENCHMARK(BM_DepthFrameToEvaluation);
+
+void BM_BookTickerFrameToEvaluation(benchmark::State& state) {
+    Server server = makeTriangleServer();
+    BookTicker ticker;
+    for (const auto& symbol : TRIANGLE) {
+        const std::string frame = benchmark_data::bookTickerFrame(symbol);
+        parseBookTickerFrame(frame.data(), frame.data() + frame.size(), 0, server.getSymbolTable(), ticker);
+        server.on_update(ticker);
+    }
+    const std::string frame = benchmark_data::bookTickerFrame("btcusdt");
+    const long long warmupEvaluations = server.getEvaluationStats().evaluations;
+    long long updateId = ticker.updateId;
+
+    for (auto _ : state) {
+        parseBookTickerFrame(frame.data(), frame.data() + frame.size(), 0, server.getSymbolTable(), ticker);
+        ticker.updateId = ++updateId;
+        ticker.bid.quantity += nudge(updateId);
+        ticker.ask.quantity += nudge(updateId);
+        server.on_update(ticker);
+    }
+    countEvaluations(state, server, warmupEvaluations);
+}
+BENCHMARK(BM_BookTickerFrameToEvaluation);
+
+} // namespace
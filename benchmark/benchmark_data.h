@@ -0,0 +1,113 @@
+#ifndef BENCHMARK_DATA_H
+#define BENCHMARK_DATA_H
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "common/order_book.h"
+
+/**
+ * Realistic benchmark inputs built from example_binance_data.json.
+ *
+ * The recorded frames are @depth5 snapshots of btcusdt, ethusdt and ethbtc. Deeper books
+ * continue each side's ladder with the recorded spacing between the last two levels and reuse
+ * the recorded quantities in turn, so prices and sizes stay in the same range as real data.
+ */
+namespace benchmark_data {
+
+struct RecordedBook {
+    std::vector<PriceLevel> bids;
+    std::vector<PriceLevel> asks;
+};
+
+inline const std::map<std::string, RecordedBook>& recordedBooks() {
+    static const std::map<std::string, RecordedBook> books = [] {
+        std::ifstream input(BENCHMARK_DATA_FILE);
+        if (!input.is_open()) {
+            throw std::runtime_error(std::string("Unable to open benchmark data: ") + BENCHMARK_DATA_FILE);
+        }
+
+        std::map<std::string, RecordedBook> parsed;
+        for (const auto& frame : nlohmann::json::parse(input)) {
+            const std::string stream = frame.at("stream").get<std::string>();
+            RecordedBook& book = parsed[stream.substr(0, stream.find('@'))];
+            for (const auto& level : frame.at("data").at("bids")) {
+                book.bids.emplace_back(std::stod(level.at(0).get<std::string>()), std::stod(level.at(1).get<std::string>()));
+            }
+            for (const auto& level : frame.at("data").at("asks")) {
+                book.asks.emplace_back(std::stod(level.at(0).get<std::string>()), std::stod(level.at(1).get<std::string>()));
+            }
+        }
+        return parsed;
+    }();
+    return books;
+}
+
+// One side extended (or truncated) to depth levels, descending for bids and ascending for asks
+inline std::vector<PriceLevel> extendSide(const std::vector<PriceLevel>& recorded, std::size_t depth) {
+    std::vector<PriceLevel> levels(recorded.begin(), recorded.begin() + std::min(depth, recorded.size()));
+    const double step = recorded[recorded.size() - 1].price - recorded[recorded.size() - 2].price;
+    while (levels.size() < depth) {
+        const double quantity = recorded[levels.size() % recorded.size()].quantity;
+        levels.emplace_back(levels.back().price + step, quantity);
+    }
+    return levels;
+}
+
+inline std::vector<PriceLevel> bids(const std::string& symbol, std::size_t depth) {
+    return extendSide(recordedBooks().at(symbol).bids, depth);
+}
+
+inline std::vector<PriceLevel> asks(const std::string& symbol, std::size_t depth) {
+    return extendSide(recordedBooks().at(symbol).asks, depth);
+}
+
+inline double sideQuoteValue(const std::vector<PriceLevel>& levels) {
+    double total = 0.0;
+    for (const auto& level : levels) total += level.price * level.quantity;
+    return total;
+}
+
+inline double sideBaseQuantity(const std::vector<PriceLevel>& levels) {
+    double total = 0.0;
+    for (const auto& level : levels) total += level.quantity;
+    return total;
+}
+
+// A combined-stream frame in Binance's wire format with depth levels per side
+inline std::string frame(const std::string& symbol, std::size_t depth) {
+    auto appendSide = [](std::string& out, const std::vector<PriceLevel>& levels) {
+        char buffer[64];
+        out += "[";
+        for (std::size_t i = 0; i < levels.size(); ++i) {
+            std::snprintf(buffer, sizeof(buffer), "%s[\"%.8f\",\"%.8f\"]", i ? "," : "", levels[i].price, levels[i].quantity);
+            out += buffer;
+        }
+        out += "]";
+    };
+
+    std::string out = "{\"stream\":\"" + symbol + "@depth" + std::to_string(depth) + "@100ms\",\"data\":{\"lastUpdateId\":73518241221,\"bids\":";
+    appendSide(out, bids(symbol, depth));
+    out += ",\"asks\":";
+    appendSide(out, asks(symbol, depth));
+    out += "}}";
+    return out;
+}
+
+// A combined-stream @bookTicker frame holding the recorded best bid and ask
+inline std::string bookTickerFrame(const std::string& symbol) {
+    const RecordedBook& book = recordedBooks().at(symbol);
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer),
+                  "{\"stream\":\"%s@bookTicker\",\"data\":{\"u\":400900217,\"s\":\"%s\",\"b\":\"%.8f\",\"B\":\"%.8f\",\"a\":\"%.8f\",\"A\":\"%.8f\"}}",
+                  symbol.c_str(), symbol.c_str(), book.bids[0].price, book.bids[0].quantity, book.asks[0].price, book.asks[0].quantity);
+    return buffer;
+}
+
+} // namespace benchmark_data
+
+#endif // BENCHMARK_DATA_H
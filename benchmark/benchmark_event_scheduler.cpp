@@ -0,0 +1,24 @@
+#include <benchmark/benchmark.h>
+#include "replay/event_scheduler.h"
+#include <random>
+
+namespace {
+
+// Steady state of a simulation: every event popped schedules one more a random delay ahead
+void BM_EventSchedulerHold(benchmark::State& state) {
+    const auto pending = static_cast<std::size_t>(state.range(0));
+    EventScheduler scheduler(pending);
+    std::mt19937_64 random(1);
+    for (std::size_t i = 0; i < pending; ++i) {
+        scheduler.schedule(static_cast<std::int64_t>(random() % 1000000), 0, static_cast<std::uint32_t>(i));
+    }
+
+    for (auto _ : state) {
+        const EventScheduler::Event event = scheduler.pop();
+        scheduler.schedule(event.time + static_cast<std::int64_t>(random() % 1000000), event.type, event.target);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+BENCHMARK(BM_EventSchedulerHold)->Arg(16)->Arg(1024)->Arg(65536);
+
+} // namespace
@@ -19,6 +19,7 @@
 #   - BINANCE_PROFIT_THRESHOLD
 #   - BINANCE_TAKER_FEE
 #   - BINANCE_MAX_STARTING_NOTIONAL_FRACTION
+#   - BINANCE_METRICS_PORT (serves Prometheus metrics on the host's 127.0.0.1:<port>/metrics)
 # ==============================================================================
 
 # --- Argument Parsing ---
@@ -62,6 +63,18 @@ BINANCE_TAKER_FEE="${BINANCE_TAKER_FEE:-0}"
 BINANCE_MAX_STARTING_NOTIONAL_FRACTION="${BINANCE_MAX_STARTING_NOTIONAL_FRACTION:-1}"
 BINANCE_MAX_STARTING_NOTIONAL_RECALC_INTERVAL="${BINANCE_MAX_STARTING_NOTIONAL_RECALC_INTERVAL:-0}"
 BINANCE_USE_FIRST_LEVEL_ONLY="${BINANCE_USE_FIRST_LEVEL_ONLY:-true}"
+BINANCE_DEPTH_PARSER="${BINANCE_DEPTH_PARSER:-fast}"
+BINANCE_UPDATE_FILE_FORMAT="${BINANCE_UPDATE_FILE_FORMAT:-text}"
+BINANCE_UPDATE_FILE_ASYNC="${BINANCE_UPDATE_FILE_ASYNC:-false}"
+BINANCE_UPDATE_FILE_OVERFLOW="${BINANCE_UPDATE_FILE_OVERFLOW:-block}"
+BINANCE_LATENCY_DUMP_INTERVAL="${BINANCE_LATENCY_DUMP_INTERVAL:-0}"
+BINANCE_METRICS_PORT="${BINANCE_METRICS_PORT:-}"
+
+# The metrics endpoint only listens on loopback, sharing the host's network makes that the host's loopback
+METRICS_OPTIONS=""
+if [ -n "$BINANCE_METRICS_PORT" ]; then
+    METRICS_OPTIONS="--network host -e \"BINANCE_METRICS_PORT=$BINANCE_METRICS_PORT\""
+fi
 
 # --- Script Execution ---
 set -e
@@ -88,6 +101,12 @@ DOCKER_COMMAND="docker run \
     -e \"BINANCE_MAX_STARTING_NOTIONAL_FRACTION=$BINANCE_MAX_STARTING_NOTIONAL_FRACTION\" \
     -e \"BINANCE_MAX_STARTING_NOTIONAL_RECALC_INTERVAL=$BINANCE_MAX_STARTING_NOTIONAL_RECALC_INTERVAL\" \
     -e \"BINANCE_USE_FIRST_LEVEL_ONLY=$BINANCE_USE_FIRST_LEVEL_ONLY\" \
+    -e \"BINANCE_DEPTH_PARSER=$BINANCE_DEPTH_PARSER\" \
+    -e \"BINANCE_UPDATE_FILE_FORMAT=$BINANCE_UPDATE_FILE_FORMAT\" \
+    -e \"BINANCE_UPDATE_FILE_ASYNC=$BINANCE_UPDATE_FILE_ASYNC\" \
+    -e \"BINANCE_UPDATE_FILE_OVERFLOW=$BINANCE_UPDATE_FILE_OVERFLOW\" \
+    -e \"BINANCE_LATENCY_DUMP_INTERVAL=$BINANCE_LATENCY_DUMP_INTERVAL\" \
+    $METRICS_OPTIONS \
     -v \"$HOST_SAVE_PATH:$CONTAINER_WRITE_PATH\" \
     \"$IMAGE_NAME\""
 
@@ -0,0 +1,35 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "analysis/result_analysis.h"
+
+/**
+ * Summarises a TradeFileWriter result file, as analysis/src/gather_data.py does, without Python
+ *
+ * Usage: Analyze <result file> [threads]
+ *
+ * The file is memory-mapped and split into line-aligned chunks parsed in parallel, one thread
+ * per core unless threads is given. Only the JSONL text format is read.
+ */
+int main(int argc, char* argv[]) {
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <result file> [threads]" << std::endl;
+        return 1;
+    }
+
+    const std::string input_path = argv[1];
+    const std::size_t threads = argc > 2 ? std::stoul(argv[2]) : 0;
+
+    try {
+        const ResultAnalysis analysis = analyzeResultFile(input_path, threads);
+        std::cout << "########### RESULT ANALYSIS ###########" << std::endl;
+        std::cout << "Result File: " << input_path << std::endl;
+        printResultAnalysis(std::cout, analysis);
+        std::cout << "######################################" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Unable to analyse " << input_path << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,288 @@
+#include "analysis/result_analysis.h"
+#include "file/mapped_file.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+// Files smaller than this per thread are not worth splitting further
+constexpr std::size_t MIN_CHUNK_BYTES = 1 << 20;
+
+// Bins of main.py's return (percent) and duration (seconds) frequency tables
+const std::vector<double> RETURN_BINS = {0.0, 0.025, 0.05, 0.075, 0.100, 0.200, 0.300, 0.400, 0.500};
+const std::vector<double> DURATION_BINS = {0.0, 0.5, 1.0, 2.0, 3.0, 4.0, 5.0};
+
+// The opportunity runs of one path within a chunk
+struct PathRuns {
+    bool startsOpen = false; // The path's first result in the chunk is an opportunity, continuing any run before it
+    bool endsOpen = false;   // Its last result is an opportunity, so the run may continue into the next chunk
+    std::vector<OpportunityGroup> runs;
+};
+
+struct ChunkAnalysis {
+    ResultAnalysis stats;
+    // Views into the mapped file, which outlives every chunk
+    std::unordered_map<std::string_view, PathRuns> paths;
+    std::vector<std::string_view> pathOrder;
+};
+
+// Value of "key": in a line written by TradeFileWriter. Keys inside the escaped orderBookLevels
+// frame are preceded by a backslash-quote, so they never match.
+std::string_view fieldValue(std::string_view line, std::string_view key) {
+    std::size_t pos = 0;
+    while ((pos = line.find(key, pos)) != std::string_view::npos) {
+        if (pos > 0 && line[pos - 1] == '"' && pos + key.size() + 1 < line.size()
+            && line[pos + key.size()] == '"' && line[pos + key.size() + 1] == ':') {
+            return line.substr(pos + key.size() + 2);
+        }
+        pos += key.size();
+    }
+    return {};
+}
+
+template <typename T>
+bool numberField(std::string_view line, std::string_view key, T& out) {
+    const std::string_view value = fieldValue(line, key);
+    if (value.empty()) return false;
+    return std::from_chars(value.data(), value.data() + value.size(), out).ec == std::errc();
+}
+
+std::string_view stringField(std::string_view line, std::string_view key) {
+    const std::string_view value = fieldValue(line, key);
+    if (value.empty() || value[0] != '"') return {};
+    const std::size_t close = value.find('"', 1);
+    return close == std::string_view::npos ? std::string_view() : value.substr(1, close - 1);
+}
+
+void analyzeLine(std::string_view line, ChunkAnalysis& chunk) {
+    ResultAnalysis& stats = chunk.stats;
+    std::int64_t receiveTime = 0;
+    std::int64_t processTime = 0;
+    double pnl = 0;
+    double notional = 0;
+    if (!numberField(line, "tickReceiveTime", receiveTime) || !numberField(line, "tickProcessTime", processTime)
+        || !numberField(line, "unrealisedPnl", pnl) || !numberField(line, "tradedNotional", notional)) {
+        stats.malformedLines++;
+        return;
+    }
+    const bool opportunity = fieldValue(line, "isArbitrageOpportunity").substr(0, 4) == "true";
+
+    stats.dataPoints++;
+    stats.latency.record(processTime - receiveTime);
+
+    // Older result files have no path, they all count as one
+    const std::string_view path = stringField(line, "path");
+    auto found = chunk.paths.find(path);
+    if (found == chunk.paths.end()) {
+        found = chunk.paths.emplace(path, PathRuns()).first;
+        found->second.startsOpen = opportunity;
+        chunk.pathOrder.push_back(path);
+    }
+    PathRuns& runs = found->second;
+
+    if (opportunity) {
+        stats.opportunities++;
+        stats.pnlSum += pnl;
+        stats.notionalSum += notional;
+        stats.minPnl = std::min(stats.minPnl, pnl);
+        stats.maxPnl = std::max(stats.maxPnl, pnl);
+        if (!runs.endsOpen) {
+            runs.runs.emplace_back();
+        }
+        runs.runs.back().add(receiveTime, pnl, notional);
+    }
+    runs.endsOpen = opportunity;
+}
+
+void analyzeChunk(const char* begin, const char* end, ChunkAnalysis& chunk) {
+    const char* pos = begin;
+    while (pos < end) {
+        const char* newline = static_cast<const char*>(std::memchr(pos, '\n', static_cast<std::size_t>(end - pos)));
+        const char* lineEnd = newline ? newline : end;
+        std::string_view line(pos, static_cast<std::size_t>(lineEnd - pos));
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (!line.empty()) analyzeLine(line, chunk);
+        pos = lineEnd + 1;
+    }
+}
+
+// Start of the line containing or following pos
+const char* lineStart(const char* begin, const char* end, const char* pos) {
+    if (pos <= begin) return begin;
+    const char* newline = static_cast<const char*>(std::memchr(pos - 1, '\n', static_cast<std::size_t>(end - pos + 1)));
+    return newline ? newline + 1 : end;
+}
+
+void printDistribution(std::ostream& out, const char* title, const std::vector<double>& bins, const std::vector<double>& values) {
+    out << title << "\n";
+    std::vector<std::uint64_t> counts(bins.size(), 0);
+    for (const double value : values) {
+        // The last bin holds everything from its lower edge up
+        const auto bin = std::upper_bound(bins.begin(), bins.end(), value) - bins.begin();
+        if (bin > 0) counts[static_cast<std::size_t>(bin - 1)]++;
+    }
+    for (std::size_t i = 0; i < bins.size(); ++i) {
+        out << "  [" << bins[i] << ", ";
+        if (i + 1 < bins.size()) out << bins[i + 1] << ")"; else out << "inf)";
+        out << "  " << counts[i] << "\n";
+    }
+}
+
+} // namespace
+
+void OpportunityGroup::add(std::int64_t receiveTime, double pnl, double notional) {
+    if (count == 0) {
+        firstReceiveTime = receiveTime;
+        firstPnl = pnl;
+        firstNotional = notional;
+    }
+    lastReceiveTime = receiveTime;
+    pnlSum += pnl;
+    notionalSum += notional;
+    count++;
+}
+
+void OpportunityGroup::extend(const OpportunityGroup& later) {
+    if (count == 0) {
+        *this = later;
+        return;
+    }
+    lastReceiveTime = later.lastReceiveTime;
+    pnlSum += later.pnlSum;
+    notionalSum += later.notionalSum;
+    count += later.count;
+}
+
+ResultAnalysis analyzeResults(const char* begin, const char* end, std::size_t threads) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t size = static_cast<std::size_t>(end - begin);
+    const std::size_t chunkCount = std::max<std::size_t>(threads, 1);
+
+    std::vector<const char*> bounds(chunkCount + 1);
+    for (std::size_t i = 0; i <= chunkCount; ++i) {
+        bounds[i] = i == chunkCount ? end : lineStart(begin, end, begin + size * i / chunkCount);
+    }
+
+    std::vector<ChunkAnalysis> chunks(chunkCount);
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < chunkCount; ++i) {
+        workers.emplace_back(analyzeChunk, bounds[i], bounds[i + 1], std::ref(chunks[i]));
+    }
+    analyzeChunk(bounds[0], bounds[1], chunks[0]);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Merge in file order, joining each path's runs across chunk boundaries
+    ResultAnalysis result;
+    std::unordered_map<std::string_view, PathRuns> paths;
+    for (const ChunkAnalysis& chunk : chunks) {
+        const ResultAnalysis& stats = chunk.stats;
+        result.dataPoints += stats.dataPoints;
+        result.opportunities += stats.opportunities;
+        result.malformedLines += stats.malformedLines;
+        result.latency.merge(stats.latency);
+        result.pnlSum += stats.pnlSum;
+        result.notionalSum += stats.notionalSum;
+        result.minPnl = std::min(result.minPnl, stats.minPnl);
+        result.maxPnl = std::max(result.maxPnl, stats.maxPnl);
+
+        for (const std::string_view path : chunk.pathOrder) {
+            const PathRuns& later = chunk.paths.at(path);
+            PathRuns& merged = paths[path];
+            auto next = later.runs.begin();
+            if (merged.endsOpen && later.startsOpen && next != later.runs.end()) {
+                merged.runs.back().extend(*next++);
+            }
+            merged.runs.insert(merged.runs.end(), next, later.runs.end());
+            merged.endsOpen = later.endsOpen;
+        }
+    }
+
+    for (auto& path : paths) {
+        result.groups.insert(result.groups.end(), path.second.runs.begin(), path.second.runs.end());
+    }
+    std::stable_sort(result.groups.begin(), result.groups.end(), [](const OpportunityGroup& a, const OpportunityGroup& b) {
+        return a.firstReceiveTime < b.firstReceiveTime;
+    });
+
+    result.chunks = chunkCount;
+    result.bytes = size;
+    result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+ResultAnalysis analyzeResultFile(const std::string& filePath, std::size_t threads) {
+    const MappedFile file(filePath, MappedFile::Mode::ReadOnly);
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, file.size() / MIN_CHUNK_BYTES + 1);
+    return analyzeResults(file.data(), file.data() + file.size(), threads);
+}
+
+void printResultAnalysis(std::ostream& out, const ResultAnalysis& analysis) {
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    out << "Number of data points: " << analysis.dataPoints << "\n"
+        << "Number of arbitrage opportunities: " << analysis.opportunities << "\n"
+        << "Number of distinct arbitrage opportunities: " << analysis.groups.size() << "\n";
+    if (analysis.malformedLines > 0) {
+        out << "Malformed lines skipped: " << analysis.malformedLines << "\n";
+    }
+
+    const LatencyHistogram& latency = analysis.latency;
+    out << "Latency (ns, tickProcessTime - tickReceiveTime): p50 " << latency.valueAtPercentile(50)
+        << "  p90 " << latency.valueAtPercentile(90)
+        << "  p99 " << latency.valueAtPercentile(99)
+        << "  p99.9 " << latency.valueAtPercentile(99.9)
+        << "  max " << latency.max() << "\n";
+
+    if (analysis.opportunities > 0) {
+        out << std::setprecision(10)
+            << "Opportunity PnL: total " << analysis.pnlSum
+            << "  mean " << analysis.pnlSum / analysis.opportunities
+            << "  min " << analysis.minPnl
+            << "  max " << analysis.maxPnl << "\n";
+    }
+
+    if (!analysis.groups.empty()) {
+        std::vector<double> returns;
+        std::vector<double> durations;
+        double averageReturn = 0;
+        double averageNotional = 0;
+        for (const auto& group : analysis.groups) {
+            returns.push_back(group.returnPercent());
+            durations.push_back(group.durationSeconds());
+            averageReturn += group.averageReturnPercent();
+            averageNotional += group.averageNotional();
+        }
+        const auto groups = static_cast<double>(analysis.groups.size());
+        out << std::fixed << std::setprecision(5)
+            << "Average Return: " << averageReturn / groups << "%\n"
+            << "Average Traded Notional: " << averageNotional / groups << "\n";
+        out.flags(flags);
+        out << std::setprecision(6);
+        printDistribution(out, "Return (%) per opportunity:", RETURN_BINS, returns);
+        printDistribution(out, "Duration (s) per opportunity:", DURATION_BINS, durations);
+    }
+
+    out.flags(flags);
+    out << std::fixed << std::setprecision(3)
+        << "Analysed " << analysis.bytes / 1e6 << " MB in " << analysis.chunks << " chunk(s), "
+        << analysis.elapsedSeconds << " s";
+    if (analysis.elapsedSeconds > 0) {
+        out << " (" << analysis.bytes / 1e6 / analysis.elapsedSeconds << " MB/s)";
+    }
+    out << "\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
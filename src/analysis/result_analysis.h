@@ -0,0 +1,76 @@
+#ifndef RESULT_ANALYSIS_H
+#define RESULT_ANALYSIS_H
+
+#include "common/latency_histogram.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @struct OpportunityGroup
+ * @brief A run of consecutive arbitrage opportunities on one path, as grouped by gather_data.py.
+ */
+struct OpportunityGroup {
+    std::int64_t firstReceiveTime = 0;
+    std::int64_t lastReceiveTime = 0;
+    double firstPnl = 0;
+    double firstNotional = 0;
+    double pnlSum = 0;
+    double notionalSum = 0;
+    std::uint64_t count = 0;
+
+    void add(std::int64_t receiveTime, double pnl, double notional);
+
+    // Appends a later part of the same run, found in the next chunk of the file
+    void extend(const OpportunityGroup& later);
+
+    // Return of the first result as a percentage of its traded notional
+    double returnPercent() const { return firstNotional != 0 ? firstPnl / firstNotional * 100 : 0.0; }
+    double averageReturnPercent() const { return notionalSum != 0 ? pnlSum / notionalSum * 100 : 0.0; }
+    double averageNotional() const { return count ? notionalSum / count : 0.0; }
+    double durationSeconds() const { return (lastReceiveTime - firstReceiveTime) / 1e9; }
+};
+
+/**
+ * @struct ResultAnalysis
+ * @brief The statistics gather_data.py computes over a TradeFileWriter result file.
+ */
+struct ResultAnalysis {
+    std::uint64_t dataPoints = 0;
+    std::uint64_t opportunities = 0;
+    std::uint64_t malformedLines = 0;
+
+    LatencyHistogram latency; // tickProcessTime - tickReceiveTime of every result
+
+    double pnlSum = 0;        // Over opportunities only
+    double minPnl = std::numeric_limits<double>::infinity();
+    double maxPnl = -std::numeric_limits<double>::infinity();
+    double notionalSum = 0;   // Over opportunities only
+
+    std::vector<OpportunityGroup> groups; // Ordered by their first receive time
+
+    std::size_t chunks = 0;   // Line-aligned chunks the input was split into
+    std::size_t bytes = 0;
+    double elapsedSeconds = 0;
+};
+
+/**
+ * @brief Analyses JSONL results between begin and end, split into line-aligned chunks parsed in parallel.
+ *
+ * Each thread parses one chunk into its own partial result, reading only the fields it needs
+ * straight out of the line, so the orderBookLevels frame is skipped rather than parsed. Runs of
+ * opportunities that cross a chunk boundary are joined when the partial results are merged in
+ * file order, so the outcome does not depend on the thread count.
+ */
+ResultAnalysis analyzeResults(const char* begin, const char* end, std::size_t threads);
+
+// Memory-maps filePath and analyses it, on one thread per core by default
+ResultAnalysis analyzeResultFile(const std::string& filePath, std::size_t threads = 0);
+
+// Prints the summary main.py prints, plus latency percentiles and return and duration distributions
+void printResultAnalysis(std::ostream& out, const ResultAnalysis& analysis);
+
+#endif // RESULT_ANALYSIS_H
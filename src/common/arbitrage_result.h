@@ -2,25 +2,33 @@
 #define ARBITRAGE_RESULT_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 #include <array>
 #include "common/order_book.h"
 
+// Handed straight to a writer; the views are only valid for the duration of the write
 struct ArbitrageResult {
 
-    const std::string symbol;
-    const std::string jsonStr;
+    const std::string_view symbol;
+    const std::string_view path; // The arbitrage path evaluated, in BINANCE_ARBITRAGE_PATH notation
+    const std::string_view jsonStr;
     long long tickInitTime;
     const long long processTime; 
     const double unrealisedPnl; 
     const double tradedNotional; 
-    const std::string bottleneckLeg; 
+    const std::string_view bottleneckLeg; 
     const bool arbitrageOpportunity;
     const std::array<double, 3> rates; 
+    const double optimalNotional;   // Starting notional maximising PnL given the books, see solveOptimalTradeSize
+    const double optimalPnl;
+    const double breakevenNotional; // Largest starting notional that does not lose money
+    const PriceLevelSpan bids; // Decoded levels of the tick's symbol
+    const PriceLevelSpan asks;
 
-    ArbitrageResult(const std::string& sym, const std::string& json, long long ti, long long pt, double upnl, double tn, const std::string& bl, bool ao, const std::array<double, 3>& r)
-        : symbol(sym), jsonStr(json), tickInitTime(ti), processTime(pt), unrealisedPnl(upnl), tradedNotional(tn), bottleneckLeg(bl), arbitrageOpportunity(ao), rates(r) {}
+    ArbitrageResult(std::string_view sym, std::string_view p, std::string_view json, long long ti, long long pt, double upnl, double tn, std::string_view bl, bool ao, const std::array<double, 3>& r, double on, double op, double bn, PriceLevelSpan b, PriceLevelSpan a)
+        : symbol(sym), path(p), jsonStr(json), tickInitTime(ti), processTime(pt), unrealisedPnl(upnl), tradedNotional(tn), bottleneckLeg(bl), arbitrageOpportunity(ao), rates(r), optimalNotional(on), optimalPnl(op), breakevenNotional(bn), bids(b), asks(a) {}
 
 };
 
@@ -0,0 +1,9 @@
+#ifndef CACHE_LINE_H
+#define CACHE_LINE_H
+
+#include <cstddef>
+
+// Alignment used to keep data written by different threads, or for different symbols, on separate lines
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+#endif // CACHE_LINE_H
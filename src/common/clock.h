@@ -0,0 +1,34 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <chrono>
+
+/**
+ * @class Clock
+ * @brief Source of nanosecond timestamps used to stamp ticks and results.
+ *
+ * Injected into the Server so that offline tools (e.g. Replay) can substitute
+ * recorded time for the wall clock.
+ */
+class Clock {
+public:
+    virtual ~Clock() = default;
+
+    // Nanoseconds since the Unix epoch
+    virtual long long now() const = 0;
+};
+
+/**
+ * @class SystemClock
+ * @brief Default clock backed by std::chrono::system_clock.
+ */
+class SystemClock : public Clock {
+public:
+    long long now() const override {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+    }
+};
+
+#endif // CLOCK_H
@@ -0,0 +1,115 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Monotonic nanoseconds for measuring stage durations, unrelated to the epoch-based Clock
+inline std::int64_t latencyNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+/**
+ * @class LatencyHistogram
+ * @brief HDR-style log-linear histogram of nanosecond durations.
+ *
+ * Values below 64 ns are counted exactly. Above that every power of two is split into 64 linear
+ * sub-buckets, so any reported value is within 1.6% of the recorded one. Values up to 2^40 ns
+ * (about 18 minutes) are tracked, longer ones are clamped into the top bucket. Recording is a
+ * count-leading-zeros and an increment into a fixed array, with no allocation.
+ *
+ * Not thread safe, each histogram is recorded and read by a single thread.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 6;
+    static constexpr std::uint64_t SUB_BUCKETS = 1ull << SUB_BUCKET_BITS;
+    static constexpr int MAX_VALUE_BITS = 40;
+    static constexpr std::size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void record(std::int64_t valueNs) {
+        const std::uint64_t value = valueNs > 0 ? static_cast<std::uint64_t>(valueNs) : 0;
+        counts[std::min(bucketIndex(value), BUCKET_COUNT - 1)]++;
+        total++;
+        maxValue = std::max(maxValue, value);
+    }
+
+    std::uint64_t count() const { return total; }
+    std::uint64_t max() const { return maxValue; }
+
+    // Highest value equivalent to the recorded value at the given percentile (0 to 100), 0 when empty
+    std::uint64_t valueAtPercentile(double percentile) const {
+        if (total == 0) {
+            return 0;
+        }
+        const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+        const auto target = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(clamped / 100.0 * total + 0.5));
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += counts[i];
+            if (seen >= target) {
+                return std::min(bucketUpperBound(i), maxValue);
+            }
+        }
+        return maxValue;
+    }
+
+    void reset() {
+        counts.fill(0);
+        total = 0;
+        maxValue = 0;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+
+    static std::size_t bucketIndex(std::uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<std::size_t>(value);
+        }
+        const int msb = highestBit(value);
+        const int shift = msb - SUB_BUCKET_BITS;
+        const std::uint64_t subBucket = (value >> shift) - SUB_BUCKETS;
+        return static_cast<std::size_t>((shift + 1) * SUB_BUCKETS + subBucket);
+    }
+
+    // Index of the most significant set bit, value must be non-zero
+    static int highestBit(std::uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<int>(index);
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    static std::uint64_t bucketUpperBound(std::size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        const std::size_t shift = index / SUB_BUCKETS - 1;
+        const std::uint64_t subBucket = index % SUB_BUCKETS + SUB_BUCKETS;
+        return ((subBucket + 1) << shift) - 1;
+    }
+
+private:
+    std::array<std::uint64_t, BUCKET_COUNT> counts{};
+    std::uint64_t total = 0;
+    std::uint64_t maxValue = 0;
+};
+
+#endif // LATENCY_HISTOGRAM_H
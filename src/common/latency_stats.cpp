@@ -0,0 +1,61 @@
+#include "common/latency_stats.h"
+#include <iomanip>
+#include <iostream>
+
+const char* to_string(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::Parse: return "parse";
+        case LatencyStage::QueueWait: return "queue wait";
+        case LatencyStage::BookUpdate: return "book update";
+        case LatencyStage::StartingNotional: return "starting notional";
+        case LatencyStage::EffectiveRates: return "effective rates";
+        case LatencyStage::WriterEnqueue: return "writer enqueue";
+        case LatencyStage::WriterFlush: return "writer flush";
+        case LatencyStage::EndToEnd: return "end to end";
+        case LatencyStage::Count: break;
+    }
+    return "unknown";
+}
+
+LatencyStats::LatencyStats(std::string name, double dumpIntervalSeconds)
+    : name(std::move(name)),
+      dumpIntervalNs(static_cast<std::int64_t>(dumpIntervalSeconds * 1e9)),
+      lastDumpNs(latencyNow()) {
+}
+
+void LatencyStats::maybeDump(std::int64_t nowNs) {
+    if (nowNs - lastDumpNs < dumpIntervalNs) {
+        return;
+    }
+    dump(std::cout, (nowNs - lastDumpNs) / 1e9);
+    reset();
+    lastDumpNs = nowNs;
+}
+
+void LatencyStats::dump(std::ostream& out, double windowSeconds) const {
+    const std::ios_base::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << "########### " << name << " LATENCY (ns) over " << std::fixed << std::setprecision(3) << windowSeconds << "s ###########\n";
+    out << std::left << std::setw(20) << "stage" << std::right
+        << std::setw(12) << "count" << std::setw(10) << "p50" << std::setw(10) << "p99"
+        << std::setw(10) << "p99.9" << std::setw(12) << "max" << "\n";
+    for (std::size_t i = 0; i < histograms.size(); ++i) {
+        const LatencyHistogram& h = histograms[i];
+        if (h.count() == 0) continue;
+        out << std::left << std::setw(20) << to_string(static_cast<LatencyStage>(i)) << std::right
+            << std::setw(12) << h.count()
+            << std::setw(10) << h.valueAtPercentile(50)
+            << std::setw(10) << h.valueAtPercentile(99)
+            << std::setw(10) << h.valueAtPercentile(99.9)
+            << std::setw(12) << h.max() << "\n";
+    }
+    out << std::flush;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void LatencyStats::reset() {
+    for (auto& h : histograms) {
+        h.reset();
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "common/latency_histogram.h"
+
+enum class LatencyStage {
+    Parse,            // Read completion to OrderBookTick, fast parser or to_struct
+    QueueWait,        // A connection queueing a parsed tick to the compute thread picking it up
+    BookUpdate,       // Copying the tick into the BookStore
+    StartingNotional, // recalcStartingNotional
+    EffectiveRates,   // The three getEffectiveRate calls of a path
+    WriterEnqueue,    // ResultWriter::write on the hot path
+    WriterFlush,      // ResultWriter::flush of a batch on the writer thread
+    EndToEnd,         // Frame receive to the last result of the tick written
+    Count
+};
+
+const char* to_string(LatencyStage stage);
+
+/**
+ * @class LatencyStats
+ * @brief One LatencyHistogram per pipeline stage, printed and reset every dump interval.
+ *
+ * Disabled (an interval of 0) it records nothing, so callers check enabled() before taking
+ * timestamps. Like the histograms it is owned and recorded by a single thread.
+ */
+class LatencyStats {
+public:
+    LatencyStats(std::string name, double dumpIntervalSeconds);
+
+    bool enabled() const { return dumpIntervalNs > 0; }
+    double getDumpIntervalSeconds() const { return dumpIntervalNs / 1e9; }
+
+    void record(LatencyStage stage, std::int64_t durationNs) {
+        histograms[static_cast<std::size_t>(stage)].record(durationNs);
+    }
+
+    const LatencyHistogram& histogram(LatencyStage stage) const {
+        return histograms[static_cast<std::size_t>(stage)];
+    }
+
+    // Dumps to std::cout and resets once the interval since the last dump has passed
+    void maybeDump(std::int64_t nowNs);
+
+    // Prints count, p50, p99, p99.9 and max for every stage that recorded anything
+    void dump(std::ostream& out, double windowSeconds) const;
+
+    void reset();
+
+private:
+    const std::string name;
+    const std::int64_t dumpIntervalNs;
+    std::int64_t lastDumpNs;
+    std::array<LatencyHistogram, static_cast<std::size_t>(LatencyStage::Count)> histograms;
+};
+
+#endif // LATENCY_STATS_H
@@ -2,8 +2,21 @@
 #define ORDER_BOOK_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include <initializer_list>
 #include <iostream>
+#include "common/symbol_table.h"
+
+// Levels kept per side of a book, matching the @depth5/@depth10/@depth20 stream subscribed to.
+// On @depth diff streams the local book holds every level and publishes this many of the best.
+// Set through the ORDER_BOOK_DEPTH CMake option.
+#ifndef ORDER_BOOK_MAX_DEPTH
+#define ORDER_BOOK_MAX_DEPTH 20
+#endif
 
 struct PriceLevel {
     double price;
@@ -12,59 +25,253 @@ struct PriceLevel {
     PriceLevel(double p = 0.0, double q = 0.0) : price(p), quantity(q) {}
 };
 
-struct OrderBookTick {
-    long long updateId;
-    std::string symbol;
-    std::string jsonStr;
-    
-    std::vector<PriceLevel> bids; // Sorted from highest bid price to lowest
-    std::vector<PriceLevel> asks; // Sorted from lowest ask price to highest
-
-    long long tickInitTime; // Time when the tick was created/received
-
-    OrderBookTick(long long u, 
-                  std::string s, 
-                  std::string json,
-                  std::vector<PriceLevel> b, 
-                  std::vector<PriceLevel> a, 
-                  long long ts = 0)
-        : updateId(u), 
-          symbol(std::move(s)), 
-          jsonStr(std::move(json)),
-          bids(std::move(b)), 
-          asks(std::move(a)), 
-          tickInitTime(ts) {}
-
-    OrderBookTick(){}
-
-
-    double getBestBidPrice() const { 
+// Doubles per AVX2 vector, the widest the price level kernels load. Level arrays are padded to a
+// multiple of this so kernels can always load whole vectors.
+constexpr std::size_t PRICE_LEVEL_LANES = 4;
+
+/**
+ * @brief Iterates price and quantity arrays, yielding PriceLevel values.
+ */
+class PriceLevelIterator {
+public:
+    PriceLevelIterator(const double* prices, const double* quantities, std::size_t i)
+        : prices(prices), quantities(quantities), i(i) {}
+
+    PriceLevel operator*() const { return PriceLevel(prices[i], quantities[i]); }
+    PriceLevelIterator& operator++() { ++i; return *this; }
+    bool operator!=(const PriceLevelIterator& other) const { return i != other.i; }
+    bool operator==(const PriceLevelIterator& other) const { return i == other.i; }
+
+private:
+    const double* prices;
+    const double* quantities;
+    std::size_t i;
+};
+
+/**
+ * @brief Writable reference to one level of a PriceLevels, which stores no PriceLevel to refer to.
+ */
+struct PriceLevelRef {
+    double& price;
+    double& quantity;
+
+    PriceLevelRef& operator=(const PriceLevel& level) {
+        price = level.price;
+        quantity = level.quantity;
+        return *this;
+    }
+
+    operator PriceLevel() const { return PriceLevel(price, quantity); }
+};
+
+/**
+ * @class PriceLevels
+ * @brief Fixed-capacity, inline price levels for one side of a book.
+ *
+ * Never allocates. Levels past the capacity are dropped, which for a side sorted best-first
+ * keeps the most relevant part of the book. Copies only move the levels in use.
+ *
+ * Prices and quantities are stored as separate arrays, aligned and padded to whole vectors,
+ * so the kernels in price_level_kernels.h can sum and scan a side without gathering. Slots
+ * past size() hold stale or zero values and are masked off by the kernels.
+ */
+template <std::size_t Capacity>
+class PriceLevels {
+public:
+    static constexpr std::size_t PADDED_CAPACITY = (Capacity + PRICE_LEVEL_LANES - 1) / PRICE_LEVEL_LANES * PRICE_LEVEL_LANES;
+
+    PriceLevels() : prices{}, quantities{}, count(0) {}
+
+    PriceLevels(std::initializer_list<PriceLevel> init) : PriceLevels() {
+        *this = init;
+    }
+
+    PriceLevels(const PriceLevels& other) : prices{}, quantities{}, count(other.count) {
+        std::copy_n(other.prices.begin(), other.count, prices.begin());
+        std::copy_n(other.quantities.begin(), other.count, quantities.begin());
+    }
+
+    PriceLevels& operator=(const PriceLevels& other) {
+        std::copy_n(other.prices.begin(), other.count, prices.begin());
+        std::copy_n(other.quantities.begin(), other.count, quantities.begin());
+        count = other.count;
+        return *this;
+    }
+
+    // Level-wise comparison of the levels in use, what lies past size() is ignored
+    bool operator==(const PriceLevels& other) const {
+        return count == other.count &&
+               std::equal(prices.begin(), prices.begin() + count, other.prices.begin()) &&
+               std::equal(quantities.begin(), quantities.begin() + count, other.quantities.begin());
+    }
+
+    bool operator!=(const PriceLevels& other) const { return !(*this == other); }
+
+    PriceLevels& operator=(std::initializer_list<PriceLevel> init) {
+        clear();
+        for (const auto& level : init) {
+            push_back(level);
+        }
+        return *this;
+    }
+
+    // Returns false once the side is full, the level is then dropped
+    bool push_back(const PriceLevel& level) {
+        return emplace_back(level.price, level.quantity);
+    }
+
+    bool emplace_back(double price, double quantity) {
+        if (count == Capacity) {
+            return false;
+        }
+        prices[count] = price;
+        quantities[count] = quantity;
+        count++;
+        return true;
+    }
+
+    void clear() { count = 0; }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    PriceLevelRef operator[](std::size_t i) { return PriceLevelRef{prices[i], quantities[i]}; }
+    PriceLevel operator[](std::size_t i) const { return PriceLevel(prices[i], quantities[i]); }
+
+    const double* priceData() const { return prices.data(); }
+    const double* quantityData() const { return quantities.data(); }
+
+    PriceLevelIterator begin() const { return PriceLevelIterator(prices.data(), quantities.data(), 0); }
+    PriceLevelIterator end() const { return PriceLevelIterator(prices.data(), quantities.data(), count); }
+
+private:
+    alignas(PRICE_LEVEL_LANES * sizeof(double)) std::array<double, PADDED_CAPACITY> prices;
+    alignas(PRICE_LEVEL_LANES * sizeof(double)) std::array<double, PADDED_CAPACITY> quantities;
+    std::size_t count;
+};
+
+/**
+ * @class PriceLevelSpan
+ * @brief Read-only view over one side's price and quantity arrays, so calculations work on any book depth.
+ *
+ * Only constructible from a PriceLevels, which guarantees both arrays are padded to whole vectors.
+ * Kept to two words, the quantities found at an offset from the prices, so it is still passed in
+ * registers like the pointer and size it replaced.
+ */
+class PriceLevelSpan {
+public:
+    PriceLevelSpan() : prices(nullptr), count(0), quantityOffset(0) {}
+
+    template <std::size_t Capacity>
+    PriceLevelSpan(const PriceLevels<Capacity>& levels)
+        : prices(levels.priceData()),
+          count(static_cast<std::uint32_t>(levels.size())),
+          quantityOffset(static_cast<std::uint32_t>(levels.quantityData() - levels.priceData())) {
+        static_assert(PriceLevels<Capacity>::PADDED_CAPACITY <= UINT32_MAX, "Offsets are held in 32 bits");
+    }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    PriceLevel operator[](std::size_t i) const { return PriceLevel(prices[i], quantityData()[i]); }
+
+    const double* priceData() const { return prices; }
+    const double* quantityData() const { return prices + quantityOffset; }
+
+    PriceLevelIterator begin() const { return PriceLevelIterator(prices, quantityData(), 0); }
+    PriceLevelIterator end() const { return PriceLevelIterator(prices, quantityData(), count); }
+
+private:
+    const double* prices;
+    std::uint32_t count;
+    std::uint32_t quantityOffset; // In elements, the quantities array follows the prices in a PriceLevels
+};
+
+/**
+ * @brief Book state for one symbol, held by value in the server's per-symbol slots.
+ */
+template <std::size_t MaxDepth>
+struct BasicOrderBook {
+    static constexpr long long NO_UPDATE = -1;
+
+    long long updateId = NO_UPDATE;
+
+    PriceLevels<MaxDepth> bids; // Sorted from highest bid price to lowest
+    PriceLevels<MaxDepth> asks; // Sorted from lowest ask price to highest
+
+    long long tickInitTime = 0; // Time when the tick was created/received
+
+    bool hasUpdate() const { return updateId != NO_UPDATE; }
+
+    double getBestBidPrice() const {
         if (!bids.empty()) {
-            return bids[0].price; 
+            return bids[0].price;
         }
-        return 0.0; 
+        return 0.0;
     }
 
-    double getBestBidQty() const { 
+    double getBestBidQty() const {
         if (!bids.empty()) {
             return bids[0].quantity;
         }
         return 0.0;
     }
 
-    double getBestAskPrice() const { 
+    double getBestAskPrice() const {
         if (!asks.empty()) {
-            return asks[0].price; 
+            return asks[0].price;
         }
         return 0.0;
     }
 
-    double getBestAskQty() const { 
+    double getBestAskQty() const {
         if (!asks.empty()) {
             return asks[0].quantity;
         }
         return 0.0;
     }
+
+    // Replaces both sides with a single level each, as a @bookTicker update describes the book
+    void setTopOfBook(long long id, const PriceLevel& bid, const PriceLevel& ask, long long initTime) {
+        updateId = id;
+        bids.clear();
+        bids.push_back(bid);
+        asks.clear();
+        asks.push_back(ask);
+        tickInitTime = initTime;
+    }
+};
+
+/**
+ * @brief A freshly parsed update: the book plus views of where it came from.
+ *
+ * symbol and jsonStr point into the received frame and are only valid while the update is
+ * being handled. Assigning the tick to a BasicOrderBook copies the levels and drops the views.
+ */
+template <std::size_t MaxDepth>
+struct BasicOrderBookTick : BasicOrderBook<MaxDepth> {
+    SymbolId symbolId = INVALID_SYMBOL_ID; // Resolved by the parser, INVALID_SYMBOL_ID if not interned
+    std::string_view symbol;
+    std::string_view jsonStr;
 };
 
-#endif // ORDER_BOOK_H
\ No newline at end of file
+/**
+ * @brief A @bookTicker update: the best bid and ask alone, pushed on every change to either.
+ *
+ * Small enough to parse and apply in a few dozen nanoseconds. The views are only valid while
+ * the update is being handled, as for BasicOrderBookTick.
+ */
+struct BookTicker {
+    SymbolId symbolId = INVALID_SYMBOL_ID;
+    std::string_view symbol;
+    std::string_view jsonStr;
+    long long updateId = 0;
+    long long tickInitTime = 0;
+    PriceLevel bid;
+    PriceLevel ask;
+};
+
+using OrderBook = BasicOrderBook<ORDER_BOOK_MAX_DEPTH>;
+using OrderBookTick = BasicOrderBookTick<ORDER_BOOK_MAX_DEPTH>;
+
+#endif // ORDER_BOOK_H
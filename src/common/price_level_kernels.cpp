@@ -0,0 +1,324 @@
+#include "common/price_level_kernels.h"
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PRICE_LEVEL_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang need the instruction set enabled per function, MSVC compiles the intrinsics as they are
+#if defined(PRICE_LEVEL_KERNELS_X86) && defined(__GNUC__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+const char* to_string(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::Scalar: return "scalar";
+        case KernelIsa::Sse2: return "sse2";
+        case KernelIsa::Avx2: return "avx2";
+    }
+    return "unknown";
+}
+
+namespace {
+
+// Sums and scans all work on blocks of PRICE_LEVEL_LANES levels. Within a block the running total
+// is built by two shifted adds, lane i adding lane i-1 and then lane i-2, the same tree a vector
+// scan computes. The scalar kernels spell that order out so every ISA rounds identically.
+static_assert(PRICE_LEVEL_LANES == 4, "Kernels are written for four lanes");
+
+void scanBlock(const double (&v)[4], double carry, double (&out)[4]) {
+    const double t0 = v[0] + 0.0;
+    const double t1 = v[1] + v[0];
+    const double t2 = v[2] + v[1];
+    const double t3 = v[3] + v[2];
+    out[0] = carry + (t0 + 0.0);
+    out[1] = carry + (t1 + 0.0);
+    out[2] = carry + (t2 + t0);
+    out[3] = carry + (t3 + t1);
+}
+
+LevelSums sumScalar(const double* prices, const double* quantities, std::size_t count) {
+    double quantity[4] = {};
+    double notional[4] = {};
+    for (std::size_t i = 0; i < count; ++i) {
+        quantity[i % 4] += quantities[i];
+        notional[i % 4] += prices[i] * quantities[i];
+    }
+    return {(quantity[0] + quantity[1]) + (quantity[2] + quantity[3]),
+            (notional[0] + notional[1]) + (notional[2] + notional[3])};
+}
+
+FillLevel findFillScalar(const double* prices, const double* quantities, std::size_t count, double target, FillTarget by) {
+
+    double carryQuantity = 0.0;
+    double carryNotional = 0.0;
+    for (std::size_t block = 0; block < count; block += 4) {
+        double quantity[4];
+        double notional[4];
+        for (std::size_t lane = 0; lane < 4; ++lane) {
+            const std::size_t i = block + lane;
+            quantity[lane] = i < count ? quantities[i] : 0.0;
+            notional[lane] = i < count ? prices[i] * quantities[i] : 0.0;
+        }
+
+        double runningQuantity[4];
+        double runningNotional[4];
+        scanBlock(quantity, carryQuantity, runningQuantity);
+        scanBlock(notional, carryNotional, runningNotional);
+        const double* running = by == FillTarget::Quantity ? runningQuantity : runningNotional;
+
+        for (std::size_t lane = 0; lane < 4 && block + lane < count; ++lane) {
+            if (running[lane] >= target) {
+                return {block + lane,
+                        lane ? runningQuantity[lane - 1] : carryQuantity,
+                        lane ? runningNotional[lane - 1] : carryNotional};
+            }
+        }
+        carryQuantity = runningQuantity[3];
+        carryNotional = runningNotional[3];
+    }
+    return {count, carryQuantity, carryNotional};
+}
+
+#ifdef PRICE_LEVEL_KERNELS_X86
+
+unsigned lowestBit(unsigned bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(bits));
+#endif
+}
+
+bool cpuHasAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+    if (!osSavesYmm) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+// --- SSE2: each block is a low pair (lanes 0, 1) and a high pair (lanes 2, 3) ---
+
+struct Pair {
+    __m128d lo;
+    __m128d hi;
+};
+
+Pair scanSse2(Pair v) {
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d t_lo = _mm_add_pd(v.lo, _mm_unpacklo_pd(zero, v.lo));     // [v0 + 0, v1 + v0]
+    const __m128d t_hi = _mm_add_pd(v.hi, _mm_shuffle_pd(v.lo, v.hi, 1));   // [v2 + v1, v3 + v2]
+    return {_mm_add_pd(t_lo, zero), _mm_add_pd(t_hi, t_lo)};
+}
+
+Pair tailMaskSse2(std::size_t valid) {
+    const __m128d count = _mm_set1_pd(static_cast<double>(valid));
+    return {_mm_cmplt_pd(_mm_set_pd(1, 0), count), _mm_cmplt_pd(_mm_set_pd(3, 2), count)};
+}
+
+LevelSums sumSse2(const double* prices, const double* quantities, std::size_t count) {
+    Pair quantity = {_mm_setzero_pd(), _mm_setzero_pd()};
+    Pair notional = quantity;
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128d q_lo = _mm_load_pd(quantities + i);
+        const __m128d q_hi = _mm_load_pd(quantities + i + 2);
+        quantity.lo = _mm_add_pd(quantity.lo, q_lo);
+        quantity.hi = _mm_add_pd(quantity.hi, q_hi);
+        notional.lo = _mm_add_pd(notional.lo, _mm_mul_pd(_mm_load_pd(prices + i), q_lo));
+        notional.hi = _mm_add_pd(notional.hi, _mm_mul_pd(_mm_load_pd(prices + i + 2), q_hi));
+    }
+    if (i < count) {
+        const Pair mask = tailMaskSse2(count - i);
+        const __m128d q_lo = _mm_load_pd(quantities + i);
+        const __m128d q_hi = _mm_load_pd(quantities + i + 2);
+        quantity.lo = _mm_add_pd(quantity.lo, _mm_and_pd(q_lo, mask.lo));
+        quantity.hi = _mm_add_pd(quantity.hi, _mm_and_pd(q_hi, mask.hi));
+        notional.lo = _mm_add_pd(notional.lo, _mm_and_pd(_mm_mul_pd(_mm_load_pd(prices + i), q_lo), mask.lo));
+        notional.hi = _mm_add_pd(notional.hi, _mm_and_pd(_mm_mul_pd(_mm_load_pd(prices + i + 2), q_hi), mask.hi));
+    }
+
+    alignas(16) double q[4];
+    alignas(16) double n[4];
+    _mm_store_pd(q, quantity.lo);
+    _mm_store_pd(q + 2, quantity.hi);
+    _mm_store_pd(n, notional.lo);
+    _mm_store_pd(n + 2, notional.hi);
+    return {(q[0] + q[1]) + (q[2] + q[3]), (n[0] + n[1]) + (n[2] + n[3])};
+}
+
+FillLevel findFillSse2(const double* prices, const double* quantities, std::size_t count, double target, FillTarget by) {
+    const __m128d targets = _mm_set1_pd(target);
+
+    __m128d carryQuantity = _mm_setzero_pd();
+    __m128d carryNotional = _mm_setzero_pd();
+    for (std::size_t block = 0; block < count; block += 4) {
+        Pair quantity = {_mm_load_pd(quantities + block), _mm_load_pd(quantities + block + 2)};
+        Pair notional = {_mm_mul_pd(_mm_load_pd(prices + block), quantity.lo),
+                         _mm_mul_pd(_mm_load_pd(prices + block + 2), quantity.hi)};
+        unsigned valid = 0xF;
+        if (count - block < 4) {
+            const Pair mask = tailMaskSse2(count - block);
+            quantity = {_mm_and_pd(quantity.lo, mask.lo), _mm_and_pd(quantity.hi, mask.hi)};
+            notional = {_mm_and_pd(notional.lo, mask.lo), _mm_and_pd(notional.hi, mask.hi)};
+            valid = (1u << (count - block)) - 1;
+        }
+
+        Pair runningQuantity = scanSse2(quantity);
+        runningQuantity = {_mm_add_pd(carryQuantity, runningQuantity.lo), _mm_add_pd(carryQuantity, runningQuantity.hi)};
+        Pair runningNotional = scanSse2(notional);
+        runningNotional = {_mm_add_pd(carryNotional, runningNotional.lo), _mm_add_pd(carryNotional, runningNotional.hi)};
+        const Pair& running = by == FillTarget::Quantity ? runningQuantity : runningNotional;
+
+        const unsigned hits = (static_cast<unsigned>(_mm_movemask_pd(_mm_cmpge_pd(running.lo, targets)))
+                               | static_cast<unsigned>(_mm_movemask_pd(_mm_cmpge_pd(running.hi, targets))) << 2) & valid;
+        if (hits) {
+            const unsigned lane = lowestBit(hits);
+            alignas(16) double q[4];
+            alignas(16) double n[4];
+            _mm_store_pd(q, runningQuantity.lo);
+            _mm_store_pd(q + 2, runningQuantity.hi);
+            _mm_store_pd(n, runningNotional.lo);
+            _mm_store_pd(n + 2, runningNotional.hi);
+            return {block + lane,
+                    lane ? q[lane - 1] : _mm_cvtsd_f64(carryQuantity),
+                    lane ? n[lane - 1] : _mm_cvtsd_f64(carryNotional)};
+        }
+        carryQuantity = _mm_unpackhi_pd(runningQuantity.hi, runningQuantity.hi);
+        carryNotional = _mm_unpackhi_pd(runningNotional.hi, runningNotional.hi);
+    }
+    return {count, _mm_cvtsd_f64(carryQuantity), _mm_cvtsd_f64(carryNotional)};
+}
+
+// --- AVX2: one block per vector ---
+
+TARGET_AVX2 __m256d scanAvx2(__m256d v) {
+    const __m256d zero = _mm256_setzero_pd();
+    // [0, v0, v1, v2], then [0, 0, t0, t1]
+    const __m256d t = _mm256_add_pd(v, _mm256_blend_pd(zero, _mm256_permute4x64_pd(v, _MM_SHUFFLE(2, 1, 0, 0)), 0xE));
+    return _mm256_add_pd(t, _mm256_permute2f128_pd(t, t, 0x08));
+}
+
+TARGET_AVX2 __m256d tailMaskAvx2(std::size_t valid) {
+    return _mm256_cmp_pd(_mm256_set_pd(3, 2, 1, 0), _mm256_set1_pd(static_cast<double>(valid)), _CMP_LT_OQ);
+}
+
+TARGET_AVX2 LevelSums sumAvx2(const double* prices, const double* quantities, std::size_t count) {
+    __m256d quantity = _mm256_setzero_pd();
+    __m256d notional = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d q = _mm256_load_pd(quantities + i);
+        quantity = _mm256_add_pd(quantity, q);
+        notional = _mm256_add_pd(notional, _mm256_mul_pd(_mm256_load_pd(prices + i), q));
+    }
+    if (i < count) {
+        const __m256d mask = tailMaskAvx2(count - i);
+        const __m256d q = _mm256_load_pd(quantities + i);
+        quantity = _mm256_add_pd(quantity, _mm256_and_pd(q, mask));
+        notional = _mm256_add_pd(notional, _mm256_and_pd(_mm256_mul_pd(_mm256_load_pd(prices + i), q), mask));
+    }
+
+    alignas(32) double q[4];
+    alignas(32) double n[4];
+    _mm256_store_pd(q, quantity);
+    _mm256_store_pd(n, notional);
+    return {(q[0] + q[1]) + (q[2] + q[3]), (n[0] + n[1]) + (n[2] + n[3])};
+}
+
+TARGET_AVX2 FillLevel findFillAvx2(const double* prices, const double* quantities, std::size_t count, double target, FillTarget by) {
+    const __m256d targets = _mm256_set1_pd(target);
+
+    __m256d carryQuantity = _mm256_setzero_pd();
+    __m256d carryNotional = _mm256_setzero_pd();
+    for (std::size_t block = 0; block < count; block += 4) {
+        __m256d quantity = _mm256_load_pd(quantities + block);
+        __m256d notional = _mm256_mul_pd(_mm256_load_pd(prices + block), quantity);
+        unsigned valid = 0xF;
+        if (count - block < 4) {
+            const __m256d mask = tailMaskAvx2(count - block);
+            quantity = _mm256_and_pd(quantity, mask);
+            notional = _mm256_and_pd(notional, mask);
+            valid = (1u << (count - block)) - 1;
+        }
+
+        const __m256d runningQuantity = _mm256_add_pd(carryQuantity, scanAvx2(quantity));
+        const __m256d runningNotional = _mm256_add_pd(carryNotional, scanAvx2(notional));
+        const __m256d running = by == FillTarget::Quantity ? runningQuantity : runningNotional;
+
+        const unsigned hits = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(running, targets, _CMP_GE_OQ))) & valid;
+        if (hits) {
+            const unsigned lane = lowestBit(hits);
+            alignas(32) double q[4];
+            alignas(32) double n[4];
+            _mm256_store_pd(q, runningQuantity);
+            _mm256_store_pd(n, runningNotional);
+            return {block + lane,
+                    lane ? q[lane - 1] : _mm256_cvtsd_f64(carryQuantity),
+                    lane ? n[lane - 1] : _mm256_cvtsd_f64(carryNotional)};
+        }
+        carryQuantity = _mm256_permute4x64_pd(runningQuantity, _MM_SHUFFLE(3, 3, 3, 3));
+        carryNotional = _mm256_permute4x64_pd(runningNotional, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    return {count, _mm256_cvtsd_f64(carryQuantity), _mm256_cvtsd_f64(carryNotional)};
+}
+
+#endif // PRICE_LEVEL_KERNELS_X86
+
+const LevelKernels SCALAR_KERNELS = {KernelIsa::Scalar, sumScalar, findFillScalar};
+#ifdef PRICE_LEVEL_KERNELS_X86
+const LevelKernels SSE2_KERNELS = {KernelIsa::Sse2, sumSse2, findFillSse2};
+const LevelKernels AVX2_KERNELS = {KernelIsa::Avx2, sumAvx2, findFillAvx2};
+#endif
+
+} // namespace
+
+bool isSupported(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::Scalar:
+            return true;
+#ifdef PRICE_LEVEL_KERNELS_X86
+        case KernelIsa::Sse2:
+            return true;
+        case KernelIsa::Avx2:
+            return cpuHasAvx2();
+#endif
+        default:
+            return false;
+    }
+}
+
+const LevelKernels& levelKernels(KernelIsa isa) {
+    if (!isSupported(isa)) {
+        throw std::invalid_argument(std::string("Price level kernels not supported on this CPU: ") + to_string(isa));
+    }
+#ifdef PRICE_LEVEL_KERNELS_X86
+    if (isa == KernelIsa::Avx2) return AVX2_KERNELS;
+    if (isa == KernelIsa::Sse2) return SSE2_KERNELS;
+#endif
+    return SCALAR_KERNELS;
+}
+
+const LevelKernels& activeLevelKernels() {
+    static const LevelKernels& active = levelKernels(
+        isSupported(KernelIsa::Avx2) ? KernelIsa::Avx2 :
+        isSupported(KernelIsa::Sse2) ? KernelIsa::Sse2 : KernelIsa::Scalar);
+    return active;
+}
@@ -0,0 +1,78 @@
+#ifndef PRICE_LEVEL_KERNELS_H
+#define PRICE_LEVEL_KERNELS_H
+
+#include <cstddef>
+#include "common/order_book.h"
+
+enum class KernelIsa {
+    Scalar, // Portable, also the reference the vector kernels are checked against
+    Sse2,   // x86-64 baseline
+    Avx2
+};
+
+const char* to_string(KernelIsa isa);
+
+struct LevelSums {
+    double quantity; // Sum of quantities, in the base currency
+    double notional; // Sum of price * quantity, in the quote currency
+};
+
+enum class FillTarget { Quantity, Notional };
+
+struct FillLevel {
+    std::size_t index;     // First level whose running total reaches the target, size() if none does
+    double quantityBefore; // Totals over the levels before index
+    double notionalBefore;
+};
+
+/**
+ * @brief One implementation of the per-side sums and scans the calculator runs on every tick.
+ *
+ * Every implementation accumulates in the same order, four interleaved lanes combined pairwise,
+ * so all of them return bit-identical results for the same input. That order differs from a
+ * plain left-to-right loop by rounding only.
+ */
+struct LevelKernels {
+    KernelIsa isa;
+
+    // Arrays as a PriceLevelSpan exposes them, passed apart so they travel in registers
+    LevelSums (*sum)(const double* prices, const double* quantities, std::size_t count);
+
+    // Walks the running total of quantity or notional until it reaches target
+    FillLevel (*findFill)(const double* prices, const double* quantities, std::size_t count, double target, FillTarget by);
+
+    LevelSums sumOf(PriceLevelSpan levels) const {
+        return sum(levels.priceData(), levels.quantityData(), levels.size());
+    }
+
+    FillLevel findFillOf(PriceLevelSpan levels, double target, FillTarget by) const {
+        return findFill(levels.priceData(), levels.quantityData(), levels.size(), target, by);
+    }
+};
+
+bool isSupported(KernelIsa isa);
+
+// The kernels for one instruction set, which must be supported
+const LevelKernels& levelKernels(KernelIsa isa);
+
+// The kernels for the widest instruction set this CPU supports, chosen on first use
+const LevelKernels& activeLevelKernels();
+
+inline LevelSums sumLevels(PriceLevelSpan levels) {
+    return activeLevelKernels().sumOf(levels);
+}
+
+// Most fills finish inside the best level. Every kernel would return the same answer for those, so
+// they are answered here without the call.
+inline FillLevel findFillLevel(PriceLevelSpan levels, double target, FillTarget by) {
+    if (!levels.empty()) {
+        const double first = by == FillTarget::Quantity ? levels.quantityData()[0]
+                                                        : levels.priceData()[0] * levels.quantityData()[0];
+        if (first >= target) {
+            return {0, 0.0, 0.0};
+        }
+    }
+    return activeLevelKernels().findFillOf(levels, target, by);
+}
+
+#endif // PRICE_LEVEL_KERNELS_H
@@ -0,0 +1,90 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include "common/cache_line.h"
+
+/**
+ * @class SpscRing
+ * @brief Bounded, lock-free single-producer/single-consumer ring of preallocated slots.
+ *
+ * Slots are filled and drained in place, so slot types can keep heap capacity (e.g. strings)
+ * from lap to lap and steady state never allocates. The producer and consumer indices live on
+ * separate cache lines, and each side caches the other's index so it only reads the shared
+ * atomic when the ring looks full or empty.
+ *
+ * Exactly one thread may call the producer functions and exactly one the consumer functions.
+ */
+template <typename T>
+class SpscRing {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscRing(std::size_t minCapacity) : slots(roundUpToPowerOfTwo(minCapacity)), mask(slots.size() - 1) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer: the next free slot to fill, nullptr if the ring is full
+    T* producerSlot() {
+        const std::size_t tail = producer.index.load(std::memory_order_relaxed);
+        if (tail - producer.cachedOther == slots.size()) {
+            producer.cachedOther = consumer.index.load(std::memory_order_acquire);
+            if (tail - producer.cachedOther == slots.size()) {
+                return nullptr;
+            }
+        }
+        return &slots[tail & mask];
+    }
+
+    // Producer: makes the slot returned by producerSlot() visible to the consumer
+    void publish() {
+        producer.index.store(producer.index.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer: the oldest published slot, nullptr if the ring is empty
+    T* consumerSlot() {
+        const std::size_t head = consumer.index.load(std::memory_order_relaxed);
+        if (head == consumer.cachedOther) {
+            consumer.cachedOther = producer.index.load(std::memory_order_acquire);
+            if (head == consumer.cachedOther) {
+                return nullptr;
+            }
+        }
+        return &slots[head & mask];
+    }
+
+    // Consumer: hands the slot returned by consumerSlot() back to the producer
+    void release() {
+        consumer.index.store(consumer.index.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Slots currently published and not yet released, exact only on the producer or consumer thread
+    std::size_t size() const {
+        return producer.index.load(std::memory_order_acquire) - consumer.index.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const { return slots.size(); }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Index {
+        std::atomic<std::size_t> index{0};
+        std::size_t cachedOther = 0; // Last seen value of the other side's index
+    };
+
+    std::vector<T> slots;
+    const std::size_t mask;
+    Index producer;
+    Index consumer;
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t n) {
+        std::size_t capacity = 1;
+        while (capacity < n) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+};
+
+#endif // SPSC_RING_H
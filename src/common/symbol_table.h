@@ -0,0 +1,89 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using SymbolId = std::uint32_t;
+
+constexpr SymbolId INVALID_SYMBOL_ID = std::numeric_limits<SymbolId>::max();
+
+/**
+ * @class SymbolTable
+ * @brief Interns trading pair symbols into small, dense integer IDs.
+ *
+ * Symbols are interned once at startup. IDs are assigned in insertion order starting at 0,
+ * so they index directly into per-symbol arrays such as the BookStore. Lookups hash the view
+ * into an open-addressed table and never allocate, so parsers can resolve IDs per frame.
+ */
+class SymbolTable {
+public:
+    SymbolTable() : buckets(16, INVALID_SYMBOL_ID) {}
+
+    // Returns the existing ID for the symbol, or assigns the next one
+    SymbolId intern(std::string_view symbol) {
+        const SymbolId existing = find(symbol);
+        if (existing != INVALID_SYMBOL_ID) {
+            return existing;
+        }
+
+        // Keep the load factor at or below one half so probe sequences stay short
+        if ((names.size() + 1) * 2 > buckets.size()) {
+            rehash(buckets.size() * 2);
+        }
+
+        const SymbolId id = static_cast<SymbolId>(names.size());
+        names.emplace_back(symbol);
+        insertBucket(id);
+        return id;
+    }
+
+    // Returns INVALID_SYMBOL_ID for symbols that were never interned
+    SymbolId find(std::string_view symbol) const {
+        const std::size_t mask = buckets.size() - 1;
+        for (std::size_t i = hash(symbol) & mask; ; i = (i + 1) & mask) {
+            const SymbolId id = buckets[i];
+            if (id == INVALID_SYMBOL_ID || names[id] == symbol) {
+                return id;
+            }
+        }
+    }
+
+    const std::string& name(SymbolId id) const { return names[id]; }
+
+    std::size_t size() const { return names.size(); }
+
+private:
+    std::vector<std::string> names;
+    std::vector<SymbolId> buckets; // Power of two sized, INVALID_SYMBOL_ID marks an empty bucket
+
+    // FNV-1a, symbols are short so this is cheaper than std::hash's setup
+    static std::size_t hash(std::string_view symbol) {
+        std::uint64_t h = 14695981039346656037ull;
+        for (const char c : symbol) {
+            h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        return static_cast<std::size_t>(h);
+    }
+
+    void insertBucket(SymbolId id) {
+        const std::size_t mask = buckets.size() - 1;
+        std::size_t i = hash(names[id]) & mask;
+        while (buckets[i] != INVALID_SYMBOL_ID) {
+            i = (i + 1) & mask;
+        }
+        buckets[i] = id;
+    }
+
+    void rehash(std::size_t bucketCount) {
+        buckets.assign(bucketCount, INVALID_SYMBOL_ID);
+        for (SymbolId id = 0; id < names.size(); ++id) {
+            insertBucket(id);
+        }
+    }
+};
+
+#endif // SYMBOL_TABLE_H
@@ -0,0 +1,36 @@
+#include "common/thread_affinity.h"
+#include <cstdlib>
+#include <sstream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+bool pinCurrentThreadToCpu(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream input(list);
+    std::string item;
+    while (std::getline(input, item, ',')) {
+        char* end = nullptr;
+        const long cpu = std::strtol(item.c_str(), &end, 10);
+        if (end != item.c_str() && cpu >= 0) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
@@ -0,0 +1,13 @@
+#ifndef THREAD_AFFINITY_H
+#define THREAD_AFFINITY_H
+
+#include <string>
+#include <vector>
+
+// Restricts the calling thread to one CPU, false where the OS refuses or pinning is unsupported
+bool pinCurrentThreadToCpu(int cpu);
+
+// Parses a comma-separated CPU list such as "2,3,5", skipping anything that is not a number
+std::vector<int> parseCpuList(const std::string& list);
+
+#endif // THREAD_AFFINITY_H
@@ -6,14 +6,18 @@
 #include <sstream>
 #include <array>
 #include <algorithm> 
+#include <vector>
+#include <stdexcept>
 #include "common/order_book.h" 
+#include "common/symbol_table.h"
 
 struct TradeLeg {
     std::string symbol;         // The actual trading pair symbol (e.g., "BTCUSDT")
     bool requiresInversion;     // True if we need to use 1.0 / tick.askPrice, False if we use tick.bidPrice
+    SymbolId symbolId;          // Interned ID of symbol, INVALID_SYMBOL_ID until internSymbols is called
 
     TradeLeg(const std::string& sym, bool flip)
-        : symbol(sym), requiresInversion(flip) {}
+        : symbol(sym), requiresInversion(flip), symbolId(INVALID_SYMBOL_ID) {}
 };
 
 struct ArbitragePath {
@@ -37,6 +41,13 @@ struct ArbitragePath {
     const TradeLeg& getSecondLeg() const { return legs[1]; }
     const TradeLeg& getThirdLeg() const { return legs[2]; }
 
+    // Interns every leg's symbol and records the resulting IDs on the legs
+    void internSymbols(SymbolTable& symbols) {
+        for (auto& leg : legs) {
+            leg.symbolId = symbols.intern(leg.symbol);
+        }
+    }
+
     /**
      * Parses a string representation of an arbitrage path, there must only be 3 legs
      * 
@@ -84,6 +95,36 @@ struct ArbitragePath {
 
         return ArbitragePath(base, parsed_legs);
     }
+
+    /**
+     * Parses several arbitrage paths separated by ';', e.g.
+     * btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY;usdt:btcusdt:SELL,ltcbtc:SELL,ltcusdt:BUY
+     */
+    static std::vector<ArbitragePath> list_from_string(const std::string& str) {
+        std::vector<ArbitragePath> paths;
+        std::stringstream ss(str);
+        std::string path_segment;
+
+        while (std::getline(ss, path_segment, ';')) {
+            if (path_segment.empty()) continue;
+            paths.push_back(from_string(path_segment));
+        }
+
+        if (paths.empty()) {
+            throw std::invalid_argument("No arbitrage paths in: " + str);
+        }
+        return paths;
+    }
+
+    // Inverse of from_string
+    std::string to_string() const {
+        std::string str = startCurrency + ":";
+        for (size_t i = 0; i < legs.size(); ++i) {
+            if (i > 0) str += ",";
+            str += legs[i].symbol + (legs[i].requiresInversion ? ":SELL" : ":BUY");
+        }
+        return str;
+    }
 };
 
 #endif // TRADE_LEG_H
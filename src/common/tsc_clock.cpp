@@ -0,0 +1,153 @@
+#include "common/tsc_clock.h"
+#include <algorithm>
+#include <cmath>
+#if defined(TSC_CLOCK_X86) && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace {
+
+// Window the counter's rate is first measured over
+constexpr std::chrono::milliseconds STARTUP_CALIBRATION{20};
+
+// Largest fraction of an interval a recalibration corrects, as adjtime slews
+constexpr double MAX_SLEW = 500e-6;
+
+// Attempts at reading the clocks between two counter reads, the tightest pair is kept
+constexpr int SAMPLE_ATTEMPTS = 5;
+
+long long steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+long long systemNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+bool TscClock::invariantTscAvailable() {
+#if defined(TSC_CLOCK_X86) && defined(_MSC_VER)
+    int registers[4];
+    __cpuid(registers, 0x80000000);
+    if (static_cast<unsigned>(registers[0]) < 0x80000007) return false;
+    __cpuid(registers, 0x80000007);
+    return (registers[3] & (1 << 8)) != 0;
+#elif defined(TSC_CLOCK_X86)
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+TscClock::TscClock(std::chrono::milliseconds recalibrationInterval, bool allowTsc)
+    : tsc(allowTsc && invariantTscAvailable()), interval(recalibrationInterval) {
+    if (!tsc) {
+        // The counter is already nanoseconds, only the epoch offset is needed
+        const Sample now = sample();
+        publish(now.ticks, now.realtimeNs, 1.0);
+        return;
+    }
+
+    const Sample start = sample();
+    std::this_thread::sleep_for(STARTUP_CALIBRATION);
+    reference = sample();
+    const double rate = static_cast<double>(reference.monotonicNs - start.monotonicNs) /
+                        static_cast<double>(reference.ticks - start.ticks);
+    publish(reference.ticks, reference.realtimeNs, rate);
+
+    if (interval.count() > 0) {
+        recalibrator = std::thread([this] {
+            std::unique_lock<std::mutex> lock(stopMutex);
+            while (!stopCondition.wait_for(lock, interval, [this] { return stopping; })) {
+                lock.unlock();
+                recalibrate();
+                lock.lock();
+            }
+        });
+    }
+}
+
+TscClock::~TscClock() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+    }
+    stopCondition.notify_all();
+    if (recalibrator.joinable()) recalibrator.join();
+}
+
+long long TscClock::toEpochNs(std::uint64_t ticks) const {
+    std::uint64_t base;
+    long long ns;
+    double rate;
+    std::uint32_t before;
+    do {
+        before = sequence.load(std::memory_order_acquire);
+        base = baseTicks.load(std::memory_order_relaxed);
+        ns = baseNs.load(std::memory_order_relaxed);
+        rate = nsPerTick.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((before & 1) || sequence.load(std::memory_order_relaxed) != before);
+
+    // Signed, a reading taken just before a recalibration still converts on the new one
+    const auto elapsed = static_cast<std::int64_t>(ticks - base);
+    return ns + std::llround(static_cast<double>(elapsed) * rate);
+}
+
+void TscClock::recalibrate() {
+    if (!tsc) return;
+
+    const Sample now = sample();
+    if (now.ticks <= reference.ticks) return;
+
+    // Rate over the last interval against the monotonic clock, which NTP slews but never steps
+    const double interval_ns = static_cast<double>(now.monotonicNs - reference.monotonicNs);
+    const double rate = interval_ns / static_cast<double>(now.ticks - reference.ticks);
+    reference = now;
+    if (!(rate > 0)) return;
+
+    // Carry on from where the current calibration is now, converging on the system clock by the next interval
+    const long long mapped = toEpochNs(now.ticks);
+    const double correction = std::clamp(static_cast<double>(now.realtimeNs - mapped) / interval_ns, -MAX_SLEW, MAX_SLEW);
+    publish(now.ticks, mapped, rate * (1 + correction));
+}
+
+double TscClock::ticksPerSecond() const {
+    return 1e9 / nsPerTick.load(std::memory_order_relaxed);
+}
+
+TscClock::Sample TscClock::sample() const {
+    Sample best{};
+    std::uint64_t bestWidth = ~std::uint64_t(0);
+    for (int attempt = 0; attempt < SAMPLE_ATTEMPTS; ++attempt) {
+        const std::uint64_t before = ticks();
+        const long long monotonic = steadyNs();
+        const long long realtime = systemNs();
+        const std::uint64_t after = ticks();
+        if (after - before < bestWidth) {
+            bestWidth = after - before;
+            best = Sample{before + bestWidth / 2, monotonic, realtime};
+        }
+    }
+    return best;
+}
+
+void TscClock::publish(std::uint64_t ticks, long long ns, double rate) {
+    const std::uint32_t current = sequence.load(std::memory_order_relaxed);
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    baseTicks.store(ticks, std::memory_order_relaxed);
+    baseNs.store(ns, std::memory_order_relaxed);
+    nsPerTick.store(rate, std::memory_order_relaxed);
+    sequence.store(current + 2, std::memory_order_release);
+}
+
+std::shared_ptr<const Clock> makeClock(const ClockConfig& config) {
+    if (config.tsc) return std::make_shared<TscClock>(config.recalibrationInterval);
+    return std::make_shared<SystemClock>();
+}
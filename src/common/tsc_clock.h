@@ -0,0 +1,124 @@
+#ifndef TSC_CLOCK_H
+#define TSC_CLOCK_H
+
+#include "common/clock.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define TSC_CLOCK_X86
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TSC_CLOCK_X86
+#endif
+
+struct ClockConfig {
+    bool tsc;                                    // TscClock, else SystemClock
+    std::chrono::milliseconds recalibrationInterval;
+
+    explicit ClockConfig(bool useTsc = true, std::chrono::milliseconds interval = std::chrono::seconds(1))
+        : tsc(useTsc), recalibrationInterval(interval) {}
+
+    // Reads BINANCE_CLOCK (tsc|system) and BINANCE_CLOCK_RECALIBRATION_MS
+    static ClockConfig from_env() {
+        const char* env_clock = std::getenv("BINANCE_CLOCK");
+        const char* env_recalibration = std::getenv("BINANCE_CLOCK_RECALIBRATION_MS");
+
+        return ClockConfig(
+            env_clock ? std::string(env_clock) != "system" : true,
+            std::chrono::milliseconds(env_recalibration ? std::stoll(env_recalibration) : 1000)
+        );
+    }
+};
+
+/**
+ * @class TscClock
+ * @brief Epoch nanoseconds read from the invariant TSC, for stamping ticks and results cheaply.
+ *
+ * A timestamp is one rdtsc and a multiply-add against the current calibration, with no system
+ * call or vDSO page read. The counter is calibrated against the system clock at construction,
+ * its rate measured against the monotonic clock over 20 ms, and a background thread
+ * recalibrates every interval. Recalibration never steps: the rate follows the monotonic
+ * clock, and any distance from the system clock is slewed out over the next interval, at
+ * most 500 ppm. Timestamps are therefore monotonic, and an NTP step of the system
+ * clock is absorbed gradually instead of showing up as a jump in measured latencies.
+ *
+ * On CPUs without an invariant TSC, or off x86, the counter is steady_clock nanoseconds
+ * instead, mapped to the epoch once at construction and never recalibrated.
+ *
+ * now() and toEpochNs() may be called from any thread.
+ */
+class TscClock : public Clock {
+public:
+    // allowTsc false forces the steady_clock fallback
+    explicit TscClock(std::chrono::milliseconds recalibrationInterval = std::chrono::seconds(1), bool allowTsc = true);
+    ~TscClock() override;
+
+    TscClock(const TscClock&) = delete;
+    TscClock& operator=(const TscClock&) = delete;
+
+    long long now() const override { return toEpochNs(ticks()); }
+
+    // Raw counter, TSC cycles or steady_clock nanoseconds
+    std::uint64_t ticks() const {
+#ifdef TSC_CLOCK_X86
+        if (tsc) return __rdtsc();
+#endif
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Epoch nanoseconds of a ticks() reading, under the calibration current at the time of the call
+    long long toEpochNs(std::uint64_t ticks) const;
+
+    // Takes a new calibration point, done by the background thread every interval unless it is zero.
+    // Not to be called from two threads at once.
+    void recalibrate();
+
+    bool usesTsc() const { return tsc; }
+
+    // Counter frequency under the current calibration
+    double ticksPerSecond() const;
+
+    // CPUID reports a TSC that runs at a constant rate through frequency and power state changes
+    static bool invariantTscAvailable();
+
+private:
+    // Counter and clocks read as close together as the counter can tell
+    struct Sample {
+        std::uint64_t ticks;
+        long long monotonicNs;
+        long long realtimeNs;
+    };
+    Sample sample() const;
+
+    // Publishes epochNs = baseNs + (ticks - baseTicks) * nsPerTick, readers retry while sequence is odd
+    void publish(std::uint64_t ticks, long long ns, double rate);
+
+    const bool tsc;
+    const std::chrono::milliseconds interval;
+
+    std::atomic<std::uint32_t> sequence{0};
+    std::atomic<std::uint64_t> baseTicks{0};
+    std::atomic<long long> baseNs{0};
+    std::atomic<double> nsPerTick{1.0};
+
+    Sample reference{}; // Last calibration sample, only touched by the recalibrating thread
+
+    std::mutex stopMutex;
+    std::condition_variable stopCondition;
+    bool stopping = false;
+    std::thread recalibrator;
+};
+
+// TscClock or SystemClock, as config selects
+std::shared_ptr<const Clock> makeClock(const ClockConfig& config);
+
+#endif // TSC_CLOCK_H
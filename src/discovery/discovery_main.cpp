@@ -0,0 +1,51 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include "discovery/triangle_discovery.h"
+
+/**
+ * Prints the triangular paths and stream target discovered from an exchange symbol file
+ *
+ * Usage: Discover <symbol file> [start currencies] [stream suffix]
+ *
+ * The symbol file is Binance's exchangeInfo response (or its "symbols" array). Start currencies
+ * are comma separated and default to usdt. The output is the BINANCE_ARBITRAGE_PATH and
+ * BINANCE_STREAM_TARGET pair to pass to run_triangular_arbitrage_bot.sh.
+ */
+int main(int argc, char* argv[]) {
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <symbol file> [start currencies] [stream suffix]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1]);
+    if (!input.is_open()) {
+        std::cerr << "Unable to open symbol file: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    const std::vector<std::string> start_currencies = splitCurrencies(argc > 2 ? argv[2] : "usdt");
+    const std::string stream_suffix = argc > 3 ? argv[3] : DEFAULT_DISCOVERY_STREAM;
+
+    try {
+        const auto start = std::chrono::steady_clock::now();
+        const TriangleDiscovery discovery(loadSymbolInfo(input));
+        const std::vector<ArbitragePath> paths = discovery.findPaths(start_currencies);
+        const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::string arbitrage_path;
+        for (const auto& path : paths) {
+            arbitrage_path += (arbitrage_path.empty() ? "" : ";") + path.to_string();
+        }
+
+        std::cerr << "Found " << paths.size() << " paths across " << discovery.symbolCount() << " symbols and "
+                  << discovery.currencyCount() << " currencies in " << elapsed << " ms" << std::endl;
+        std::cout << "BINANCE_ARBITRAGE_PATH=" << arbitrage_path << std::endl;
+        std::cout << "BINANCE_STREAM_TARGET=" << TriangleDiscovery::streamTarget(paths, stream_suffix) << std::endl;
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "discovery/triangle_discovery.h"
+#include <nlohmann/json.hpp>
+#include <cctype>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+
+std::string toLower(std::string str) {
+    for (auto& c : str) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return str;
+}
+
+std::string requiredField(const nlohmann::json& entry, const char* field) {
+    const auto it = entry.find(field);
+    if (it == entry.end() || !it->is_string()) {
+        throw std::invalid_argument(std::string("Symbol entry missing '") + field + "': " + entry.dump());
+    }
+    return toLower(it->get<std::string>());
+}
+
+} // namespace
+
+std::vector<SymbolInfo> loadSymbolInfo(std::istream& input) {
+    nlohmann::json document;
+    try {
+        document = nlohmann::json::parse(input);
+    } catch (const nlohmann::json::exception& e) {
+        throw std::invalid_argument(std::string("Invalid symbol file: ") + e.what());
+    }
+
+    const nlohmann::json& entries = document.is_object() ? document.value("symbols", nlohmann::json::array()) : document;
+    if (!entries.is_array()) {
+        throw std::invalid_argument("Symbol file must hold an array of symbols or an object with a 'symbols' array");
+    }
+
+    std::vector<SymbolInfo> symbols;
+    symbols.reserve(entries.size());
+    for (const auto& entry : entries) {
+        const auto status = entry.find("status");
+        if (status != entry.end() && *status != "TRADING") {
+            continue;
+        }
+        symbols.emplace_back(requiredField(entry, "symbol"), requiredField(entry, "baseAsset"), requiredField(entry, "quoteAsset"));
+    }
+    return symbols;
+}
+
+std::vector<std::string> splitCurrencies(const std::string& str) {
+    std::vector<std::string> currencies;
+    std::stringstream ss(str);
+    std::string currency;
+    while (std::getline(ss, currency, ',')) {
+        if (!currency.empty()) currencies.push_back(toLower(currency));
+    }
+    return currencies;
+}
+
+TriangleDiscovery::TriangleDiscovery(const std::vector<SymbolInfo>& symbolList) : symbols(symbolList) {
+    for (std::uint32_t i = 0; i < symbols.size(); ++i) {
+        const std::uint32_t base = currencyId(symbols[i].baseAsset);
+        const std::uint32_t quote = currencyId(symbols[i].quoteAsset);
+        if (base == quote) continue;
+
+        const Edge sellBase{quote, i, false};
+        const Edge buyBase{base, i, true};
+        edges[base].push_back(sellBase);
+        edges[quote].push_back(buyBase);
+        edgesBetween[pairKey(base, quote)].push_back(sellBase);
+        edgesBetween[pairKey(quote, base)].push_back(buyBase);
+    }
+}
+
+std::uint32_t TriangleDiscovery::currencyId(const std::string& currency) {
+    const auto [it, inserted] = currencyIds.emplace(currency, static_cast<std::uint32_t>(currencies.size()));
+    if (inserted) {
+        currencies.push_back(currency);
+        edges.emplace_back();
+    }
+    return it->second;
+}
+
+std::vector<ArbitragePath> TriangleDiscovery::findPaths(const std::vector<std::string>& startCurrencies) const {
+    std::vector<ArbitragePath> paths;
+    std::unordered_set<std::uint32_t> seenStarts;
+
+    for (const auto& startName : startCurrencies) {
+        const auto startIt = currencyIds.find(toLower(startName));
+        if (startIt == currencyIds.end() || !seenStarts.insert(startIt->second).second) {
+            continue;
+        }
+        const std::uint32_t start = startIt->second;
+
+        for (const Edge& first : edges[start]) {
+            for (const Edge& second : edges[first.to]) {
+                if (second.to == start) continue;
+
+                const auto closing = edgesBetween.find(pairKey(second.to, start));
+                if (closing == edgesBetween.end()) continue;
+
+                for (const Edge& third : closing->second) {
+                    paths.emplace_back(currencies[start], toLeg(first), toLeg(second), toLeg(third));
+                }
+            }
+        }
+    }
+    return paths;
+}
+
+std::string TriangleDiscovery::streamTarget(const std::vector<ArbitragePath>& paths, const std::string& streamSuffix) {
+    std::string target = "/stream?streams=";
+    std::unordered_set<std::string> subscribed;
+    for (const auto& path : paths) {
+        for (const auto& leg : path.legs) {
+            if (!subscribed.insert(leg.symbol).second) continue;
+            if (subscribed.size() > 1) target += "/";
+            target += leg.symbol + streamSuffix;
+        }
+    }
+    return target;
+}
@@ -0,0 +1,94 @@
+#ifndef TRIANGLE_DISCOVERY_H
+#define TRIANGLE_DISCOVERY_H
+
+#include "common/trade_leg.h"
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Stream suffix appended to every discovered symbol, matches the default ORDER_BOOK_DEPTH
+constexpr const char* DEFAULT_DISCOVERY_STREAM = "@depth20@100ms";
+
+struct SymbolInfo {
+    std::string symbol;     // Lower case, as used in stream names (e.g. "btcusdt")
+    std::string baseAsset;  // Lower case (e.g. "btc")
+    std::string quoteAsset; // Lower case (e.g. "usdt")
+
+    SymbolInfo(std::string sym, std::string base, std::string quote)
+        : symbol(std::move(sym)), baseAsset(std::move(base)), quoteAsset(std::move(quote)) {}
+};
+
+/**
+ * Loads symbols from an exchange-info style JSON document, either Binance's
+ * GET /api/v3/exchangeInfo response or a bare array of its "symbols" entries.
+ *
+ * Each entry needs symbol, baseAsset and quoteAsset. Entries with a status other than
+ * TRADING are skipped. Names are lower cased to match the stream and path notation.
+ *
+ * @throws std::invalid_argument if the document is not valid JSON or an entry is missing a field
+ */
+std::vector<SymbolInfo> loadSymbolInfo(std::istream& input);
+
+// Splits a comma separated currency list such as "usdt,btc"
+std::vector<std::string> splitCurrencies(const std::string& str);
+
+/**
+ * @class TriangleDiscovery
+ * @brief Currency graph built from a symbol list, enumerating the triangular paths through it.
+ *
+ * Currencies are the vertices and every symbol is an edge usable in both directions. Holding
+ * the base asset a leg sells it into the bids (requiresInversion false, BUY in path notation),
+ * holding the quote asset it buys the base from the asks (requiresInversion true, SELL).
+ *
+ * The graph is built once in O(symbols). Enumeration walks the edges out of each start
+ * currency and closes each triangle with a hash lookup, so it is O(sum of deg(a) over the start
+ * currency's neighbours a) rather than a scan of every symbol triple.
+ */
+class TriangleDiscovery {
+public:
+    explicit TriangleDiscovery(const std::vector<SymbolInfo>& symbols);
+
+    /**
+     * Every 3-cycle starting and ending at one of the start currencies. Both directions of a
+     * triangle are returned as separate paths, since each trades against opposite book sides.
+     * Unknown start currencies yield no paths.
+     */
+    std::vector<ArbitragePath> findPaths(const std::vector<std::string>& startCurrencies) const;
+
+    std::size_t currencyCount() const { return currencies.size(); }
+    std::size_t symbolCount() const { return symbols.size(); }
+
+    /**
+     * The combined stream target subscribing to every symbol used by the paths, once each, e.g.
+     * /stream?streams=btcusdt@depth20@100ms/ethbtc@depth20@100ms/ethusdt@depth20@100ms
+     */
+    static std::string streamTarget(const std::vector<ArbitragePath>& paths,
+                                    const std::string& streamSuffix = DEFAULT_DISCOVERY_STREAM);
+
+private:
+    struct Edge {
+        std::uint32_t to;     // Currency received by trading this symbol
+        std::uint32_t symbol; // Index into symbols
+        bool requiresInversion;
+    };
+
+    std::vector<SymbolInfo> symbols;
+    std::vector<std::string> currencies;
+    std::unordered_map<std::string, std::uint32_t> currencyIds;
+    std::vector<std::vector<Edge>> edges; // Indexed by the currency held
+    std::unordered_map<std::uint64_t, std::vector<Edge>> edgesBetween; // Keyed by (from, to)
+
+    std::uint32_t currencyId(const std::string& currency);
+
+    static std::uint64_t pairKey(std::uint32_t from, std::uint32_t to) {
+        return (static_cast<std::uint64_t>(from) << 32) | to;
+    }
+
+    TradeLeg toLeg(const Edge& edge) const {
+        return TradeLeg(symbols[edge.symbol].symbol, edge.requiresInversion);
+    }
+};
+
+#endif // TRIANGLE_DISCOVERY_H
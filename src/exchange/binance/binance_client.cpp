@@ -1,6 +1,7 @@
 #include "binance_client.h"
 #include "common/trade_util.h"
 #include <iostream>
+#include <stdexcept>
 #include <boost/asio/strand.hpp>
 #include <boost/beast/core/bind_handler.hpp>
 #include <boost/beast/core/buffers_to_string.hpp>
@@ -19,13 +20,56 @@ void BaseClient::write_str_to_buf(const std::string& str, boost::beast::flat_buf
 
 const std::string BinanceClient::WS_CLIENT_HEADER = "TriangularArbitrageAsyncBinanceWsClient";
 
-BinanceClient::BinanceClient(boost::asio::io_context& ioc, boost::asio::ssl::context& ssl_ctx) 
-    : BaseClient(ioc), resolver(ioc), ssl_ctx(ssl_ctx) {
-    std::cout << "BinanceClient initialised" << "\n";
+BinanceClient::BinanceClient(boost::asio::io_context& ioc, boost::asio::ssl::context& ssl_ctx, std::string name) 
+    : BaseClient(ioc), resolver(ioc), ssl_ctx(ssl_ctx), name(std::move(name)), parserMode(DepthParserMode::Fast), bookTickerStream(false) {
+    std::cout << "BinanceClient initialised: " << this->name << "\n";
 }
 
 void BinanceClient::set_callback(const std::shared_ptr<Server>& server){
     callback = server;
+    // Parsing runs on this connection's strand, which may share the server with other connections
+    latency = std::make_unique<LatencyStats>(name + " CLIENT", server->getLatencyStats().getDumpIntervalSeconds());
+    counters.symbolFrames = std::vector<std::atomic<std::uint64_t>>(server->getSymbolTable().size());
+}
+
+void BinanceClient::set_parser_mode(DepthParserMode mode){
+    parserMode = mode;
+}
+
+void BinanceClient::set_depth_snapshots(std::shared_ptr<SnapshotProvider> snapshots){
+    localBooks = std::make_unique<LocalOrderBooks>(std::move(snapshots));
+}
+
+void BinanceClient::set_book_ticker(bool enabled){
+    bookTickerStream = enabled;
+}
+
+void BinanceClient::set_tick_queue(std::shared_ptr<TickQueue> queue){
+    tickQueue = std::move(queue);
+}
+
+void BinanceClient::set_capture(std::unique_ptr<FrameCaptureWriter> capture){
+    this->capture = std::move(capture);
+}
+
+void BinanceClient::set_transport(const TransportConfig& transport){
+    this->transport = transport;
+}
+
+void BinanceClient::configure_tls(boost::asio::ssl::context& ssl_ctx, const TransportConfig& transport) {
+    if (transport.tlsCiphers.empty()) return;
+    if (SSL_CTX_set_cipher_list(ssl_ctx.native_handle(), transport.tlsCiphers.c_str()) != 1) {
+        throw std::invalid_argument("No usable TLS ciphers in: " + transport.tlsCiphers);
+    }
+}
+
+template <typename Update>
+void BinanceClient::publish(Update& update) {
+    if (tickQueue) {
+        tickQueue->push(update);
+    } else {
+        callback->on_update(update);
+    }
 }
 
 void BinanceClient::reset_stream(boost::asio::ssl::context& ssl_ctx) {
@@ -39,6 +83,15 @@ void BinanceClient::reset_stream(boost::asio::ssl::context& ssl_ctx) {
             req.set(boost::beast::http::field::user_agent, WS_CLIENT_HEADER);
         }
     ));
+    if (transport.permessageDeflate) {
+        boost::beast::websocket::permessage_deflate deflate;
+        deflate.client_enable = true;
+        ws->set_option(deflate);
+    }
+    // Reserved up front so the first frames are not read into a buffer still growing
+    if (transport.readBufferBytes > 0) {
+        buffer.reserve(transport.readBufferBytes);
+    }
     std::cout << "WebSocket stream reset complete." << std::endl;
 }
 
@@ -47,7 +100,7 @@ void BinanceClient::async_connect(const std::string& host_in, const std::string&
     port = port_in;
     target = target_in;
 
-    std::cout << "Connecting to Binance WebSocket at " << host << ":" << port << target << "\n";
+    std::cout << name << " connecting to Binance WebSocket at " << host << ":" << port << target << "\n";
 
     reset_stream(ssl_ctx);
 
@@ -61,13 +114,37 @@ void BinanceClient::async_connect(const std::string& host_in, const std::string&
 void BinanceClient::on_resolve(boost::beast::error_code ec, boost::asio::ip::tcp::resolver::results_type results) {
     if (ec) return fail(ec, "Resolve Endpoint");
 
+    endpoints = std::move(results);
+    connect_endpoint(endpoints.begin());
+}
+
+void BinanceClient::connect_endpoint(boost::asio::ip::tcp::resolver::results_type::const_iterator endpoint) {
     auto& lowest_layer = boost::beast::get_lowest_layer(*ws);
-    lowest_layer.expires_after(std::chrono::seconds(30));
+    const auto next = std::next(endpoint);
 
-    lowest_layer.async_connect(results,
-        boost::asio::bind_executor(strand,
-            boost::beast::bind_front_handler(&BinanceClient::on_connect, shared_from_this())
-        )
+    // Opened here rather than by the connect, so the options are in place before the SYN. The receive
+    // buffer in particular decides the window scale the handshake offers.
+    boost::beast::error_code ec;
+    lowest_layer.socket().close(ec);
+    lowest_layer.socket().open(endpoint->endpoint().protocol(), ec);
+    if (ec) {
+        if (next != endpoints.end()) return connect_endpoint(next);
+        return fail(ec, "Client TCP Open");
+    }
+    lowest_layer.socket().set_option(boost::asio::ip::tcp::no_delay(transport.tcpNoDelay), ec);
+    if (ec) fail(ec, "TCP_NODELAY");
+    if (transport.receiveBufferBytes > 0) {
+        lowest_layer.socket().set_option(boost::asio::socket_base::receive_buffer_size(transport.receiveBufferBytes), ec);
+        if (ec) fail(ec, "SO_RCVBUF");
+    }
+
+    lowest_layer.expires_after(std::chrono::seconds(30));
+    lowest_layer.async_connect(endpoint->endpoint(),
+        boost::asio::bind_executor(strand, [self = shared_from_this(), endpoint, next](boost::beast::error_code connect_ec) {
+            // Each resolved address in turn, as connecting to the whole range would
+            if (connect_ec && next != self->endpoints.end()) return self->connect_endpoint(next);
+            self->on_connect(connect_ec, endpoint->endpoint());
+        })
     );
 }
 
@@ -120,8 +197,6 @@ void BinanceClient::read() {
 }
 
 void BinanceClient::on_read(boost::beast::error_code ec, std::size_t bytes_transferred) {
-    boost::ignore_unused(bytes_transferred);
-
     if (ec == boost::beast::websocket::error::closed) {
         std::cout << "WebSocket connection closed gracefully" << std::endl;
         return;
@@ -130,6 +205,7 @@ void BinanceClient::on_read(boost::beast::error_code ec, std::size_t bytes_trans
         fail(ec, "read");
         std::cerr << "Restarting connection due to unexpected error ... " << std::endl;
         buffer.consume(buffer.size());
+        ConnectionCounters::add(counters.reconnects, 1);
         reconnect_timer.expires_after(std::chrono::seconds(5));
         reconnect_timer.async_wait(
             boost::asio::bind_executor(strand, [self = shared_from_this()](boost::beast::error_code) {
@@ -139,17 +215,87 @@ void BinanceClient::on_read(boost::beast::error_code ec, std::size_t bytes_trans
         return; 
     }
 
-    long long localTimestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::system_clock::now().time_since_epoch()
-    ).count();
+    const long long localTimestampNs = callback->getClock().now();
+
+    const std::int64_t handleStart = latencyNow();
+    ConnectionCounters::add(counters.frames, 1);
+    ConnectionCounters::add(counters.bytes, bytes_transferred);
+
+    if (capture) {
+        const auto frame = buffer.cdata();
+        capture->append(std::string_view(static_cast<const char*>(frame.data()), frame.size()), localTimestampNs);
+    }
+
+    const bool timed = latency->enabled();
+    const std::int64_t parseStart = handleStart;
+    bool updated = false;
+    bool parsed = true;
+    SymbolId frameSymbol = INVALID_SYMBOL_ID;
 
     // Process the message
-    const std::string& json_string = boost::beast::buffers_to_string(buffer.data());
-    // std::cout << "Received: " << json_string << std::endl;
-    auto data = nlohmann::json::parse(json_string);
-    auto tick_struct = to_struct(data,json_string,localTimestampNs);
-    
-    callback->on_update(tick_struct);
+    if (bookTickerStream) {
+        const auto frame = buffer.cdata();
+        const char* frame_begin = static_cast<const char*>(frame.data());
+
+        const DepthParseError err = parseBookTickerFrame(frame_begin, frame_begin + frame.size(), localTimestampNs, callback->getSymbolTable(), bookTicker);
+        if (err == DepthParseError::None) {
+            if (timed) latency->record(LatencyStage::Parse, latencyNow() - parseStart);
+            frameSymbol = bookTicker.symbolId;
+            publish(bookTicker);
+            updated = true;
+        } else {
+            fail(to_string(err), "Book Ticker Parse");
+            parsed = false;
+        }
+    } else if (localBooks) {
+        const auto frame = buffer.cdata();
+        const char* frame_begin = static_cast<const char*>(frame.data());
+
+        const DepthParseError err = parseDepthDiffFrame(frame_begin, frame_begin + frame.size(), localTimestampNs, callback->getSymbolTable(), diff);
+        if (err != DepthParseError::None) {
+            fail(to_string(err), "Depth Diff Parse");
+            parsed = false;
+        } else {
+            frameSymbol = diff.symbolId;
+            if (localBooks->apply(diff, tick)) {
+                if (timed) latency->record(LatencyStage::Parse, latencyNow() - parseStart);
+                publish(tick);
+                updated = true;
+            }
+        }
+    } else if (parserMode == DepthParserMode::Fast) {
+        // A flat_buffer's readable bytes are always a single contiguous region
+        const auto frame = buffer.cdata();
+        const char* frame_begin = static_cast<const char*>(frame.data());
+
+        const DepthParseError err = parseDepthFrame(frame_begin, frame_begin + frame.size(), localTimestampNs, callback->getSymbolTable(), tick);
+        if (err == DepthParseError::None) {
+            if (timed) latency->record(LatencyStage::Parse, latencyNow() - parseStart);
+            frameSymbol = tick.symbolId;
+            publish(tick);
+            updated = true;
+        } else {
+            fail(to_string(err), "Depth Parse");
+            parsed = false;
+        }
+    } else {
+        const std::string& json_string = boost::beast::buffers_to_string(buffer.data());
+        // std::cout << "Received: " << json_string << std::endl;
+        auto data = nlohmann::json::parse(json_string);
+        auto tick_struct = to_struct(data,json_string,localTimestampNs,callback->getSymbolTable());
+
+        if (timed) latency->record(LatencyStage::Parse, latencyNow() - parseStart);
+        frameSymbol = tick_struct.symbolId;
+        publish(tick_struct);
+        updated = true;
+    }
+
+    if (updated) ConnectionCounters::add(counters.updates, 1);
+    if (!parsed) ConnectionCounters::add(counters.parseErrors, 1);
+    if (frameSymbol < counters.symbolFrames.size()) ConnectionCounters::add(counters.symbolFrames[frameSymbol], 1);
+    const std::int64_t handleEnd = latencyNow();
+    ConnectionCounters::add(counters.busyNs, static_cast<std::uint64_t>(handleEnd - handleStart));
+    if (timed) latency->maybeDump(handleEnd);
     
     buffer.consume(buffer.size());
     read(); // Listen for the next message
@@ -160,15 +306,15 @@ void BinanceClient::on_close(boost::beast::error_code ec) {
     std::cout << "Client connection closed gracefully" << "\n";
 }
 
-std::vector<PriceLevel> BinanceClient::parsePriceLevels(const nlohmann::json& json_array) {
-    std::vector<PriceLevel> levels_vec;
+void BinanceClient::parsePriceLevels(const nlohmann::json& json_array, PriceLevels<ORDER_BOOK_MAX_DEPTH>& levels) {
+    levels.clear();
 
     for (const auto& level_json : json_array) {
         if (level_json.is_array() && level_json.size() == 2) {
             try {
                 double price = std::stod(level_json.at(0).get<std::string>());
                 double quantity = std::stod(level_json.at(1).get<std::string>());
-                levels_vec.emplace_back(price, quantity);
+                levels.emplace_back(price, quantity);
             } catch (const std::exception& e) {
                 std::cerr << "Error parsing " << e.what() << "\n";
                 throw std::runtime_error("Failed to parse price level: " + std::string(e.what()));
@@ -178,21 +324,24 @@ std::vector<PriceLevel> BinanceClient::parsePriceLevels(const nlohmann::json& js
             throw std::runtime_error("Invalid price level format in JSON data");
         }
     }
-    return levels_vec;
 }
 
-OrderBookTick BinanceClient::to_struct(const nlohmann::json& json_data, const std::string& json_string, long long localTimestampNs) {
+OrderBookTick BinanceClient::to_struct(const nlohmann::json& json_data, const std::string& json_string, long long localTimestampNs, const SymbolTable& symbols) {
     try {
+        OrderBookTick tick;
         const auto& data = json_data.at("data");
-        const long long updateId = data.at("lastUpdateId").get<long long>(); 
+        tick.updateId = data.at("lastUpdateId").get<long long>(); 
         
-        std::string full_stream_name = json_data.at("stream").get<std::string>();
-        std::string symbol = full_stream_name.substr(0, full_stream_name.find('@'));
+        const std::string_view full_stream_name = json_data.at("stream").get_ref<const std::string&>();
+        tick.symbol = full_stream_name.substr(0, full_stream_name.find('@'));
+        tick.symbolId = symbols.find(tick.symbol);
+        tick.jsonStr = json_string;
+        tick.tickInitTime = localTimestampNs;
 
-        std::vector<PriceLevel> bids_vec = parsePriceLevels(data.at("bids"));
-        std::vector<PriceLevel> asks_vec = parsePriceLevels(data.at("asks"));
+        parsePriceLevels(data.at("bids"), tick.bids);
+        parsePriceLevels(data.at("asks"), tick.asks);
 
-        return OrderBookTick(updateId, symbol,json_string, std::move(bids_vec), std::move(asks_vec), localTimestampNs);
+        return tick;
 
     } catch (const nlohmann::json::exception& e) {
         std::cerr << "JSON parsing error in BinanceClient::to_struct: " << e.what() << "\n";
@@ -2,8 +2,72 @@
 #define BINANCE_CLIENT_H
 
 #include "exchange/abstract/market_data_client.h"
+#include "exchange/binance/binance_depth_parser.h"
+#include "exchange/binance/local_order_book.h"
+#include "file/frame_capture.h"
+#include "server/compute_pipeline.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 
+struct TransportConfig {
+    bool tcpNoDelay;              // Disables Nagle, only our pongs and close are ever sent but they go out at once
+    int receiveBufferBytes;       // SO_RCVBUF, 0 keeps the OS default and its auto-tuning
+    bool permessageDeflate;       // Offers permessage-deflate, trading CPU for bytes on the wire
+    std::size_t readBufferBytes;  // Capacity the read buffer starts with, 0 lets it grow from the first frame
+    std::string tlsCiphers;       // OpenSSL cipher list for TLS 1.2, empty keeps the library default
+    bool busyPoll;                // IO threads spin on the io_context instead of sleeping in epoll
+
+    explicit TransportConfig(bool noDelay = true, int receiveBuffer = 0, bool deflate = false, std::size_t readBuffer = 0,
+                             std::string ciphers = "", bool spin = false)
+        : tcpNoDelay(noDelay), receiveBufferBytes(receiveBuffer), permessageDeflate(deflate),
+          readBufferBytes(readBuffer), tlsCiphers(std::move(ciphers)), busyPoll(spin) {}
+
+    // Reads BINANCE_TCP_NODELAY, BINANCE_SOCKET_RCVBUF, BINANCE_WS_DEFLATE, BINANCE_READ_BUFFER_BYTES,
+    // BINANCE_TLS_CIPHERS and BINANCE_BUSY_POLL, the flags as true or false
+    static TransportConfig from_env() {
+        const char* env_tcp_no_delay = std::getenv("BINANCE_TCP_NODELAY");
+        const char* env_socket_rcvbuf = std::getenv("BINANCE_SOCKET_RCVBUF");
+        const char* env_ws_deflate = std::getenv("BINANCE_WS_DEFLATE");
+        const char* env_read_buffer_bytes = std::getenv("BINANCE_READ_BUFFER_BYTES");
+        const char* env_tls_ciphers = std::getenv("BINANCE_TLS_CIPHERS");
+        const char* env_busy_poll = std::getenv("BINANCE_BUSY_POLL");
+
+        return TransportConfig(
+            env_tcp_no_delay ? std::string(env_tcp_no_delay) != "false" : true,
+            env_socket_rcvbuf ? std::stoi(env_socket_rcvbuf) : 0,
+            env_ws_deflate && std::string(env_ws_deflate) == "true",
+            env_read_buffer_bytes ? std::stoul(env_read_buffer_bytes) : 0,
+            env_tls_ciphers ? env_tls_ciphers : "",
+            env_busy_poll && std::string(env_busy_poll) == "true"
+        );
+    }
+};
+
+/**
+ * @struct ConnectionCounters
+ * @brief Running totals for one connection, bumped by its strand and read by whoever reports throughput.
+ *
+ * There is a single writer, so counts are stored rather than atomically incremented and relaxed
+ * loads are enough to read them.
+ */
+struct ConnectionCounters {
+    std::atomic<std::uint64_t> frames{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> updates{0};     // Ticks handed to the server or its compute pipeline
+    std::atomic<std::uint64_t> busyNs{0};      // Time spent handling frames, parsing and anything run inline
+    std::atomic<std::uint64_t> parseErrors{0};
+    std::atomic<std::uint64_t> reconnects{0};
+    std::vector<std::atomic<std::uint64_t>> symbolFrames; // Frames parsed per SymbolId of the callback's table, sized by set_callback
+
+    static void add(std::atomic<std::uint64_t>& counter, std::uint64_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
 /**
  * @class BinanceClient
  * @brief Concrete implementation for a Binance WebSocket client.
@@ -13,10 +77,41 @@
  */
 class BinanceClient : public BaseClient, public std::enable_shared_from_this<BinanceClient> {
 public:
-    BinanceClient(boost::asio::io_context& ioc, boost::asio::ssl::context& ssl_ctx);
+    // name labels the connection's log lines and its parse latency dumps
+    BinanceClient(boost::asio::io_context& ioc, boost::asio::ssl::context& ssl_ctx, std::string name = "BINANCE");
 
     void set_callback(const std::shared_ptr<Server>& server) override;
     void async_connect(const std::string& host, const std::string& port, const std::string& target) override;
+
+    // Chooses between the nlohmann::json path and the allocation-free parser for incoming frames
+    void set_parser_mode(DepthParserMode mode);
+
+    // Reads the stream as @depth diffs into a local full-depth book per symbol, resynced from snapshots.
+    // Diffs always go through the allocation-free parser, whatever the parser mode.
+    void set_depth_snapshots(std::shared_ptr<SnapshotProvider> snapshots);
+
+    // Reads the stream as @bookTicker best bid and ask updates, through their own parser
+    void set_book_ticker(bool enabled);
+
+    // Hands parsed ticks to a ComputePipeline's compute thread instead of calling the server inline
+    void set_tick_queue(std::shared_ptr<TickQueue> queue);
+
+    // Appends every frame with its receive time to capture before it is parsed
+    void set_capture(std::unique_ptr<FrameCaptureWriter> capture);
+
+    // Socket and websocket options applied from the next connect on. busyPoll is up to whoever runs the io_context.
+    void set_transport(const TransportConfig& transport);
+
+    // Restricts ssl_ctx to transport's cipher list, shared by every client on the context.
+    // Throws std::invalid_argument if OpenSSL accepts none of the ciphers.
+    static void configure_tls(boost::asio::ssl::context& ssl_ctx, const TransportConfig& transport);
+
+    const std::string& getName() const { return name; }
+    const ConnectionCounters& getCounters() const { return counters; }
+
+    // Converts a combined-stream depth frame into an OrderBookTick, shared by on_read and the offline Replay tool.
+    // The tick's views point into json_data and json_string, which must outlive it.
+    static OrderBookTick to_struct(const nlohmann::json& json_data, const std::string& json_string, long long localTimestampNs, const SymbolTable& symbols);
 private:
     // Use the 'override' keyword to ensure we are correctly implementing
     // the virtual functions from the base classes.
@@ -33,13 +128,40 @@ private:
 
     void reset_stream(boost::asio::ssl::context& ssl_ctx) override;
 
-    static std::vector<PriceLevel> parsePriceLevels(const nlohmann::json& json_array);
+    // Opens the socket for endpoint, applies the transport's socket options and connects, moving on
+    // to the next resolved endpoint if that fails
+    void connect_endpoint(boost::asio::ip::tcp::resolver::results_type::const_iterator endpoint);
+
+    // Passes a parsed update on to the tick queue if there is one, else straight to the server
+    template <typename Update>
+    void publish(Update& update);
+
+    static void parsePriceLevels(const nlohmann::json& json_array, PriceLevels<ORDER_BOOK_MAX_DEPTH>& levels);
 
     // Binance-specific implementation details
-    OrderBookTick to_struct(const nlohmann::json& json_data, const std::string& json_string, long long localTimestampNs);
     boost::asio::ip::tcp::resolver resolver;
+    boost::asio::ip::tcp::resolver::results_type endpoints; // Of the connect in progress
     static const std::string WS_CLIENT_HEADER;
     boost::asio::ssl::context& ssl_ctx;
+
+    const std::string name;
+    ConnectionCounters counters;
+    std::unique_ptr<LatencyStats> latency; // Parse stage of this connection, created with the callback's dump interval
+
+    DepthParserMode parserMode;
+    OrderBookTick tick; // Written in place by the fast parser, or from the local book on diff streams
+
+    std::unique_ptr<LocalOrderBooks> localBooks; // Set for diff streams only
+    DepthDiff diff;
+
+    bool bookTickerStream;
+    BookTicker bookTicker;
+
+    std::shared_ptr<TickQueue> tickQueue; // Set when a ComputePipeline runs the server
+
+    std::unique_ptr<FrameCaptureWriter> capture; // Set when raw frames are captured
+
+    TransportConfig transport;
 };
 
 #endif // BINANCE_CLIENT_H
\ No newline at end of file
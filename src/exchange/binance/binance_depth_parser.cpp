@@ -0,0 +1,420 @@
+#include "exchange/binance/binance_depth_parser.h"
+#include <charconv>
+#include <string_view>
+
+DepthParserMode depthParserModeFromString(const std::string& mode) {
+    return mode == "json" ? DepthParserMode::Json : DepthParserMode::Fast;
+}
+
+const char* to_string(DepthParseError error) {
+    switch (error) {
+        case DepthParseError::None: return "none";
+        case DepthParseError::UnexpectedEnd: return "unexpected end of frame";
+        case DepthParseError::UnexpectedToken: return "unexpected token";
+        case DepthParseError::MissingStream: return "missing stream name";
+        case DepthParseError::MissingData: return "missing update id, bids or asks";
+        case DepthParseError::InvalidUpdateId: return "invalid lastUpdateId";
+        case DepthParseError::InvalidPriceLevel: return "invalid price level";
+    }
+    return "unknown";
+}
+
+namespace {
+
+// Forward-only cursor over the frame, every step reports failure through its return value
+struct Cursor {
+    const char* pos;
+    const char* end;
+
+    void skipWhitespace() {
+        while (pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) {
+            ++pos;
+        }
+    }
+
+    // Consumes the expected character after any whitespace
+    DepthParseError expect(char c) {
+        skipWhitespace();
+        if (pos >= end) return DepthParseError::UnexpectedEnd;
+        if (*pos != c) return DepthParseError::UnexpectedToken;
+        ++pos;
+        return DepthParseError::None;
+    }
+
+    // Peeks the next non whitespace character, 0 at the end of the frame
+    char peek() {
+        skipWhitespace();
+        return pos < end ? *pos : 0;
+    }
+
+    // Reads a string without unescaping it, the view excludes the quotes
+    DepthParseError readString(std::string_view& out) {
+        DepthParseError err = expect('"');
+        if (err != DepthParseError::None) return err;
+
+        const char* start = pos;
+        while (pos < end && *pos != '"') {
+            if (*pos == '\\') ++pos;
+            ++pos;
+        }
+        if (pos >= end) return DepthParseError::UnexpectedEnd;
+
+        out = std::string_view(start, static_cast<size_t>(pos - start));
+        ++pos;
+        return DepthParseError::None;
+    }
+
+    // Reads a number that Binance may send either quoted ("0.041") or bare (0.041)
+    template <typename T>
+    DepthParseError readNumber(T& out) {
+        skipWhitespace();
+        if (pos >= end) return DepthParseError::UnexpectedEnd;
+
+        if (*pos == '"') {
+            std::string_view text;
+            DepthParseError err = readString(text);
+            if (err != DepthParseError::None) return err;
+            const auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+            return (result.ec == std::errc() && result.ptr == text.data() + text.size())
+                ? DepthParseError::None : DepthParseError::InvalidPriceLevel;
+        }
+
+        const auto result = std::from_chars(pos, end, out);
+        if (result.ec != std::errc()) return DepthParseError::InvalidPriceLevel;
+        pos = result.ptr;
+        return DepthParseError::None;
+    }
+
+    // Skips any JSON value, used for keys this parser does not care about
+    DepthParseError skipValue() {
+        const char c = peek();
+        if (c == 0) return DepthParseError::UnexpectedEnd;
+
+        if (c == '"') {
+            std::string_view ignored;
+            return readString(ignored);
+        }
+
+        if (c == '{' || c == '[') {
+            int depth = 0;
+            while (pos < end) {
+                const char current = *pos;
+                if (current == '"') {
+                    std::string_view ignored;
+                    DepthParseError err = readString(ignored);
+                    if (err != DepthParseError::None) return err;
+                    continue;
+                }
+                ++pos;
+                if (current == '{' || current == '[') {
+                    ++depth;
+                } else if (current == '}' || current == ']') {
+                    if (--depth == 0) return DepthParseError::None;
+                }
+            }
+            return DepthParseError::UnexpectedEnd;
+        }
+
+        // Number, true, false or null
+        while (pos < end && *pos != ',' && *pos != '}' && *pos != ']') {
+            ++pos;
+        }
+        return pos < end ? DepthParseError::None : DepthParseError::UnexpectedEnd;
+    }
+
+    // Consumes the separator after a member or element, reporting whether the container closed
+    DepthParseError nextMember(char close, bool& closed) {
+        const char c = peek();
+        if (c == 0) return DepthParseError::UnexpectedEnd;
+        if (c == ',') {
+            ++pos;
+            closed = false;
+            return DepthParseError::None;
+        }
+        if (c == close) {
+            ++pos;
+            closed = true;
+            return DepthParseError::None;
+        }
+        return DepthParseError::UnexpectedToken;
+    }
+};
+
+#define RETURN_IF_ERROR(expr) \
+    do { const DepthParseError err_ = (expr); if (err_ != DepthParseError::None) return err_; } while (0)
+
+// Levels beyond a fixed-capacity side are parsed for validity but not kept
+template <typename Levels>
+DepthParseError parsePriceLevels(Cursor& cursor, Levels& levels) {
+    levels.clear();
+    RETURN_IF_ERROR(cursor.expect('['));
+
+    if (cursor.peek() == ']') {
+        ++cursor.pos;
+        return DepthParseError::None;
+    }
+
+    bool closed = false;
+    while (!closed) {
+        double price = 0.0;
+        double quantity = 0.0;
+
+        RETURN_IF_ERROR(cursor.expect('['));
+        RETURN_IF_ERROR(cursor.readNumber(price));
+        RETURN_IF_ERROR(cursor.expect(','));
+        RETURN_IF_ERROR(cursor.readNumber(quantity));
+        if (cursor.expect(']') != DepthParseError::None) return DepthParseError::InvalidPriceLevel;
+
+        levels.emplace_back(price, quantity);
+        RETURN_IF_ERROR(cursor.nextMember(']', closed));
+    }
+    return DepthParseError::None;
+}
+
+// The {"lastUpdateId":..,"bids":[..],"asks":[..]} object of partial frames and REST snapshots
+template <typename Levels>
+DepthParseError parseBook(Cursor& cursor, long long& updateId, Levels& bids, Levels& asks) {
+    RETURN_IF_ERROR(cursor.expect('{'));
+
+    bool hasUpdateId = false;
+    bool hasBids = false;
+    bool hasAsks = false;
+
+    bool closed = cursor.peek() == '}';
+    if (closed) ++cursor.pos;
+
+    while (!closed) {
+        std::string_view key;
+        RETURN_IF_ERROR(cursor.readString(key));
+        RETURN_IF_ERROR(cursor.expect(':'));
+
+        if (key == "lastUpdateId") {
+            if (cursor.readNumber(updateId) != DepthParseError::None) return DepthParseError::InvalidUpdateId;
+            hasUpdateId = true;
+        } else if (key == "bids") {
+            RETURN_IF_ERROR(parsePriceLevels(cursor, bids));
+            hasBids = true;
+        } else if (key == "asks") {
+            RETURN_IF_ERROR(parsePriceLevels(cursor, asks));
+            hasAsks = true;
+        } else {
+            RETURN_IF_ERROR(cursor.skipValue());
+        }
+
+        RETURN_IF_ERROR(cursor.nextMember('}', closed));
+    }
+
+    return (hasUpdateId && hasBids && hasAsks) ? DepthParseError::None : DepthParseError::MissingData;
+}
+
+// The data object of a diff event, keys are case sensitive: U and u are the first and final update ids
+DepthParseError parseDiff(Cursor& cursor, DepthDiff& diff) {
+    RETURN_IF_ERROR(cursor.expect('{'));
+
+    bool hasFirstUpdateId = false;
+    bool hasFinalUpdateId = false;
+    bool hasBids = false;
+    bool hasAsks = false;
+
+    bool closed = cursor.peek() == '}';
+    if (closed) ++cursor.pos;
+
+    while (!closed) {
+        std::string_view key;
+        RETURN_IF_ERROR(cursor.readString(key));
+        RETURN_IF_ERROR(cursor.expect(':'));
+
+        if (key == "U") {
+            if (cursor.readNumber(diff.firstUpdateId) != DepthParseError::None) return DepthParseError::InvalidUpdateId;
+            hasFirstUpdateId = true;
+        } else if (key == "u") {
+            if (cursor.readNumber(diff.finalUpdateId) != DepthParseError::None) return DepthParseError::InvalidUpdateId;
+            hasFinalUpdateId = true;
+        } else if (key == "b") {
+            RETURN_IF_ERROR(parsePriceLevels(cursor, diff.bids));
+            hasBids = true;
+        } else if (key == "a") {
+            RETURN_IF_ERROR(parsePriceLevels(cursor, diff.asks));
+            hasAsks = true;
+        } else {
+            RETURN_IF_ERROR(cursor.skipValue());
+        }
+
+        RETURN_IF_ERROR(cursor.nextMember('}', closed));
+    }
+
+    if (!(hasFirstUpdateId && hasFinalUpdateId && hasBids && hasAsks)) return DepthParseError::MissingData;
+    return diff.firstUpdateId <= diff.finalUpdateId ? DepthParseError::None : DepthParseError::InvalidUpdateId;
+}
+
+// The data object of a best bid and ask update, four prices and quantities and nothing else worth keeping
+DepthParseError parseTicker(Cursor& cursor, BookTicker& ticker) {
+    RETURN_IF_ERROR(cursor.expect('{'));
+
+    unsigned seen = 0; // One bit per required key
+    bool closed = cursor.peek() == '}';
+    if (closed) ++cursor.pos;
+
+    while (!closed) {
+        std::string_view key;
+        RETURN_IF_ERROR(cursor.readString(key));
+        RETURN_IF_ERROR(cursor.expect(':'));
+
+        if (key.size() != 1) {
+            RETURN_IF_ERROR(cursor.skipValue());
+        } else if (key[0] == 'u') {
+            if (cursor.readNumber(ticker.updateId) != DepthParseError::None) return DepthParseError::InvalidUpdateId;
+            seen |= 1u;
+        } else if (key[0] == 'b') {
+            RETURN_IF_ERROR(cursor.readNumber(ticker.bid.price));
+            seen |= 2u;
+        } else if (key[0] == 'B') {
+            RETURN_IF_ERROR(cursor.readNumber(ticker.bid.quantity));
+            seen |= 4u;
+        } else if (key[0] == 'a') {
+            RETURN_IF_ERROR(cursor.readNumber(ticker.ask.price));
+            seen |= 8u;
+        } else if (key[0] == 'A') {
+            RETURN_IF_ERROR(cursor.readNumber(ticker.ask.quantity));
+            seen |= 16u;
+        } else {
+            RETURN_IF_ERROR(cursor.skipValue());
+        }
+
+        RETURN_IF_ERROR(cursor.nextMember('}', closed));
+    }
+
+    return seen == 31u ? DepthParseError::None : DepthParseError::MissingData;
+}
+
+// Matches a frame laid out exactly as Binance sends a best bid and ask, keys in order and no whitespace.
+// Returns false at the first difference, leaving the general parser to decide.
+bool parseTickerAsSent(const char* begin, const char* end, const SymbolTable& symbols, BookTicker& ticker) {
+    const char* pos = begin;
+    const auto literal = [&](std::string_view text) {
+        if (static_cast<std::size_t>(end - pos) < text.size() || std::string_view(pos, text.size()) != text) return false;
+        pos += text.size();
+        return true;
+    };
+    const auto until = [&](char c, std::string_view& out) {
+        const char* start = pos;
+        while (pos < end && *pos != c) ++pos;
+        out = std::string_view(start, static_cast<std::size_t>(pos - start));
+        return pos < end;
+    };
+    const auto number = [&](auto& out) {
+        const auto result = std::from_chars(pos, end, out);
+        pos = result.ptr;
+        return result.ec == std::errc();
+    };
+
+    std::string_view stream;
+    std::string_view ignored;
+    if (!literal(R"({"stream":")") || !until('"', stream)) return false;
+    if (!literal(R"(","data":{"u":)") || !number(ticker.updateId)) return false;
+    if (!literal(R"(,"s":")") || !until('"', ignored)) return false;
+    if (!literal(R"(","b":")") || !number(ticker.bid.price)) return false;
+    if (!literal(R"(","B":")") || !number(ticker.bid.quantity)) return false;
+    if (!literal(R"(","a":")") || !number(ticker.ask.price)) return false;
+    if (!literal(R"(","A":")") || !number(ticker.ask.quantity)) return false;
+    if (!literal(R"("}})") || pos != end) return false;
+
+    ticker.symbol = stream.substr(0, stream.find('@'));
+    ticker.symbolId = symbols.find(ticker.symbol);
+    return !ticker.symbol.empty();
+}
+
+// The {"stream":..,"data":{..}} envelope of every combined stream, the data object is read by parseData
+template <typename Event, typename ParseData>
+DepthParseError parseCombinedStream(Cursor& cursor, const SymbolTable& symbols, Event& event, ParseData parseData) {
+    bool hasStream = false;
+    bool hasData = false;
+
+    RETURN_IF_ERROR(cursor.expect('{'));
+
+    bool closed = cursor.peek() == '}';
+    if (closed) ++cursor.pos;
+
+    while (!closed) {
+        std::string_view key;
+        RETURN_IF_ERROR(cursor.readString(key));
+        RETURN_IF_ERROR(cursor.expect(':'));
+
+        if (key == "stream") {
+            std::string_view stream;
+            RETURN_IF_ERROR(cursor.readString(stream));
+            event.symbol = stream.substr(0, stream.find('@'));
+            event.symbolId = symbols.find(event.symbol);
+            hasStream = !event.symbol.empty();
+        } else if (key == "data") {
+            RETURN_IF_ERROR(parseData(cursor, event));
+            hasData = true;
+        } else {
+            RETURN_IF_ERROR(cursor.skipValue());
+        }
+
+        RETURN_IF_ERROR(cursor.nextMember('}', closed));
+    }
+
+    if (!hasStream) return DepthParseError::MissingStream;
+    if (!hasData) return DepthParseError::MissingData;
+    return DepthParseError::None;
+}
+
+} // namespace
+
+DepthParseError parseDepthFrame(const char* begin, const char* end, long long localTimestampNs, const SymbolTable& symbols, OrderBookTick& tick) {
+    Cursor cursor{begin, end};
+
+    RETURN_IF_ERROR(parseCombinedStream(cursor, symbols, tick, [](Cursor& data, OrderBookTick& book) {
+        return parseBook(data, book.updateId, book.bids, book.asks);
+    }));
+
+    tick.jsonStr = std::string_view(begin, static_cast<size_t>(end - begin));
+    tick.tickInitTime = localTimestampNs;
+    return DepthParseError::None;
+}
+
+bool isDiffDepthStream(std::string_view stream) {
+    // Partial streams name their depth, @depth5 and so on, diff streams are @depth or @depth@100ms
+    static constexpr std::string_view DEPTH = "@depth";
+    for (std::size_t at = stream.find(DEPTH); at != std::string_view::npos; at = stream.find(DEPTH, at + 1)) {
+        const std::size_t next = at + DEPTH.size();
+        if (next == stream.size() || stream[next] < '0' || stream[next] > '9') {
+            return true;
+        }
+    }
+    return false;
+}
+
+DepthParseError parseDepthDiffFrame(const char* begin, const char* end, long long localTimestampNs, const SymbolTable& symbols, DepthDiff& diff) {
+    Cursor cursor{begin, end};
+
+    RETURN_IF_ERROR(parseCombinedStream(cursor, symbols, diff, parseDiff));
+
+    diff.jsonStr = std::string_view(begin, static_cast<size_t>(end - begin));
+    diff.tickInitTime = localTimestampNs;
+    return DepthParseError::None;
+}
+
+DepthParseError parseDepthSnapshot(const char* begin, const char* end, DepthSnapshot& snapshot) {
+    Cursor cursor{begin, end};
+    return parseBook(cursor, snapshot.lastUpdateId, snapshot.bids, snapshot.asks);
+}
+
+bool isBookTickerStream(std::string_view stream) {
+    return stream.find("@bookTicker") != std::string_view::npos;
+}
+
+DepthParseError parseBookTickerFrame(const char* begin, const char* end, long long localTimestampNs, const SymbolTable& symbols, BookTicker& ticker) {
+    if (!parseTickerAsSent(begin, end, symbols, ticker)) {
+        Cursor cursor{begin, end};
+        RETURN_IF_ERROR(parseCombinedStream(cursor, symbols, ticker, parseTicker));
+    }
+
+    ticker.jsonStr = std::string_view(begin, static_cast<size_t>(end - begin));
+    ticker.tickInitTime = localTimestampNs;
+    return DepthParseError::None;
+}
+
+#undef RETURN_IF_ERROR
@@ -0,0 +1,101 @@
+#ifndef BINANCE_DEPTH_PARSER_H
+#define BINANCE_DEPTH_PARSER_H
+
+#include "common/order_book.h"
+#include "common/symbol_table.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Selects how BinanceClient turns a frame into an OrderBookTick
+enum class DepthParserMode {
+    Json, // nlohmann::json DOM + std::stod, kept for comparison
+    Fast  // parseDepthFrame directly over the received bytes
+};
+
+DepthParserMode depthParserModeFromString(const std::string& mode);
+
+enum class DepthParseError {
+    None,
+    UnexpectedEnd,
+    UnexpectedToken,
+    MissingStream,
+    MissingData,
+    InvalidUpdateId,
+    InvalidPriceLevel
+};
+
+const char* to_string(DepthParseError error);
+
+/**
+ * Parses a combined-stream partial depth frame without building a DOM:
+ *
+ * {"stream":"btcusdt@depth5@100ms","data":{"lastUpdateId":1,"bids":[["p","q"],..],"asks":[["p","q"],..]}}
+ *
+ * Keys may appear in any order and unknown keys are skipped. Prices and quantities are read
+ * with std::from_chars straight out of the frame and the tick is overwritten in place, so
+ * nothing is allocated or thrown. On error the tick contents are unspecified.
+ *
+ * @param begin Start of the frame bytes
+ * @param end One past the last frame byte
+ * @param localTimestampNs Receive time stored into tick.tickInitTime
+ * @param symbols Resolves the stream's symbol into tick.symbolId
+ * @param tick Destination, its symbol and jsonStr views point into [begin, end)
+ */
+DepthParseError parseDepthFrame(const char* begin, const char* end, long long localTimestampNs, const SymbolTable& symbols, OrderBookTick& tick);
+
+// Whether a stream name, or a whole /stream?streams=... target, carries @depth diffs rather than partial books
+bool isDiffDepthStream(std::string_view stream);
+
+/**
+ * @brief One @depth diff event: the new quantity of every level that changed between
+ * firstUpdateId and finalUpdateId. A zero quantity removes the level.
+ *
+ * Levels are unbounded, so they are held in vectors that keep their capacity across events.
+ */
+struct DepthDiff {
+    SymbolId symbolId = INVALID_SYMBOL_ID;
+    std::string_view symbol;
+    std::string_view jsonStr;
+    long long firstUpdateId = 0; // U
+    long long finalUpdateId = 0; // u
+    long long tickInitTime = 0;
+    std::vector<PriceLevel> bids;
+    std::vector<PriceLevel> asks;
+};
+
+// A full book as returned by GET /api/v3/depth, the starting point diffs are applied to
+struct DepthSnapshot {
+    long long lastUpdateId = 0;
+    std::vector<PriceLevel> bids; // Best first, as sent
+    std::vector<PriceLevel> asks;
+};
+
+/**
+ * Parses a combined-stream diff frame the same way parseDepthFrame parses a partial one:
+ *
+ * {"stream":"btcusdt@depth@100ms","data":{"e":"depthUpdate","E":1,"s":"BTCUSDT","U":157,"u":160,"b":[["p","q"],..],"a":[["p","q"],..]}}
+ *
+ * Every level is kept. The diff's vectors only allocate while growing past their previous size.
+ */
+DepthParseError parseDepthDiffFrame(const char* begin, const char* end, long long localTimestampNs, const SymbolTable& symbols, DepthDiff& diff);
+
+/**
+ * Parses a REST depth snapshot: {"lastUpdateId":1027024,"bids":[["p","q"],..],"asks":[["p","q"],..]}
+ */
+DepthParseError parseDepthSnapshot(const char* begin, const char* end, DepthSnapshot& snapshot);
+
+// Whether a stream name, or a whole /stream?streams=... target, carries @bookTicker best bid and ask updates
+bool isBookTickerStream(std::string_view stream);
+
+/**
+ * Parses a combined-stream best bid and ask frame:
+ *
+ * {"stream":"btcusdt@bookTicker","data":{"u":400900217,"s":"BTCUSDT","b":"25.35","B":"31.21","a":"25.36","A":"40.66"}}
+ *
+ * Keys are case sensitive, lower case is the price and upper case the quantity.
+ */
+DepthParseError parseBookTickerFrame(const char* begin, const char* end, long long localTimestampNs, const SymbolTable& symbols, BookTicker& ticker);
+
+#endif // BINANCE_DEPTH_PARSER_H
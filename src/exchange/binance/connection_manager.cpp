@@ -0,0 +1,185 @@
+#include "exchange/binance/connection_manager.h"
+#include "common/trade_util.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+constexpr const char* COMBINED_STREAM_PREFIX = "/stream?streams=";
+
+} // namespace
+
+std::vector<std::string> splitStreamTarget(const std::string& target) {
+    std::vector<std::string> streams;
+    if (target.rfind(COMBINED_STREAM_PREFIX, 0) != 0) {
+        return streams;
+    }
+
+    std::size_t begin = std::char_traits<char>::length(COMBINED_STREAM_PREFIX);
+    while (begin < target.size()) {
+        std::size_t end = target.find('/', begin);
+        if (end == std::string::npos) end = target.size();
+        if (end > begin) streams.push_back(target.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return streams;
+}
+
+std::string joinStreamTarget(const std::vector<std::string>& streams) {
+    std::string target = COMBINED_STREAM_PREFIX;
+    for (std::size_t i = 0; i < streams.size(); ++i) {
+        if (i > 0) target += "/";
+        target += streams[i];
+    }
+    return target;
+}
+
+std::vector<std::vector<std::string>> shardStreams(const std::vector<std::string>& streams,
+                                                   std::size_t shards, std::size_t maxStreamsPerShard) {
+    // Group by symbol, the part of a stream name before its first '@'
+    std::vector<std::vector<std::string>> symbols;
+    std::unordered_map<std::string, std::size_t> symbolIndex;
+    for (const auto& stream : streams) {
+        const std::string symbol = stream.substr(0, stream.find('@'));
+        const auto inserted = symbolIndex.emplace(symbol, symbols.size());
+        if (inserted.second) symbols.emplace_back();
+        symbols[inserted.first->second].push_back(stream);
+    }
+
+    if (maxStreamsPerShard > 0) {
+        shards = std::max(shards, (streams.size() + maxStreamsPerShard - 1) / maxStreamsPerShard);
+    }
+    shards = std::min(std::max<std::size_t>(shards, 1), std::max<std::size_t>(symbols.size(), 1));
+
+    std::vector<std::vector<std::string>> result(shards);
+    for (const auto& symbolStreams : symbols) {
+        auto& emptiest = *std::min_element(result.begin(), result.end(),
+            [](const auto& a, const auto& b) { return a.size() < b.size(); });
+        emptiest.insert(emptiest.end(), symbolStreams.begin(), symbolStreams.end());
+    }
+    return result;
+}
+
+ConnectionManager::ConnectionManager(boost::asio::io_context& ioc, boost::asio::ssl::context& ssl_ctx, const ConnectionConfig& config)
+    : ioc(ioc), ssl_ctx(ssl_ctx), config(config), reportTimer(ioc), lastReport(std::chrono::steady_clock::now()) {
+}
+
+void ConnectionManager::set_pipeline(std::shared_ptr<ComputePipeline> computePipeline) {
+    pipeline = std::move(computePipeline);
+}
+
+void ConnectionManager::set_transport(const TransportConfig& transportConfig) {
+    transport = transportConfig;
+}
+
+void ConnectionManager::connect(const std::string& host, const std::string& port, const std::string& target,
+                                const std::shared_ptr<Server>& server, const std::function<void(BinanceClient&)>& configure) {
+    std::vector<std::string> targets;
+    std::vector<std::size_t> streamCounts;
+    const std::vector<std::string> streams = splitStreamTarget(target);
+    if (streams.empty()) {
+        // Not a combined stream, so there is nothing to split
+        targets.push_back(target);
+        streamCounts.push_back(1);
+    } else {
+        for (const auto& shard : shardStreams(streams, config.connections, config.maxStreamsPerConnection)) {
+            targets.push_back(joinStreamTarget(shard));
+            streamCounts.push_back(shard.size());
+        }
+    }
+
+    // The compute thread is the only caller once there is a pipeline
+    server->setConcurrentUpdates(!pipeline && targets.size() > 1 && config.ioThreads > 1);
+
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        auto client = std::make_shared<BinanceClient>(ioc, ssl_ctx, "BINANCE CONNECTION " + std::to_string(i));
+        client->set_transport(transport);
+        configure(*client);
+        client->set_callback(server);
+        if (pipeline) client->set_tick_queue(pipeline->addQueue());
+        connections.push_back({client, targets[i], streamCounts[i]});
+    }
+
+    for (const auto& connection : connections) {
+        connection.client->async_connect(host, port, connection.target);
+    }
+
+    if (config.throughputReportInterval > 0) {
+        lastReport = std::chrono::steady_clock::now();
+        scheduleReport();
+    }
+}
+
+void ConnectionManager::run() {
+    std::vector<std::thread> threads;
+    threads.reserve(config.ioThreads - 1);
+    const auto runPinned = [this](std::size_t thread) {
+        if (!config.ioCpus.empty()) {
+            const int cpu = config.ioCpus[thread % config.ioCpus.size()];
+            if (!pinCurrentThreadToCpu(cpu)) {
+                fail(("Unable to pin IO thread " + std::to_string(thread) + " to CPU " + std::to_string(cpu)).c_str(), "ConnectionManager");
+            }
+        }
+        if (transport.busyPoll) {
+            while (!ioc.stopped()) {
+                ioc.poll();
+            }
+        } else {
+            ioc.run();
+        }
+    };
+    for (std::size_t i = 1; i < config.ioThreads; ++i) {
+        threads.emplace_back(runPinned, i);
+    }
+    runPinned(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ConnectionManager::scheduleReport() {
+    reportTimer.expires_after(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(config.throughputReportInterval)));
+    reportTimer.async_wait([this](boost::beast::error_code ec) {
+        if (ec) return;
+        const auto now = std::chrono::steady_clock::now();
+        report(std::cout, std::chrono::duration<double>(now - lastReport).count());
+        lastReport = now;
+        scheduleReport();
+    });
+}
+
+void ConnectionManager::report(std::ostream& out, double windowSeconds) {
+    const double window = windowSeconds > 0 ? windowSeconds : 1;
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    out << "########### CONNECTION THROUGHPUT (" << std::fixed << std::setprecision(1) << windowSeconds << "s) ###########\n";
+    for (auto& connection : connections) {
+        const ConnectionCounters& counters = connection.client->getCounters();
+        const std::uint64_t frames = counters.frames.load(std::memory_order_relaxed);
+        const std::uint64_t bytes = counters.bytes.load(std::memory_order_relaxed);
+        const std::uint64_t updates = counters.updates.load(std::memory_order_relaxed);
+        const std::uint64_t busyNs = counters.busyNs.load(std::memory_order_relaxed);
+
+        out << connection.client->getName()
+            << "  streams " << connection.streams
+            << "  frames/s " << (frames - connection.lastFrames) / window
+            << "  KB/s " << (bytes - connection.lastBytes) / window / 1024
+            << "  updates/s " << (updates - connection.lastUpdates) / window
+            << "  busy " << 100.0 * (busyNs - connection.lastBusyNs) / (window * 1e9) << "%"
+            << "  parse errors " << counters.parseErrors.load(std::memory_order_relaxed)
+            << "  reconnects " << counters.reconnects.load(std::memory_order_relaxed) << "\n";
+
+        connection.lastFrames = frames;
+        connection.lastBytes = bytes;
+        connection.lastUpdates = updates;
+        connection.lastBusyNs = busyNs;
+    }
+    out.flags(flags);
+    out.precision(precision);
+    out << std::flush;
+}
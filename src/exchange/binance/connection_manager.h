@@ -0,0 +1,135 @@
+#ifndef CONNECTION_MANAGER_H
+#define CONNECTION_MANAGER_H
+
+#include "common/thread_affinity.h"
+#include "exchange/binance/binance_client.h"
+#include "server/compute_pipeline.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+struct ConnectionConfig {
+    std::size_t connections;             // Websocket connections the subscription set is split over
+    std::size_t ioThreads;               // Threads running the shared io_context
+    std::size_t maxStreamsPerConnection; // Binance refuses more streams than this on one connection
+    double throughputReportInterval;     // Seconds between per-connection throughput reports, 0 disables them
+    std::vector<int> ioCpus;             // CPUs the IO threads are pinned to in turn, empty leaves them to the OS
+
+    explicit ConnectionConfig(std::size_t connectionCount = 1, std::size_t threads = 0,
+                              std::size_t maxStreams = DEFAULT_MAX_STREAMS_PER_CONNECTION, double reportInterval = 0,
+                              std::vector<int> cpus = {})
+        : connections(connectionCount ? connectionCount : 1),
+          ioThreads(threads ? threads : connections),
+          maxStreamsPerConnection(maxStreams ? maxStreams : DEFAULT_MAX_STREAMS_PER_CONNECTION),
+          throughputReportInterval(reportInterval),
+          ioCpus(std::move(cpus)) {}
+
+    // Reads BINANCE_CONNECTIONS, BINANCE_IO_THREADS (one per connection by default),
+    // BINANCE_MAX_STREAMS_PER_CONNECTION, BINANCE_THROUGHPUT_REPORT_INTERVAL and BINANCE_IO_CPUS (e.g. "2,3")
+    static ConnectionConfig from_env() {
+        const char* env_connections = std::getenv("BINANCE_CONNECTIONS");
+        const char* env_io_threads = std::getenv("BINANCE_IO_THREADS");
+        const char* env_max_streams = std::getenv("BINANCE_MAX_STREAMS_PER_CONNECTION");
+        const char* env_report_interval = std::getenv("BINANCE_THROUGHPUT_REPORT_INTERVAL");
+        const char* env_io_cpus = std::getenv("BINANCE_IO_CPUS");
+
+        return ConnectionConfig(
+            env_connections ? std::stoul(env_connections) : 1,
+            env_io_threads ? std::stoul(env_io_threads) : 0,
+            env_max_streams ? std::stoul(env_max_streams) : DEFAULT_MAX_STREAMS_PER_CONNECTION,
+            env_report_interval ? std::stod(env_report_interval) : 0,
+            env_io_cpus ? parseCpuList(env_io_cpus) : std::vector<int>()
+        );
+    }
+
+    static constexpr std::size_t DEFAULT_MAX_STREAMS_PER_CONNECTION = 1024;
+};
+
+// Stream names of a combined-stream target (/stream?streams=a/b/c), empty for any other target
+std::vector<std::string> splitStreamTarget(const std::string& target);
+
+// The combined-stream target subscribing to streams
+std::string joinStreamTarget(const std::vector<std::string>& streams);
+
+/**
+ * @brief Splits streams into shards, keeping every stream of a symbol in the same shard.
+ *
+ * Symbols are dealt in order of first appearance to the shard holding the fewest streams so far.
+ * More shards than asked for are used when that many would exceed maxStreamsPerShard, and fewer
+ * when there are not enough symbols to go round.
+ */
+std::vector<std::vector<std::string>> shardStreams(const std::vector<std::string>& streams,
+                                                   std::size_t shards, std::size_t maxStreamsPerShard);
+
+/**
+ * @class ConnectionManager
+ * @brief Splits one subscription over several BinanceClients sharing an io_context run by a pool of threads.
+ *
+ * Every client reads on its own strand, so connections parse in parallel while each one's
+ * frames are still handled one at a time and in order. All streams of a symbol go to the same
+ * connection, which keeps that symbol's ticks in order all the way into the server. Once more
+ * than one thread can call it, the server serialises on_update itself, unless a ComputePipeline
+ * runs it, in which case each connection only parses and queues its ticks for the compute thread.
+ */
+class ConnectionManager {
+public:
+    ConnectionManager(boost::asio::io_context& ioc, boost::asio::ssl::context& ssl_ctx, const ConnectionConfig& config);
+
+    // Gives every connection created from now on its own queue into the pipeline
+    void set_pipeline(std::shared_ptr<ComputePipeline> pipeline);
+
+    // Socket and websocket options for every connection created from now on, and whether run() busy-polls
+    void set_transport(const TransportConfig& transport);
+
+    /**
+     * @brief Creates one client per shard of target's streams and starts connecting them.
+     * @param configure Applied to each client before it connects, for the parser and stream settings
+     */
+    void connect(const std::string& host, const std::string& port, const std::string& target,
+                 const std::shared_ptr<Server>& server, const std::function<void(BinanceClient&)>& configure);
+
+    // Runs the io_context on the configured number of threads, the calling one included, until it stops.
+    // Each thread is pinned to the next of the configured IO CPUs, if any. With busyPoll set, the threads
+    // spin on poll() rather than sleep in run(), each one keeping a core busy for a faster wake-up.
+    void run();
+
+    // Frames, bytes, updates and errors per second and the share of time spent handling frames, for
+    // every connection since the previous report
+    void report(std::ostream& out, double windowSeconds);
+
+    struct Connection {
+        std::shared_ptr<BinanceClient> client;
+        std::string target;
+        std::size_t streams;
+        // Totals at the previous report
+        std::uint64_t lastFrames = 0;
+        std::uint64_t lastBytes = 0;
+        std::uint64_t lastUpdates = 0;
+        std::uint64_t lastBusyNs = 0;
+    };
+
+    const std::vector<Connection>& getConnections() const { return connections; }
+
+private:
+    void scheduleReport();
+
+    boost::asio::io_context& ioc;
+    boost::asio::ssl::context& ssl_ctx;
+    const ConnectionConfig config;
+    std::vector<Connection> connections;
+    std::shared_ptr<ComputePipeline> pipeline;
+    TransportConfig transport;
+    boost::asio::steady_timer reportTimer;
+    std::chrono::steady_clock::time_point lastReport;
+};
+
+#endif // CONNECTION_MANAGER_H
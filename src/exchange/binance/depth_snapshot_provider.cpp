@@ -0,0 +1,117 @@
+#include "exchange/binance/depth_snapshot_provider.h"
+#include "common/trade_util.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <system_error>
+#include <iterator>
+#include <utility>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http.hpp>
+
+std::shared_ptr<SnapshotProvider> SnapshotProvider::from_env() {
+    const char* env_snapshot_dir = std::getenv("BINANCE_SNAPSHOT_DIR");
+    const char* env_snapshot_endpoint = std::getenv("BINANCE_SNAPSHOT_ENDPOINT");
+
+    if (env_snapshot_dir) {
+        return std::make_shared<FileSnapshotProvider>(env_snapshot_dir);
+    }
+    if (env_snapshot_endpoint) {
+        const std::string endpoint = env_snapshot_endpoint;
+        const std::size_t colon = endpoint.rfind(':');
+        if (colon == std::string::npos) {
+            return std::make_shared<HttpSnapshotProvider>(endpoint, "80");
+        }
+        return std::make_shared<HttpSnapshotProvider>(endpoint.substr(0, colon), endpoint.substr(colon + 1));
+    }
+    return nullptr;
+}
+
+FileSnapshotProvider::FileSnapshotProvider(std::string directory) : directory(std::move(directory)) {
+}
+
+bool FileSnapshotProvider::fetch(std::string_view symbol, DepthSnapshot& snapshot) {
+    const std::string path = directory + "/" + std::string(symbol) + ".json";
+
+    std::error_code ec;
+    const std::filesystem::file_time_type modified = std::filesystem::last_write_time(path, ec);
+    const std::uintmax_t size = ec ? 0 : std::filesystem::file_size(path, ec);
+    if (ec) {
+        fail(("Unable to open snapshot file: " + path).c_str(), "Depth Snapshot");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    const auto cached = cache.find(path);
+    if (cached != cache.end() && cached->second.modified == modified && cached->second.size == size) {
+        snapshot = cached->second.snapshot;
+        return true;
+    }
+
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        fail(("Unable to open snapshot file: " + path).c_str(), "Depth Snapshot");
+        return false;
+    }
+
+    const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const DepthParseError err = parseDepthSnapshot(content.data(), content.data() + content.size(), snapshot);
+    if (err != DepthParseError::None) {
+        fail(to_string(err), "Depth Snapshot");
+        return false;
+    }
+    cache[path] = CachedSnapshot{modified, size, snapshot};
+    return true;
+}
+
+HttpSnapshotProvider::HttpSnapshotProvider(std::string host, std::string port, int limit)
+    : host(std::move(host)), port(std::move(port)), limit(limit) {
+}
+
+bool HttpSnapshotProvider::fetch(std::string_view symbol, DepthSnapshot& snapshot) {
+    // Streams name symbols in lower case, the REST API wants them upper case
+    std::string restSymbol(symbol);
+    std::transform(restSymbol.begin(), restSymbol.end(), restSymbol.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    try {
+        boost::asio::io_context ioc;
+        boost::asio::ip::tcp::resolver resolver(ioc);
+        boost::beast::tcp_stream stream(ioc);
+        stream.expires_after(std::chrono::seconds(10));
+        stream.connect(resolver.resolve(host, port));
+
+        boost::beast::http::request<boost::beast::http::empty_body> request(
+            boost::beast::http::verb::get, "/api/v3/depth?symbol=" + restSymbol + "&limit=" + std::to_string(limit), 11);
+        request.set(boost::beast::http::field::host, host);
+        boost::beast::http::write(stream, request);
+
+        boost::beast::flat_buffer buffer;
+        boost::beast::http::response<boost::beast::http::string_body> response;
+        boost::beast::http::read(stream, buffer, response);
+
+        boost::beast::error_code ec;
+        stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+
+        if (response.result() != boost::beast::http::status::ok) {
+            fail(("HTTP " + std::to_string(response.result_int()) + " for " + restSymbol).c_str(), "Depth Snapshot");
+            return false;
+        }
+
+        const std::string& body = response.body();
+        const DepthParseError err = parseDepthSnapshot(body.data(), body.data() + body.size(), snapshot);
+        if (err != DepthParseError::None) {
+            fail(to_string(err), "Depth Snapshot");
+            return false;
+        }
+        return true;
+    } catch (const boost::system::system_error& e) {
+        fail(e.code(), "Depth Snapshot");
+        return false;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef DEPTH_SNAPSHOT_PROVIDER_H
+#define DEPTH_SNAPSHOT_PROVIDER_H
+
+#include "exchange/binance/binance_depth_parser.h"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @class SnapshotProvider
+ * @brief Source of the full-depth snapshots a LocalOrderBook starts from and resyncs to.
+ */
+class SnapshotProvider {
+public:
+    virtual ~SnapshotProvider() = default;
+
+    // Overwrites snapshot with the symbol's current book, false and logged if none could be had
+    virtual bool fetch(std::string_view symbol, DepthSnapshot& snapshot) = 0;
+
+    // BINANCE_SNAPSHOT_DIR picks a FileSnapshotProvider and BINANCE_SNAPSHOT_ENDPOINT (host:port) an
+    // HttpSnapshotProvider, nullptr if neither is set
+    static std::shared_ptr<SnapshotProvider> from_env();
+};
+
+/**
+ * @class FileSnapshotProvider
+ * @brief Reads <directory>/<symbol>.json, each holding a saved GET /api/v3/depth response.
+ *
+ * Each file is parsed once and kept until its modification time or size changes, so a
+ * book that keeps resyncing against a file that has not been refreshed costs a stat and a
+ * copy per attempt instead of a read and a parse. Safe to share between connections.
+ */
+class FileSnapshotProvider : public SnapshotProvider {
+public:
+    explicit FileSnapshotProvider(std::string directory);
+
+    bool fetch(std::string_view symbol, DepthSnapshot& snapshot) override;
+
+private:
+    struct CachedSnapshot {
+        std::filesystem::file_time_type modified;
+        std::uintmax_t size;
+        DepthSnapshot snapshot;
+    };
+
+    const std::string directory;
+    std::mutex cacheMutex;
+    std::unordered_map<std::string, CachedSnapshot> cache; // By path
+};
+
+/**
+ * @class HttpSnapshotProvider
+ * @brief GETs /api/v3/depth?symbol=<SYMBOL>&limit=<limit> over plain HTTP, from a local stand-in for the REST API.
+ *
+ * Each fetch opens its own connection and blocks until the response is read.
+ */
+class HttpSnapshotProvider : public SnapshotProvider {
+public:
+    HttpSnapshotProvider(std::string host, std::string port, int limit = DEFAULT_LIMIT);
+
+    bool fetch(std::string_view symbol, DepthSnapshot& snapshot) override;
+
+    static constexpr int DEFAULT_LIMIT = 1000;
+
+private:
+    const std::string host;
+    const std::string port;
+    const int limit;
+};
+
+#endif // DEPTH_SNAPSHOT_PROVIDER_H
@@ -0,0 +1,90 @@
+#include "exchange/binance/local_order_book.h"
+#include <utility>
+
+void LocalOrderBook::load(const DepthSnapshot& snapshot) {
+    // Snapshots list the best level first, inserting in reverse appends to the back of each side
+    bids.clear();
+    for (auto it = snapshot.bids.rbegin(); it != snapshot.bids.rend(); ++it) {
+        bids.set(it->price, it->quantity);
+    }
+    asks.clear();
+    for (auto it = snapshot.asks.rbegin(); it != snapshot.asks.rend(); ++it) {
+        asks.set(it->price, it->quantity);
+    }
+
+    updateId = snapshot.lastUpdateId;
+    synced = true;
+    live = false;
+}
+
+DiffResult LocalOrderBook::apply(const DepthDiff& diff) {
+    if (!synced) {
+        return DiffResult::OutOfSync;
+    }
+    if (diff.finalUpdateId <= updateId) {
+        return DiffResult::Stale;
+    }
+
+    const bool contiguous = live ? diff.firstUpdateId == updateId + 1 : diff.firstUpdateId <= updateId + 1;
+    if (!contiguous) {
+        synced = false;
+        return DiffResult::OutOfSync;
+    }
+
+    for (const auto& level : diff.bids) {
+        bids.set(level.price, level.quantity);
+    }
+    for (const auto& level : diff.asks) {
+        asks.set(level.price, level.quantity);
+    }
+
+    updateId = diff.finalUpdateId;
+    live = true;
+    return DiffResult::Applied;
+}
+
+LocalOrderBooks::LocalOrderBooks(std::shared_ptr<SnapshotProvider> snapshots)
+    : snapshots(std::move(snapshots)), resyncCount(0) {
+}
+
+bool LocalOrderBooks::apply(const DepthDiff& diff, OrderBookTick& tick) {
+    if (diff.symbolId == INVALID_SYMBOL_ID) {
+        return false; // Not a leg of any path
+    }
+    if (diff.symbolId >= books.size()) {
+        books.resize(diff.symbolId + 1);
+    }
+    LocalOrderBook& book = books[diff.symbolId];
+
+    const DiffResult result = book.apply(diff);
+    bool changed = result == DiffResult::Applied;
+
+    if (result == DiffResult::OutOfSync) {
+        if (!snapshots->fetch(diff.symbol, snapshot)) {
+            return false;
+        }
+        // A snapshot older than the diff leaves a gap, it is not worth loading and the next diff tries again
+        if (snapshot.lastUpdateId + 1 < diff.firstUpdateId) {
+            return false;
+        }
+        book.load(snapshot);
+        resyncCount++;
+
+        changed = book.apply(diff) != DiffResult::OutOfSync;
+    }
+
+    if (!changed) {
+        return false;
+    }
+
+    tick.symbolId = diff.symbolId;
+    tick.symbol = diff.symbol;
+    tick.jsonStr = diff.jsonStr;
+    tick.tickInitTime = diff.tickInitTime;
+    book.copyTo(tick);
+    return true;
+}
+
+const LocalOrderBook* LocalOrderBooks::find(SymbolId id) const {
+    return id < books.size() && books[id].isSynced() ? &books[id] : nullptr;
+}
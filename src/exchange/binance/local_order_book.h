@@ -0,0 +1,148 @@
+#ifndef LOCAL_ORDER_BOOK_H
+#define LOCAL_ORDER_BOOK_H
+
+#include "common/order_book.h"
+#include "exchange/binance/binance_depth_parser.h"
+#include "exchange/binance/depth_snapshot_provider.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @class BookSide
+ * @brief One side of a full-depth book as sorted, contiguous price and quantity arrays.
+ *
+ * Levels are kept worst first so the best level sits at the back. Most diffs touch the top of
+ * the book, and inserting or removing there moves next to nothing.
+ *
+ * @tparam WorseFirst Orders prices from worst to best, std::less for bids and std::greater for asks
+ */
+template <typename WorseFirst>
+class BookSide {
+public:
+    // Sets the quantity resting at a price, zero removes the level
+    void set(double price, double quantity) {
+        const auto it = std::lower_bound(prices.begin(), prices.end(), price, WorseFirst());
+        const auto index = it - prices.begin();
+        const bool exists = it != prices.end() && *it == price;
+
+        if (quantity == 0.0) {
+            if (exists) {
+                prices.erase(it);
+                quantities.erase(quantities.begin() + index);
+            }
+        } else if (exists) {
+            quantities[index] = quantity;
+        } else {
+            prices.insert(it, price);
+            quantities.insert(quantities.begin() + index, quantity);
+        }
+    }
+
+    void clear() {
+        prices.clear();
+        quantities.clear();
+    }
+
+    std::size_t size() const { return prices.size(); }
+    bool empty() const { return prices.empty(); }
+
+    // The level at a depth, 0 being the best
+    PriceLevel level(std::size_t depth) const {
+        const std::size_t at = prices.size() - 1 - depth;
+        return PriceLevel(prices[at], quantities[at]);
+    }
+
+    // Overwrites levels with the best of this side, as many as fit
+    template <std::size_t Capacity>
+    void copyBest(PriceLevels<Capacity>& levels) const {
+        levels.clear();
+        const std::size_t depth = std::min(Capacity, prices.size());
+        for (std::size_t i = 0; i < depth; ++i) {
+            levels.emplace_back(prices[prices.size() - 1 - i], quantities[prices.size() - 1 - i]);
+        }
+    }
+
+private:
+    std::vector<double> prices;
+    std::vector<double> quantities;
+};
+
+enum class DiffResult {
+    Applied,
+    Stale,     // Every update in it is already in the book, dropped
+    OutOfSync  // No snapshot yet or a gap in update ids, the book needs a snapshot before it can continue
+};
+
+/**
+ * @class LocalOrderBook
+ * @brief Full-depth book for one symbol, kept from a REST snapshot and the @depth diff stream.
+ *
+ * Follows Binance's rules for a local book: diffs ending at or before the snapshot's
+ * lastUpdateId are dropped, the first one applied must straddle it (U <= lastUpdateId + 1 <= u)
+ * and every later one must start right after the previous (U == previous u + 1). Anything
+ * else is a gap, after which diffs are refused until the next snapshot is loaded.
+ */
+class LocalOrderBook {
+public:
+    // Replaces the whole book, diffs then continue from the snapshot's lastUpdateId
+    void load(const DepthSnapshot& snapshot);
+
+    DiffResult apply(const DepthDiff& diff);
+
+    bool isSynced() const { return synced; }
+    long long lastUpdateId() const { return updateId; }
+
+    const BookSide<std::less<double>>& getBids() const { return bids; }
+    const BookSide<std::greater<double>>& getAsks() const { return asks; }
+
+    // Publishes the best levels into a fixed-depth book, as many as it holds
+    template <std::size_t MaxDepth>
+    void copyTo(BasicOrderBook<MaxDepth>& book) const {
+        book.updateId = updateId;
+        bids.copyBest(book.bids);
+        asks.copyBest(book.asks);
+    }
+
+private:
+    BookSide<std::less<double>> bids;
+    BookSide<std::greater<double>> asks;
+    long long updateId = 0;
+    bool synced = false; // A snapshot is loaded and no gap has been seen since
+    bool live = false;   // At least one diff has been applied on top of the snapshot
+};
+
+/**
+ * @class LocalOrderBooks
+ * @brief The local books of every symbol on a diff stream, resynced from snapshots on gaps.
+ *
+ * Turns each diff into the OrderBookTick Server::on_update expects, holding the best
+ * ORDER_BOOK_MAX_DEPTH levels of the full book. Snapshots are fetched synchronously, so a
+ * resync stalls the calling thread for as long as the provider takes.
+ */
+class LocalOrderBooks {
+public:
+    explicit LocalOrderBooks(std::shared_ptr<SnapshotProvider> snapshots);
+
+    /**
+     * @brief Applies a diff to its symbol's book, first fetching a snapshot if the book is out of sync.
+     * @return True if the book changed and tick now holds it, with the diff's symbol, frame and receive time
+     */
+    bool apply(const DepthDiff& diff, OrderBookTick& tick);
+
+    // Nullptr unless the symbol's book is in sync
+    const LocalOrderBook* find(SymbolId id) const;
+
+    // Snapshots loaded so far, the initial one for every symbol included, not counting ones too old to use
+    long long getResyncCount() const { return resyncCount; }
+
+private:
+    std::shared_ptr<SnapshotProvider> snapshots;
+    std::vector<LocalOrderBook> books; // Indexed by SymbolId, grown as symbols are seen
+    DepthSnapshot snapshot;            // Reused between resyncs
+    long long resyncCount;
+};
+
+#endif // LOCAL_ORDER_BOOK_H
@@ -0,0 +1,144 @@
+#include "file/async_result_writer.h"
+#include "common/trade_util.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// How long the writer thread sleeps when the ring is empty
+constexpr std::chrono::microseconds IDLE_WAIT(200);
+
+template <std::size_t Capacity>
+void copyLevels(PriceLevelSpan from, PriceLevels<Capacity>& to) {
+    to.clear();
+    for (const auto& level : from) {
+        if (!to.push_back(level)) break;
+    }
+}
+
+} // namespace
+
+AsyncResultWriter::AsyncResultWriter(std::unique_ptr<ResultWriter>&& writer, const AsyncWriterConfig& config)
+    : writer(std::move(writer)),
+      config(config),
+      ring(std::max<std::size_t>(config.queueCapacity, 1)),
+      stopping(false),
+      enqueued(0),
+      written(0),
+      dropped(0),
+      highWaterMark(0),
+      latency("WRITER", config.latencyDumpInterval),
+      writerThread(&AsyncResultWriter::run, this) {
+}
+
+AsyncResultWriter::~AsyncResultWriter() {
+    stopping.store(true, std::memory_order_release);
+    writerThread.join();
+
+    const long long droppedResults = dropped.load(std::memory_order_relaxed);
+    if (droppedResults > 0) {
+        const std::string message = std::to_string(droppedResults) + " results dropped, queue high-water mark " +
+                                    std::to_string(highWaterMark.load(std::memory_order_relaxed)) + " of " +
+                                    std::to_string(ring.capacity());
+        fail(message.c_str(), "AsyncResultWriter");
+    }
+}
+
+void AsyncResultWriter::write(const ArbitrageResult& result) {
+    Slot* slot = ring.producerSlot();
+    while (!slot) {
+        if (config.overflowPolicy != OverflowPolicy::Block) {
+            onOverflow();
+            return;
+        }
+        std::this_thread::yield();
+        slot = ring.producerSlot();
+    }
+
+    // assign() reuses the slot's capacity from earlier laps
+    slot->symbol.assign(result.symbol);
+    slot->path.assign(result.path);
+    slot->jsonStr.assign(result.jsonStr);
+    slot->bottleneckLeg.assign(result.bottleneckLeg);
+    slot->tickInitTime = result.tickInitTime;
+    slot->processTime = result.processTime;
+    slot->unrealisedPnl = result.unrealisedPnl;
+    slot->tradedNotional = result.tradedNotional;
+    slot->arbitrageOpportunity = result.arbitrageOpportunity;
+    slot->rates = result.rates;
+    slot->optimalNotional = result.optimalNotional;
+    slot->optimalPnl = result.optimalPnl;
+    slot->breakevenNotional = result.breakevenNotional;
+    copyLevels(result.bids, slot->bids);
+    copyLevels(result.asks, slot->asks);
+    ring.publish();
+
+    // Only this thread writes these, relaxed loads and stores are enough
+    enqueued.store(enqueued.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    const auto queued = static_cast<long long>(ring.size());
+    if (queued > highWaterMark.load(std::memory_order_relaxed)) {
+        highWaterMark.store(queued, std::memory_order_relaxed);
+    }
+}
+
+void AsyncResultWriter::onOverflow() {
+    const long long droppedResults = dropped.load(std::memory_order_relaxed) + 1;
+    dropped.store(droppedResults, std::memory_order_relaxed);
+
+    if (config.overflowPolicy == OverflowPolicy::Count && (droppedResults & (droppedResults - 1)) == 0) {
+        const std::string message = std::to_string(droppedResults) + " results dropped, writer thread is behind";
+        fail(message.c_str(), "AsyncResultWriter");
+    }
+}
+
+AsyncWriterStats AsyncResultWriter::stats() const {
+    AsyncWriterStats stats;
+    stats.enqueued = enqueued.load(std::memory_order_relaxed);
+    stats.written = written.load(std::memory_order_relaxed);
+    stats.dropped = dropped.load(std::memory_order_relaxed);
+    stats.highWaterMark = highWaterMark.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AsyncResultWriter::run() {
+    for (;;) {
+        // Read the flag before draining, so results published before stopping are never left behind
+        const bool stop = stopping.load(std::memory_order_acquire);
+        const std::size_t drained = drainBatch();
+        if (drained > 0) {
+            continue;
+        }
+        if (stop) {
+            return;
+        }
+        std::this_thread::sleep_for(IDLE_WAIT);
+    }
+}
+
+std::size_t AsyncResultWriter::drainBatch() {
+    std::size_t drained = 0;
+    while (drained < config.batchSize) {
+        Slot* slot = ring.consumerSlot();
+        if (!slot) break;
+
+        const ArbitrageResult result(slot->symbol, slot->path, slot->jsonStr, slot->tickInitTime, slot->processTime,
+                                     slot->unrealisedPnl, slot->tradedNotional, slot->bottleneckLeg,
+                                     slot->arbitrageOpportunity, slot->rates, slot->optimalNotional, slot->optimalPnl,
+                                     slot->breakevenNotional, slot->bids, slot->asks);
+        writer->write(result);
+        ring.release();
+        drained++;
+    }
+
+    if (drained > 0) {
+        const std::int64_t flushStart = latency.enabled() ? latencyNow() : 0;
+        writer->flush();
+        if (latency.enabled()) {
+            const std::int64_t now = latencyNow();
+            latency.record(LatencyStage::WriterFlush, now - flushStart);
+            latency.maybeDump(now);
+        }
+        written.store(written.load(std::memory_order_relaxed) + static_cast<long long>(drained), std::memory_order_relaxed);
+    }
+    return drained;
+}
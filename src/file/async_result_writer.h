@@ -0,0 +1,82 @@
+#ifndef ASYNC_RESULT_WRITER_H
+#define ASYNC_RESULT_WRITER_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include "common/latency_stats.h"
+#include "common/spsc_ring.h"
+#include "file/result_writer.h"
+
+struct AsyncWriterStats {
+    long long enqueued = 0;
+    long long written = 0;
+    long long dropped = 0;
+    long long highWaterMark = 0; // Most results ever waiting in the queue
+};
+
+/**
+ * @class AsyncResultWriter
+ * @brief Moves result writing off the tick's hot path onto a dedicated writer thread.
+ *
+ * write() copies the result into a preallocated ring slot and returns. The slot's strings keep
+ * their capacity between laps, so once every slot has held a frame the hot path stops
+ * allocating. The writer thread drains the ring in batches into the wrapped writer and flushes
+ * it once per batch, turning many small writes into a few large ones.
+ *
+ * The destructor drains every queued result before returning.
+ */
+class AsyncResultWriter : public ResultWriter {
+public:
+    AsyncResultWriter(std::unique_ptr<ResultWriter>&& writer, const AsyncWriterConfig& config = AsyncWriterConfig());
+
+    void write(const ArbitrageResult& result) override;
+
+    ~AsyncResultWriter() override;
+
+    // Safe to call from any thread, counters are read individually
+    AsyncWriterStats stats() const;
+
+    // The wrapped writer's, so results still queued are not counted
+    std::uint64_t bytesWritten() const override { return writer->bytesWritten(); }
+
+private:
+    // An ArbitrageResult with owned copies of everything its views point at
+    struct Slot {
+        std::string symbol;
+        std::string path;
+        std::string jsonStr;
+        std::string bottleneckLeg;
+        long long tickInitTime = 0;
+        long long processTime = 0;
+        double unrealisedPnl = 0;
+        double tradedNotional = 0;
+        bool arbitrageOpportunity = false;
+        std::array<double, 3> rates{};
+        double optimalNotional = 0;
+        double optimalPnl = 0;
+        double breakevenNotional = 0;
+        PriceLevels<ORDER_BOOK_MAX_DEPTH> bids;
+        PriceLevels<ORDER_BOOK_MAX_DEPTH> asks;
+    };
+
+    const std::unique_ptr<ResultWriter> writer;
+    const AsyncWriterConfig config;
+    SpscRing<Slot> ring;
+
+    std::atomic<bool> stopping;
+    std::atomic<long long> enqueued;
+    std::atomic<long long> written;
+    std::atomic<long long> dropped;
+    std::atomic<long long> highWaterMark;
+    LatencyStats latency; // Recorded and dumped by the writer thread
+
+    std::thread writerThread; // Started last, once everything it touches is constructed
+
+    void run();
+    std::size_t drainBatch();
+    void onOverflow();
+};
+
+#endif // ASYNC_RESULT_WRITER_H
@@ -0,0 +1,167 @@
+#include "file/binary_trade_file_writer.h"
+#include "common/trade_util.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::size_t PAGE_SIZE = 4096;
+
+std::size_t dataOffsetFor(std::uint32_t dictionaryCapacity) {
+    const std::size_t end = sizeof(BinaryTradeFileHeader) + dictionaryCapacity;
+    return (end + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+}
+
+} // namespace
+
+BinaryTradeFileWriter::BinaryTradeFileWriter(const std::string& filePath,
+                                             std::uint32_t levelDepth,
+                                             std::uint32_t blockRecords,
+                                             std::uint32_t dictionaryCapacity,
+                                             std::size_t preallocatedBlocks)
+    : file(filePath, MappedFile::Mode::ReadWrite,
+           dataOffsetFor(dictionaryCapacity) + std::max<std::size_t>(preallocatedBlocks, 1) * BinaryTradeFileLayout{levelDepth, blockRecords}.blockBytes()),
+      layout{levelDepth, blockRecords},
+      blockCapacity(std::max<std::size_t>(preallocatedBlocks, 1)),
+      failed(false) {
+    if (levelDepth > UINT8_MAX || blockRecords == 0) {
+        throw std::invalid_argument("BinaryTradeFileWriter needs 1 or more records per block and at most 255 levels");
+    }
+
+    BinaryTradeFileHeader& h = header();
+    std::memcpy(h.magic, BINARY_TRADE_FILE_MAGIC, sizeof(h.magic));
+    h.version = BINARY_TRADE_FILE_VERSION;
+    h.levelDepth = levelDepth;
+    h.blockRecords = blockRecords;
+    h.blockBytes = static_cast<std::uint32_t>(layout.blockBytes());
+    h.dataOffset = dataOffsetFor(dictionaryCapacity);
+    h.recordCount = 0;
+    h.dictionaryCount = 0;
+    h.dictionaryBytes = 0;
+    h.dictionaryCapacity = dictionaryCapacity;
+}
+
+BinaryTradeFileWriter::~BinaryTradeFileWriter() {
+    // A failed grow can leave the file unmapped, with no header left to trim by
+    if (failed || !file.data()) {
+        return;
+    }
+    try {
+        // Drop the preallocated blocks that were never written
+        const std::size_t usedBlocks = (header().recordCount + layout.blockRecords - 1) / layout.blockRecords;
+        file.resize(header().dataOffset + usedBlocks * layout.blockBytes());
+        file.flush();
+    } catch (const std::runtime_error& e) {
+        fail(e.what(), "BinaryTradeFileWriter Error");
+    }
+}
+
+void BinaryTradeFileWriter::write(const ArbitrageResult& result) {
+    if (failed) {
+        return;
+    }
+
+    const std::size_t record = header().recordCount;
+    if (record == blockCapacity * layout.blockRecords) {
+        grow();
+        if (failed) return;
+    }
+
+    const std::uint32_t symbol = dictionaryIndex(result.symbol);
+    const std::uint32_t path = dictionaryIndex(result.path);
+    const std::uint32_t bottleneckLeg = dictionaryIndex(result.bottleneckLeg);
+
+    char* block = file.data() + header().dataOffset + (record / layout.blockRecords) * layout.blockBytes();
+    const std::size_t row = record % layout.blockRecords;
+
+    store<std::int64_t>(block, layout.columnOffset(BinaryColumn::TickReceiveTime), row, result.tickInitTime);
+    store<std::int64_t>(block, layout.columnOffset(BinaryColumn::TickProcessTime), row, result.processTime);
+    store<double>(block, layout.columnOffset(BinaryColumn::UnrealisedPnl), row, result.unrealisedPnl);
+    store<double>(block, layout.columnOffset(BinaryColumn::TradedNotional), row, result.tradedNotional);
+    store<double>(block, layout.columnOffset(BinaryColumn::Rate1), row, result.rates[0]);
+    store<double>(block, layout.columnOffset(BinaryColumn::Rate2), row, result.rates[1]);
+    store<double>(block, layout.columnOffset(BinaryColumn::Rate3), row, result.rates[2]);
+    store<double>(block, layout.columnOffset(BinaryColumn::OptimalNotional), row, result.optimalNotional);
+    store<double>(block, layout.columnOffset(BinaryColumn::OptimalPnl), row, result.optimalPnl);
+    store<double>(block, layout.columnOffset(BinaryColumn::BreakevenNotional), row, result.breakevenNotional);
+
+    const std::size_t bidCount = std::min<std::size_t>(result.bids.size(), layout.levelDepth);
+    const std::size_t askCount = std::min<std::size_t>(result.asks.size(), layout.levelDepth);
+    for (std::size_t level = 0; level < layout.levelDepth; ++level) {
+        const PriceLevel bid = level < bidCount ? result.bids[level] : PriceLevel();
+        const PriceLevel ask = level < askCount ? result.asks[level] : PriceLevel();
+        store<double>(block, layout.levelOffset(level, 0), row, bid.price);
+        store<double>(block, layout.levelOffset(level, 1), row, bid.quantity);
+        store<double>(block, layout.levelOffset(level, 2), row, ask.price);
+        store<double>(block, layout.levelOffset(level, 3), row, ask.quantity);
+    }
+
+    store<std::uint32_t>(block, layout.columnOffset(BinaryColumn::Symbol), row, symbol);
+    store<std::uint32_t>(block, layout.columnOffset(BinaryColumn::Path), row, path);
+    store<std::uint32_t>(block, layout.columnOffset(BinaryColumn::BottleneckLeg), row, bottleneckLeg);
+    store<std::uint8_t>(block, layout.columnOffset(BinaryColumn::IsArbitrageOpportunity), row, result.arbitrageOpportunity ? 1 : 0);
+    store<std::uint8_t>(block, layout.columnOffset(BinaryColumn::BidCount), row, static_cast<std::uint8_t>(bidCount));
+    store<std::uint8_t>(block, layout.columnOffset(BinaryColumn::AskCount), row, static_cast<std::uint8_t>(askCount));
+
+    // Publish the record only once it is complete
+    header().recordCount = record + 1;
+    bytes.store(bytes.load(std::memory_order_relaxed) + layout.recordBytes(), std::memory_order_relaxed);
+}
+
+std::uint32_t BinaryTradeFileWriter::dictionaryIndex(std::string_view str) {
+    const SymbolId existing = dictionary.find(str);
+    if (existing != INVALID_SYMBOL_ID) {
+        return existing;
+    }
+
+    BinaryTradeFileHeader& h = header();
+    const std::size_t entryBytes = sizeof(std::uint16_t) + str.size();
+    if (str.size() > UINT16_MAX || h.dictionaryBytes + entryBytes > h.dictionaryCapacity) {
+        return NO_DICTIONARY_ENTRY;
+    }
+
+    char* entry = file.data() + sizeof(BinaryTradeFileHeader) + h.dictionaryBytes;
+    const auto length = static_cast<std::uint16_t>(str.size());
+    std::memcpy(entry, &length, sizeof(length));
+    std::memcpy(entry + sizeof(length), str.data(), str.size());
+    h.dictionaryBytes += static_cast<std::uint32_t>(entryBytes);
+    bytes.store(bytes.load(std::memory_order_relaxed) + entryBytes, std::memory_order_relaxed);
+    h.dictionaryCount++;
+    return dictionary.intern(str);
+}
+
+void BinaryTradeFileWriter::grow() {
+    try {
+        blockCapacity *= 2;
+        file.resize(header().dataOffset + blockCapacity * layout.blockBytes());
+    } catch (const std::runtime_error& e) {
+        fail(e.what(), "BinaryTradeFileWriter Error");
+        failed = true;
+    }
+}
+
+BinaryTradeFileReader::BinaryTradeFileReader(const std::string& filePath)
+    : file(filePath, MappedFile::Mode::ReadOnly),
+      layout{0, 0} {
+    if (file.size() < sizeof(BinaryTradeFileHeader) || std::memcmp(header().magic, BINARY_TRADE_FILE_MAGIC, sizeof(BINARY_TRADE_FILE_MAGIC)) != 0) {
+        throw std::invalid_argument("Not a binary result file: " + filePath);
+    }
+    if (header().version != BINARY_TRADE_FILE_VERSION) {
+        throw std::invalid_argument("Unsupported binary result file version " + std::to_string(header().version) + ": " + filePath);
+    }
+    layout = BinaryTradeFileLayout{header().levelDepth, header().blockRecords};
+
+    const char* entry = file.data() + sizeof(BinaryTradeFileHeader);
+    strings.reserve(header().dictionaryCount);
+    for (std::uint32_t i = 0; i < header().dictionaryCount; ++i) {
+        std::uint16_t length;
+        std::memcpy(&length, entry, sizeof(length));
+        strings.emplace_back(entry + sizeof(length), length);
+        entry += sizeof(length) + length;
+    }
+}
+
+const std::string& BinaryTradeFileReader::string(std::uint32_t index) const {
+    static const std::string empty;
+    return index < strings.size() ? strings[index] : empty;
+}
@@ -0,0 +1,202 @@
+#ifndef BINARY_TRADE_FILE_WRITER_H
+#define BINARY_TRADE_FILE_WRITER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "common/symbol_table.h"
+#include "file/mapped_file.h"
+#include "file/result_writer.h"
+
+/*
+ * Binary result file layout, all values little endian:
+ *
+ *   BinaryTradeFileHeader            64 bytes
+ *   Dictionary                       dictionaryCapacity bytes of [uint16 length][bytes] entries
+ *   Blocks                           from dataOffset, blockBytes each
+ *
+ * Strings (symbols, paths, bottleneck legs) are stored once in the dictionary and referenced by
+ * their index. Each block holds blockRecords records column by column, widest type first:
+ *
+ *   int64   tickReceiveTime, tickProcessTime
+ *   float64 unrealisedPnl, tradedNotional, rate1, rate2, rate3,
+ *           optimalNotional, optimalPnl, breakevenNotional
+ *   float64 bidPrice0, bidQty0, askPrice0, askQty0, ... up to levelDepth
+ *   uint32  symbol, path, bottleneckLeg         (dictionary indices, NO_DICTIONARY_ENTRY if full)
+ *   uint8   isArbitrageOpportunity, bidCount, askCount
+ *
+ * padded to a multiple of 64 bytes. Only the first recordCount records are valid, the last
+ * block may be partially filled. analysis/src/read_binary_results.py reads the same layout.
+ */
+
+constexpr char BINARY_TRADE_FILE_MAGIC[8] = {'T', 'R', 'I', 'A', 'R', 'E', 'S', '\0'};
+constexpr std::uint32_t BINARY_TRADE_FILE_VERSION = 2;
+constexpr std::uint32_t NO_DICTIONARY_ENTRY = 0xFFFFFFFFu;
+
+struct BinaryTradeFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t levelDepth;         // Levels recorded per side
+    std::uint32_t blockRecords;       // Records per column block
+    std::uint32_t blockBytes;
+    std::uint64_t dataOffset;         // Offset of the first block
+    std::uint64_t recordCount;        // Updated after every record, so a killed writer leaves a readable file
+    std::uint32_t dictionaryCount;
+    std::uint32_t dictionaryBytes;    // Bytes of the dictionary in use
+    std::uint32_t dictionaryCapacity;
+    std::uint32_t reserved[3];
+};
+
+static_assert(sizeof(BinaryTradeFileHeader) == 64, "Header layout is part of the file format");
+
+enum class BinaryColumn : std::uint32_t {
+    TickReceiveTime,
+    TickProcessTime,
+    UnrealisedPnl,
+    TradedNotional,
+    Rate1,
+    Rate2,
+    Rate3,
+    OptimalNotional,
+    OptimalPnl,
+    BreakevenNotional,
+    Symbol,
+    Path,
+    BottleneckLeg,
+    IsArbitrageOpportunity,
+    BidCount,
+    AskCount
+};
+
+/**
+ * @brief Byte offsets of every column within a block, shared by the writer and the reader.
+ */
+struct BinaryTradeFileLayout {
+    std::uint32_t levelDepth;
+    std::uint32_t blockRecords;
+
+    static constexpr std::size_t FIXED_WIDE_COLUMNS = 10; // int64 and float64 columns before the levels
+
+    std::size_t columnOffset(BinaryColumn column) const {
+        const auto index = static_cast<std::size_t>(column);
+        if (index < FIXED_WIDE_COLUMNS) {
+            return index * sizeof(double) * blockRecords;
+        }
+        if (column <= BinaryColumn::BottleneckLeg) {
+            return narrowOffset() + (index - static_cast<std::size_t>(BinaryColumn::Symbol)) * sizeof(std::uint32_t) * blockRecords;
+        }
+        return byteOffset() + (index - static_cast<std::size_t>(BinaryColumn::IsArbitrageOpportunity)) * blockRecords;
+    }
+
+    // field: 0 bid price, 1 bid quantity, 2 ask price, 3 ask quantity
+    std::size_t levelOffset(std::size_t level, std::size_t field) const {
+        return (FIXED_WIDE_COLUMNS + level * 4 + field) * sizeof(double) * blockRecords;
+    }
+
+    // Bytes one record takes up within its block, not counting the block's padding
+    std::size_t recordBytes() const {
+        return (FIXED_WIDE_COLUMNS + 4 * levelDepth) * sizeof(double) + 3 * sizeof(std::uint32_t) + 3;
+    }
+
+    std::size_t blockBytes() const {
+        const std::size_t used = byteOffset() + 3 * blockRecords;
+        return (used + 63) & ~static_cast<std::size_t>(63);
+    }
+
+private:
+    std::size_t narrowOffset() const { return (FIXED_WIDE_COLUMNS + 4 * levelDepth) * sizeof(double) * blockRecords; }
+    std::size_t byteOffset() const { return narrowOffset() + 3 * sizeof(std::uint32_t) * blockRecords; }
+};
+
+/**
+ * @class BinaryTradeFileWriter
+ * @brief Writes results as fixed-size binary records into a preallocated memory-mapped file.
+ *
+ * Each write is a handful of stores into the mapping, with no formatting or allocation. The raw
+ * frame is not kept, only its top levelDepth decoded levels per side. The file is preallocated
+ * a few blocks at a time, doubling when full, and trimmed to the blocks in use on destruction.
+ * The file is replaced rather than appended to.
+ */
+class BinaryTradeFileWriter : public ResultWriter {
+public:
+    explicit BinaryTradeFileWriter(const std::string& filePath,
+                                   std::uint32_t levelDepth = 5,
+                                   std::uint32_t blockRecords = 4096,
+                                   std::uint32_t dictionaryCapacity = 1 << 20,
+                                   std::size_t preallocatedBlocks = 16);
+
+    void write(const ArbitrageResult& result) override;
+
+    // Records and dictionary entries stored so far, header and preallocation excluded
+    std::uint64_t bytesWritten() const override { return bytes.load(std::memory_order_relaxed); }
+
+    ~BinaryTradeFileWriter() override;
+
+private:
+    MappedFile file;
+    const BinaryTradeFileLayout layout;
+    SymbolTable dictionary; // Mirrors the file's dictionary, to find a string's index without allocating
+    std::size_t blockCapacity;
+    bool failed;
+    std::atomic<std::uint64_t> bytes{0}; // Only the writing thread stores, relaxed loads are enough to read
+
+    BinaryTradeFileHeader& header() { return *reinterpret_cast<BinaryTradeFileHeader*>(file.data()); }
+
+    std::uint32_t dictionaryIndex(std::string_view str);
+    void grow();
+
+    template <typename T>
+    void store(char* block, std::size_t columnOffset, std::size_t row, T value) {
+        std::memcpy(block + columnOffset + row * sizeof(T), &value, sizeof(T));
+    }
+};
+
+/**
+ * @class BinaryTradeFileReader
+ * @brief Random access to the records of a file written by BinaryTradeFileWriter.
+ *
+ * @throws std::invalid_argument if the file is not a binary result file of a supported version
+ */
+class BinaryTradeFileReader {
+public:
+    explicit BinaryTradeFileReader(const std::string& filePath);
+
+    std::size_t size() const { return static_cast<std::size_t>(header().recordCount); }
+    std::uint32_t levelDepth() const { return layout.levelDepth; }
+
+    // Dictionary entry for a string column, empty for NO_DICTIONARY_ENTRY
+    const std::string& string(std::uint32_t index) const;
+
+    template <typename T>
+    T value(BinaryColumn column, std::size_t record) const {
+        return load<T>(layout.columnOffset(column), record);
+    }
+
+    PriceLevel bid(std::size_t record, std::size_t level) const {
+        return PriceLevel(load<double>(layout.levelOffset(level, 0), record), load<double>(layout.levelOffset(level, 1), record));
+    }
+
+    PriceLevel ask(std::size_t record, std::size_t level) const {
+        return PriceLevel(load<double>(layout.levelOffset(level, 2), record), load<double>(layout.levelOffset(level, 3), record));
+    }
+
+private:
+    MappedFile file;
+    BinaryTradeFileLayout layout;
+    std::vector<std::string> strings;
+
+    const BinaryTradeFileHeader& header() const { return *reinterpret_cast<const BinaryTradeFileHeader*>(file.data()); }
+
+    template <typename T>
+    T load(std::size_t columnOffset, std::size_t record) const {
+        const char* block = file.data() + header().dataOffset + (record / layout.blockRecords) * header().blockBytes;
+        T value;
+        std::memcpy(&value, block + columnOffset + (record % layout.blockRecords) * sizeof(T), sizeof(T));
+        return value;
+    }
+};
+
+#endif // BINARY_TRADE_FILE_WRITER_H
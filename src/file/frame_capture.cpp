@@ -0,0 +1,284 @@
+#include "file/frame_capture.h"
+#include "common/trade_util.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::size_t INITIAL_INDEX_ENTRIES = 4096;
+constexpr std::int64_t NO_RECEIVE_TIME = std::numeric_limits<std::int64_t>::min();
+
+std::size_t recordBytes(std::size_t frameBytes) {
+    return (sizeof(FrameRecordHeader) + frameBytes + 7) & ~static_cast<std::size_t>(7);
+}
+
+std::size_t indexFileBytes(std::size_t entries) {
+    return sizeof(FrameCaptureIndexHeader) + entries * sizeof(FrameCaptureIndexEntry);
+}
+
+// Path of base's index, refusing to reuse a base a previous capture wrote to
+std::string newCaptureIndexPath(const std::string& base) {
+    const std::string path = base + ".idx";
+    std::error_code ec;
+    if (std::filesystem::exists(path, ec) || std::filesystem::exists(frameCaptureSegmentPath(base, 0), ec)) {
+        throw std::runtime_error("Capture " + base + " already exists, refusing to overwrite it");
+    }
+    return path;
+}
+
+} // namespace
+
+std::string frameCaptureSegmentPath(const std::string& base, std::uint32_t segment) {
+    char number[16];
+    std::snprintf(number, sizeof(number), "-%06u.seg", segment);
+    return base + number;
+}
+
+std::string createCaptureSessionDirectory(const std::string& directory) {
+    const std::time_t now = std::time(nullptr);
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    char started[32];
+    std::strftime(started, sizeof(started), "%Y%m%d-%H%M%S", &utc);
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        const std::string session = directory + "/" + started + (attempt ? "-" + std::to_string(attempt) : "");
+        // create_directory is false when the path already exists, which is what keeps sessions apart
+        if (std::filesystem::create_directory(session, ec)) return session;
+        if (ec) break;
+    }
+    throw std::runtime_error("Unable to create a capture session directory in " + directory +
+                             (ec ? ": " + ec.message() : ""));
+}
+
+FrameCaptureWriter::FrameCaptureWriter(const std::string& base, std::size_t segmentBytes, std::int64_t indexIntervalNs)
+    : base(base),
+      segmentBytes(std::max(segmentBytes, sizeof(FrameCaptureSegmentHeader) + recordBytes(0))),
+      indexIntervalNs(std::max<std::int64_t>(indexIntervalNs, 0)),
+      index(newCaptureIndexPath(base), MappedFile::Mode::ReadWrite, indexFileBytes(INITIAL_INDEX_ENTRIES)),
+      indexCapacity(INITIAL_INDEX_ENTRIES),
+      nextIndexTimeNs(NO_RECEIVE_TIME),
+      frames(0),
+      failed(false) {
+    FrameCaptureIndexHeader& h = indexHeader();
+    std::memcpy(h.magic, FRAME_CAPTURE_INDEX_MAGIC, sizeof(h.magic));
+    h.version = FRAME_CAPTURE_VERSION;
+    h.segmentCount = 0;
+    h.segmentBytes = this->segmentBytes;
+    h.entryCount = 0;
+    h.indexIntervalNs = this->indexIntervalNs;
+}
+
+FrameCaptureWriter::~FrameCaptureWriter() {
+    // A failed index growth can leave the index unmapped, with no header left to trim by
+    if (failed || !index.data()) {
+        return;
+    }
+    try {
+        closeSegment();
+        index.resize(indexFileBytes(indexHeader().entryCount));
+        index.flush();
+    } catch (const std::runtime_error& e) {
+        fail(e.what(), "FrameCaptureWriter Error");
+    }
+}
+
+void FrameCaptureWriter::append(std::string_view frame, std::int64_t receiveTimeNs) {
+    if (failed) {
+        return;
+    }
+
+    const std::size_t bytes = recordBytes(frame.size());
+    if (!segment || segmentHeader().bytesUsed + bytes > segment->size()) {
+        rotate(bytes);
+        if (failed) return;
+    }
+
+    FrameCaptureSegmentHeader& h = segmentHeader();
+    const std::uint64_t offset = h.bytesUsed;
+    // Every segment starts with an entry, so a seek never has to read the segment before it
+    if (h.recordCount == 0 || receiveTimeNs >= nextIndexTimeNs) {
+        addIndexEntry(receiveTimeNs, offset);
+        if (failed) return;
+    }
+
+    FrameRecordHeader record;
+    record.length = static_cast<std::uint32_t>(frame.size());
+    record.reserved = 0;
+    record.receiveTimeNs = receiveTimeNs;
+    char* out = segment->data() + offset;
+    std::memcpy(out, &record, sizeof(record));
+    std::memcpy(out + sizeof(record), frame.data(), frame.size());
+
+    // Publish the record only once it is complete
+    if (h.recordCount == 0) h.firstReceiveTimeNs = receiveTimeNs;
+    h.lastReceiveTimeNs = receiveTimeNs;
+    h.recordCount++;
+    h.bytesUsed = offset + bytes;
+    frames++;
+}
+
+void FrameCaptureWriter::rotate(std::size_t recordBytes) {
+    try {
+        closeSegment();
+
+        FrameCaptureIndexHeader& ih = indexHeader();
+        const std::uint32_t number = ih.segmentCount;
+        // A frame larger than a segment gets a segment of its own
+        const std::size_t size = std::max(segmentBytes, sizeof(FrameCaptureSegmentHeader) + recordBytes);
+        segment = std::make_unique<MappedFile>(frameCaptureSegmentPath(base, number), MappedFile::Mode::ReadWrite, size);
+
+        FrameCaptureSegmentHeader& h = segmentHeader();
+        std::memcpy(h.magic, FRAME_CAPTURE_SEGMENT_MAGIC, sizeof(h.magic));
+        h.version = FRAME_CAPTURE_VERSION;
+        h.segment = number;
+        h.bytesUsed = sizeof(FrameCaptureSegmentHeader);
+        h.recordCount = 0;
+        h.firstReceiveTimeNs = 0;
+        h.lastReceiveTimeNs = 0;
+        ih.segmentCount = number + 1;
+    } catch (const std::runtime_error& e) {
+        fail(e.what(), "FrameCaptureWriter Error");
+        segment.reset();
+        failed = true;
+    }
+}
+
+void FrameCaptureWriter::closeSegment() {
+    if (!segment) return;
+    // The unused tail was never written, drop it
+    segment->resize(segmentHeader().bytesUsed);
+    segment.reset();
+}
+
+void FrameCaptureWriter::addIndexEntry(std::int64_t receiveTimeNs, std::uint64_t offset) {
+    if (indexHeader().entryCount == indexCapacity) {
+        try {
+            indexCapacity *= 2;
+            index.resize(indexFileBytes(indexCapacity));
+        } catch (const std::runtime_error& e) {
+            fail(e.what(), "FrameCaptureWriter Error");
+            failed = true;
+            return;
+        }
+    }
+
+    FrameCaptureIndexHeader& ih = indexHeader();
+    FrameCaptureIndexEntry entry;
+    entry.receiveTimeNs = receiveTimeNs;
+    entry.segment = ih.segmentCount - 1;
+    entry.reserved = 0;
+    entry.offset = offset;
+    std::memcpy(index.data() + indexFileBytes(ih.entryCount), &entry, sizeof(entry));
+    ih.entryCount++;
+    nextIndexTimeNs = receiveTimeNs + indexIntervalNs;
+}
+
+FrameCaptureReader::FrameCaptureReader(const std::string& indexPath)
+    : index(indexPath, MappedFile::Mode::ReadOnly),
+      segmentNumber(0),
+      offset(0) {
+    const std::string suffix = ".idx";
+    if (indexPath.size() <= suffix.size() || indexPath.compare(indexPath.size() - suffix.size(), suffix.size(), suffix) != 0) {
+        throw std::invalid_argument("Capture index files end in .idx: " + indexPath);
+    }
+    if (index.size() < sizeof(FrameCaptureIndexHeader) || std::memcmp(indexHeader().magic, FRAME_CAPTURE_INDEX_MAGIC, sizeof(FRAME_CAPTURE_INDEX_MAGIC)) != 0) {
+        throw std::invalid_argument("Not a frame capture index: " + indexPath);
+    }
+    if (indexHeader().version != FRAME_CAPTURE_VERSION) {
+        throw std::invalid_argument("Unsupported frame capture version " + std::to_string(indexHeader().version) + ": " + indexPath);
+    }
+    base = indexPath.substr(0, indexPath.size() - suffix.size());
+    if (segmentCount() > 0) {
+        openSegment(0);
+    }
+}
+
+const FrameCaptureIndexEntry& FrameCaptureReader::entry(std::uint64_t i) const {
+    return *reinterpret_cast<const FrameCaptureIndexEntry*>(index.data() + indexFileBytes(i));
+}
+
+void FrameCaptureReader::openSegment(std::uint32_t number) {
+    const std::string path = frameCaptureSegmentPath(base, number);
+    segment = std::make_unique<MappedFile>(path, MappedFile::Mode::ReadOnly);
+    if (segment->size() < sizeof(FrameCaptureSegmentHeader) || std::memcmp(segmentHeader().magic, FRAME_CAPTURE_SEGMENT_MAGIC, sizeof(FRAME_CAPTURE_SEGMENT_MAGIC)) != 0) {
+        throw std::invalid_argument("Not a frame capture segment: " + path);
+    }
+    segmentNumber = number;
+    offset = sizeof(FrameCaptureSegmentHeader);
+}
+
+bool FrameCaptureReader::next(CapturedFrame& frame) {
+    if (!segment) {
+        return false;
+    }
+    while (offset >= std::min<std::uint64_t>(segmentHeader().bytesUsed, segment->size())) {
+        if (segmentNumber + 1 >= segmentCount()) {
+            return false;
+        }
+        openSegment(segmentNumber + 1);
+    }
+
+    FrameRecordHeader record;
+    std::memcpy(&record, segment->data() + offset, sizeof(record));
+    if (offset + recordBytes(record.length) > segment->size()) {
+        throw std::invalid_argument("Truncated frame record in " + segment->path());
+    }
+    frame.receiveTimeNs = record.receiveTimeNs;
+    frame.data = std::string_view(segment->data() + offset + sizeof(record), record.length);
+    offset += recordBytes(record.length);
+    return true;
+}
+
+void FrameCaptureReader::seek(std::int64_t timeNs) {
+    if (segmentCount() == 0) {
+        return;
+    }
+
+    // Start from the last entry before timeNs, every frame between it and the next entry is scanned
+    std::uint64_t lo = 0;
+    std::uint64_t hi = indexSize();
+    while (lo < hi) {
+        const std::uint64_t mid = lo + (hi - lo) / 2;
+        if (entry(mid).receiveTimeNs < timeNs) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        openSegment(0);
+    } else {
+        const FrameCaptureIndexEntry& start = entry(lo - 1);
+        if (!segment || segmentNumber != start.segment) {
+            openSegment(start.segment);
+        }
+        offset = start.offset;
+    }
+
+    for (;;) {
+        const std::uint32_t recordSegment = segmentNumber;
+        const std::uint64_t recordOffset = offset;
+        CapturedFrame frame;
+        if (!next(frame)) {
+            return;
+        }
+        if (frame.receiveTimeNs >= timeNs) {
+            // Step back so next() returns this frame
+            if (segmentNumber != recordSegment) openSegment(recordSegment);
+            offset = recordOffset;
+            return;
+        }
+    }
+}
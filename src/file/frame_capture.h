@@ -0,0 +1,194 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "file/mapped_file.h"
+
+/*
+ * Raw frame capture layout, all values little endian. A capture named <base> is
+ *
+ *   <base>.idx                       FrameCaptureIndexHeader then FrameCaptureIndexEntry records
+ *   <base>-000000.seg, -000001, ...  FrameCaptureSegmentHeader then frame records
+ *
+ * Each frame record is a FrameRecordHeader followed by the frame bytes, padded to a multiple of
+ * 8 bytes. A segment holds records up to bytesUsed; the header counts are updated after every
+ * record, so a killed writer leaves readable segments. The index holds the first record of every
+ * segment plus one record per indexIntervalNs of receive time, enough to seek a multi-hour
+ * capture without reading the segments before the one wanted.
+ */
+
+constexpr char FRAME_CAPTURE_INDEX_MAGIC[8] = {'T', 'R', 'I', 'C', 'I', 'D', 'X', '\0'};
+constexpr char FRAME_CAPTURE_SEGMENT_MAGIC[8] = {'T', 'R', 'I', 'C', 'S', 'E', 'G', '\0'};
+constexpr std::uint32_t FRAME_CAPTURE_VERSION = 1;
+
+struct FrameCaptureIndexHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t segmentCount;
+    std::uint64_t segmentBytes;     // Preallocated size of each segment
+    std::uint64_t entryCount;       // Updated after every entry
+    std::int64_t indexIntervalNs;
+    std::uint64_t reserved[3];
+};
+
+struct FrameCaptureIndexEntry {
+    std::int64_t receiveTimeNs;
+    std::uint32_t segment;
+    std::uint32_t reserved;
+    std::uint64_t offset;           // Of the record within its segment
+};
+
+struct FrameCaptureSegmentHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t segment;
+    std::uint64_t bytesUsed;        // End of the last complete record
+    std::uint64_t recordCount;
+    std::int64_t firstReceiveTimeNs;
+    std::int64_t lastReceiveTimeNs;
+    std::uint64_t reserved[2];
+};
+
+struct FrameRecordHeader {
+    std::uint32_t length;
+    std::uint32_t reserved;
+    std::int64_t receiveTimeNs;
+};
+
+static_assert(sizeof(FrameCaptureIndexHeader) == 64, "Header layout is part of the file format");
+static_assert(sizeof(FrameCaptureIndexEntry) == 24, "Entry layout is part of the file format");
+static_assert(sizeof(FrameCaptureSegmentHeader) == 64, "Header layout is part of the file format");
+static_assert(sizeof(FrameRecordHeader) == 16, "Record layout is part of the file format");
+
+// Path of segment number of the capture named base
+std::string frameCaptureSegmentPath(const std::string& base, std::uint32_t segment);
+
+struct CaptureConfig {
+    std::string directory;        // Main writes each session's captures to a subdirectory of this, empty disables capture
+    std::size_t segmentBytes;     // Segments rotate at this size
+    std::int64_t indexIntervalNs; // Receive time between index entries
+
+    explicit CaptureConfig(std::string dir = "", std::size_t segmentMb = 256, double indexIntervalMs = 100)
+        : directory(std::move(dir)),
+          segmentBytes(segmentMb << 20),
+          indexIntervalNs(static_cast<std::int64_t>(indexIntervalMs * 1e6)) {}
+
+    bool enabled() const { return !directory.empty(); }
+
+    // Reads BINANCE_CAPTURE_DIR, BINANCE_CAPTURE_SEGMENT_MB and BINANCE_CAPTURE_INDEX_INTERVAL_MS
+    static CaptureConfig from_env() {
+        const char* env_dir = std::getenv("BINANCE_CAPTURE_DIR");
+        const char* env_segment_mb = std::getenv("BINANCE_CAPTURE_SEGMENT_MB");
+        const char* env_index_interval = std::getenv("BINANCE_CAPTURE_INDEX_INTERVAL_MS");
+
+        return CaptureConfig(
+            env_dir ? env_dir : "",
+            env_segment_mb ? std::stoul(env_segment_mb) : 256,
+            env_index_interval ? std::stod(env_index_interval) : 100
+        );
+    }
+};
+
+/**
+ * @brief Creates a new subdirectory of directory for one session's captures and returns its path.
+ *
+ * Named after the UTC start time, e.g. 20240101-120000, with -1, -2, ... appended if a session
+ * started in the same second. Throws std::runtime_error if it cannot be created.
+ */
+std::string createCaptureSessionDirectory(const std::string& directory);
+
+/**
+ * @class FrameCaptureWriter
+ * @brief Appends raw frames with their receive time to a memory-mapped, segment-rotated log.
+ *
+ * Segments are preallocated, so appending a frame is a copy into the mapping and a few header
+ * stores. Opening the next segment or growing the index are the only system calls, once per
+ * segment and per few thousand index entries. Receive times are expected not to go backwards,
+ * seeking relies on it. Not thread safe, each connection has its own writer.
+ *
+ * Throws std::runtime_error if a capture named base already exists, rather than truncating it.
+ */
+class FrameCaptureWriter {
+public:
+    explicit FrameCaptureWriter(const std::string& base,
+                                std::size_t segmentBytes = 256 << 20,
+                                std::int64_t indexIntervalNs = 100'000'000);
+
+    // Trims the last segment to the records in use
+    ~FrameCaptureWriter();
+
+    FrameCaptureWriter(const FrameCaptureWriter&) = delete;
+    FrameCaptureWriter& operator=(const FrameCaptureWriter&) = delete;
+
+    void append(std::string_view frame, std::int64_t receiveTimeNs);
+
+    std::uint64_t getFrames() const { return frames; }
+    std::uint32_t getSegments() const { return indexHeader().segmentCount; }
+
+private:
+    const std::string base;
+    const std::size_t segmentBytes;
+    const std::int64_t indexIntervalNs;
+
+    MappedFile index;
+    std::size_t indexCapacity;
+    std::unique_ptr<MappedFile> segment;
+    std::int64_t nextIndexTimeNs;
+    std::uint64_t frames;
+    bool failed;
+
+    FrameCaptureIndexHeader& indexHeader() { return *reinterpret_cast<FrameCaptureIndexHeader*>(index.data()); }
+    const FrameCaptureIndexHeader& indexHeader() const { return *reinterpret_cast<const FrameCaptureIndexHeader*>(index.data()); }
+    FrameCaptureSegmentHeader& segmentHeader() { return *reinterpret_cast<FrameCaptureSegmentHeader*>(segment->data()); }
+
+    void rotate(std::size_t recordBytes);
+    void closeSegment();
+    void addIndexEntry(std::int64_t receiveTimeNs, std::uint64_t offset);
+};
+
+struct CapturedFrame {
+    std::int64_t receiveTimeNs = 0;
+    std::string_view data;
+};
+
+/**
+ * @class FrameCaptureReader
+ * @brief Reads the frames of a capture in order, from the start or from a receive time.
+ *
+ * Only one segment is mapped at a time, so a frame's data is only valid until the next call.
+ *
+ * @throws std::invalid_argument if the index or a segment is not a capture file of a supported version
+ */
+class FrameCaptureReader {
+public:
+    // indexPath is the capture's .idx file
+    explicit FrameCaptureReader(const std::string& indexPath);
+
+    // False once every frame has been read
+    bool next(CapturedFrame& frame);
+
+    // Positions the reader on the first frame received at or after timeNs
+    void seek(std::int64_t timeNs);
+
+    std::uint32_t segmentCount() const { return indexHeader().segmentCount; }
+    std::uint64_t indexSize() const { return indexHeader().entryCount; }
+
+private:
+    MappedFile index;
+    std::string base;
+    std::unique_ptr<MappedFile> segment;
+    std::uint32_t segmentNumber;
+    std::uint64_t offset;
+
+    const FrameCaptureIndexHeader& indexHeader() const { return *reinterpret_cast<const FrameCaptureIndexHeader*>(index.data()); }
+    const FrameCaptureIndexEntry& entry(std::uint64_t i) const;
+    const FrameCaptureSegmentHeader& segmentHeader() const { return *reinterpret_cast<const FrameCaptureSegmentHeader*>(segment->data()); }
+
+    void openSegment(std::uint32_t number);
+};
+
+#endif // FRAME_CAPTURE_H
@@ -0,0 +1,175 @@
+#include "file/mapped_file.h"
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::runtime_error mappingError(const std::string& action, const std::string& path) {
+#ifdef _WIN32
+    return std::runtime_error(action + " " + path + " failed, error " + std::to_string(GetLastError()));
+#else
+    return std::runtime_error(action + " " + path + " failed: " + std::strerror(errno));
+#endif
+}
+
+} // namespace
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path, Mode mode, std::size_t initialSize)
+    : filePath(path), mode(mode), mapping(nullptr), length(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {
+    const bool writable = mode == Mode::ReadWrite;
+    fileHandle = CreateFileA(path.c_str(),
+                             writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                             FILE_SHARE_READ,
+                             nullptr,
+                             writable ? CREATE_ALWAYS : OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        throw mappingError("Opening", path);
+    }
+
+    if (writable) {
+        length = initialSize;
+    } else {
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(fileHandle, &fileSize);
+        length = static_cast<std::size_t>(fileSize.QuadPart);
+    }
+    map();
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+    }
+}
+
+void MappedFile::resize(std::size_t newSize) {
+    unmap();
+    length = newSize;
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(newSize);
+    if (!SetFilePointerEx(fileHandle, size, nullptr, FILE_BEGIN) || !SetEndOfFile(fileHandle)) {
+        throw mappingError("Resizing", filePath);
+    }
+    map();
+}
+
+void MappedFile::flush() {
+    if (mapping) {
+        FlushViewOfFile(mapping, 0);
+    }
+}
+
+void MappedFile::map() {
+    if (length == 0) return;
+    const bool writable = mode == Mode::ReadWrite;
+    const DWORD high = static_cast<DWORD>(static_cast<unsigned long long>(length) >> 32);
+    const DWORD low = static_cast<DWORD>(length & 0xFFFFFFFFu);
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, high, low, nullptr);
+    if (!mappingHandle) {
+        throw mappingError("Mapping", filePath);
+    }
+    mapping = static_cast<char*>(MapViewOfFile(mappingHandle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, length));
+    if (!mapping) {
+        throw mappingError("Mapping", filePath);
+    }
+}
+
+void MappedFile::unmap() {
+    if (mapping) {
+        UnmapViewOfFile(mapping);
+        mapping = nullptr;
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path, Mode mode, std::size_t initialSize)
+    : filePath(path), mode(mode), mapping(nullptr), length(0), fd(-1) {
+    const bool writable = mode == Mode::ReadWrite;
+    fd = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+    if (fd < 0) {
+        throw mappingError("Opening", path);
+    }
+
+    if (writable) {
+        if (::ftruncate(fd, static_cast<off_t>(initialSize)) != 0) {
+            ::close(fd);
+            throw mappingError("Resizing", path);
+        }
+        length = initialSize;
+    } else {
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw mappingError("Reading size of", path);
+        }
+        length = static_cast<std::size_t>(st.st_size);
+    }
+
+    try {
+        map();
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+void MappedFile::resize(std::size_t newSize) {
+    unmap();
+    if (::ftruncate(fd, static_cast<off_t>(newSize)) != 0) {
+        throw mappingError("Resizing", filePath);
+    }
+    length = newSize;
+    map();
+}
+
+void MappedFile::flush() {
+    if (mapping) {
+        ::msync(mapping, length, MS_SYNC);
+    }
+}
+
+void MappedFile::map() {
+    if (length == 0) return;
+    const int protection = mode == Mode::ReadWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* address = ::mmap(nullptr, length, protection, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        throw mappingError("Mapping", filePath);
+    }
+    mapping = static_cast<char*>(address);
+}
+
+void MappedFile::unmap() {
+    if (mapping) {
+        ::munmap(mapping, length);
+        mapping = nullptr;
+    }
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief A file mapped into memory, either read-only or read-write and resizable.
+ *
+ * Writers preallocate the file with resize() and then write through data() with plain stores,
+ * so the hot path never makes a system call. Growing remaps the file, which invalidates any
+ * pointers previously taken from data().
+ *
+ * @throws std::runtime_error from the constructor and resize() when the OS calls fail
+ */
+class MappedFile {
+public:
+    enum class Mode { ReadOnly, ReadWrite };
+
+    // ReadWrite creates the file if missing and truncates it to initialSize
+    MappedFile(const std::string& path, Mode mode, std::size_t initialSize = 0);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Changes the file length and remaps it, contents up to the smaller size are kept
+    void resize(std::size_t newSize);
+
+    // Writes dirty pages back to the file
+    void flush();
+
+    char* data() { return mapping; }
+    const char* data() const { return mapping; }
+    std::size_t size() const { return length; }
+    const std::string& path() const { return filePath; }
+
+private:
+    std::string filePath;
+    Mode mode;
+    char* mapping;
+    std::size_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fd;
+#endif
+
+    void map();
+    void unmap();
+};
+
+#endif // MAPPED_FILE_H
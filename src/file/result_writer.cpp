@@ -0,0 +1,32 @@
+#include "file/result_writer.h"
+#include "file/trade_file_writer.h"
+#include "file/binary_trade_file_writer.h"
+#include "file/async_result_writer.h"
+
+// Stream buffer for text output written from the writer thread, each flush is then one large write
+constexpr std::size_t ASYNC_TEXT_BUFFER_BYTES = 1 << 20;
+
+ResultFileFormat resultFileFormatFromString(const std::string& format) {
+    return format == "binary" ? ResultFileFormat::Binary : ResultFileFormat::Text;
+}
+
+OverflowPolicy overflowPolicyFromString(const std::string& policy) {
+    if (policy == "drop") return OverflowPolicy::Drop;
+    if (policy == "count") return OverflowPolicy::Count;
+    return OverflowPolicy::Block;
+}
+
+std::unique_ptr<ResultWriter> makeResultWriter(ResultFileFormat format, const std::string& filePath,
+                                               const std::optional<AsyncWriterConfig>& asyncConfig) {
+    std::unique_ptr<ResultWriter> writer;
+    if (format == ResultFileFormat::Binary) {
+        writer = std::make_unique<BinaryTradeFileWriter>(filePath);
+    } else {
+        writer = std::make_unique<TradeFileWriter>(filePath, asyncConfig ? ASYNC_TEXT_BUFFER_BYTES : 0);
+    }
+
+    if (asyncConfig) {
+        return std::make_unique<AsyncResultWriter>(std::move(writer), *asyncConfig);
+    }
+    return writer;
+}
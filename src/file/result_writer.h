@@ -0,0 +1,78 @@
+#ifndef RESULT_WRITER_H
+#define RESULT_WRITER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include "common/arbitrage_result.h"
+
+/**
+ * @class ResultWriter
+ * @brief Destination for every ArbitrageResult the server produces.
+ *
+ * write() is called on the tick's hot path and must not keep the result's views past the call.
+ */
+class ResultWriter {
+public:
+    virtual ~ResultWriter() = default;
+
+    virtual void write(const ArbitrageResult& result) = 0;
+
+    // Pushes buffered results to the OS, called after each batch by AsyncResultWriter
+    virtual void flush() {}
+
+    // Bytes written to the destination so far, safe to read from any thread while writes go on
+    virtual std::uint64_t bytesWritten() const { return 0; }
+};
+
+enum class ResultFileFormat {
+    Text,   // TradeFileWriter, one JSON object per line including the raw frame
+    Binary  // BinaryTradeFileWriter, fixed-size records in column blocks
+};
+
+// "binary" selects Binary, anything else Text
+ResultFileFormat resultFileFormatFromString(const std::string& format);
+
+enum class OverflowPolicy {
+    Block, // The hot path waits for the writer thread to free a slot, nothing is lost
+    Drop,  // The result is discarded and counted
+    Count  // As Drop, and each doubling of the drop count is also reported through fail()
+};
+
+// "drop" and "count" select those policies, anything else Block
+OverflowPolicy overflowPolicyFromString(const std::string& policy);
+
+struct AsyncWriterConfig {
+    std::size_t queueCapacity; // Results buffered between the hot path and the writer thread
+    std::size_t batchSize;     // Results written before each flush of the underlying writer, at least 1
+    OverflowPolicy overflowPolicy;
+    double latencyDumpInterval; // Seconds between writer flush latency dumps, 0 disables them
+
+    explicit AsyncWriterConfig(std::size_t capacity = 8192, std::size_t batch = 1024, OverflowPolicy policy = OverflowPolicy::Block, double latencyInterval = 0)
+        : queueCapacity(capacity), batchSize(std::max<std::size_t>(batch, 1)), overflowPolicy(policy), latencyDumpInterval(latencyInterval) {}
+
+    // Reads BINANCE_UPDATE_FILE_QUEUE_CAPACITY, BINANCE_UPDATE_FILE_BATCH_SIZE, BINANCE_UPDATE_FILE_OVERFLOW
+    // and BINANCE_LATENCY_DUMP_INTERVAL
+    static AsyncWriterConfig from_env() {
+        const char* env_queue_capacity = std::getenv("BINANCE_UPDATE_FILE_QUEUE_CAPACITY");
+        const char* env_batch_size = std::getenv("BINANCE_UPDATE_FILE_BATCH_SIZE");
+        const char* env_overflow = std::getenv("BINANCE_UPDATE_FILE_OVERFLOW");
+        const char* env_latency_dump_interval = std::getenv("BINANCE_LATENCY_DUMP_INTERVAL");
+
+        return AsyncWriterConfig(
+            env_queue_capacity ? std::stoul(env_queue_capacity) : 8192,
+            env_batch_size ? std::stoul(env_batch_size) : 1024,
+            overflowPolicyFromString(env_overflow ? env_overflow : "block"),
+            env_latency_dump_interval ? std::stod(env_latency_dump_interval) : 0
+        );
+    }
+};
+
+// With an asyncConfig the writer runs on its own thread behind an AsyncResultWriter
+std::unique_ptr<ResultWriter> makeResultWriter(ResultFileFormat format, const std::string& filePath,
+                                               const std::optional<AsyncWriterConfig>& asyncConfig = std::nullopt);
+
+#endif // RESULT_WRITER_H
@@ -2,9 +2,15 @@
 #include "common/trade_util.h"
 #include <iomanip>
 
-TradeFileWriter::TradeFileWriter(const std::string& filePath)
-    : file_stream_(filePath, std::ios::app), filePath_(filePath)
-{}
+TradeFileWriter::TradeFileWriter(const std::string& filePath, std::size_t bufferBytes)
+    : buffer_(bufferBytes), filePath_(filePath)
+{
+    // The buffer has to be installed before the file is opened
+    if (!buffer_.empty()) {
+        file_stream_.rdbuf()->pubsetbuf(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    }
+    file_stream_.open(filePath, std::ios::app);
+}
 
 TradeFileWriter::~TradeFileWriter() {
     if (file_stream_.is_open()) {
@@ -12,9 +18,16 @@ TradeFileWriter::~TradeFileWriter() {
     }
 }
 
+void TradeFileWriter::flush() {
+    if (file_stream_.is_open()) {
+        file_stream_.flush();
+    }
+}
+
 void TradeFileWriter::write(const ArbitrageResult& result) {
     if (file_stream_.is_open()) {
         nlohmann::json tick_json;
+        tick_json["path"] = result.path;
         tick_json["orderBookLevels"] = result.jsonStr;
         tick_json["tickReceiveTime"] = result.tickInitTime;
         tick_json["tickProcessTime"] = result.processTime;
@@ -25,9 +38,14 @@ void TradeFileWriter::write(const ArbitrageResult& result) {
         tick_json["rate1"] = result.rates[0];
         tick_json["rate2"] = result.rates[1];
         tick_json["rate3"] = result.rates[2];
+        tick_json["optimalNotional"] = result.optimalNotional;
+        tick_json["optimalPnl"] = result.optimalPnl;
+        tick_json["breakevenNotional"] = result.breakevenNotional;
 
         // Write the finalized JSON to the file
-        file_stream_ << tick_json.dump() << "\n";
+        const std::string line = tick_json.dump();
+        file_stream_ << line << "\n";
+        bytes.store(bytes.load(std::memory_order_relaxed) + line.size() + 1, std::memory_order_relaxed);
 
         if (!file_stream_.good()) {
             const std::string error_message = "Error writing to file. Stream state: "
@@ -1,20 +1,24 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <fstream>
+#include <vector>
 #include <nlohmann/json.hpp>
 
-#include "common/arbitrage_result.h"
+#include "file/result_writer.h"
 
-class TradeFileWriter {
+class TradeFileWriter : public ResultWriter {
 public:
     // Constructor takes file path, opens file in append mode
-    explicit TradeFileWriter(const std::string& file_path);
+    // A non-zero bufferBytes replaces the stream's default buffer, so batches reach the OS in fewer writes
+    explicit TradeFileWriter(const std::string& file_path, std::size_t bufferBytes = 0);
 
     /**
      * Writes an ArbitrageResult to a text file
      * Inserts the following comma separated details per tick on a new line: 
      * 
+     * - Arbitrage path the result was evaluated for
      * - JSON string representation of the tick
      * - Time the tick was created 
      * - Time the server took to process the tick 
@@ -24,12 +28,18 @@ public:
      * 
      * @param result The ArbitrageResult to write to the file
      */
-    void write(const ArbitrageResult& result);
+    void write(const ArbitrageResult& result) override;
+
+    void flush() override;
+
+    std::uint64_t bytesWritten() const override { return bytes.load(std::memory_order_relaxed); }
 
     // Destructor closes the file
-    ~TradeFileWriter();
+    ~TradeFileWriter() override;
 
 private:
+    std::vector<char> buffer_; // Declared before the stream so it outlives it
     std::ofstream file_stream_;
     std::string filePath_;
+    std::atomic<std::uint64_t> bytes{0}; // Only the writing thread stores, relaxed loads are enough to read
 };
\ No newline at end of file
@@ -6,25 +6,43 @@
 #include <boost/asio/ssl.hpp>
 #include <boost/asio/executor_work_guard.hpp>
 #include "exchange/binance/binance_client.h"
+#include "exchange/binance/connection_manager.h"
+#include "discovery/triangle_discovery.h"
+#include "file/async_result_writer.h"
+#include "common/tsc_clock.h"
+#include "metrics/metrics_server.h"
+#include <fstream>
 #include <memory>
 
 int main() {
 
     const char* env_path = std::getenv("BINANCE_UPDATE_FILE_PATH");
+    const char* env_file_format = std::getenv("BINANCE_UPDATE_FILE_FORMAT");
+    const char* env_file_async = std::getenv("BINANCE_UPDATE_FILE_ASYNC");
     const char* env_target = std::getenv("BINANCE_STREAM_TARGET");
     const char* env_arbitrage_path = std::getenv("BINANCE_ARBITRAGE_PATH");
-    const char* env_profit_threshold = std::getenv("BINANCE_PROFIT_THRESHOLD");
-    const char* env_taker_fee = std::getenv("BINANCE_TAKER_FEE");
-    const char* env_max_starting_notional_fraction = std::getenv("BINANCE_MAX_STARTING_NOTIONAL_FRACTION");
-    const char* env_max_starting_notional_recalc_interval = std::getenv("BINANCE_MAX_STARTING_NOTIONAL_RECALC_INTERVAL");
-    const char* env_use_first_level_only = std::getenv("BINANCE_USE_FIRST_LEVEL_ONLY");
+    const char* env_depth_parser = std::getenv("BINANCE_DEPTH_PARSER");
+    const char* env_discovery_symbol_file = std::getenv("BINANCE_DISCOVERY_SYMBOL_FILE");
+    const char* env_discovery_start_currencies = std::getenv("BINANCE_DISCOVERY_START_CURRENCIES");
+    const char* env_discovery_stream = std::getenv("BINANCE_DISCOVERY_STREAM");
+    const char* env_pipeline = std::getenv("BINANCE_PIPELINE");
+    const char* env_stream_host = std::getenv("BINANCE_STREAM_HOST");
+    const char* env_stream_port = std::getenv("BINANCE_STREAM_PORT");
+    const char* env_metrics_port = std::getenv("BINANCE_METRICS_PORT");
 
-    const std::string host = "stream.binance.com";
-    const std::string port = "9443";
+    // Overridden to point the bot at a local MockBinance server
+    const std::string host = env_stream_host ? env_stream_host : "stream.binance.com";
+    const std::string port = env_stream_port ? env_stream_port : "9443";
 
     const std::string trade_write_file_path = env_path ? env_path : "";
-    const std::string target = env_target ? env_target : "/stream?streams=btcusdt@depth5@100ms/ethbtc@depth5@100ms/ethusdt@depth5@100ms";
-    const std::string arbitrage_path = env_arbitrage_path ? env_arbitrage_path : "btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY";
+    const std::string file_format = env_file_format ? env_file_format : "text";
+    const bool file_async = env_file_async && std::string(env_file_async) == "true";
+    const std::optional<AsyncWriterConfig> async_writer_config =
+        file_async ? std::optional<AsyncWriterConfig>(AsyncWriterConfig::from_env()) : std::nullopt;
+    std::string target = env_target ? env_target : "/stream?streams=btcusdt@depth5@100ms/ethbtc@depth5@100ms/ethusdt@depth5@100ms";
+    std::string arbitrage_path = env_arbitrage_path ? env_arbitrage_path : "btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY";
+    const std::string depth_parser = env_depth_parser ? env_depth_parser : "fast";
+    const bool use_pipeline = env_pipeline && std::string(env_pipeline) == "true";
 
     boost::asio::io_context io_context; 
     auto work_guard = boost::asio::make_work_guard(io_context);
@@ -32,40 +50,149 @@ int main() {
     // Use TLS Version 1.2 
     boost::asio::ssl::context ctx(boost::asio::ssl::context::tlsv12_client);
 
-    ArbitragePath path = ArbitragePath::from_string(arbitrage_path);
+    std::vector<ArbitragePath> paths;
+    if (env_discovery_symbol_file) {
+        // Discovered paths and their subscription replace BINANCE_ARBITRAGE_PATH and BINANCE_STREAM_TARGET
+        std::ifstream symbol_file(env_discovery_symbol_file);
+        if (!symbol_file.is_open()) {
+            std::cerr << "Unable to open symbol file: " << env_discovery_symbol_file << std::endl;
+            return 1;
+        }
+        const TriangleDiscovery discovery(loadSymbolInfo(symbol_file));
+        paths = discovery.findPaths(splitCurrencies(env_discovery_start_currencies ? env_discovery_start_currencies : "usdt"));
+        if (paths.empty()) {
+            std::cerr << "No triangular paths found in symbol file: " << env_discovery_symbol_file << std::endl;
+            return 1;
+        }
+        target = TriangleDiscovery::streamTarget(paths, env_discovery_stream ? env_discovery_stream : DEFAULT_DISCOVERY_STREAM);
+        arbitrage_path.clear();
+        for (const auto& path : paths) {
+            arbitrage_path += (arbitrage_path.empty() ? "" : ";") + path.to_string();
+        }
+    } else {
+        paths = ArbitragePath::list_from_string(arbitrage_path);
+    }
 
-    ServerConfig server_config(
-        env_profit_threshold ? std::stod(env_profit_threshold) : 0,
-        env_taker_fee ? std::stod(env_taker_fee) : 0,
-        env_max_starting_notional_fraction ? std::stod(env_max_starting_notional_fraction) : 1,
-        env_max_starting_notional_recalc_interval ? std::stod(env_max_starting_notional_recalc_interval) : 0,
-        env_use_first_level_only ? std::string(env_use_first_level_only) == "true" : true
-    );
+    const ServerConfig server_config = ServerConfig::from_env();
+    const ConnectionConfig connection_config = ConnectionConfig::from_env();
+    const TransportConfig transport_config = TransportConfig::from_env();
+    const ClockConfig clock_config = ClockConfig::from_env();
+    try {
+        BinanceClient::configure_tls(ctx, transport_config);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    const DepthParserMode parser_mode = depthParserModeFromString(depth_parser);
 
-    auto client = std::make_shared<BinanceClient>(io_context,ctx);
+    // Best bid and ask streams carry one level per side, which is all first-level-only mode reads
+    const bool book_ticker = isBookTickerStream(target);
 
-    if (trade_write_file_path.empty()) {
-        auto server = std::make_shared<Server>(path, server_config);
-        client->set_callback(server);
-    } else {
-        auto server = std::make_shared<Server>(path, server_config, std::make_unique<TradeFileWriter>(trade_write_file_path));
-        client->set_callback(server);
+    // Diff streams are only usable on top of a snapshot, which has to come from somewhere
+    const bool diff_depth = !book_ticker && isDiffDepthStream(target);
+    std::shared_ptr<SnapshotProvider> snapshots;
+    if (diff_depth) {
+        snapshots = SnapshotProvider::from_env();
+        if (!snapshots) {
+            std::cerr << "Diff depth streams need BINANCE_SNAPSHOT_DIR or BINANCE_SNAPSHOT_ENDPOINT to sync from" << std::endl;
+            return 1;
+        }
     }
 
+    // Stamps both the ticks and the results, the clients read it through the server
+    const std::shared_ptr<const Clock> clock = makeClock(clock_config);
+    const std::shared_ptr<Server> server = trade_write_file_path.empty()
+        ? std::make_shared<Server>(paths, server_config, clock)
+        : std::make_shared<Server>(paths, server_config, makeResultWriter(resultFileFormatFromString(file_format), trade_write_file_path, async_writer_config), clock);
+
     std::cout << "Starting Triangular Arbitrage Bot" << std::endl;
     std::cout << "########### CONFIGURATION ###########" << std::endl;
-    std::cout << "Writing results to: " << trade_write_file_path << std::endl;
-    std::cout << "Websocket Stream Target: " << target << std::endl;
-    std::cout << "Arbitrage Path to Search: " << arbitrage_path << std::endl;
+    std::cout << "Writing results to: " << trade_write_file_path << " (" << file_format << (file_async ? ", async" : "") << ")" << std::endl;
+    std::cout << "Websocket Stream: " << host << ":" << port << target << std::endl;
+    std::cout << "Arbitrage Paths to Search (" << paths.size() << "): " << arbitrage_path << std::endl;
     std::cout << "Profit Threshold: " << server_config.profitThreshold << std::endl;
     std::cout << "Taker Fee: " << server_config.takerFee << std::endl;
     std::cout << "Max Starting Notional Fraction: " << server_config.maxStartingNotionalFraction << std::endl;
     std::cout << "Max Starting Notional Recalc Interval: " << server_config.maxStartingNotionalRecalcInterval << std::endl;
     std::cout << "Use First Level Only: " << (server_config.useFirstLevelOnly ? "true" : "false") << std::endl;
+    std::cout << "Depth Parser: " << depth_parser << std::endl;
+    if (book_ticker) {
+        std::cout << "Depth Stream: bookTicker (best level only)" << std::endl;
+    } else {
+        std::cout << "Depth Stream: " << (diff_depth ? "diff, local full book" : "partial") << " (up to " << ORDER_BOOK_MAX_DEPTH << " levels evaluated)" << std::endl;
+    }
+    if (const auto* tsc_clock = dynamic_cast<const TscClock*>(clock.get())) {
+        std::cout << "Clock: " << (tsc_clock->usesTsc() ? "TSC at " + std::to_string(tsc_clock->ticksPerSecond() / 1e6) + " MHz" : "steady_clock, no invariant TSC")
+                  << ", recalibrated every " << clock_config.recalibrationInterval.count() << " ms" << std::endl;
+    } else {
+        std::cout << "Clock: system_clock" << std::endl;
+    }
+    std::cout << "Latency Dump Interval: " << server_config.latencyDumpInterval << std::endl;
+    std::cout << "Connections: " << connection_config.connections << " on " << connection_config.ioThreads << " IO thread(s)" << std::endl;
+    std::cout << "Throughput Report Interval: " << connection_config.throughputReportInterval << std::endl;
+    std::cout << "Transport: TCP_NODELAY " << (transport_config.tcpNoDelay ? "on" : "off")
+              << ", SO_RCVBUF " << (transport_config.receiveBufferBytes > 0 ? std::to_string(transport_config.receiveBufferBytes) : "default")
+              << ", permessage-deflate " << (transport_config.permessageDeflate ? "on" : "off")
+              << ", read buffer " << (transport_config.readBufferBytes > 0 ? std::to_string(transport_config.readBufferBytes) : "default")
+              << ", TLS ciphers " << (transport_config.tlsCiphers.empty() ? "default" : transport_config.tlsCiphers)
+              << (transport_config.busyPoll ? ", busy-polling" : "") << std::endl;
+    if (use_pipeline) {
+        const PipelineConfig pipeline_config = PipelineConfig::from_env();
+        std::cout << "Compute Pipeline: queue " << pipeline_config.queueCapacity << " per connection, compute CPU "
+                  << (pipeline_config.computeCpu >= 0 ? std::to_string(pipeline_config.computeCpu) : "unpinned") << std::endl;
+    } else {
+        std::cout << "Compute Pipeline: off, evaluating on the IO threads" << std::endl;
+    }
+    const CaptureConfig capture_config = CaptureConfig::from_env();
+    // Every run captures into its own directory, so a restart never truncates an earlier session
+    std::string capture_session;
+    if (capture_config.enabled()) {
+        try {
+            capture_session = createCaptureSessionDirectory(capture_config.directory);
+        } catch (const std::runtime_error& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Frame Capture: " << capture_session << " (" << (capture_config.segmentBytes >> 20) << " MB segments)" << std::endl;
+    }
     std::cout << "######################################" << std::endl;
 
-    client->async_connect(host, port, target);
+    ConnectionManager connections(io_context, ctx, connection_config);
+    connections.set_transport(transport_config);
+    std::shared_ptr<ComputePipeline> pipeline;
+    if (use_pipeline) {
+        pipeline = std::make_shared<ComputePipeline>(server, PipelineConfig::from_env());
+        connections.set_pipeline(pipeline);
+    }
+    std::size_t captured_connections = 0;
+    connections.connect(host, port, target, server, [&](BinanceClient& client) {
+        client.set_parser_mode(parser_mode);
+        client.set_book_ticker(book_ticker);
+        // Each connection keeps the local books of its own symbols, all synced from the same provider
+        if (diff_depth) client.set_depth_snapshots(snapshots);
+        // One capture per connection, so appending never contends with another IO thread
+        if (capture_config.enabled()) {
+            const std::string base = capture_session + "/connection-" + std::to_string(captured_connections++);
+            client.set_capture(std::make_unique<FrameCaptureWriter>(base, capture_config.segmentBytes, capture_config.indexIntervalNs));
+        }
+    });
+
+    if (pipeline) pipeline->start();
+
+    // Loopback only, scraping reads the same relaxed counters the throughput report does
+    std::unique_ptr<MetricsServer> metrics;
+    if (env_metrics_port) {
+        metrics = std::make_unique<MetricsServer>(static_cast<unsigned short>(std::stoul(env_metrics_port)),
+            [&server, &connections](std::ostream& out) { writeMetrics(out, *server, &connections); });
+        try {
+            metrics->start();
+        } catch (const std::exception& e) {
+            std::cerr << "Unable to serve metrics on port " << env_metrics_port << ": " << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Serving metrics on http://127.0.0.1:" << metrics->port() << "/metrics" << std::endl;
+    }
 
-    io_context.run();
+    connections.run();
     return 0;
 }
\ No newline at end of file
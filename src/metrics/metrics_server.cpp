@@ -0,0 +1,203 @@
+#include "metrics/metrics_server.h"
+#include "exchange/binance/connection_manager.h"
+#include "file/async_result_writer.h"
+#include "server/arbitrage_server.h"
+#include "common/trade_util.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <boost/asio/ip/address_v4.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+namespace beast = boost::beast;
+namespace http = boost::beast::http;
+using tcp = boost::asio::ip::tcp;
+
+namespace {
+
+// A scraper that connects and sends nothing is dropped after this long
+constexpr std::chrono::seconds REQUEST_TIMEOUT{5};
+
+void describe(std::ostream& out, const char* name, const char* type, const char* help) {
+    out << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+}
+
+// Label values as the exposition format quotes them
+std::string escapeLabel(std::string_view value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (const char c : value) {
+        if (c == '\\' || c == '"') escaped += '\\';
+        if (c == '\n') {
+            escaped += "\\n";
+            continue;
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+std::uint64_t load(const std::atomic<std::uint64_t>& counter) {
+    return counter.load(std::memory_order_relaxed);
+}
+
+// One counter per connection, labelled with the connection's name
+template <typename Value>
+void perConnection(std::ostream& out, const std::vector<ConnectionManager::Connection>& connections,
+                   const char* name, const char* type, const char* help, Value value) {
+    describe(out, name, type, help);
+    for (const auto& connection : connections) {
+        out << name << "{connection=\"" << escapeLabel(connection.client->getName()) << "\"} "
+            << value(connection.client->getCounters()) << '\n';
+    }
+}
+
+/**
+ * One request per connection: read it, answer it, close.
+ */
+class MetricsSession : public std::enable_shared_from_this<MetricsSession> {
+public:
+    MetricsSession(tcp::socket&& socket, const MetricsServer::Collector& collect, std::atomic<std::uint64_t>& scrapes)
+        : stream(std::move(socket)), collect(collect), scrapes(scrapes) {}
+
+    void start() {
+        stream.expires_after(REQUEST_TIMEOUT);
+        http::async_read(stream, buffer, request, [self = shared_from_this()](beast::error_code ec, std::size_t) {
+            if (!ec) self->respond();
+        });
+    }
+
+private:
+    void respond() {
+        const beast::string_view target = request.target();
+        const beast::string_view path = target.substr(0, target.find('?'));
+        response.version(request.version());
+        response.keep_alive(false);
+        if (request.method() == http::verb::get && path == "/metrics") {
+            std::ostringstream body;
+            collect(body);
+            response.result(http::status::ok);
+            response.set(http::field::content_type, "text/plain; version=0.0.4; charset=utf-8");
+            response.body() = body.str();
+            scrapes.store(scrapes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        } else {
+            response.result(http::status::not_found);
+            response.set(http::field::content_type, "text/plain");
+            response.body() = "Only GET /metrics is served\n";
+        }
+        response.prepare_payload();
+
+        stream.expires_after(REQUEST_TIMEOUT);
+        http::async_write(stream, response, [self = shared_from_this()](beast::error_code, std::size_t) {
+            beast::error_code ec;
+            self->stream.socket().shutdown(tcp::socket::shutdown_send, ec);
+        });
+    }
+
+    beast::tcp_stream stream;
+    beast::flat_buffer buffer;
+    http::request<http::string_body> request;
+    http::response<http::string_body> response;
+    const MetricsServer::Collector& collect;
+    std::atomic<std::uint64_t>& scrapes; // Only bumped on the server's single thread
+};
+
+} // namespace
+
+void writeMetrics(std::ostream& out, const Server& server, const ConnectionManager* connections) {
+    if (connections) {
+        const auto& list = connections->getConnections();
+        perConnection(out, list, "arbitrage_connection_frames_total", "counter", "Websocket frames received.",
+                      [](const ConnectionCounters& c) { return load(c.frames); });
+        perConnection(out, list, "arbitrage_connection_bytes_total", "counter", "Websocket payload bytes received.",
+                      [](const ConnectionCounters& c) { return load(c.bytes); });
+        perConnection(out, list, "arbitrage_connection_updates_total", "counter", "Ticks handed to the server or its compute pipeline.",
+                      [](const ConnectionCounters& c) { return load(c.updates); });
+        perConnection(out, list, "arbitrage_connection_parse_errors_total", "counter", "Frames that failed to parse.",
+                      [](const ConnectionCounters& c) { return load(c.parseErrors); });
+        perConnection(out, list, "arbitrage_connection_reconnects_total", "counter", "Reconnects after a read error.",
+                      [](const ConnectionCounters& c) { return load(c.reconnects); });
+        perConnection(out, list, "arbitrage_connection_busy_seconds_total", "counter", "Time spent handling frames.",
+                      [](const ConnectionCounters& c) { return static_cast<double>(load(c.busyNs)) / 1e9; });
+
+        // Stream names come from each connection's target, their counts from the symbol they carry
+        const SymbolTable& symbols = server.getSymbolTable();
+        describe(out, "arbitrage_stream_frames_total", "counter", "Frames parsed per subscribed stream.");
+        for (const auto& connection : list) {
+            const ConnectionCounters& counters = connection.client->getCounters();
+            const std::string name = escapeLabel(connection.client->getName());
+            for (const std::string& stream : splitStreamTarget(connection.target)) {
+                const SymbolId id = symbols.find(std::string_view(stream).substr(0, stream.find('@')));
+                out << "arbitrage_stream_frames_total{connection=\"" << name << "\",stream=\"" << escapeLabel(stream) << "\"} "
+                    << (id < counters.symbolFrames.size() ? load(counters.symbolFrames[id]) : 0) << '\n';
+            }
+        }
+    }
+
+    const ServerCounters& counters = server.getCounters();
+    describe(out, "arbitrage_ticks_total", "counter", "Updates received for symbols on at least one path.");
+    out << "arbitrage_ticks_total " << load(counters.ticks) << '\n';
+    describe(out, "arbitrage_evaluations_total", "counter", "Path evaluations run, each writing one result.");
+    out << "arbitrage_evaluations_total " << load(counters.evaluations) << '\n';
+    describe(out, "arbitrage_skipped_evaluations_total", "counter", "Path evaluations skipped because no side they trade changed.");
+    out << "arbitrage_skipped_evaluations_total " << load(counters.skippedEvaluations) << '\n';
+    describe(out, "arbitrage_opportunities_total", "counter", "Evaluations clearing the profit threshold.");
+    out << "arbitrage_opportunities_total " << load(counters.opportunities) << '\n';
+
+    const ResultWriter* writer = server.getResultWriter();
+    if (!writer) return;
+    describe(out, "arbitrage_writer_bytes_total", "counter", "Bytes of results written.");
+    out << "arbitrage_writer_bytes_total " << writer->bytesWritten() << '\n';
+    if (const auto* async = dynamic_cast<const AsyncResultWriter*>(writer)) {
+        const AsyncWriterStats stats = async->stats();
+        describe(out, "arbitrage_writer_queue_depth", "gauge", "Results queued for the writer thread.");
+        out << "arbitrage_writer_queue_depth " << std::max(0LL, stats.enqueued - stats.written) << '\n';
+        describe(out, "arbitrage_writer_dropped_total", "counter", "Results dropped because the queue was full.");
+        out << "arbitrage_writer_dropped_total " << stats.dropped << '\n';
+    }
+}
+
+MetricsServer::MetricsServer(unsigned short port, Collector collect)
+    : requestedPort(port), collect(std::move(collect)), acceptor(ioc) {}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+void MetricsServer::start() {
+    const tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), requestedPort);
+    acceptor.open(endpoint.protocol());
+    acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+    acceptor.bind(endpoint);
+    acceptor.listen(boost::asio::socket_base::max_listen_connections);
+    accept();
+    thread = std::thread([this] { ioc.run(); });
+}
+
+void MetricsServer::stop() {
+    if (!thread.joinable()) return;
+    ioc.stop();
+    thread.join();
+    beast::error_code ec;
+    acceptor.close(ec);
+}
+
+unsigned short MetricsServer::port() const {
+    return acceptor.local_endpoint().port();
+}
+
+void MetricsServer::accept() {
+    acceptor.async_accept([this](beast::error_code ec, tcp::socket socket) {
+        if (ec == boost::asio::error::operation_aborted) return;
+        if (ec) {
+            fail(ec, "Metrics Accept");
+        } else {
+            std::make_shared<MetricsSession>(std::move(socket), collect, scrapeCount)->start();
+        }
+        accept();
+    });
+}
@@ -0,0 +1,70 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <thread>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+class ConnectionManager;
+class Server;
+
+/**
+ * @brief Writes the bot's counters and gauges in the Prometheus text exposition format.
+ *
+ * Covers every connection's frames, bytes, updates, parse errors, reconnects and busy time, the
+ * frames parsed on each stream, the server's ticks, evaluations, skipped evaluations and
+ * opportunities, and the result writer's bytes written and, when it is asynchronous, its queue
+ * depth and dropped results. Everything is read with relaxed loads of counters their owners
+ * only ever store to, so a scrape takes no lock the hot path could wait on.
+ *
+ * connections may be null, as when the server is fed by something other than a ConnectionManager.
+ * Its connections must all have been created before the first scrape.
+ */
+void writeMetrics(std::ostream& out, const Server& server, const ConnectionManager* connections);
+
+/**
+ * @class MetricsServer
+ * @brief HTTP endpoint on the loopback interface serving GET /metrics for a Prometheus scraper.
+ *
+ * Runs its own io_context on its own thread, so scrapes never take time from the IO threads.
+ * Each request is answered with whatever collect writes and the connection is then closed.
+ * Any other path gets a 404.
+ */
+class MetricsServer {
+public:
+    using Collector = std::function<void(std::ostream&)>;
+
+    // port 0 lets the OS pick a free one, see port()
+    MetricsServer(unsigned short port, Collector collect);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // Binds 127.0.0.1 and starts serving, throws boost::system::system_error if the port cannot be bound
+    void start();
+
+    // Stops serving and joins the thread, also done on destruction
+    void stop();
+
+    unsigned short port() const;
+
+    // Requests answered with metrics so far
+    std::uint64_t scrapes() const { return scrapeCount.load(std::memory_order_relaxed); }
+
+private:
+    void accept();
+
+    const unsigned short requestedPort;
+    const Collector collect;
+    boost::asio::io_context ioc;
+    boost::asio::ip::tcp::acceptor acceptor;
+    std::atomic<std::uint64_t> scrapeCount{0};
+    std::thread thread;
+};
+
+#endif // METRICS_SERVER_H
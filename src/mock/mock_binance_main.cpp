@@ -0,0 +1,202 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <boost/asio/ssl.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include "common/latency_histogram.h"
+#include "common/tsc_clock.h"
+#include "discovery/triangle_discovery.h"
+#include "exchange/binance/connection_manager.h"
+#include "metrics/metrics_server.h"
+#include "mock/mock_binance_server.h"
+
+namespace {
+
+// Latency of every frame that reached a result, from the send time the mock stamped as its update id
+class FrameLatencyWriter : public ResultWriter {
+public:
+    LatencyHistogram histogram;
+    std::uint64_t results = 0;
+
+    void write(const ArbitrageResult& result) override {
+        results++;
+        // Every path on the tick's symbol writes a result, the frame is only counted once
+        const long long sentNs = frameUpdateId(result.jsonStr);
+        if (sentNs < 0 || sentNs == lastSentNs) return;
+        lastSentNs = sentNs;
+        const long long nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        histogram.record(nowNs - sentNs);
+    }
+
+private:
+    long long lastSentNs = -1;
+};
+
+void printServer(const MockServerConfig& config, const MockBinanceServer& mock, double seconds) {
+    const MockServerStats& stats = mock.getStats();
+    const std::uint64_t frames = stats.frames.load(std::memory_order_relaxed);
+    std::cout << "Mock Connections: " << stats.connections.load(std::memory_order_relaxed)
+              << ", target " << config.rate << " frames/s each" << std::endl;
+    std::cout << "Mock Sent: " << frames << " frames (" << frames / seconds << " frames/s, "
+              << stats.bytes.load(std::memory_order_relaxed) / seconds / 1024 << " KB/s), "
+              << stats.lateFrames.load(std::memory_order_relaxed) << " late" << std::endl;
+}
+
+} // namespace
+
+/**
+ * Local stand-in for the Binance combined-stream endpoint
+ *
+ * Usage: MockBinance serve [seconds]
+ *        MockBinance selftest [seconds]
+ *
+ * serve listens until stopped, or for the given seconds, for Main to connect to through
+ * BINANCE_STREAM_HOST and BINANCE_STREAM_PORT. selftest runs the bot in the same process
+ * against the mock for 10 seconds by default, over loopback, and reports the frames per second
+ * it sustained and the latency from a frame being sent to its result being written. The mock
+ * reads the BINANCE_MOCK_* variables described in MockServerConfig::from_env, the bot the same
+ * variables as Main, transport and metrics options included. selftest needs TLS, which is all BinanceClient
+ * speaks.
+ */
+int main(int argc, char* argv[]) {
+
+    const std::string mode = argc > 1 ? argv[1] : "";
+    if (mode != "serve" && mode != "selftest") {
+        std::cerr << "Usage: " << argv[0] << " <serve|selftest> [seconds]" << std::endl;
+        return 1;
+    }
+    const double seconds = argc > 2 ? std::stod(argv[2]) : (mode == "serve" ? 0 : 10);
+    const MockServerConfig mock_config = MockServerConfig::from_env();
+
+    boost::asio::io_context mock_ioc;
+    MockBinanceServer mock(mock_ioc, mock_config);
+    try {
+        mock.start();
+    } catch (const std::exception& e) {
+        std::cerr << "Unable to listen on " << mock_config.address << ":" << mock_config.port << ": " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "########### MOCK BINANCE ###########" << std::endl;
+    std::cout << "Listening on " << (mock_config.tls ? "wss://" : "ws://") << mock_config.address << ":" << mock.port()
+              << " (BINANCE_STREAM_HOST=" << mock_config.address << " BINANCE_STREAM_PORT=" << mock.port() << ")" << std::endl;
+    std::cout << "Frames: " << (mock_config.framesPath.empty() ? "synthetic, " + std::to_string(mock_config.levels) + " levels" : mock_config.framesPath)
+              << " at " << mock_config.rate << " per second per connection" << std::endl;
+
+    if (mode == "serve") {
+        boost::asio::steady_timer stop_timer(mock_ioc);
+        if (seconds > 0) {
+            stop_timer.expires_after(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds)));
+            stop_timer.async_wait([&](boost::beast::error_code) { mock_ioc.stop(); });
+        }
+        const auto start = std::chrono::steady_clock::now();
+        mock_ioc.run();
+        printServer(mock_config, mock, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        std::cout << "####################################" << std::endl;
+        return 0;
+    }
+
+    if (!mock_config.tls) {
+        std::cerr << "selftest connects with BinanceClient, which needs BINANCE_MOCK_TLS=true" << std::endl;
+        return 1;
+    }
+
+    const char* env_target = std::getenv("BINANCE_STREAM_TARGET");
+    const char* env_arbitrage_path = std::getenv("BINANCE_ARBITRAGE_PATH");
+    const char* env_depth_parser = std::getenv("BINANCE_DEPTH_PARSER");
+    const char* env_pipeline = std::getenv("BINANCE_PIPELINE");
+
+    const std::vector<ArbitragePath> paths = ArbitragePath::list_from_string(
+        env_arbitrage_path ? env_arbitrage_path : "btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY");
+    const std::string target = env_target ? env_target : TriangleDiscovery::streamTarget(paths, "@depth5@100ms");
+    const DepthParserMode parser_mode = depthParserModeFromString(env_depth_parser ? env_depth_parser : "fast");
+    const bool use_pipeline = env_pipeline && std::string(env_pipeline) == "true";
+    const ConnectionConfig connection_config = ConnectionConfig::from_env();
+    const TransportConfig transport_config = TransportConfig::from_env();
+    boost::asio::ssl::context ctx(boost::asio::ssl::context::tlsv12_client);
+    try {
+        BinanceClient::configure_tls(ctx, transport_config);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    auto writer = std::make_unique<FrameLatencyWriter>();
+    FrameLatencyWriter& latency = *writer;
+    const auto server = std::make_shared<Server>(paths, ServerConfig::from_env(), std::move(writer), makeClock(ClockConfig::from_env()));
+
+    std::cout << "Self Test: " << seconds << " s, " << paths.size() << " path(s), " << splitStreamTarget(target).size()
+              << " stream(s) over " << connection_config.connections << " connection(s)"
+              << (use_pipeline ? ", compute pipeline" : "") << (transport_config.busyPoll ? ", busy-polling" : "")
+              << (transport_config.permessageDeflate ? ", permessage-deflate" : "") << std::endl;
+
+    std::thread mock_thread([&mock_ioc] { mock_ioc.run(); });
+
+    boost::asio::io_context bot_ioc;
+    ConnectionManager connections(bot_ioc, ctx, connection_config);
+    connections.set_transport(transport_config);
+    std::shared_ptr<ComputePipeline> pipeline;
+    if (use_pipeline) {
+        pipeline = std::make_shared<ComputePipeline>(server, PipelineConfig::from_env());
+        connections.set_pipeline(pipeline);
+    }
+    connections.connect(mock_config.address, std::to_string(mock.port()), target, server, [&](BinanceClient& client) {
+        client.set_parser_mode(parser_mode);
+        client.set_book_ticker(isBookTickerStream(target));
+    });
+    if (pipeline) pipeline->start();
+
+    std::unique_ptr<MetricsServer> metrics;
+    if (const char* env_metrics_port = std::getenv("BINANCE_METRICS_PORT")) {
+        metrics = std::make_unique<MetricsServer>(static_cast<unsigned short>(std::stoul(env_metrics_port)),
+            [&server, &connections](std::ostream& out) { writeMetrics(out, *server, &connections); });
+        try {
+            metrics->start();
+        } catch (const std::exception& e) {
+            std::cerr << "Unable to serve metrics on port " << env_metrics_port << ": " << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Serving metrics on http://127.0.0.1:" << metrics->port() << "/metrics" << std::endl;
+    }
+
+    boost::asio::steady_timer stop_timer(bot_ioc);
+    stop_timer.expires_after(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds)));
+    stop_timer.async_wait([&](boost::beast::error_code) {
+        mock.stop();
+        bot_ioc.stop();
+    });
+    connections.run();
+    if (metrics) metrics->stop();
+    if (pipeline) pipeline->stop();
+    mock_ioc.stop();
+    mock_thread.join();
+
+    std::uint64_t frames = 0;
+    std::uint64_t updates = 0;
+    std::uint64_t parse_errors = 0;
+    std::uint64_t reconnects = 0;
+    for (const auto& connection : connections.getConnections()) {
+        const ConnectionCounters& counters = connection.client->getCounters();
+        frames += counters.frames.load(std::memory_order_relaxed);
+        updates += counters.updates.load(std::memory_order_relaxed);
+        parse_errors += counters.parseErrors.load(std::memory_order_relaxed);
+        reconnects += counters.reconnects.load(std::memory_order_relaxed);
+    }
+
+    printServer(mock_config, mock, seconds);
+    std::cout << "Bot Received: " << frames << " frames (" << frames / seconds << " frames/s), "
+              << updates << " updates, " << parse_errors << " parse errors, " << reconnects << " reconnects" << std::endl;
+    std::cout << "Evaluations: " << server->getEvaluationStats().evaluations << ", results " << latency.results << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "Send to Result Latency (us): p50 " << latency.histogram.valueAtPercentile(50) / 1e3
+              << "  p90 " << latency.histogram.valueAtPercentile(90) / 1e3
+              << "  p99 " << latency.histogram.valueAtPercentile(99) / 1e3
+              << "  p99.9 " << latency.histogram.valueAtPercentile(99.9) / 1e3
+              << "  max " << latency.histogram.max() / 1e3
+              << "  (" << latency.histogram.count() << " frames)" << std::endl;
+    std::cout << "####################################" << std::endl;
+    return 0;
+}
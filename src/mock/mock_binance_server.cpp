@@ -0,0 +1,434 @@
+#include "mock/mock_binance_server.h"
+#include "common/trade_util.h"
+#include "exchange/binance/connection_manager.h"
+#include "file/frame_capture.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
+#include <boost/asio/ssl.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <nlohmann/json.hpp>
+#include <openssl/evp.h>
+#include <openssl/ec.h>
+#include <openssl/x509.h>
+
+namespace beast = boost::beast;
+namespace websocket = boost::beast::websocket;
+namespace http = boost::beast::http;
+using tcp = boost::asio::ip::tcp;
+
+struct MockBinanceServer::State {
+    const MockServerConfig config;
+    std::unique_ptr<boost::asio::ssl::context> ssl; // Set when serving TLS
+    std::shared_ptr<const std::vector<std::string>> recorded; // Set when serving recorded frames
+    MockServerStats stats;
+    std::atomic<bool> stopped{false};
+    std::atomic<std::uint64_t> nextSeed{1};
+
+    explicit State(const MockServerConfig& config) : config(config) {}
+};
+
+namespace {
+
+// Start of the value after key and its colon, npos if frame has no such key
+std::size_t valueStart(std::string_view frame, std::string_view key) {
+    const std::size_t found = frame.find(key);
+    if (found == std::string_view::npos) return found;
+    std::size_t i = found + key.size();
+    while (i < frame.size() && (frame[i] == ' ' || frame[i] == ':')) ++i;
+    return i < frame.size() ? i : std::string_view::npos;
+}
+
+// Where the update id's digits start in frame, npos if it has none
+std::size_t updateIdStart(std::string_view frame) {
+    const std::size_t depth = valueStart(frame, "\"lastUpdateId\"");
+    return depth != std::string_view::npos ? depth : valueStart(frame, "\"u\"");
+}
+
+std::size_t digitsEnd(std::string_view frame, std::size_t begin) {
+    std::size_t end = begin;
+    while (end < frame.size() && frame[end] >= '0' && frame[end] <= '9') ++end;
+    return end;
+}
+
+void appendNumber(std::string& out, double value) {
+    char digits[32];
+    const int length = std::snprintf(digits, sizeof(digits), "%.8f", value);
+    out.append(digits, static_cast<std::size_t>(length));
+}
+
+// Levels of a partial depth stream, e.g. 20 for btcusdt@depth20@100ms, 0 for any other stream
+std::size_t streamDepth(const std::string& stream) {
+    const std::size_t depth = stream.find("@depth");
+    if (depth == std::string::npos) return 0;
+    std::size_t levels = 0;
+    for (std::size_t i = depth + 6; i < stream.size() && stream[i] >= '0' && stream[i] <= '9'; ++i) {
+        levels = levels * 10 + static_cast<std::size_t>(stream[i] - '0');
+    }
+    return levels;
+}
+
+/**
+ * One accepted connection: TLS handshake if any, HTTP upgrade, then frames until the server
+ * stops or the peer goes away. Everything runs on the socket's strand.
+ */
+template <bool Tls>
+class MockSession : public std::enable_shared_from_this<MockSession<Tls>> {
+public:
+    using NextLayer = std::conditional_t<Tls, beast::ssl_stream<beast::tcp_stream>, beast::tcp_stream>;
+
+    template <typename... StreamArgs>
+    explicit MockSession(std::shared_ptr<MockBinanceServer::State> state, StreamArgs&&... streamArgs)
+        : ws(std::forward<StreamArgs>(streamArgs)...), state(std::move(state)), timer(ws.get_executor()) {}
+
+    void run() {
+        beast::get_lowest_layer(ws).expires_after(std::chrono::seconds(30));
+        if constexpr (Tls) {
+            ws.next_layer().async_handshake(boost::asio::ssl::stream_base::server,
+                [self = this->shared_from_this()](beast::error_code ec) {
+                    if (ec) return fail(ec, "Mock SSL Handshake");
+                    self->readRequest();
+                });
+        } else {
+            readRequest();
+        }
+    }
+
+private:
+    void readRequest() {
+        http::async_read(ws.next_layer(), buffer, request,
+            [self = this->shared_from_this()](beast::error_code ec, std::size_t) { self->onRequest(ec); });
+    }
+
+    void onRequest(beast::error_code ec) {
+        if (ec) return fail(ec, "Mock HTTP Read");
+        if (!websocket::is_upgrade(request)) return fail("Not a websocket upgrade", "Mock HTTP Read");
+
+        beast::get_lowest_layer(ws).expires_never();
+        ws.set_option(websocket::stream_base::timeout::suggested(beast::role_type::server));
+        // Only used when the client offers it, as with BINANCE_WS_DEFLATE
+        websocket::permessage_deflate deflate;
+        deflate.server_enable = true;
+        ws.set_option(deflate);
+        ws.async_accept(request, [self = this->shared_from_this()](beast::error_code ec) { self->onAccept(ec); });
+    }
+
+    void onAccept(beast::error_code ec) {
+        if (ec) return fail(ec, "Mock WS Accept");
+
+        const std::vector<std::string> streams = splitStreamTarget(std::string(request.target()));
+        if (state->recorded) {
+            feed = std::make_unique<MockFeed>(streams, state->recorded);
+        } else {
+            feed = std::make_unique<MockFeed>(streams, state->config.levels, state->nextSeed.fetch_add(1, std::memory_order_relaxed));
+        }
+        if (feed->empty()) {
+            fail(("Nothing to send for " + std::string(request.target())).c_str(), "Mock WS Accept");
+            ws.async_close(websocket::close_code::policy_error, [self = this->shared_from_this()](beast::error_code) {});
+            return;
+        }
+
+        state->stats.connections.fetch_add(1, std::memory_order_relaxed);
+        ws.text(true);
+        start = std::chrono::steady_clock::now();
+        read();
+        send();
+    }
+
+    // Nothing is expected from the client, but reading answers its pings and its close
+    void read() {
+        ws.async_read(incoming, [self = this->shared_from_this()](beast::error_code ec, std::size_t) {
+            if (ec) return;
+            self->incoming.consume(self->incoming.size());
+            self->read();
+        });
+    }
+
+    void send() {
+        if (state->stopped.load(std::memory_order_relaxed)) {
+            ws.async_close(websocket::close_code::normal, [self = this->shared_from_this()](beast::error_code) {});
+            return;
+        }
+
+        // Frame n is due n / rate seconds after the start, the first one straight away
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const auto due = static_cast<std::uint64_t>(elapsed * state->config.rate) + 1;
+        if (sent >= due) {
+            timer.expires_at(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(sent / state->config.rate)));
+            timer.async_wait([self = this->shared_from_this()](beast::error_code ec) {
+                if (!ec) self->send();
+            });
+            return;
+        }
+        if (due - sent > 1) state->stats.lateFrames.fetch_add(1, std::memory_order_relaxed);
+
+        const long long now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        lastUpdateId = std::max(now, lastUpdateId + 1);
+        const std::string& frame = feed->next(lastUpdateId);
+        ws.async_write(boost::asio::buffer(frame), [self = this->shared_from_this()](beast::error_code ec, std::size_t bytes) {
+            self->onWrite(ec, bytes);
+        });
+    }
+
+    void onWrite(beast::error_code ec, std::size_t bytes) {
+        if (ec) {
+            // The peer leaving is how every connection ends, anything else is worth a line
+            if (ec != websocket::error::closed && ec != boost::asio::error::broken_pipe &&
+                ec != boost::asio::error::connection_reset) {
+                fail(ec, "Mock WS Write");
+            }
+            return;
+        }
+        sent++;
+        state->stats.frames.fetch_add(1, std::memory_order_relaxed);
+        state->stats.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        send();
+    }
+
+    websocket::stream<NextLayer> ws;
+    std::shared_ptr<MockBinanceServer::State> state;
+    boost::asio::steady_timer timer;
+    beast::flat_buffer buffer;
+    beast::flat_buffer incoming;
+    http::request<http::string_body> request;
+    std::unique_ptr<MockFeed> feed;
+    std::chrono::steady_clock::time_point start;
+    std::uint64_t sent = 0;
+    long long lastUpdateId = 0;
+};
+
+} // namespace
+
+void useSelfSignedCertificate(boost::asio::ssl::context& ctx) {
+    std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> keyContext(EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr), EVP_PKEY_CTX_free);
+    EVP_PKEY* rawKey = nullptr;
+    if (!keyContext || EVP_PKEY_keygen_init(keyContext.get()) <= 0 ||
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyContext.get(), NID_X9_62_prime256v1) <= 0 ||
+        EVP_PKEY_keygen(keyContext.get(), &rawKey) <= 0) {
+        throw std::runtime_error("Unable to generate a key for the self-signed certificate");
+    }
+    std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key(rawKey, EVP_PKEY_free);
+
+    std::unique_ptr<X509, decltype(&X509_free)> certificate(X509_new(), X509_free);
+    X509_set_version(certificate.get(), 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate.get()), 1);
+    X509_gmtime_adj(X509_getm_notBefore(certificate.get()), 0);
+    X509_gmtime_adj(X509_getm_notAfter(certificate.get()), 365L * 24 * 3600);
+    X509_set_pubkey(certificate.get(), key.get());
+    X509_NAME* name = X509_get_subject_name(certificate.get());
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(certificate.get(), name);
+    if (X509_sign(certificate.get(), key.get(), EVP_sha256()) <= 0 ||
+        SSL_CTX_use_certificate(ctx.native_handle(), certificate.get()) != 1 ||
+        SSL_CTX_use_PrivateKey(ctx.native_handle(), key.get()) != 1) {
+        throw std::runtime_error("Unable to install the self-signed certificate");
+    }
+}
+
+std::shared_ptr<const std::vector<std::string>> loadMockFrames(const std::string& path) {
+    auto frames = std::make_shared<std::vector<std::string>>();
+    if (path.size() > 4 && path.compare(path.size() - 4, 4, ".idx") == 0) {
+        FrameCaptureReader reader(path);
+        CapturedFrame frame;
+        while (reader.next(frame)) {
+            frames->emplace_back(frame.data);
+        }
+        return frames;
+    }
+
+    std::ifstream input(path);
+    if (!input.is_open()) {
+        throw std::runtime_error("Unable to open recorded frames: " + path);
+    }
+    std::stringstream contents;
+    contents << input.rdbuf();
+    const std::string text = contents.str();
+
+    const std::size_t first = text.find_first_not_of(" \t\r\n");
+    if (first != std::string::npos && text[first] == '[') {
+        for (const auto& frame : nlohmann::json::parse(text)) {
+            frames->push_back(frame.dump());
+        }
+        return frames;
+    }
+
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.find('{') == std::string::npos) continue;
+        try {
+            // TradeFileWriter lines wrap the frame, anything else is taken to be the frame itself
+            const auto record = nlohmann::json::parse(line);
+            const auto levels = record.find("orderBookLevels");
+            frames->push_back(levels != record.end() ? levels->get<std::string>() : line);
+        } catch (const nlohmann::json::exception& e) {
+            fail(e.what(), "Mock Frame Load");
+        }
+    }
+    return frames;
+}
+
+std::string_view frameStreamName(std::string_view frame) {
+    const std::size_t begin = valueStart(frame, "\"stream\"");
+    if (begin == std::string_view::npos || frame[begin] != '"') return {};
+    const std::size_t end = frame.find('"', begin + 1);
+    return end == std::string_view::npos ? std::string_view() : frame.substr(begin + 1, end - begin - 1);
+}
+
+long long frameUpdateId(std::string_view frame) {
+    const std::size_t begin = updateIdStart(frame);
+    if (begin == std::string_view::npos) return -1;
+    const std::size_t end = digitsEnd(frame, begin);
+    if (end == begin) return -1;
+    long long id = 0;
+    for (std::size_t i = begin; i < end; ++i) id = id * 10 + (frame[i] - '0');
+    return id;
+}
+
+bool stampUpdateId(std::string& frame, long long updateId) {
+    const std::size_t begin = updateIdStart(frame);
+    if (begin == std::string::npos) return false;
+    frame.replace(begin, digitsEnd(frame, begin) - begin, std::to_string(updateId));
+    return true;
+}
+
+MockFeed::MockFeed(std::vector<std::string> streamNames, std::size_t levels, std::uint64_t seed) : random(seed) {
+    std::uniform_real_distribution<double> startMid(10, 1000);
+    for (auto& name : streamNames) {
+        SyntheticStream stream;
+        stream.symbol = name.substr(0, name.find('@'));
+        const std::size_t depth = streamDepth(name);
+        stream.levels = isBookTickerStream(name) ? 0 : (depth ? std::min(depth, levels) : levels);
+        stream.mid = startMid(random);
+        stream.name = std::move(name);
+        streams.push_back(std::move(stream));
+    }
+}
+
+MockFeed::MockFeed(const std::vector<std::string>& streamNames, std::shared_ptr<const std::vector<std::string>> frames)
+    : recorded(std::move(frames)) {
+    const std::unordered_set<std::string_view> subscribed(streamNames.begin(), streamNames.end());
+    for (std::size_t i = 0; i < recorded->size(); ++i) {
+        if (subscribed.count(frameStreamName((*recorded)[i]))) selected.push_back(i);
+    }
+}
+
+const std::string& MockFeed::next(long long updateId) {
+    if (recorded) {
+        frame = (*recorded)[selected[position++ % selected.size()]];
+        stampUpdateId(frame, updateId);
+        return frame;
+    }
+
+    SyntheticStream& stream = streams[position++ % streams.size()];
+    std::uniform_real_distribution<double> move(-1e-4, 1e-4);
+    std::uniform_real_distribution<double> quantity(0.1, 10);
+    stream.mid *= 1 + move(random);
+    const double tick = stream.mid * 1e-5;
+
+    frame.clear();
+    frame += "{\"stream\":\"";
+    frame += stream.name;
+    if (stream.levels == 0) {
+        std::string upper = stream.symbol;
+        std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        frame += "\",\"data\":{\"u\":" + std::to_string(updateId) + ",\"s\":\"" + upper + "\",\"b\":\"";
+        appendNumber(frame, stream.mid - tick);
+        frame += "\",\"B\":\"";
+        appendNumber(frame, quantity(random));
+        frame += "\",\"a\":\"";
+        appendNumber(frame, stream.mid + tick);
+        frame += "\",\"A\":\"";
+        appendNumber(frame, quantity(random));
+        frame += "\"}}";
+        return frame;
+    }
+
+    frame += "\",\"data\":{\"lastUpdateId\":" + std::to_string(updateId) + ",\"bids\":[";
+    for (std::size_t i = 0; i < stream.levels; ++i) {
+        frame += i ? ",[\"" : "[\"";
+        appendNumber(frame, stream.mid - tick * static_cast<double>(i + 1));
+        frame += "\",\"";
+        appendNumber(frame, quantity(random));
+        frame += "\"]";
+    }
+    frame += "],\"asks\":[";
+    for (std::size_t i = 0; i < stream.levels; ++i) {
+        frame += i ? ",[\"" : "[\"";
+        appendNumber(frame, stream.mid + tick * static_cast<double>(i + 1));
+        frame += "\",\"";
+        appendNumber(frame, quantity(random));
+        frame += "\"]";
+    }
+    frame += "]}}";
+    return frame;
+}
+
+MockBinanceServer::MockBinanceServer(boost::asio::io_context& ioc, const MockServerConfig& config)
+    : ioc(ioc), acceptor(ioc), state(std::make_shared<State>(config)) {
+    if (config.tls) {
+        state->ssl = std::make_unique<boost::asio::ssl::context>(boost::asio::ssl::context::tlsv12_server);
+        useSelfSignedCertificate(*state->ssl);
+    }
+    if (!config.framesPath.empty()) {
+        state->recorded = loadMockFrames(config.framesPath);
+    }
+}
+
+MockBinanceServer::~MockBinanceServer() = default;
+
+void MockBinanceServer::start() {
+    const tcp::endpoint endpoint(boost::asio::ip::make_address(state->config.address), state->config.port);
+    acceptor.open(endpoint.protocol());
+    acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+    acceptor.bind(endpoint);
+    acceptor.listen(boost::asio::socket_base::max_listen_connections);
+    accept();
+}
+
+void MockBinanceServer::stop() {
+    state->stopped.store(true, std::memory_order_relaxed);
+    boost::asio::post(acceptor.get_executor(), [this] {
+        beast::error_code ec;
+        acceptor.close(ec);
+    });
+}
+
+unsigned short MockBinanceServer::port() const {
+    return acceptor.local_endpoint().port();
+}
+
+const MockServerStats& MockBinanceServer::getStats() const {
+    return state->stats;
+}
+
+void MockBinanceServer::accept() {
+    acceptor.async_accept(boost::asio::make_strand(ioc), [this](beast::error_code ec, tcp::socket socket) {
+        if (ec == boost::asio::error::operation_aborted) return;
+        if (ec) {
+            fail(ec, "Mock Accept");
+        } else {
+            socket.set_option(tcp::no_delay(true));
+            if (state->ssl) {
+                std::make_shared<MockSession<true>>(state, std::move(socket), *state->ssl)->run();
+            } else {
+                std::make_shared<MockSession<false>>(state, std::move(socket))->run();
+            }
+        }
+        if (!state->stopped.load(std::memory_order_relaxed)) accept();
+    });
+}
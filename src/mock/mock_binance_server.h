@@ -0,0 +1,153 @@
+#ifndef MOCK_BINANCE_SERVER_H
+#define MOCK_BINANCE_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl/context.hpp>
+
+struct MockServerConfig {
+    std::string address;  // Listening address, loopback unless set otherwise
+    unsigned short port;  // 0 lets the OS pick a free one, see MockBinanceServer::port
+    bool tls;             // wss with a self-signed certificate, else plain ws
+    double rate;          // Frames per second sent on each connection
+    std::size_t levels;   // Levels per side of synthetic depth frames, at most the stream's @depthN
+    std::string framesPath; // Recorded frames sent instead of synthetic ones, see loadMockFrames
+
+    explicit MockServerConfig(std::string listenAddress = "127.0.0.1", unsigned short listenPort = 0, bool useTls = true,
+                              double frameRate = 1000, std::size_t depthLevels = 5, std::string frames = "")
+        : address(std::move(listenAddress)), port(listenPort), tls(useTls), rate(frameRate > 0 ? frameRate : 1),
+          levels(depthLevels ? depthLevels : 1), framesPath(std::move(frames)) {}
+
+    // Reads BINANCE_MOCK_ADDRESS, BINANCE_MOCK_PORT, BINANCE_MOCK_TLS (true|false), BINANCE_MOCK_RATE,
+    // BINANCE_MOCK_LEVELS and BINANCE_MOCK_FRAMES
+    static MockServerConfig from_env() {
+        const char* env_address = std::getenv("BINANCE_MOCK_ADDRESS");
+        const char* env_port = std::getenv("BINANCE_MOCK_PORT");
+        const char* env_tls = std::getenv("BINANCE_MOCK_TLS");
+        const char* env_rate = std::getenv("BINANCE_MOCK_RATE");
+        const char* env_levels = std::getenv("BINANCE_MOCK_LEVELS");
+        const char* env_frames = std::getenv("BINANCE_MOCK_FRAMES");
+
+        return MockServerConfig(
+            env_address ? env_address : "127.0.0.1",
+            env_port ? static_cast<unsigned short>(std::stoul(env_port)) : 0,
+            env_tls ? std::string(env_tls) != "false" : true,
+            env_rate ? std::stod(env_rate) : 1000,
+            env_levels ? std::stoul(env_levels) : 5,
+            env_frames ? env_frames : ""
+        );
+    }
+};
+
+// Generates a key pair and a certificate for localhost, signed by itself, and installs both in ctx
+void useSelfSignedCertificate(boost::asio::ssl::context& ctx);
+
+/**
+ * @brief Reads recorded combined-stream frames to serve from a mock server.
+ *
+ * A path ending in .idx is read as a FrameCaptureWriter capture, anything else as one frame per
+ * line. Lines that are not a frame, such as the timestamp prefix of a result file, are skipped
+ * up to the frame's opening brace.
+ */
+std::shared_ptr<const std::vector<std::string>> loadMockFrames(const std::string& path);
+
+// The "stream" value of a combined-stream frame, empty if it has none
+std::string_view frameStreamName(std::string_view frame);
+
+// The update id of a depth ("lastUpdateId") or book ticker ("u") frame, -1 if it has none
+long long frameUpdateId(std::string_view frame);
+
+// Rewrites the update id of a depth or book ticker frame in place, false if it has none
+bool stampUpdateId(std::string& frame, long long updateId);
+
+/**
+ * @class MockFeed
+ * @brief The frames one mock connection sends, in order, each stamped with a new update id.
+ *
+ * Synthetic feeds round-robin the subscribed streams, random-walking one mid price per stream
+ * and writing partial depth or book ticker frames to match each stream's name. Recorded feeds
+ * cycle through the recorded frames of the subscribed streams, in recorded order.
+ */
+class MockFeed {
+public:
+    MockFeed(std::vector<std::string> streams, std::size_t levels, std::uint64_t seed);
+    MockFeed(const std::vector<std::string>& streams, std::shared_ptr<const std::vector<std::string>> recorded);
+
+    // False when a recorded feed has nothing for its streams
+    bool empty() const { return recorded ? selected.empty() : streams.empty(); }
+
+    // The next frame, valid until the following call
+    const std::string& next(long long updateId);
+
+private:
+    struct SyntheticStream {
+        std::string name;
+        std::string symbol;
+        std::size_t levels; // 0 for a book ticker stream
+        double mid;
+    };
+
+    std::vector<SyntheticStream> streams;
+    std::shared_ptr<const std::vector<std::string>> recorded;
+    std::vector<std::size_t> selected; // Indices of the recorded frames of the subscribed streams
+    std::size_t position = 0;
+    std::mt19937_64 random;
+    std::string frame;
+};
+
+/**
+ * @struct MockServerStats
+ * @brief Totals over every connection, each counter bumped by whichever session sent.
+ */
+struct MockServerStats {
+    std::atomic<std::uint64_t> connections{0};
+    std::atomic<std::uint64_t> frames{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> lateFrames{0}; // Sent behind schedule because the previous write had not completed
+};
+
+/**
+ * @class MockBinanceServer
+ * @brief Local stand-in for the Binance combined-stream endpoint, for load testing without network access.
+ *
+ * Accepts websocket connections, over TLS or plain TCP, on any /stream?streams=... target and
+ * sends each one a MockFeed of its streams at the configured rate. Pacing is against the
+ * connection's start time, so a slow reader is caught up with back-to-back writes rather than
+ * given a lower rate, and what it could not take shows up as late frames. Every frame's update
+ * id is the system clock time it was sent at in nanoseconds, kept strictly increasing, so
+ * receivers can measure the latency of each frame from its tick alone.
+ */
+class MockBinanceServer {
+public:
+    MockBinanceServer(boost::asio::io_context& ioc, const MockServerConfig& config);
+    ~MockBinanceServer();
+
+    // Binds and starts accepting, throws boost::system::system_error if the address cannot be bound
+    void start();
+
+    // Stops accepting and closes every connection once its current write completes
+    void stop();
+
+    unsigned short port() const;
+    const MockServerStats& getStats() const;
+
+    struct State;
+
+private:
+    void accept();
+
+    boost::asio::io_context& ioc;
+    boost::asio::ip::tcp::acceptor acceptor;
+    std::shared_ptr<State> state;
+};
+
+#endif // MOCK_BINANCE_SERVER_H
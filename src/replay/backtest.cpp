@@ -0,0 +1,257 @@
+#include "replay/backtest.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+std::vector<std::string> split(const std::string& str, char delimiter) {
+    std::vector<std::string> parts;
+    std::stringstream stream(str);
+    std::string part;
+    while (std::getline(stream, part, delimiter)) {
+        part.erase(0, part.find_first_not_of(" \t"));
+        part.erase(part.find_last_not_of(" \t") + 1);
+        if (!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+double parseValue(const std::string& name, const std::string& value) {
+    try {
+        std::size_t used = 0;
+        const double parsed = std::stod(value, &used);
+        if (used == value.size()) return parsed;
+    } catch (const std::exception&) {
+    }
+    throw std::invalid_argument("Invalid value for " + name + ": " + value);
+}
+
+std::vector<double> parseValues(const std::string& name, const std::string& values) {
+    const std::vector<std::string> range = split(values, ':');
+    if (range.size() == 3) {
+        const double start = parseValue(name, range[0]);
+        const double stop = parseValue(name, range[1]);
+        const double step = parseValue(name, range[2]);
+        if (step <= 0 || stop < start) {
+            throw std::invalid_argument("Invalid range for " + name + ": " + values);
+        }
+        std::vector<double> expanded;
+        const auto count = static_cast<std::size_t>(std::floor((stop - start) / step + 1e-9)) + 1;
+        for (std::size_t i = 0; i < count; ++i) {
+            expanded.push_back(start + i * step);
+        }
+        return expanded;
+    }
+
+    std::vector<double> listed;
+    for (const auto& value : split(values, ',')) {
+        if (name == "useFirstLevelOnly") {
+            if (value != "true" && value != "false") throw std::invalid_argument("useFirstLevelOnly is true or false: " + value);
+            listed.push_back(value == "true" ? 1 : 0);
+        } else {
+            listed.push_back(parseValue(name, value));
+        }
+    }
+    if (listed.empty()) {
+        throw std::invalid_argument("No values for " + name);
+    }
+    return listed;
+}
+
+// Tallies what one server finds, only ever written by the thread running that server
+class OutcomeWriter : public ResultWriter {
+public:
+    explicit OutcomeWriter(BacktestOutcome& outcome) : outcome(outcome) {}
+
+    void write(const ArbitrageResult& result) override {
+        outcome.results++;
+        if (!result.arbitrageOpportunity) return;
+
+        outcome.opportunities++;
+        outcome.totalPnl += result.unrealisedPnl;
+        outcome.totalOptimalPnl += result.optimalPnl;
+        for (auto& leg : outcome.bottleneckLegs) {
+            if (leg.first == result.bottleneckLeg) {
+                leg.second++;
+                return;
+            }
+        }
+        outcome.bottleneckLegs.emplace_back(std::string(result.bottleneckLeg), 1);
+    }
+
+private:
+    BacktestOutcome& outcome;
+};
+
+} // namespace
+
+std::vector<BacktestParameters> parseBacktestGrid(const std::string& spec) {
+    std::vector<BacktestParameters> grid(1);
+    for (const auto& axis : split(spec, ';')) {
+        const std::size_t equals = axis.find('=');
+        if (equals == std::string::npos) {
+            throw std::invalid_argument("Expected name=values in grid: " + axis);
+        }
+        const std::string name = axis.substr(0, equals);
+        double BacktestParameters::* field = nullptr;
+        if (name == "profitThreshold") field = &BacktestParameters::profitThreshold;
+        else if (name == "takerFee") field = &BacktestParameters::takerFee;
+        else if (name == "maxStartingNotionalFraction") field = &BacktestParameters::maxStartingNotionalFraction;
+        else if (name == "maxStartingNotionalRecalcInterval") field = &BacktestParameters::maxStartingNotionalRecalcInterval;
+        else if (name != "useFirstLevelOnly") throw std::invalid_argument("Unknown grid parameter: " + name);
+
+        const std::vector<double> values = parseValues(name, axis.substr(equals + 1));
+        std::vector<BacktestParameters> expanded;
+        expanded.reserve(grid.size() * values.size());
+        for (const auto& point : grid) {
+            for (const double value : values) {
+                BacktestParameters next = point;
+                if (field) next.*field = value; else next.useFirstLevelOnly = value != 0;
+                expanded.push_back(next);
+            }
+        }
+        grid = std::move(expanded);
+    }
+    return grid;
+}
+
+TickRecording TickRecording::load(std::istream& input, const SymbolTable& symbols, DepthParserMode parserMode) {
+    TickRecording recording;
+    ReplaySink sink{[&recording](OrderBookTick& tick) { recording.add(tick); },
+                    [&recording](const BookTicker& ticker) { recording.add(ticker); }};
+    ReplayEngine engine(symbols, std::move(sink), ReplayConfig(0, parserMode));
+    recording.loadStats = engine.run(input);
+    recording.ticks.shrink_to_fit();
+    recording.levels.shrink_to_fit();
+    return recording;
+}
+
+void TickRecording::add(const OrderBookTick& tick) {
+    if (tick.symbolId == INVALID_SYMBOL_ID) return;
+    Tick record{tick.updateId, tick.tickInitTime, static_cast<std::uint32_t>(levels.size()), tick.symbolId,
+                static_cast<std::uint8_t>(tick.bids.size()), static_cast<std::uint8_t>(tick.asks.size()), false};
+    for (const PriceLevel& level : tick.bids) levels.push_back(level);
+    for (const PriceLevel& level : tick.asks) levels.push_back(level);
+    ticks.push_back(record);
+}
+
+void TickRecording::add(const BookTicker& ticker) {
+    if (ticker.symbolId == INVALID_SYMBOL_ID) return;
+    Tick record{ticker.updateId, ticker.tickInitTime, static_cast<std::uint32_t>(levels.size()), ticker.symbolId, 1, 1, true};
+    levels.push_back(ticker.bid);
+    levels.push_back(ticker.ask);
+    ticks.push_back(record);
+}
+
+void TickRecording::replay(Server& server) const {
+    OrderBookTick tick;
+    BookTicker ticker;
+    for (std::size_t i = 0; i < ticks.size(); ++i) {
+        if (get(i, server.getSymbolTable(), tick, ticker)) {
+            server.on_update(ticker);
+        } else {
+            server.on_update(tick);
+        }
+    }
+}
+
+bool TickRecording::get(std::size_t index, const SymbolTable& symbols, OrderBookTick& tick, BookTicker& ticker) const {
+    const Tick& record = ticks[index];
+    const PriceLevel* recordLevels = levels.data() + record.levelOffset;
+    if (record.isBookTicker) {
+        ticker.symbolId = record.symbolId;
+        ticker.symbol = symbols.name(record.symbolId);
+        ticker.updateId = record.updateId;
+        ticker.tickInitTime = record.receiveTime;
+        ticker.bid = recordLevels[0];
+        ticker.ask = recordLevels[1];
+        return true;
+    }
+
+    tick.symbolId = record.symbolId;
+    tick.symbol = symbols.name(record.symbolId);
+    tick.updateId = record.updateId;
+    tick.tickInitTime = record.receiveTime;
+    tick.bids.clear();
+    tick.asks.clear();
+    for (std::uint8_t i = 0; i < record.bidCount; ++i) tick.bids.push_back(recordLevels[i]);
+    for (std::uint8_t i = 0; i < record.askCount; ++i) tick.asks.push_back(recordLevels[record.bidCount + i]);
+    return false;
+}
+
+std::vector<BacktestOutcome> runBacktest(const TickRecording& recording, const std::vector<ArbitragePath>& paths,
+                                         const std::vector<BacktestParameters>& grid, std::size_t threads) {
+    std::vector<BacktestOutcome> outcomes(grid.size());
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::max<std::size_t>(1, std::min(threads, grid.size()));
+
+    // Parameter sets are handed out one at a time, so a slow one never holds up a whole batch
+    std::atomic<std::size_t> next{0};
+    const auto work = [&] {
+        for (std::size_t i = next.fetch_add(1); i < grid.size(); i = next.fetch_add(1)) {
+            BacktestOutcome& outcome = outcomes[i];
+            outcome.parameters = grid[i];
+            Server server(paths, grid[i].toServerConfig(), std::make_unique<OutcomeWriter>(outcome));
+            recording.replay(server);
+            std::sort(outcome.bottleneckLegs.begin(), outcome.bottleneckLegs.end(),
+                      [](const auto& a, const auto& b) { return a.second > b.second; });
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return outcomes;
+}
+
+void rankBacktestOutcomes(std::vector<BacktestOutcome>& outcomes) {
+    std::stable_sort(outcomes.begin(), outcomes.end(), [](const BacktestOutcome& a, const BacktestOutcome& b) {
+        if (a.totalPnl != b.totalPnl) return a.totalPnl > b.totalPnl;
+        return a.opportunities > b.opportunities;
+    });
+}
+
+void printBacktestOutcomes(std::ostream& out, const std::vector<BacktestOutcome>& outcomes, std::size_t rows) {
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    out << std::left
+        << std::setw(6) << "rank" << std::setw(12) << "threshold" << std::setw(10) << "fee"
+        << std::setw(10) << "fraction" << std::setw(10) << "recalc" << std::setw(8) << "first"
+        << std::setw(10) << "opps" << std::setw(16) << "total pnl" << std::setw(16) << "mean pnl"
+        << "bottleneck legs\n";
+
+    const std::size_t shown = std::min(rows, outcomes.size());
+    for (std::size_t i = 0; i < shown; ++i) {
+        const BacktestOutcome& outcome = outcomes[i];
+        const BacktestParameters& p = outcome.parameters;
+        out << std::setw(6) << i + 1
+            << std::setw(12) << p.profitThreshold << std::setw(10) << p.takerFee
+            << std::setw(10) << p.maxStartingNotionalFraction << std::setw(10) << p.maxStartingNotionalRecalcInterval
+            << std::setw(8) << (p.useFirstLevelOnly ? "true" : "false")
+            << std::setw(10) << outcome.opportunities
+            << std::setw(16) << outcome.totalPnl << std::setw(16) << outcome.meanPnl();
+        for (const auto& leg : outcome.bottleneckLegs) {
+            out << leg.first << " " << std::fixed << std::setprecision(0) << 100.0 * leg.second / outcome.opportunities << "% ";
+            out.flags(flags);
+            out << std::left;
+            out.precision(precision);
+        }
+        out << "\n";
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,119 @@
+#ifndef BACKTEST_H
+#define BACKTEST_H
+
+#include "replay/replay_engine.h"
+#include "server/arbitrage_server.h"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct BacktestParameters
+ * @brief One point of a parameter grid, in the same units as the BINANCE_* environment variables.
+ */
+struct BacktestParameters {
+    double profitThreshold = 0;
+    double takerFee = 0;
+    double maxStartingNotionalFraction = 1;
+    double maxStartingNotionalRecalcInterval = 0;
+    bool useFirstLevelOnly = true;
+
+    ServerConfig toServerConfig() const {
+        return ServerConfig(profitThreshold, takerFee, maxStartingNotionalFraction, maxStartingNotionalRecalcInterval, useFirstLevelOnly);
+    }
+};
+
+/**
+ * @brief Expands a grid spec into every combination of its values.
+ *
+ * The spec is a ';' separated list of name=values, where values is a ',' separated list, or
+ * start:stop:step for an inclusive range. Names are profitThreshold, takerFee,
+ * maxStartingNotionalFraction, maxStartingNotionalRecalcInterval and useFirstLevelOnly (true or
+ * false); any not given keeps its BacktestParameters default.
+ * e.g. "profitThreshold=0:0.001:0.0002;takerFee=0.00075,0.001;useFirstLevelOnly=true,false"
+ *
+ * @throws std::invalid_argument for unknown names or values that do not parse
+ */
+std::vector<BacktestParameters> parseBacktestGrid(const std::string& spec);
+
+/**
+ * @class TickRecording
+ * @brief Ticks parsed once from a recording, kept as compact fixed-size records in memory.
+ *
+ * Levels of every tick share one flat array, so a tick costs its header plus the levels it
+ * actually has rather than a full OrderBookTick. Ticks for symbols outside every path are
+ * dropped when recorded. Replaying rebuilds each tick into one reused OrderBookTick, with no
+ * frame, so one recording can feed any number of servers on any number of threads.
+ */
+class TickRecording {
+public:
+    // Parses input in any format ReplayEngine reads, resolving symbols against symbols
+    static TickRecording load(std::istream& input, const SymbolTable& symbols, DepthParserMode parserMode = DepthParserMode::Fast);
+
+    void add(const OrderBookTick& tick);
+    void add(const BookTicker& ticker);
+
+    // Feeds every tick to server in recorded order. The server must have been built from the paths the symbol table came from.
+    void replay(Server& server) const;
+
+    // Rebuilds tick index into tick or ticker, returning true if it is a book ticker
+    bool get(std::size_t index, const SymbolTable& symbols, OrderBookTick& tick, BookTicker& ticker) const;
+
+    long long receiveTime(std::size_t index) const { return ticks[index].receiveTime; }
+
+    std::size_t size() const { return ticks.size(); }
+    std::size_t bytes() const { return ticks.capacity() * sizeof(Tick) + levels.capacity() * sizeof(PriceLevel); }
+    const ReplayStats& getLoadStats() const { return loadStats; }
+
+private:
+    struct Tick {
+        long long updateId;
+        long long receiveTime;
+        std::uint32_t levelOffset; // Bids then asks in levels
+        SymbolId symbolId;
+        std::uint8_t bidCount;
+        std::uint8_t askCount;
+        bool isBookTicker;
+    };
+
+    std::vector<Tick> ticks;
+    std::vector<PriceLevel> levels;
+    ReplayStats loadStats;
+};
+
+/**
+ * @struct BacktestOutcome
+ * @brief What one parameter set would have found over a recording.
+ */
+struct BacktestOutcome {
+    BacktestParameters parameters;
+    std::uint64_t results = 0;
+    std::uint64_t opportunities = 0;
+    double totalPnl = 0;      // unrealisedPnl summed over opportunities
+    double totalOptimalPnl = 0;
+    std::vector<std::pair<std::string, std::uint64_t>> bottleneckLegs; // Opportunities per bottleneck leg, most first
+
+    double meanPnl() const { return opportunities ? totalPnl / opportunities : 0.0; }
+};
+
+/**
+ * @brief Replays recording through one fresh Server per parameter set, spread over threads.
+ *
+ * Every server has its own books and path state and is only touched by the thread evaluating
+ * it, so the outcome of a parameter set does not depend on the thread count. Outcomes are
+ * returned in grid order.
+ */
+std::vector<BacktestOutcome> runBacktest(const TickRecording& recording, const std::vector<ArbitragePath>& paths,
+                                         const std::vector<BacktestParameters>& grid, std::size_t threads = 0);
+
+// Sorts by total PnL, then opportunity count, best first
+void rankBacktestOutcomes(std::vector<BacktestOutcome>& outcomes);
+
+// A table of the first rows outcomes in their current order
+void printBacktestOutcomes(std::ostream& out, const std::vector<BacktestOutcome>& outcomes, std::size_t rows);
+
+#endif // BACKTEST_H
@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include "replay/backtest.h"
+
+/**
+ * Backtests a grid of ServerConfig parameters over one recording
+ *
+ * Usage: Backtest <recorded file> <grid> [threads] [rows]
+ *
+ * The recording is anything Replay reads, parsed once into memory. grid is described in
+ * parseBacktestGrid, e.g. "profitThreshold=0:0.001:0.0001;takerFee=0.00075,0.001". Every
+ * combination is evaluated by its own server, one thread per core unless threads is given, and
+ * the best rows (20 by default) are printed ranked by total PnL. Paths come from
+ * BINANCE_ARBITRAGE_PATH and the parser from BINANCE_DEPTH_PARSER, as for Replay.
+ */
+int main(int argc, char* argv[]) {
+
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <recorded file> <grid> [threads] [rows]" << std::endl;
+        return 1;
+    }
+
+    const char* env_arbitrage_path = std::getenv("BINANCE_ARBITRAGE_PATH");
+    const char* env_depth_parser = std::getenv("BINANCE_DEPTH_PARSER");
+
+    const std::string input_path = argv[1];
+    const std::size_t threads = argc > 3 ? std::stoul(argv[3]) : 0;
+    const std::size_t rows = argc > 4 ? std::stoul(argv[4]) : 20;
+    const std::string arbitrage_path = env_arbitrage_path ? env_arbitrage_path : "btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY";
+
+    std::vector<BacktestParameters> grid;
+    try {
+        grid = parseBacktestGrid(argv[2]);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(input_path);
+    if (!input.is_open()) {
+        std::cerr << "Unable to open recorded file: " << input_path << std::endl;
+        return 1;
+    }
+
+    const std::vector<ArbitragePath> paths = ArbitragePath::list_from_string(arbitrage_path);
+    // Every backtest server interns the same paths, so they all share this symbol table's ids
+    const Server prototype(paths, BacktestParameters().toServerConfig());
+
+    const auto load_start = std::chrono::steady_clock::now();
+    const TickRecording recording = TickRecording::load(
+        input, prototype.getSymbolTable(), depthParserModeFromString(env_depth_parser ? env_depth_parser : "fast"));
+    const double load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - load_start).count();
+
+    std::cout << "########### BACKTEST ###########" << std::endl;
+    std::cout << "Recording: " << input_path << std::endl;
+    std::cout << "Arbitrage Paths to Search (" << paths.size() << "): " << arbitrage_path << std::endl;
+    std::cout << "Ticks: " << recording.size() << " (" << recording.bytes() / 1024 << " KiB, "
+              << recording.getLoadStats().parseFailures << " parse failures, loaded in " << load_seconds << " s)" << std::endl;
+    std::cout << "Parameter Sets: " << grid.size() << std::endl;
+
+    const auto run_start = std::chrono::steady_clock::now();
+    std::vector<BacktestOutcome> outcomes = runBacktest(recording, paths, grid, threads);
+    const double run_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start).count();
+
+    std::cout << "Evaluated in " << run_seconds << " s ("
+              << (run_seconds > 0 ? grid.size() * static_cast<double>(recording.size()) / run_seconds : 0.0) << " ticks/s)" << std::endl;
+    rankBacktestOutcomes(outcomes);
+    printBacktestOutcomes(std::cout, outcomes, rows);
+    std::cout << "################################" << std::endl;
+    return 0;
+}
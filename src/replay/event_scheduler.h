@@ -0,0 +1,60 @@
+#ifndef EVENT_SCHEDULER_H
+#define EVENT_SCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+/**
+ * @class EventScheduler
+ * @brief Priority queue of timestamped events for a discrete-event simulation.
+ *
+ * Events come out in time order, and events scheduled for the same time come out in the order
+ * they were scheduled, so a simulation is deterministic. An event is a plain 24-byte record, a
+ * type and the index of whatever it acts on, so scheduling never allocates once the heap has
+ * grown to the simulation's working size.
+ */
+class EventScheduler {
+public:
+    struct Event {
+        std::int64_t time;
+        std::uint64_t sequence; // Breaks ties between events at the same time
+        std::uint32_t type;
+        std::uint32_t target;
+
+        bool operator>(const Event& other) const {
+            return time != other.time ? time > other.time : sequence > other.sequence;
+        }
+    };
+
+    explicit EventScheduler(std::size_t reserve = 1024) {
+        std::vector<Event> storage;
+        storage.reserve(reserve);
+        queue = Queue(std::greater<Event>(), std::move(storage));
+    }
+
+    void schedule(std::int64_t time, std::uint32_t type, std::uint32_t target) {
+        queue.push(Event{time, nextSequence++, type, target});
+    }
+
+    bool empty() const { return queue.empty(); }
+    std::size_t size() const { return queue.size(); }
+
+    // Time of the next event, only valid when not empty
+    std::int64_t nextTime() const { return queue.top().time; }
+
+    Event pop() {
+        const Event event = queue.top();
+        queue.pop();
+        return event;
+    }
+
+private:
+    using Queue = std::priority_queue<Event, std::vector<Event>, std::greater<Event>>;
+    Queue queue;
+    std::uint64_t nextSequence = 0;
+};
+
+#endif // EVENT_SCHEDULER_H
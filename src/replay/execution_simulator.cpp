@@ -0,0 +1,240 @@
+#include "replay/execution_simulator.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// Fills below this fraction of what was sent count as short, so rounding never leaves inventory
+constexpr double FILL_EPSILON = 1e-9;
+
+// Best rate the leg trades at, after fees, 0 if its side is empty
+double topOfBookRate(const TradeLeg& leg, const OrderBook& book, double feeMultiplier) {
+    if (leg.requiresInversion) {
+        const double ask = book.getBestAskPrice();
+        return ask > 0 ? feeMultiplier / ask : 0.0;
+    }
+    return book.getBestBidPrice() * feeMultiplier;
+}
+
+} // namespace
+
+ExecutionMode executionModeFromString(const std::string& mode) {
+    return mode == "sequential" ? ExecutionMode::Sequential : ExecutionMode::Parallel;
+}
+
+LegFill fillLeg(const TradeLeg& leg, const OrderBook& book, double input, double limitPrice,
+                double feeMultiplier, std::size_t maxLevels) {
+    LegFill fill;
+    double remaining = input;
+    if (leg.requiresInversion) {
+        // Spending quote on the asks, each level takes up to price * quantity of it
+        const std::size_t levels = std::min(maxLevels, book.asks.size());
+        for (std::size_t i = 0; i < levels && remaining > 0; ++i) {
+            const PriceLevel level = book.asks[i];
+            if (limitPrice > 0 && level.price > limitPrice) break;
+            const double spent = std::min(remaining, level.price * level.quantity);
+            fill.filledInput += spent;
+            fill.output += spent / level.price;
+            fill.worstPrice = level.price;
+            remaining -= spent;
+        }
+    } else {
+        // Selling base into the bids, each level takes up to its quantity
+        const std::size_t levels = std::min(maxLevels, book.bids.size());
+        for (std::size_t i = 0; i < levels && remaining > 0; ++i) {
+            const PriceLevel level = book.bids[i];
+            if (limitPrice > 0 && level.price < limitPrice) break;
+            const double sold = std::min(remaining, level.quantity);
+            fill.filledInput += sold;
+            fill.output += sold * level.price;
+            fill.worstPrice = level.price;
+            remaining -= sold;
+        }
+    }
+    fill.output *= feeMultiplier;
+    return fill;
+}
+
+// Queues the server's opportunities, they are acted on once the tick that produced them is handled
+class ExecutionSimulator::SignalWriter : public ResultWriter {
+public:
+    explicit SignalWriter(ExecutionSimulator& simulator) : simulator(simulator) {}
+
+    void write(const ArbitrageResult& result) override {
+        if (!result.arbitrageOpportunity) return;
+        const auto path = simulator.pathIndex.find(result.path);
+        if (path == simulator.pathIndex.end()) return;
+        simulator.pendingSignals.push_back(Signal{path->second, result.tradedNotional, result.unrealisedPnl});
+    }
+
+private:
+    ExecutionSimulator& simulator;
+};
+
+ExecutionSimulator::ExecutionSimulator(const std::vector<ArbitragePath>& paths, const ServerConfig& serverConfig,
+                                       const ExecutionConfig& config)
+    : paths(paths), serverConfig(serverConfig), config(config), jitter(config.seed) {
+    server = std::make_unique<Server>(paths, serverConfig, std::make_unique<SignalWriter>(*this));
+
+    // Interned in the same order the server interns them, so the ids match its symbol table
+    SymbolTable symbols;
+    pathNames.reserve(this->paths.size());
+    for (auto& path : this->paths) {
+        path.internSymbols(symbols);
+        pathNames.push_back(path.to_string());
+    }
+    for (std::uint32_t i = 0; i < pathNames.size(); ++i) {
+        pathIndex.emplace(pathNames[i], i);
+    }
+    books = BookStore(symbols.size());
+    pathBusy.assign(this->paths.size(), false);
+}
+
+ExecutionSimulator::~ExecutionSimulator() = default;
+
+ExecutionReport ExecutionSimulator::run(const TickRecording& recording) {
+    const auto start = std::chrono::steady_clock::now();
+    const SymbolTable& symbols = server->getSymbolTable();
+    OrderBookTick tick;
+    BookTicker ticker;
+
+    std::size_t next = 0;
+    while (next < recording.size() || !scheduler.empty()) {
+        // A tick goes before any order event at the same time, so orders see the book as of their arrival
+        if (next < recording.size() && (scheduler.empty() || recording.receiveTime(next) <= scheduler.nextTime())) {
+            const std::int64_t now = recording.receiveTime(next);
+            if (recording.get(next++, symbols, tick, ticker)) {
+                OrderBook& book = books[ticker.symbolId];
+                if (!book.hasUpdate() || ticker.updateId > book.updateId) {
+                    book.setTopOfBook(ticker.updateId, ticker.bid, ticker.ask, ticker.tickInitTime);
+                }
+                server->on_update(ticker);
+            } else {
+                OrderBook& book = books[tick.symbolId];
+                if (!book.hasUpdate() || tick.updateId > book.updateId) {
+                    book = tick;
+                }
+                server->on_update(tick);
+            }
+            report.ticks++;
+            report.events++;
+
+            for (const Signal& signal : pendingSignals) {
+                startAttempt(signal, now);
+            }
+            pendingSignals.clear();
+            continue;
+        }
+
+        const EventScheduler::Event event = scheduler.pop();
+        report.events++;
+        Order& order = orders[event.target];
+        if (event.type == ORDER_ARRIVAL) {
+            onArrival(order);
+            scheduler.schedule(event.time + delay(config.responseLatencyNs), FILL_REPORT, event.target);
+        } else {
+            onFillReport(order, event.time);
+        }
+    }
+
+    report.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+std::int64_t ExecutionSimulator::delay(std::int64_t latencyNs) {
+    if (config.jitterNs <= 0) return latencyNs;
+    return latencyNs + static_cast<std::int64_t>(jitter() % static_cast<std::uint64_t>(config.jitterNs + 1));
+}
+
+void ExecutionSimulator::startAttempt(const Signal& signal, std::int64_t now) {
+    report.signals++;
+    if (pathBusy[signal.path]) {
+        report.skippedBusy++;
+        return;
+    }
+
+    // Plan every leg against the books that triggered the signal, as the server sized it
+    const ArbitragePath& path = paths[signal.path];
+    const std::size_t planLevels = serverConfig.useFirstLevelOnly ? 1 : ORDER_BOOK_MAX_DEPTH;
+    Attempt attempt{signal.path, {}, {}};
+    double input = signal.notional;
+    for (std::size_t i = 0; i < path.legs.size(); ++i) {
+        const TradeLeg& leg = path.legs[i];
+        const LegFill plan = fillLeg(leg, books[leg.symbolId], input, 0, serverConfig.takerFee, planLevels);
+        attempt.plannedInputs[i] = input;
+        attempt.limitPrices[i] = leg.requiresInversion ? plan.worstPrice * (1 + config.slippageTolerance)
+                                                       : plan.worstPrice * (1 - config.slippageTolerance);
+        input = plan.output;
+    }
+    if (input <= 0) return; // A side emptied since the server evaluated, nothing to trade
+
+    const auto attemptIndex = static_cast<std::uint32_t>(attempts.size());
+    attempts.push_back(attempt);
+    pathBusy[signal.path] = true;
+    report.attempts++;
+    report.unrealisedPnl += signal.unrealisedPnl;
+
+    const std::uint32_t legsSent = config.mode == ExecutionMode::Parallel ? 3 : 1;
+    for (std::uint32_t leg = 0; leg < legsSent; ++leg) {
+        sendOrder(attemptIndex, leg, attempt.plannedInputs[leg], attempt.limitPrices[leg], now);
+    }
+}
+
+void ExecutionSimulator::sendOrder(std::uint32_t attempt, std::uint32_t leg, double input, double limitPrice,
+                                   std::int64_t now) {
+    const auto orderIndex = static_cast<std::uint32_t>(orders.size());
+    orders.push_back(Order{attempt, leg, input, limitPrice, LegFill()});
+    report.legRequested[leg] += input;
+    scheduler.schedule(now + delay(config.sendLatencyNs), ORDER_ARRIVAL, orderIndex);
+}
+
+void ExecutionSimulator::onArrival(Order& order) {
+    Attempt& attempt = attempts[order.attempt];
+    const TradeLeg& leg = paths[attempt.path].legs[order.leg];
+    order.fill = fillLeg(leg, books[leg.symbolId], order.input, order.limitPrice, serverConfig.takerFee);
+
+    attempt.balances[order.leg] -= order.fill.filledInput;
+    attempt.balances[(order.leg + 1) % 3] += order.fill.output;
+    report.legFilled[order.leg] += order.fill.filledInput;
+    if (order.fill.filledInput < order.input * (1 - FILL_EPSILON)) {
+        attempt.shortFilled = true;
+    }
+}
+
+void ExecutionSimulator::onFillReport(const Order& order, std::int64_t now) {
+    Attempt& attempt = attempts[order.attempt];
+    attempt.legsReported++;
+
+    if (config.mode == ExecutionMode::Sequential && order.leg < 2) {
+        if (order.fill.output > 0) {
+            // Only what actually filled carries on, the limit still holds the plan's worst price
+            sendOrder(order.attempt, order.leg + 1, order.fill.output, attempt.limitPrices[order.leg + 1], now);
+            return;
+        }
+        attempt.shortFilled = true; // Nothing to pass on, the remaining legs are never sent
+    } else if (attempt.legsReported < 3) {
+        return;
+    }
+    completeAttempt(attempt);
+}
+
+void ExecutionSimulator::completeAttempt(Attempt& attempt) {
+    report.realisedPnl += attempt.balances[0];
+    if (attempt.shortFilled) {
+        report.partiallyFilled++;
+        report.inventoryValue += markInventory(attempt);
+    } else {
+        report.fullyFilled++;
+    }
+    pathBusy[attempt.path] = false;
+}
+
+double ExecutionSimulator::markInventory(const Attempt& attempt) const {
+    const ArbitragePath& path = paths[attempt.path];
+    std::array<double, 3> rates{};
+    for (std::size_t i = 0; i < path.legs.size(); ++i) {
+        rates[i] = topOfBookRate(path.legs[i], books[path.legs[i].symbolId], serverConfig.takerFee);
+    }
+    // balances[1] is what leg 2 takes, balances[2] what leg 3 takes, either may be negative when legs raced
+    return attempt.balances[1] * rates[1] * rates[2] + attempt.balances[2] * rates[2];
+}
@@ -0,0 +1,171 @@
+#ifndef EXECUTION_SIMULATOR_H
+#define EXECUTION_SIMULATOR_H
+
+#include "replay/backtest.h"
+#include "replay/event_scheduler.h"
+#include "server/book_store.h"
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+enum class ExecutionMode {
+    Parallel,  // All three legs are sent at once, sized from the books that triggered the signal
+    Sequential // Each leg is sent once the previous one's fill comes back, sized by what it filled
+};
+
+// "sequential" selects Sequential, anything else Parallel
+ExecutionMode executionModeFromString(const std::string& mode);
+
+struct ExecutionConfig {
+    std::int64_t sendLatencyNs;     // From the signal, or a fill report, to the order reaching the exchange
+    std::int64_t responseLatencyNs; // From the match to its fill report reaching us
+    std::int64_t jitterNs;          // Up to this much extra delay on every order, drawn uniformly
+    ExecutionMode mode;
+    double slippageTolerance;       // Limit prices are this fraction beyond the worst price the plan touched
+    std::uint64_t seed;             // Of the jitter, so a run is reproducible
+
+    explicit ExecutionConfig(std::int64_t sendLatency = 0, std::int64_t responseLatency = 0, std::int64_t jitter = 0,
+                             ExecutionMode executionMode = ExecutionMode::Parallel, double tolerance = 0, std::uint64_t jitterSeed = 1)
+        : sendLatencyNs(sendLatency), responseLatencyNs(responseLatency), jitterNs(jitter),
+          mode(executionMode), slippageTolerance(tolerance), seed(jitterSeed) {}
+
+    // Reads BINANCE_SIM_SEND_LATENCY_US, BINANCE_SIM_RESPONSE_LATENCY_US, BINANCE_SIM_JITTER_US,
+    // BINANCE_SIM_MODE (parallel|sequential), BINANCE_SIM_SLIPPAGE_TOLERANCE and BINANCE_SIM_SEED
+    static ExecutionConfig from_env() {
+        const char* env_send_latency = std::getenv("BINANCE_SIM_SEND_LATENCY_US");
+        const char* env_response_latency = std::getenv("BINANCE_SIM_RESPONSE_LATENCY_US");
+        const char* env_jitter = std::getenv("BINANCE_SIM_JITTER_US");
+        const char* env_mode = std::getenv("BINANCE_SIM_MODE");
+        const char* env_slippage_tolerance = std::getenv("BINANCE_SIM_SLIPPAGE_TOLERANCE");
+        const char* env_seed = std::getenv("BINANCE_SIM_SEED");
+
+        return ExecutionConfig(
+            env_send_latency ? static_cast<std::int64_t>(std::stod(env_send_latency) * 1000) : 0,
+            env_response_latency ? static_cast<std::int64_t>(std::stod(env_response_latency) * 1000) : 0,
+            env_jitter ? static_cast<std::int64_t>(std::stod(env_jitter) * 1000) : 0,
+            env_mode ? executionModeFromString(env_mode) : ExecutionMode::Parallel,
+            env_slippage_tolerance ? std::stod(env_slippage_tolerance) : 0,
+            env_seed ? std::stoull(env_seed) : 1
+        );
+    }
+};
+
+// What taking one leg against a book's side yields
+struct LegFill {
+    double filledInput = 0; // In the leg's input currency
+    double output = 0;      // In its output currency, after fees
+    double worstPrice = 0;  // Deepest price traded at, 0 if nothing filled
+};
+
+/**
+ * @brief Takes input through leg's side of book as an immediate-or-cancel order.
+ *
+ * Levels are taken best first while their price is no worse than limitPrice (0 means no limit)
+ * and within maxLevels, the rest of the input stays unfilled.
+ */
+LegFill fillLeg(const TradeLeg& leg, const OrderBook& book, double input, double limitPrice,
+                double feeMultiplier, std::size_t maxLevels = ORDER_BOOK_MAX_DEPTH);
+
+struct ExecutionReport {
+    std::uint64_t ticks = 0;
+    std::uint64_t signals = 0;          // Opportunities the server reported
+    std::uint64_t skippedBusy = 0;      // Signals on a path that still had an attempt in flight
+    std::uint64_t attempts = 0;
+    std::uint64_t fullyFilled = 0;      // Attempts whose three legs filled in full
+    std::uint64_t partiallyFilled = 0;  // Attempts with at least one leg short, leaving inventory behind
+    std::array<double, 3> legRequested{}; // Input sent per leg, in each leg's own currency
+    std::array<double, 3> legFilled{};
+
+    double unrealisedPnl = 0;   // What the server reported for the signals acted on
+    double realisedPnl = 0;     // Change in start currency once every leg has filled or been cancelled
+    double inventoryValue = 0;  // Leg-risk inventory left in the intermediate currencies, in start currency
+    std::uint64_t events = 0;   // Ticks plus order events processed
+    double elapsedSeconds = 0;
+
+    double netPnl() const { return realisedPnl + inventoryValue; }
+    double eventsPerSecond() const { return elapsedSeconds > 0 ? events / elapsedSeconds : 0.0; }
+};
+
+/**
+ * @class ExecutionSimulator
+ * @brief Replays recorded ticks through a Server and executes its opportunities with latency.
+ *
+ * A discrete-event loop merges the recorded ticks, already in time order, with order events on
+ * an EventScheduler. Each opportunity becomes an attempt of three immediate-or-cancel orders,
+ * priced no worse than the plan made from the books that triggered it. An order is matched
+ * against the books as they are at its arrival time, so it fills less, or not at all, when
+ * the market has moved. What a short leg leaves behind in an intermediate currency is carried
+ * as inventory, valued when its attempt completes by taking it through the remaining legs at
+ * the best prices.
+ *
+ * Our own fills do not deplete the recorded books, and only one attempt per path is in
+ * flight at a time.
+ */
+class ExecutionSimulator {
+public:
+    ExecutionSimulator(const std::vector<ArbitragePath>& paths, const ServerConfig& serverConfig, const ExecutionConfig& config);
+    ~ExecutionSimulator();
+
+    // Runs the whole recording, once per simulator
+    ExecutionReport run(const TickRecording& recording);
+
+private:
+    enum EventType : std::uint32_t { ORDER_ARRIVAL, FILL_REPORT };
+
+    struct Signal {
+        std::uint32_t path;
+        double notional;
+        double unrealisedPnl;
+    };
+
+    struct Order {
+        std::uint32_t attempt;
+        std::uint32_t leg;
+        double input;
+        double limitPrice;
+        LegFill fill;
+    };
+
+    struct Attempt {
+        std::uint32_t path;
+        std::array<double, 3> plannedInputs; // Each leg's input in the plan made from the signal's books
+        std::array<double, 3> limitPrices;
+        std::uint32_t legsReported = 0;
+        std::array<double, 3> balances{}; // Net change in each leg's input currency, the start currency first
+        bool shortFilled = false;
+    };
+
+    class SignalWriter;
+
+    std::vector<ArbitragePath> paths;
+    const ServerConfig serverConfig;
+    const ExecutionConfig config;
+    std::unique_ptr<Server> server;
+    std::vector<std::string> pathNames;
+    std::unordered_map<std::string_view, std::uint32_t> pathIndex; // By name, as results report it
+    BookStore books; // The books as they are at the current simulation time
+    std::vector<Signal> pendingSignals;
+    std::vector<bool> pathBusy;
+    std::vector<Order> orders;
+    std::vector<Attempt> attempts;
+    EventScheduler scheduler;
+    std::mt19937_64 jitter;
+    ExecutionReport report;
+
+    std::int64_t delay(std::int64_t latencyNs);
+    void startAttempt(const Signal& signal, std::int64_t now);
+    void sendOrder(std::uint32_t attempt, std::uint32_t leg, double input, double limitPrice, std::int64_t now);
+    void onArrival(Order& order);
+    void onFillReport(const Order& order, std::int64_t now);
+    void completeAttempt(Attempt& attempt);
+    double markInventory(const Attempt& attempt) const;
+};
+
+#endif // EXECUTION_SIMULATOR_H
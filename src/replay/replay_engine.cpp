@@ -0,0 +1,154 @@
+#include "replay/replay_engine.h"
+#include "exchange/binance/binance_client.h"
+#include "common/trade_util.h"
+#include <nlohmann/json.hpp>
+#include <iterator>
+#include <thread>
+
+ReplayEngine::ReplayEngine(std::shared_ptr<Server> server, std::shared_ptr<ReplayClock> clock, const ReplayConfig& config)
+    : server(std::move(server)),
+      clock(std::move(clock)),
+      config(config),
+      symbols(this->server->getSymbolTable()),
+      sink{[this](OrderBookTick& tick) { this->server->on_update(tick); },
+           [this](const BookTicker& ticker) { this->server->on_update(ticker); }},
+      firstRecordedTimeNs(-1) {
+}
+
+ReplayEngine::ReplayEngine(const SymbolTable& symbols, ReplaySink sink, const ReplayConfig& config)
+    : config(ReplayConfig(0, config.parserMode)),
+      symbols(symbols),
+      sink(std::move(sink)),
+      firstRecordedTimeNs(-1) {
+}
+
+ReplayStats ReplayEngine::run(std::istream& input) {
+    ReplayStats stats;
+    firstRecordedTimeNs = -1;
+    replayStart = std::chrono::steady_clock::now();
+
+    // A JSON array of frames has to be parsed as a whole, everything else is one record per line
+    input >> std::ws;
+    if (input.peek() == '[') {
+        const std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        try {
+            const auto frames = nlohmann::json::parse(content);
+            for (const auto& frame : frames) {
+                stats.framesRead++;
+                dispatch(frame.dump(), -1, stats);
+            }
+        } catch (const nlohmann::json::exception& e) {
+            fail(e.what(), "Replay Parse");
+            stats.parseFailures++;
+        }
+    } else {
+        std::string line;
+        while (std::getline(input, line)) {
+            if (line.empty()) continue;
+            stats.framesRead++;
+            dispatchLine(line, stats);
+        }
+    }
+
+    stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - replayStart).count();
+    return stats;
+}
+
+ReplayStats ReplayEngine::run(FrameCaptureReader& capture, std::int64_t startTimeNs) {
+    ReplayStats stats;
+    firstRecordedTimeNs = -1;
+    replayStart = std::chrono::steady_clock::now();
+
+    if (startTimeNs >= 0) {
+        capture.seek(startTimeNs);
+    }
+    CapturedFrame frame;
+    while (capture.next(frame)) {
+        stats.framesRead++;
+        dispatch(frame.data, frame.receiveTimeNs, stats);
+    }
+
+    stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - replayStart).count();
+    return stats;
+}
+
+void ReplayEngine::dispatchLine(const std::string& line, ReplayStats& stats) {
+    try {
+        const auto record = nlohmann::json::parse(line);
+
+        // TradeFileWriter output wraps the raw frame, a bare frame is dispatched as is
+        const auto levels = record.find("orderBookLevels");
+        if (levels != record.end()) {
+            const auto receiveTime = record.find("tickReceiveTime");
+            dispatch(levels->get<std::string>(), receiveTime != record.end() ? receiveTime->get<long long>() : -1, stats);
+        } else {
+            dispatch(line, -1, stats);
+        }
+    } catch (const nlohmann::json::exception& e) {
+        fail(e.what(), "Replay Parse");
+        stats.parseFailures++;
+    }
+}
+
+void ReplayEngine::dispatch(std::string_view frame, long long recordedTimeNs, ReplayStats& stats) {
+    if (recordedTimeNs >= 0) {
+        pace(recordedTimeNs);
+    } else {
+        recordedTimeNs = SystemClock().now();
+    }
+
+    if (clock) clock->rebase(recordedTimeNs);
+
+    LatencyStats* latency = server && server->getLatencyStats().enabled() ? &server->getLatencyStats() : nullptr;
+    const std::int64_t parseStart = latency ? latencyNow() : 0;
+
+    if (isBookTickerStream(frame)) {
+        const DepthParseError err = parseBookTickerFrame(frame.data(), frame.data() + frame.size(), recordedTimeNs, symbols, bookTicker);
+        if (err != DepthParseError::None) {
+            fail(to_string(err), "Replay Dispatch");
+            stats.parseFailures++;
+            return;
+        }
+        if (latency) latency->record(LatencyStage::Parse, latencyNow() - parseStart);
+        sink.onBookTicker(bookTicker);
+        stats.ticksDispatched++;
+        return;
+    }
+
+    if (config.parserMode == DepthParserMode::Fast) {
+        const DepthParseError err = parseDepthFrame(frame.data(), frame.data() + frame.size(), recordedTimeNs, symbols, tick);
+        if (err != DepthParseError::None) {
+            fail(to_string(err), "Replay Dispatch");
+            stats.parseFailures++;
+            return;
+        }
+        if (latency) latency->record(LatencyStage::Parse, latencyNow() - parseStart);
+        sink.onTick(tick);
+        stats.ticksDispatched++;
+        return;
+    }
+
+    try {
+        const std::string json_string(frame);
+        const auto data = nlohmann::json::parse(json_string);
+        auto tick_struct = BinanceClient::to_struct(data, json_string, recordedTimeNs, symbols);
+        if (latency) latency->record(LatencyStage::Parse, latencyNow() - parseStart);
+        sink.onTick(tick_struct);
+        stats.ticksDispatched++;
+    } catch (const std::exception& e) {
+        fail(e.what(), "Replay Dispatch");
+        stats.parseFailures++;
+    }
+}
+
+void ReplayEngine::pace(long long recordedTimeNs) {
+    if (firstRecordedTimeNs < 0) {
+        firstRecordedTimeNs = recordedTimeNs;
+    }
+    if (config.speed <= 0) {
+        return;
+    }
+
+    const auto offset = std::chrono::nanoseconds(static_cast<long long>((recordedTimeNs - firstRecordedTimeNs) / config.speed));
+    std::this_thread::sleep_until(replayStart + offset);
+}
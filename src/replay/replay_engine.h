@@ -0,0 +1,107 @@
+#ifndef REPLAY_ENGINE_H
+#define REPLAY_ENGINE_H
+
+#include "common/clock.h"
+#include "exchange/binance/binance_depth_parser.h"
+#include "file/frame_capture.h"
+#include "server/arbitrage_server.h"
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/**
+ * @class ReplayClock
+ * @brief Clock that follows recorded time rather than the wall clock.
+ *
+ * Each frame rebases the clock onto its recorded receive time, and now() then advances
+ * with the real elapsed time, so processTime - tickInitTime remains the genuine compute latency.
+ */
+class ReplayClock : public Clock {
+public:
+    void rebase(long long recordedTimeNs) {
+        baseTimeNs = recordedTimeNs;
+        anchor = std::chrono::steady_clock::now();
+    }
+
+    long long now() const override {
+        return baseTimeNs + std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - anchor
+        ).count();
+    }
+
+private:
+    long long baseTimeNs = 0;
+    std::chrono::steady_clock::time_point anchor = std::chrono::steady_clock::now();
+};
+
+struct ReplayConfig {
+    double speed; // Multiple of recorded time to replay at, 0 replays as fast as possible
+    DepthParserMode parserMode;
+
+    explicit ReplayConfig(double replaySpeed = 0, DepthParserMode mode = DepthParserMode::Fast)
+        : speed(replaySpeed), parserMode(mode) {}
+};
+
+struct ReplayStats {
+    long long framesRead = 0;
+    long long ticksDispatched = 0;
+    long long parseFailures = 0;
+    double elapsedSeconds = 0;
+
+    double ticksPerSecond() const {
+        return elapsedSeconds > 0 ? ticksDispatched / elapsedSeconds : 0.0;
+    }
+};
+
+// Where a ReplayEngine without a server hands the ticks it parses, e.g. to record them
+struct ReplaySink {
+    std::function<void(OrderBookTick&)> onTick;
+    std::function<void(const BookTicker&)> onBookTicker;
+};
+
+/**
+ * @class ReplayEngine
+ * @brief Drives Server::on_update from recorded data through the same to_struct path as BinanceClient.
+ *
+ * Accepts three input shapes:
+ * - TradeFileWriter JSONL output, where each line's orderBookLevels holds the raw frame
+ *   and tickReceiveTime the time it was received
+ * - Raw combined-stream frames, one per line
+ * - A JSON array of raw combined-stream frames (e.g. example_binance_data.json)
+ *
+ * Raw frames carry no receive time, so they are always replayed as fast as possible. Frame
+ * captures are read through their own run() overload, which keeps each frame's receive time.
+ * @bookTicker frames are told apart by their stream name and always use the fast parser.
+ */
+class ReplayEngine {
+public:
+    ReplayEngine(std::shared_ptr<Server> server, std::shared_ptr<ReplayClock> clock, const ReplayConfig& config);
+
+    // Parses against symbols and hands every tick to sink rather than to a server, without pacing
+    ReplayEngine(const SymbolTable& symbols, ReplaySink sink, const ReplayConfig& config);
+
+    ReplayStats run(std::istream& input);
+
+    // Replays a FrameCaptureWriter capture, from the first frame received at or after startTimeNs if not negative
+    ReplayStats run(FrameCaptureReader& capture, std::int64_t startTimeNs = -1);
+
+private:
+    std::shared_ptr<Server> server;   // Null when replaying into a sink
+    std::shared_ptr<ReplayClock> clock;
+    const ReplayConfig config;
+    const SymbolTable& symbols;
+    ReplaySink sink;
+
+    long long firstRecordedTimeNs;
+    std::chrono::steady_clock::time_point replayStart;
+    OrderBookTick tick; // Reused by the fast parser, as in BinanceClient
+    BookTicker bookTicker;
+
+    void dispatch(std::string_view frame, long long recordedTimeNs, ReplayStats& stats);
+    void dispatchLine(const std::string& line, ReplayStats& stats);
+    void pace(long long recordedTimeNs);
+};
+
+#endif // REPLAY_ENGINE_H
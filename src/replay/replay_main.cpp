@@ -0,0 +1,114 @@
+#define _WIN32_WINNT 0x0601
+#define NOMINMAX
+
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include "replay/replay_engine.h"
+#include "file/async_result_writer.h"
+
+/**
+ * Offline replay of recorded frames through Server::on_update
+ *
+ * Usage: Replay <recorded file | capture .idx> [speed] [start time ns]
+ *
+ * speed is a multiple of recorded time (e.g. 10 replays ten times faster than it was captured),
+ * omitting it or passing 0 replays as fast as possible. A frame capture written with
+ * BINANCE_CAPTURE_DIR, found in the subdirectory of the session that wrote it, is replayed from
+ * its index file, optionally starting from the first frame received at or after the start time.
+ * The server is configured from the same BINANCE_* environment variables as Main, including
+ * BINANCE_DEPTH_PARSER (fast|json).
+ */
+int main(int argc, char* argv[]) {
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <recorded file | capture .idx> [speed] [start time ns]" << std::endl;
+        return 1;
+    }
+
+    const char* env_depth_parser = std::getenv("BINANCE_DEPTH_PARSER");
+
+    const std::string input_path = argv[1];
+    const ReplayConfig replay_config(
+        argc > 2 ? std::stod(argv[2]) : 0,
+        depthParserModeFromString(env_depth_parser ? env_depth_parser : "fast")
+    );
+
+    const char* env_path = std::getenv("BINANCE_UPDATE_FILE_PATH");
+    const char* env_file_format = std::getenv("BINANCE_UPDATE_FILE_FORMAT");
+    const char* env_file_async = std::getenv("BINANCE_UPDATE_FILE_ASYNC");
+    const char* env_arbitrage_path = std::getenv("BINANCE_ARBITRAGE_PATH");
+
+    const std::string trade_write_file_path = env_path ? env_path : "";
+    const std::string file_format = env_file_format ? env_file_format : "text";
+    const bool file_async = env_file_async && std::string(env_file_async) == "true";
+    const std::optional<AsyncWriterConfig> async_writer_config =
+        file_async ? std::optional<AsyncWriterConfig>(AsyncWriterConfig::from_env()) : std::nullopt;
+    const std::string arbitrage_path = env_arbitrage_path ? env_arbitrage_path : "btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY";
+
+    const bool is_capture = input_path.size() > 4 && input_path.compare(input_path.size() - 4, 4, ".idx") == 0;
+    const std::int64_t start_time_ns = argc > 3 ? std::stoll(argv[3]) : -1;
+
+    std::ifstream input;
+    std::unique_ptr<FrameCaptureReader> capture;
+    if (is_capture) {
+        try {
+            capture = std::make_unique<FrameCaptureReader>(input_path);
+        } catch (const std::exception& e) {
+            std::cerr << "Unable to open frame capture: " << e.what() << std::endl;
+            return 1;
+        }
+    } else {
+        input.open(input_path);
+        if (!input.is_open()) {
+            std::cerr << "Unable to open recorded file: " << input_path << std::endl;
+            return 1;
+        }
+    }
+
+    const std::vector<ArbitragePath> paths = ArbitragePath::list_from_string(arbitrage_path);
+    const ServerConfig server_config = ServerConfig::from_env();
+    auto clock = std::make_shared<ReplayClock>();
+
+    std::shared_ptr<Server> server;
+    if (trade_write_file_path.empty()) {
+        server = std::make_shared<Server>(paths, server_config, clock);
+    } else {
+        server = std::make_shared<Server>(paths, server_config, makeResultWriter(resultFileFormatFromString(file_format), trade_write_file_path, async_writer_config), clock);
+    }
+
+    std::cout << "Replaying " << input_path << " at "
+              << (replay_config.speed > 0 ? std::to_string(replay_config.speed) + "x" : std::string("max speed")) << std::endl;
+    std::cout << "Arbitrage Paths to Search (" << paths.size() << "): " << arbitrage_path << std::endl;
+    std::cout << "Depth Parser: " << (replay_config.parserMode == DepthParserMode::Fast ? "fast" : "json") << std::endl;
+    if (capture) {
+        std::cout << "Frame Capture: " << capture->segmentCount() << " segment(s), " << capture->indexSize() << " index entries";
+        if (start_time_ns >= 0) std::cout << ", from " << start_time_ns;
+        std::cout << std::endl;
+    }
+
+    ReplayEngine engine(server, clock, replay_config);
+    const ReplayStats stats = capture ? engine.run(*capture, start_time_ns) : engine.run(input);
+
+    std::cout << "########### REPLAY SUMMARY ###########" << std::endl;
+    std::cout << "Frames Read: " << stats.framesRead << std::endl;
+    std::cout << "Ticks Dispatched: " << stats.ticksDispatched << std::endl;
+    std::cout << "Parse Failures: " << stats.parseFailures << std::endl;
+    std::cout << "Elapsed Seconds: " << stats.elapsedSeconds << std::endl;
+    std::cout << "Ticks/sec: " << stats.ticksPerSecond() << std::endl;
+
+    const EvaluationStats& evaluation = server->getEvaluationStats();
+    std::cout << "Duplicate Ticks: " << evaluation.duplicateTicks << std::endl;
+    std::cout << "Unchanged Ticks: " << evaluation.unchangedTicks << std::endl;
+    std::cout << "Path Evaluations: " << evaluation.evaluations << " (" << evaluation.skippedEvaluations << " skipped)" << std::endl;
+    std::cout << "Leg Rates: " << evaluation.legRatesComputed << " computed, " << evaluation.legRatesReused << " reused" << std::endl;
+    std::cout << "Starting Notionals: " << evaluation.startingNotionalsComputed << " computed, " << evaluation.startingNotionalsReused << " reused" << std::endl;
+    std::cout << "######################################" << std::endl;
+
+    // Whatever was recorded since the last periodic dump
+    LatencyStats& latency = server->getLatencyStats();
+    if (latency.enabled()) {
+        latency.dump(std::cout, stats.elapsedSeconds);
+    }
+    return 0;
+}
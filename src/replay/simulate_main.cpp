@@ -0,0 +1,70 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include "replay/execution_simulator.h"
+
+/**
+ * Executes the opportunities found in one recording with simulated order latency
+ *
+ * Usage: Simulate <recorded file>
+ *
+ * The recording is anything Replay reads, parsed once into memory. Paths and server parameters
+ * come from the usual BINANCE_* variables, latencies and execution mode from the
+ * BINANCE_SIM_* variables read by ExecutionConfig::from_env. Prints the realised PnL of the
+ * orders that would have been sent next to the unrealised PnL the server reported.
+ */
+int main(int argc, char* argv[]) {
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <recorded file>" << std::endl;
+        return 1;
+    }
+
+    const char* env_arbitrage_path = std::getenv("BINANCE_ARBITRAGE_PATH");
+    const char* env_depth_parser = std::getenv("BINANCE_DEPTH_PARSER");
+
+    const std::string input_path = argv[1];
+    const std::string arbitrage_path = env_arbitrage_path ? env_arbitrage_path : "btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY";
+    const ServerConfig server_config = ServerConfig::from_env();
+    const ExecutionConfig execution_config = ExecutionConfig::from_env();
+
+    std::ifstream input(input_path);
+    if (!input.is_open()) {
+        std::cerr << "Unable to open recorded file: " << input_path << std::endl;
+        return 1;
+    }
+
+    const std::vector<ArbitragePath> paths = ArbitragePath::list_from_string(arbitrage_path);
+    const Server prototype(paths, server_config);
+    const TickRecording recording = TickRecording::load(
+        input, prototype.getSymbolTable(), depthParserModeFromString(env_depth_parser ? env_depth_parser : "fast"));
+
+    ExecutionSimulator simulator(paths, server_config, execution_config);
+    const ExecutionReport report = simulator.run(recording);
+
+    std::cout << "########### SIMULATION ###########" << std::endl;
+    std::cout << "Recording: " << input_path << std::endl;
+    std::cout << "Arbitrage Paths to Search (" << paths.size() << "): " << arbitrage_path << std::endl;
+    std::cout << "Mode: " << (execution_config.mode == ExecutionMode::Sequential ? "sequential" : "parallel")
+              << ", send latency " << execution_config.sendLatencyNs / 1000.0 << " us"
+              << ", response latency " << execution_config.responseLatencyNs / 1000.0 << " us"
+              << ", jitter " << execution_config.jitterNs / 1000.0 << " us"
+              << ", slippage tolerance " << execution_config.slippageTolerance << std::endl;
+    std::cout << "Ticks: " << report.ticks << ", Signals: " << report.signals
+              << " (" << report.skippedBusy << " while busy)" << std::endl;
+    std::cout << "Attempts: " << report.attempts << " (" << report.fullyFilled << " filled, "
+              << report.partiallyFilled << " short)" << std::endl;
+    for (std::size_t leg = 0; leg < report.legRequested.size(); ++leg) {
+        std::cout << "Leg " << leg + 1 << " filled: " << report.legFilled[leg] << " of " << report.legRequested[leg] << std::endl;
+    }
+    std::cout << "Unrealised PnL: " << report.unrealisedPnl << std::endl;
+    std::cout << "Realised PnL: " << report.realisedPnl << std::endl;
+    std::cout << "Inventory Value: " << report.inventoryValue << std::endl;
+    std::cout << "Net PnL: " << report.netPnl() << std::endl;
+    std::cout << "Events: " << report.events << " in " << report.elapsedSeconds << " s ("
+              << report.eventsPerSecond() << " events/s)" << std::endl;
+    std::cout << "##################################" << std::endl;
+    return 0;
+}
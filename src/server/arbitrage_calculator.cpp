@@ -1,35 +1,25 @@
 #include "arbitrage_calculator.h"
+#include "common/price_level_kernels.h"
+#include <array>
 #include <limits>
 
-StartingNotional calculateStartingNotional(const ArbitragePath& path, const std::unordered_map<std::string, OrderBookTick>& pairToPriceMap) {
+StartingNotional calculateStartingNotional(const ArbitragePath& path, const BookStore& books) {
   
     auto calculateBookSideValue = 
-        [](const std::vector<PriceLevel>& levels, bool sumBaseQuantity) -> double {
-        double totalValue = 0.0;
-        if (sumBaseQuantity) { // Sum the base currency quantity
-            for (const auto& level : levels) {
-                totalValue += level.quantity;
-            }
-        } else { // Sum the quote currency value (price * quantity)
-            for (const auto& level : levels) {
-                totalValue += level.price * level.quantity;
-            }
-        }
-        return totalValue;
+        [](PriceLevelSpan levels, bool sumBaseQuantity) -> double {
+        const LevelSums sums = sumLevels(levels);
+        return sumBaseQuantity ? sums.quantity : sums.notional;
     };
 
     // --- Leg 1: Calculate its value AND the data needed for Leg 2's conversion ---
     const auto& leg1 = path.getFirstLeg();
-    const auto& tick1 = pairToPriceMap.at(leg1.symbol);
-    const auto& levels1 = leg1.requiresInversion ? tick1.asks : tick1.bids;
+    const auto& tick1 = books[leg1.symbolId];
+    const PriceLevelSpan levels1 = leg1.requiresInversion ? tick1.asks : tick1.bids;
 
     // Calculate all required values from Leg 1 in a single pass to avoid redundancy.
-    double totalQuoteValueLeg1 = 0.0;
-    double totalBaseQuantityLeg1 = 0.0;
-    for (const auto& level : levels1) {
-        totalQuoteValueLeg1 += level.price * level.quantity;
-        totalBaseQuantityLeg1 += level.quantity;
-    }
+    const LevelSums sumsLeg1 = sumLevels(levels1);
+    const double totalQuoteValueLeg1 = sumsLeg1.notional;
+    const double totalBaseQuantityLeg1 = sumsLeg1.quantity;
 
     // Determine the final value for Leg 1 based on its inversion flag.
     const double firstLegValue = leg1.requiresInversion ? totalQuoteValueLeg1 : totalBaseQuantityLeg1;
@@ -38,8 +28,8 @@ StartingNotional calculateStartingNotional(const ArbitragePath& path, const std:
     // --- Leg 2: Calculate its value and convert it using Leg 1's data ---
     double secondLegValue = 0.0;
     const auto& leg2 = path.getSecondLeg();
-    const auto& tick2 = pairToPriceMap.at(leg2.symbol);
-    const auto& levels2 = leg2.requiresInversion ? tick2.asks : tick2.bids;
+    const auto& tick2 = books[leg2.symbolId];
+    const PriceLevelSpan levels2 = leg2.requiresInversion ? tick2.asks : tick2.bids;
 
     const double secondLegValueIntermediate = calculateBookSideValue(levels2, !leg2.requiresInversion);
     const double effectivePriceLeg1 = totalQuoteValueLeg1 / totalBaseQuantityLeg1;
@@ -50,8 +40,8 @@ StartingNotional calculateStartingNotional(const ArbitragePath& path, const std:
 
     // --- Leg 3: Opposite to Leg1's Calculation --- 
     const auto& leg3 = path.getThirdLeg();
-    const auto& tick3 = pairToPriceMap.at(leg3.symbol);
-    const auto& levels3 = leg3.requiresInversion ? tick3.asks : tick3.bids;
+    const auto& tick3 = books[leg3.symbolId];
+    const PriceLevelSpan levels3 = leg3.requiresInversion ? tick3.asks : tick3.bids;
     const double thirdLegValue = calculateBookSideValue(levels3, leg3.requiresInversion);
 
     const StartingNotional leg3StartingNotional = {thirdLegValue, leg3.symbol};
@@ -63,22 +53,22 @@ StartingNotional calculateStartingNotional(const ArbitragePath& path, const std:
     return std::min({leg1StartingNotional, leg2StartingNotional, leg3StartingNotional});
 }
 
-StartingNotional calculateStartingNotionalWithFirstLevelOnly(const ArbitragePath& path, const std::unordered_map<std::string, OrderBookTick>& pairToPriceMap){
+StartingNotional calculateStartingNotionalWithFirstLevelOnly(const ArbitragePath& path, const BookStore& books){
 
     // Get the first leg's tick data
     const auto& leg1 = path.getFirstLeg();
-    const auto& tick1 = pairToPriceMap.at(leg1.symbol);
+    const auto& tick1 = books[leg1.symbolId];
     const double firstLegValue = leg1.requiresInversion ? tick1.getBestAskQty() * tick1.getBestAskPrice() : tick1.getBestBidQty();
     const StartingNotional leg1StartingNotional = {firstLegValue, leg1.symbol};
 
     const auto& leg2 = path.getSecondLeg();
-    const auto& tick2 = pairToPriceMap.at(leg2.symbol);
+    const auto& tick2 = books[leg2.symbolId];
     const double secondLegIntermediaryValue = leg2.requiresInversion ? tick2.getBestAskQty() * tick2.getBestAskPrice() : tick2.getBestBidQty();
     const double secondLegValue = leg1.requiresInversion ? secondLegIntermediaryValue * tick1.getBestAskPrice() : secondLegIntermediaryValue / tick1.getBestBidPrice();
     const StartingNotional leg2StartingNotional = {secondLegValue, leg2.symbol};
 
     const auto& leg3 = path.getThirdLeg();
-    const auto& tick3 = pairToPriceMap.at(leg3.symbol);
+    const auto& tick3 = books[leg3.symbolId];
     const double thirdLegValue = leg3.requiresInversion ? tick3.getBestAskQty() : tick3.getBestBidQty() * tick3.getBestBidPrice();
     const StartingNotional leg3StartingNotional = {thirdLegValue, leg3.symbol};
 
@@ -89,7 +79,119 @@ StartingNotional calculateStartingNotionalWithFirstLevelOnly(const ArbitragePath
     return std::min({leg1StartingNotional, leg2StartingNotional, leg3StartingNotional});
 }
 
-double getEffectiveRate(const TradeLeg& leg,const OrderBookTick& tick, double current_notional_in_previous_leg_currency) {
+namespace {
+
+// Walks one leg's book side level by level in units of the currency the leg receives as input
+class LegCurve {
+public:
+    LegCurve(const TradeLeg& leg, const OrderBook& book, double feeMultiplier, std::size_t maxLevels)
+        : levels(leg.requiresInversion ? PriceLevelSpan(book.asks) : PriceLevelSpan(book.bids)),
+          spendsQuote(leg.requiresInversion),
+          feeMultiplier(feeMultiplier),
+          levelCount(std::min(levels.size(), maxLevels)),
+          level(0),
+          remaining(0),
+          rate(0) {
+        skipEmptyLevels();
+    }
+
+    bool exhausted() const { return level >= levelCount; }
+
+    // Output per unit of input at the current level, after fees
+    double slope() const { return rate; }
+
+    // Input the current level can still absorb
+    double capacity() const { return remaining; }
+
+    void consume(double input) {
+        remaining -= input;
+        // Relative tolerance, so rounding in the caller's unit conversions cannot strand a level
+        if (remaining <= levelInput() * 1e-12) {
+            level++;
+            skipEmptyLevels();
+        }
+    }
+
+private:
+    PriceLevelSpan levels;
+    bool spendsQuote; // SELL legs spend quote on the asks, BUY legs sell base into the bids
+    double feeMultiplier;
+    std::size_t levelCount;
+    std::size_t level;
+    double remaining;
+    double rate;
+
+    double levelInput() const {
+        const PriceLevel l = levels[level];
+        return spendsQuote ? l.price * l.quantity : l.quantity;
+    }
+
+    void skipEmptyLevels() {
+        while (level < levelCount && (levels[level].price <= 0 || levels[level].quantity <= 0)) {
+            level++;
+        }
+        if (exhausted()) {
+            remaining = 0;
+            return;
+        }
+        const double price = levels[level].price;
+        remaining = levelInput();
+        rate = (spendsQuote ? 1.0 / price : price) * feeMultiplier;
+    }
+};
+
+} // namespace
+
+OptimalTradeSize solveOptimalTradeSize(const ArbitragePath& path, const BookStore& books, double feeMultiplier, std::size_t maxLevels) {
+    std::array<LegCurve, 3> legs = {
+        LegCurve(path.legs[0], books[path.legs[0].symbolId], feeMultiplier, maxLevels),
+        LegCurve(path.legs[1], books[path.legs[1].symbolId], feeMultiplier, maxLevels),
+        LegCurve(path.legs[2], books[path.legs[2].symbolId], feeMultiplier, maxLevels),
+    };
+
+    OptimalTradeSize result{0, 0, 0};
+    double notional = 0;
+    double pnl = 0;
+    bool pastOptimum = false;
+
+    while (!legs[0].exhausted() && !legs[1].exhausted() && !legs[2].exhausted()) {
+        const double slope1 = legs[0].slope();
+        const double slope12 = slope1 * legs[1].slope();
+        const double marginal = slope12 * legs[2].slope(); // Final currency per unit of starting notional
+
+        // Starting notional until the first of the three current levels runs out
+        const double segment = std::min({legs[0].capacity(), legs[1].capacity() / slope1, legs[2].capacity() / slope12});
+        const double segmentPnl = segment * (marginal - 1.0);
+
+        if (marginal <= 1.0 && !pastOptimum) {
+            pastOptimum = true;
+            result.notional = notional;
+            result.pnl = pnl;
+        }
+
+        if (pastOptimum && pnl + segmentPnl < 0) {
+            // PnL crosses zero within this segment
+            result.breakevenNotional = pnl > 0 ? notional + pnl / (1.0 - marginal) : notional;
+            return result;
+        }
+
+        notional += segment;
+        pnl += segmentPnl;
+        legs[0].consume(segment);
+        legs[1].consume(segment * slope1);
+        legs[2].consume(segment * slope12);
+    }
+
+    // A book ran out before PnL turned negative, every size it can fill is at least breakeven
+    if (!pastOptimum) {
+        result.notional = notional;
+        result.pnl = pnl;
+    }
+    result.breakevenNotional = result.notional > 0 ? notional : 0;
+    return result;
+}
+
+double getEffectiveRate(const TradeLeg& leg,const OrderBook& tick, double current_notional_in_previous_leg_currency) {
         if (current_notional_in_previous_leg_currency <= 0 || tick.bids.empty() || tick.asks.empty()) {
             return 0.0;
         }
@@ -115,25 +217,21 @@ double getEffectiveRate(const TradeLeg& leg,const OrderBookTick& tick, double cu
         }
 }
 
-double calculateVwapBid(const std::vector<PriceLevel>& levels, double desired_quantity) {
+double calculateVwapBid(PriceLevelSpan levels, double desired_quantity) {
     if (desired_quantity <= 0) {
         return 0.0; 
     }
 
-    double total_price_x_quantity = 0.0;
-    double total_quantity_filled = 0.0;
-    double remaining_quantity_to_fill = desired_quantity;
+    // The level the sale finishes on, everything before it is sold in full
+    const FillLevel fill = findFillLevel(levels, desired_quantity, FillTarget::Quantity);
 
-    for (const auto& level : levels) {
-        if (remaining_quantity_to_fill <= 0) {
-            break; 
-        }
-
-        double fill_quantity = std::min(level.quantity, remaining_quantity_to_fill);
+    double total_price_x_quantity = fill.notionalBefore;
+    double total_quantity_filled = fill.quantityBefore;
 
-        total_price_x_quantity += (level.price * fill_quantity);
+    if (fill.index < levels.size()) {
+        const double fill_quantity = desired_quantity - fill.quantityBefore;
+        total_price_x_quantity += levels[fill.index].price * fill_quantity;
         total_quantity_filled += fill_quantity;
-        remaining_quantity_to_fill -= fill_quantity;
     }
 
     const double EPSILON = std::numeric_limits<double>::epsilon() * desired_quantity;
@@ -147,46 +245,25 @@ double calculateVwapBid(const std::vector<PriceLevel>& levels, double desired_qu
     return total_price_x_quantity / total_quantity_filled;
 }
 
-double calculateVwapAsk(const std::vector<PriceLevel>& levels, double old_currency) {
+double calculateVwapAsk(PriceLevelSpan levels, double old_currency) {
     if (old_currency <= 0.0) {
         return 0.0;
     }
 
     const double EPSILON = std::numeric_limits<double>::epsilon() * old_currency;
 
-    double total_eth_acquired = 0.0;
-    double usdt_spent_actual = 0.0; 
-    double remaining_usdt_to_spend = old_currency;
-
-    for (const auto& level : levels) {
-        double price = level.price;
-        double available_eth_at_level = level.quantity;
-
-
-        double cost_to_buy_all_at_level = price * available_eth_at_level;
+    // The level the spend finishes on, everything before it is bought in full
+    const FillLevel fill = findFillLevel(levels, old_currency, FillTarget::Notional);
 
-        if (remaining_usdt_to_spend >= cost_to_buy_all_at_level) {
-            // Buy all the ETH at this level
-            total_eth_acquired += available_eth_at_level;
-            usdt_spent_actual += cost_to_buy_all_at_level;
-            remaining_usdt_to_spend -= cost_to_buy_all_at_level;
-        } else {
-            // Buy only a portion of ETH with the remaining USDT
-            // This is where the division of (remaining_usdt / price) happens
-            double eth_to_buy_with_remaining_usdt = remaining_usdt_to_spend / price;
+    double total_eth_acquired = fill.quantityBefore;
+    double usdt_spent_actual = fill.notionalBefore;
+    double remaining_usdt_to_spend = old_currency - fill.notionalBefore;
 
-            total_eth_acquired += eth_to_buy_with_remaining_usdt;
-            usdt_spent_actual += remaining_usdt_to_spend; // All remaining USDT is spent here
-            remaining_usdt_to_spend = 0.0; // No USDT left
-
-            break; // All funds spent, stop processing further levels
-        }
-
-        // If all old_currency has been spent (or very close to it due to precision), break
-        if (remaining_usdt_to_spend <= EPSILON) {
-            remaining_usdt_to_spend = 0.0; 
-            break;
-        }
+    if (fill.index < levels.size() && remaining_usdt_to_spend > EPSILON) {
+        // Buy only a portion of ETH with the remaining USDT
+        total_eth_acquired += remaining_usdt_to_spend / levels[fill.index].price;
+        usdt_spent_actual += remaining_usdt_to_spend; // All remaining USDT is spent here
+        remaining_usdt_to_spend = 0.0; // No USDT left
     }
 
     if (total_eth_acquired > 0.0 && remaining_usdt_to_spend <= EPSILON) {
@@ -200,4 +277,4 @@ double calculateVwapAsk(const std::vector<PriceLevel>& levels, double old_curren
     //     << ", Remaining : " << remaining_usdt_to_spend << "\n";
 
     return 0.0;
-}
\ No newline at end of file
+}
@@ -3,11 +3,12 @@
 #include <algorithm>
 #include <common/order_book.h>
 #include <common/trade_leg.h>
-#include <unordered_map>
+#include "server/book_store.h"
+#include <string_view>
 
 struct StartingNotional {
     double notional;
-    std::string bottleneckLeg;
+    std::string_view bottleneckLeg; // Symbol of the limiting leg, points into the ArbitragePath
 
     bool operator<(const StartingNotional& other) const {
         // Comparison is based solely on the 'notional' value
@@ -40,12 +41,35 @@ struct StartingNotional {
     If Leg1 is Bid then divide by Leg1's Rate
     Otherwise Leg1 is Ask so multiply by Leg1's Rate
  */
-StartingNotional calculateStartingNotional(const ArbitragePath& path, const std::unordered_map<std::string, OrderBookTick>& pairToPriceMap);
+StartingNotional calculateStartingNotional(const ArbitragePath& path, const BookStore& books);
 
-StartingNotional calculateStartingNotionalWithFirstLevelOnly(const ArbitragePath& path, const std::unordered_map<std::string, OrderBookTick>& pairToPriceMap);
+StartingNotional calculateStartingNotionalWithFirstLevelOnly(const ArbitragePath& path, const BookStore& books);
 
-double getEffectiveRate(const TradeLeg& leg, const OrderBookTick& tick, double current_notional_in_previous_leg_currency);
+struct OptimalTradeSize {
+    double notional;          // Starting notional maximising absolute PnL, 0 when no size is profitable
+    double pnl;               // PnL at that notional, in the start currency
+    double breakevenNotional; // Largest starting notional whose PnL is still non-negative
+};
+
+/**
+ * Finds the trade size maximising absolute PnL, and the breakeven size, exactly.
+ *
+ * Each leg's output as a function of its input is piecewise linear, with one segment per book
+ * level and a slope of the level's rate times the fee, decreasing as the trade walks deeper.
+ * Their composition is therefore concave and piecewise linear, with breakpoints wherever any
+ * leg crosses a level. Walking those breakpoints in order, PnL grows while the product of the
+ * three current slopes exceeds 1, so the optimum is the first breakpoint where it no longer
+ * does. Continuing the walk until PnL returns to 0 gives the breakeven size. The walk visits
+ * each level of each leg at most once.
+ *
+ * @param feeMultiplier What remains of each leg after fees, i.e. ServerConfig::takerFee
+ * @param maxLevels Levels per side to consider, 1 matches useFirstLevelOnly
+ */
+OptimalTradeSize solveOptimalTradeSize(const ArbitragePath& path, const BookStore& books, double feeMultiplier,
+                                       std::size_t maxLevels = ORDER_BOOK_MAX_DEPTH);
+
+double getEffectiveRate(const TradeLeg& leg, const OrderBook& tick, double current_notional_in_previous_leg_currency);
 
-double calculateVwapBid(const std::vector<PriceLevel>& levels, double desired_quantity);
+double calculateVwapBid(PriceLevelSpan levels, double desired_quantity);
 
-double calculateVwapAsk(const std::vector<PriceLevel>& levels, double old_currency);
+double calculateVwapAsk(PriceLevelSpan levels, double old_currency);
@@ -7,54 +7,249 @@
 #include <iostream>
 #include <cmath>
 
-Server::Server(const ArbitragePath& path, 
-               const ServerConfig& config)
-               : lastUpdateId(0), 
-               path(path),
-               currentNotional(0),
-               ticksRemainingBeforeRecalc(0),
-               config(config),
-               tradeFileWriter(nullptr) {
+namespace {
+
+bool sameLevel(const PriceLevel& a, const PriceLevel& b) {
+    return a.price == b.price && a.quantity == b.quantity;
 }
 
-Server::Server(const ArbitragePath& path, 
+} // namespace
+
+Server::Server(const std::vector<ArbitragePath>& arbitragePaths, 
                const ServerConfig& config,
-               std::unique_ptr<TradeFileWriter>&& writer)
-               : lastUpdateId(0), 
-               path(path),
-               currentNotional(0),
-               ticksRemainingBeforeRecalc(0),
+               std::shared_ptr<const Clock> clock)
+               : Server(arbitragePaths, config, nullptr, std::move(clock)) {
+}
+
+Server::Server(const std::vector<ArbitragePath>& arbitragePaths, 
+               const ServerConfig& config,
+               std::unique_ptr<ResultWriter>&& writer,
+               std::shared_ptr<const Clock> clock)
+               : concurrentUpdates(false),
+               lastUpdateId(0), 
                config(config),
-               tradeFileWriter(std::move(writer)) {
+               tradeFileWriter(std::move(writer)),
+               clock(std::move(clock)),
+               latency("SERVER", config.latencyDumpInterval) {
+
+    paths.reserve(arbitragePaths.size());
+    for (const auto& arbitragePath : arbitragePaths) {
+        PathState state(arbitragePath);
+        state.path.internSymbols(symbols);
+        paths.push_back(std::move(state));
+    }
+
+    // One book per symbol no matter how many paths share it, and the paths to re-evaluate per symbol
+    books = BookStore(symbols.size());
+    sideVersions.resize(symbols.size());
+    symbolToPaths.resize(symbols.size());
+    for (std::uint32_t pathIndex = 0; pathIndex < paths.size(); ++pathIndex) {
+        for (const auto& leg : paths[pathIndex].path.legs) {
+            auto& symbolPaths = symbolToPaths[leg.symbolId];
+            if (symbolPaths.empty() || symbolPaths.back() != pathIndex) {
+                symbolPaths.push_back(pathIndex);
+            }
+        }
+    }
 }
 
 void Server::on_update(OrderBookTick& update) {
-    // std::lock_guard<std::mutex> lock(mutex);
-    
-    pairToPriceMap.insert_or_assign(update.symbol, update);
+    std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+    if (concurrentUpdates) lock.lock();
 
-    // Wait until we have at least 3 pairs to check for arbitrage opportunities
-    if (pairToPriceMap.size() < 3){
-        return; 
+    if (!books.contains(update.symbolId)) {
+        return; // Not a leg of any path
     }
 
-    recalcStartingNotional();
+    OrderBook& book = books[update.symbolId];
+    if (isDuplicate(book, update.updateId)) {
+        return;
+    }
+
+    const bool timed = latency.enabled();
+    const std::int64_t bookUpdateStart = timed ? latencyNow() : 0;
+
+    const std::uint8_t changes = sideChanges(book, update.bids, update.asks);
+    book = update;
+    bumpVersions(update.symbolId, changes);
+
+    if (timed) latency.record(LatencyStage::BookUpdate, latencyNow() - bookUpdateStart);
+
+    evaluatePaths({update.symbolId, update.symbol, update.jsonStr, update.tickInitTime, changes}, timed);
+}
+
+void Server::on_update(const BookTicker& update) {
+    std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+    if (concurrentUpdates) lock.lock();
+
+    if (!books.contains(update.symbolId)) {
+        return; // Not a leg of any path
+    }
+
+    OrderBook& book = books[update.symbolId];
+    if (isDuplicate(book, update.updateId)) {
+        return;
+    }
+
+    const bool timed = latency.enabled();
+    const std::int64_t bookUpdateStart = timed ? latencyNow() : 0;
+
+    const std::uint8_t changes = sideChanges(book, update.bid, update.ask);
+    book.setTopOfBook(update.updateId, update.bid, update.ask, update.tickInitTime);
+    bumpVersions(update.symbolId, changes);
+
+    if (timed) latency.record(LatencyStage::BookUpdate, latencyNow() - bookUpdateStart);
+
+    evaluatePaths({update.symbolId, update.symbol, update.jsonStr, update.tickInitTime, changes}, timed);
+}
+
+bool Server::isDuplicate(const OrderBook& book, long long updateId) {
+    evaluationStats.ticks++;
+    ServerCounters::add(counters.ticks, 1);
+    // Binance update ids only grow, so anything not newer has already been applied
+    if (book.hasUpdate() && updateId <= book.updateId) {
+        evaluationStats.duplicateTicks++;
+        return true;
+    }
+    return false;
+}
+
+std::uint8_t Server::sideChanges(const OrderBook& book, const PriceLevels<ORDER_BOOK_MAX_DEPTH>& bids,
+                                 const PriceLevels<ORDER_BOOK_MAX_DEPTH>& asks) {
+    std::uint8_t changes = 0;
+    if (book.bids != bids) {
+        changes |= BIDS_CHANGED;
+        if (book.bids.empty() || bids.empty() || !sameLevel(book.bids[0], bids[0])) changes |= BEST_BID_CHANGED;
+    }
+    if (book.asks != asks) {
+        changes |= ASKS_CHANGED;
+        if (book.asks.empty() || asks.empty() || !sameLevel(book.asks[0], asks[0])) changes |= BEST_ASK_CHANGED;
+    }
+    // getEffectiveRate refuses a book with either side empty, so one emptying or filling changes both
+    if (book.bids.empty() != bids.empty() || book.asks.empty() != asks.empty()) {
+        changes |= BIDS_CHANGED | ASKS_CHANGED;
+    }
+    return changes;
+}
 
-    double initialNotional = startingNotional.notional * config.maxStartingNotionalFraction;
+std::uint8_t Server::sideChanges(const OrderBook& book, const PriceLevel& bid, const PriceLevel& ask) {
+    std::uint8_t changes = 0;
+    const bool sameBestBid = !book.bids.empty() && sameLevel(book.bids[0], bid);
+    const bool sameBestAsk = !book.asks.empty() && sameLevel(book.asks[0], ask);
+    if (!sameBestBid) changes |= BEST_BID_CHANGED;
+    if (!sameBestAsk) changes |= BEST_ASK_CHANGED;
+    // The ticker replaces each side with its single best level
+    if (!sameBestBid || book.bids.size() != 1) changes |= BIDS_CHANGED;
+    if (!sameBestAsk || book.asks.size() != 1) changes |= ASKS_CHANGED;
+    if (book.bids.empty() || book.asks.empty()) {
+        changes |= BIDS_CHANGED | ASKS_CHANGED;
+    }
+    return changes;
+}
+
+void Server::bumpVersions(SymbolId id, std::uint8_t changes) {
+    if (changes == 0) {
+        evaluationStats.unchangedTicks++;
+        return;
+    }
+    SideVersions& versions = sideVersions[id];
+    if (changes & BIDS_CHANGED) versions.bids++;
+    if (changes & ASKS_CHANGED) versions.asks++;
+    if (changes & BEST_BID_CHANGED) versions.bestBid++;
+    if (changes & BEST_ASK_CHANGED) versions.bestAsk++;
+}
+
+std::array<std::uint64_t, 3> Server::legVersions(const ArbitragePath& path, bool firstLevel) const {
+    std::array<std::uint64_t, 3> result;
+    for (std::size_t i = 0; i < 3; ++i) {
+        const TradeLeg& leg = path.legs[i];
+        const SideVersions& versions = sideVersions[leg.symbolId];
+        // Buying spends quote on the asks, selling hits the bids
+        if (leg.requiresInversion) {
+            result[i] = firstLevel ? versions.bestAsk : versions.asks;
+        } else {
+            result[i] = firstLevel ? versions.bestBid : versions.bids;
+        }
+    }
+    return result;
+}
+
+void Server::evaluatePaths(const TickOrigin& origin, bool timed) {
+    // Only the triangles containing this symbol can have changed
+    for (const std::uint32_t pathIndex : symbolToPaths[origin.symbolId]) {
+        evaluatePath(paths[pathIndex], origin);
+    }
+
+    if (timed) {
+        latency.record(LatencyStage::EndToEnd, clock->now() - origin.tickInitTime);
+        latency.maybeDump(latencyNow());
+    }
+}
+
+void Server::evaluatePath(PathState& state, const TickOrigin& origin) {
+    const ArbitragePath& path = state.path;
+
+    // Wait until we have all 3 pairs to check for arbitrage opportunities
+    for (const auto& leg : path.legs) {
+        if (!books[leg.symbolId].hasUpdate()) {
+            return;
+        }
+    }
+
+    // Nothing this path reads has moved, so its last result still stands
+    bool tradedSideChanged = false;
+    for (const auto& leg : path.legs) {
+        if (leg.symbolId == origin.symbolId) {
+            tradedSideChanged |= (origin.changes & (leg.requiresInversion ? ASKS_CHANGED : BIDS_CHANGED)) != 0;
+        }
+    }
+    if (!tradedSideChanged) {
+        evaluationStats.skippedEvaluations++;
+        ServerCounters::add(counters.skippedEvaluations, 1);
+        return;
+    }
+    evaluationStats.evaluations++;
+    ServerCounters::add(counters.evaluations, 1);
+
+    const bool timed = latency.enabled();
+    std::int64_t stageStart = timed ? latencyNow() : 0;
+
+    recalcStartingNotional(state);
+
+    if (timed) {
+        const std::int64_t now = latencyNow();
+        latency.record(LatencyStage::StartingNotional, now - stageStart);
+        stageStart = now;
+    }
+
+    double initialNotional = state.startingNotional.notional * config.maxStartingNotionalFraction;
     double newNotional = initialNotional;
 
     std::array<double, 3> rates;
+    const std::array<std::uint64_t, 3> versions = legVersions(path, false);
 
     for (int i = 0; i < 3; ++i) {
         const auto& trade_leg = path.legs[i];
-        const auto& leg_tick = pairToPriceMap.find(trade_leg.symbol)->second;
-        double rate = getEffectiveRate(trade_leg, leg_tick, newNotional);
+        const auto& leg_tick = books[trade_leg.symbolId];
+
+        // Legs ahead of the one that ticked usually see the same side and notional as last time
+        PathState::LegRate& cached = state.legRates[i];
+        double rate;
+        if (cached.version == versions[i] && cached.inputNotional == newNotional) {
+            rate = cached.rate;
+            evaluationStats.legRatesReused++;
+        } else {
+            rate = getEffectiveRate(trade_leg, leg_tick, newNotional);
+            cached = {versions[i], newNotional, rate};
+            evaluationStats.legRatesComputed++;
+        }
 
         // std::cout << "Update ID: " << leg_tick.updateId
         //           << ", Symbol: " << trade_leg.symbol
         //           << ", Rate VWAP: " << rate << "\n";
 
         if (rate <= 0){
+            if (timed) latency.record(LatencyStage::EffectiveRates, latencyNow() - stageStart);
             return; 
         }
 
@@ -62,6 +257,8 @@ void Server::on_update(OrderBookTick& update) {
         newNotional = newNotional * rate * config.takerFee;
     }
 
+    if (timed) latency.record(LatencyStage::EffectiveRates, latencyNow() - stageStart);
+
     double profit = newNotional - initialNotional;
     // std::cout << std::fixed << std::setprecision(15) << profit << "\n"; // Example: 15 decimal places
 
@@ -74,36 +271,59 @@ void Server::on_update(OrderBookTick& update) {
         // std::cout << "Final Notional after Trades: " << newNotional << "\n";
         // std::cout << "Profit: " << profit << "\n";
 
-        currentNotional = newNotional;
+        state.currentNotional = newNotional;
         arbitrageOpportunity = true; 
+        ServerCounters::add(counters.opportunities, 1);
     } 
 
-    const long long processTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::system_clock::now().time_since_epoch()
-    ).count();
+    // The fixed fraction above is what gets reported as traded, the solver says what the books would have allowed
+    const OptimalTradeSize optimal = solveOptimalTradeSize(path, books, config.takerFee,
+                                                           config.useFirstLevelOnly ? 1 : ORDER_BOOK_MAX_DEPTH);
+
+    const long long processTime = clock->now();
 
     // std::cout << std::fixed << std::setprecision(10) << "nanoseconds taken " << update.processTime - update.tickInitTime << "\n";
 
-    const ArbitrageResult arbitrageResult = ArbitrageResult(update.symbol,
-        update.jsonStr,
-        update.tickInitTime,
+    const OrderBook& updatedBook = books[origin.symbolId];
+
+    const ArbitrageResult arbitrageResult = ArbitrageResult(origin.symbol,
+        state.name,
+        origin.jsonStr,
+        origin.tickInitTime,
         processTime, 
         profit, 
         initialNotional, 
-        startingNotional.bottleneckLeg, 
+        state.startingNotional.bottleneckLeg, 
         arbitrageOpportunity, 
-        rates);
+        rates,
+        optimal.notional,
+        optimal.pnl,
+        optimal.breakevenNotional,
+        updatedBook.bids,
+        updatedBook.asks);
 
     if (tradeFileWriter){
+        if (timed) stageStart = latencyNow();
         tradeFileWriter->write(arbitrageResult);
+        if (timed) latency.record(LatencyStage::WriterEnqueue, latencyNow() - stageStart);
     }
 }
 
-void Server::recalcStartingNotional() {
-    if (ticksRemainingBeforeRecalc == 0) {
-        ticksRemainingBeforeRecalc = config.maxStartingNotionalRecalcInterval;
-        startingNotional = config.useFirstLevelOnly ? calculateStartingNotionalWithFirstLevelOnly(path,pairToPriceMap) : calculateStartingNotional(path,pairToPriceMap);
+void Server::recalcStartingNotional(PathState& state) {
+    if (state.ticksRemainingBeforeRecalc == 0) {
+        state.ticksRemainingBeforeRecalc = config.maxStartingNotionalRecalcInterval;
+
+        // First-level-only notionals depend on nothing past each side's best level
+        const std::array<std::uint64_t, 3> versions = legVersions(state.path, config.useFirstLevelOnly);
+        if (state.hasStartingNotional && versions == state.startingNotionalVersions) {
+            evaluationStats.startingNotionalsReused++;
+            return;
+        }
+        state.startingNotional = config.useFirstLevelOnly ? calculateStartingNotionalWithFirstLevelOnly(state.path,books) : calculateStartingNotional(state.path,books);
+        state.startingNotionalVersions = versions;
+        state.hasStartingNotional = true;
+        evaluationStats.startingNotionalsComputed++;
     } else {
-        ticksRemainingBeforeRecalc--;
+        state.ticksRemainingBeforeRecalc--;
     }
 }
\ No newline at end of file
@@ -3,10 +3,22 @@
 
 #include "common/order_book.h"
 #include "common/trade_leg.h"
+#include "common/clock.h"
+#include "file/result_writer.h"
 #include "file/trade_file_writer.h"
 #include "arbitrage_calculator.h"
+#include "server/book_store.h"
+#include "common/symbol_table.h"
+#include "common/latency_stats.h"
+#include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
 #include <boost/asio/io_context.hpp>
 #include <boost/beast/core.hpp>
 
@@ -16,37 +28,191 @@ struct ServerConfig {
     double maxStartingNotionalFraction;
     double maxStartingNotionalRecalcInterval;
     bool useFirstLevelOnly;
+    double latencyDumpInterval; // Seconds between per-stage latency dumps, 0 disables latency recording
 
     // Constructor to easily initialize config
-    ServerConfig(double profitThresh, double fee, double maxNotionalFraction, double maxNotionalRecalcInterval, bool useFirstLevel)
-        : profitThreshold(profitThresh+1), takerFee(1-fee), maxStartingNotionalFraction(maxNotionalFraction), maxStartingNotionalRecalcInterval(maxNotionalRecalcInterval), useFirstLevelOnly(useFirstLevel) {}
+    ServerConfig(double profitThresh, double fee, double maxNotionalFraction, double maxNotionalRecalcInterval, bool useFirstLevel, double latencyInterval = 0)
+        : profitThreshold(profitThresh+1), takerFee(1-fee), maxStartingNotionalFraction(maxNotionalFraction), maxStartingNotionalRecalcInterval(maxNotionalRecalcInterval), useFirstLevelOnly(useFirstLevel), latencyDumpInterval(latencyInterval) {}
+
+    // Reads the BINANCE_* environment variables shared by every executable, falling back to the defaults
+    static ServerConfig from_env() {
+        const char* env_profit_threshold = std::getenv("BINANCE_PROFIT_THRESHOLD");
+        const char* env_taker_fee = std::getenv("BINANCE_TAKER_FEE");
+        const char* env_max_starting_notional_fraction = std::getenv("BINANCE_MAX_STARTING_NOTIONAL_FRACTION");
+        const char* env_max_starting_notional_recalc_interval = std::getenv("BINANCE_MAX_STARTING_NOTIONAL_RECALC_INTERVAL");
+        const char* env_use_first_level_only = std::getenv("BINANCE_USE_FIRST_LEVEL_ONLY");
+        const char* env_latency_dump_interval = std::getenv("BINANCE_LATENCY_DUMP_INTERVAL");
+
+        return ServerConfig(
+            env_profit_threshold ? std::stod(env_profit_threshold) : 0,
+            env_taker_fee ? std::stod(env_taker_fee) : 0,
+            env_max_starting_notional_fraction ? std::stod(env_max_starting_notional_fraction) : 1,
+            env_max_starting_notional_recalc_interval ? std::stod(env_max_starting_notional_recalc_interval) : 0,
+            env_use_first_level_only ? std::string(env_use_first_level_only) == "true" : true,
+            env_latency_dump_interval ? std::stod(env_latency_dump_interval) : 0
+        );
+    }
+};
+
+// Work done and avoided by on_update, read on the thread calling it or once it has stopped
+struct EvaluationStats {
+    long long ticks = 0;                     // Updates for symbols on at least one path
+    long long duplicateTicks = 0;            // Update id no newer than the book's, dropped unapplied
+    long long unchangedTicks = 0;            // Applied, but neither side's levels differed
+    long long evaluations = 0;               // Path evaluations run, each writing one result
+    long long skippedEvaluations = 0;        // Paths not re-evaluated because the sides they trade did not change
+    long long legRatesComputed = 0;
+    long long legRatesReused = 0;            // The leg's side and incoming notional were unchanged since last computed
+    long long startingNotionalsComputed = 0;
+    long long startingNotionalsReused = 0;   // Every side it is computed from was unchanged
+};
+
+/**
+ * @struct ServerCounters
+ * @brief Running totals of on_update for readers on other threads, such as the metrics endpoint.
+ *
+ * Only one thread runs on_update at a time, so counts are stored rather than atomically
+ * incremented and relaxed loads are enough to read them.
+ */
+struct ServerCounters {
+    std::atomic<std::uint64_t> ticks{0};
+    std::atomic<std::uint64_t> evaluations{0};
+    std::atomic<std::uint64_t> skippedEvaluations{0};
+    std::atomic<std::uint64_t> opportunities{0}; // Evaluations clearing the profit threshold
+
+    static void add(std::atomic<std::uint64_t>& counter, std::uint64_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
 };
 
+/**
+ * @class Server
+ * @brief Evaluates any number of arbitrage paths against one shared book per symbol.
+ *
+ * An inverted index from symbol to the paths using it means a tick only re-evaluates the
+ * triangles that contain that symbol. Each result is tagged with the path that produced it.
+ *
+ * Evaluation is incremental. A tick whose update id is not newer than the book's is dropped,
+ * and one that leaves every side a path trades unchanged does not re-evaluate that path or
+ * write a result for it. Each side of each book carries a version bumped on every change, so
+ * paths can reuse a leg's rate and their starting notional until a side they depend on moves.
+ */
 class Server : public std::enable_shared_from_this<Server> {
 public:
-    Server(const ArbitragePath& path,
-           const ServerConfig& config);
+    Server(const std::vector<ArbitragePath>& paths,
+           const ServerConfig& config,
+           std::shared_ptr<const Clock> clock = std::make_shared<SystemClock>());
 
-    Server(const ArbitragePath& path,
+    Server(const std::vector<ArbitragePath>& paths,
            const ServerConfig& config,
-           std::unique_ptr<TradeFileWriter>&& writer);
+           std::unique_ptr<ResultWriter>&& writer,
+           std::shared_ptr<const Clock> clock = std::make_shared<SystemClock>());
 
     //Receive updates from 3rd party clients
     void on_update(OrderBookTick& update);
 
+    // Best bid and ask only, written straight into the symbol's book as its single level per side
+    void on_update(const BookTicker& update);
+
+    // Symbols interned at construction, used by parsers to resolve OrderBookTick::symbolId
+    const SymbolTable& getSymbolTable() const { return symbols; }
+
+    // Serialises on_update on a mutex so several connections can feed one server from their own threads.
+    // Each caller's updates are still handled in the order it made them, so keeping a symbol on one
+    // connection keeps its ticks in order.
+    void setConcurrentUpdates(bool enabled) { concurrentUpdates = enabled; }
+
+    const EvaluationStats& getEvaluationStats() const { return evaluationStats; }
+
+    // The headline figures of getEvaluationStats, safe to read from any thread while updates go on
+    const ServerCounters& getCounters() const { return counters; }
+
+    // Null when results are discarded
+    const ResultWriter* getResultWriter() const { return tradeFileWriter.get(); }
+
+    // Per-stage latencies recorded under on_update, the offline Replay tool records its parse stage here too
+    LatencyStats& getLatencyStats() { return latency; }
+
+    // Stamps results, and the ticks of clients feeding this server, so both are on the same clock
+    const Clock& getClock() const { return *clock; }
+
 
 private:
-    std::mutex mutex;
-    double currentNotional;
-    double ticksRemainingBeforeRecalc;
-    StartingNotional startingNotional;
+    // Evaluation state kept separately for every path
+    struct PathState {
+        ArbitragePath path;
+        std::string name; // Path in BINANCE_ARBITRAGE_PATH notation, written with each result
+        double currentNotional;
+        double ticksRemainingBeforeRecalc;
+        StartingNotional startingNotional;
+
+        // Last rate computed for each leg, still valid while its side's version and incoming notional match
+        struct LegRate {
+            std::uint64_t version = 0;
+            double inputNotional = -1;
+            double rate = 0;
+        };
+        std::array<LegRate, 3> legRates;
+        std::array<std::uint64_t, 3> startingNotionalVersions{}; // Side versions startingNotional was computed from
+        bool hasStartingNotional = false;
+
+        explicit PathState(const ArbitragePath& p)
+            : path(p), name(p.to_string()), currentNotional(0), ticksRemainingBeforeRecalc(0), startingNotional{0, {}} {}
+    };
+
+    // Which parts of a book a tick changed
+    enum SideChange : std::uint8_t {
+        BIDS_CHANGED = 1,
+        ASKS_CHANGED = 2,
+        BEST_BID_CHANGED = 4,
+        BEST_ASK_CHANGED = 8
+    };
+
+    // Bumped on every change to a symbol's side, or to just its first level, for the caches in PathState
+    struct SideVersions {
+        std::uint64_t bids = 0;
+        std::uint64_t asks = 0;
+        std::uint64_t bestBid = 0;
+        std::uint64_t bestAsk = 0;
+    };
+
+    std::mutex mutex; // Held through on_update when concurrentUpdates is set
+    bool concurrentUpdates;
     long long lastUpdateId; 
-    const ArbitragePath path;
+    SymbolTable symbols;
+    std::vector<PathState> paths;
+    std::vector<std::vector<std::uint32_t>> symbolToPaths; // Indexed by SymbolId, holds indices into paths
     const ServerConfig config;
-    const std::unique_ptr<TradeFileWriter> tradeFileWriter;
-    std::unordered_map<std::string, OrderBookTick> pairToPriceMap; 
+    const std::unique_ptr<ResultWriter> tradeFileWriter;
+    const std::shared_ptr<const Clock> clock;
+    BookStore books; // One preallocated slot per interned symbol
+    std::vector<SideVersions> sideVersions; // Indexed by SymbolId
+    EvaluationStats evaluationStats;
+    ServerCounters counters;
+    LatencyStats latency;
+
+    // Where a book change came from, reported with every result it produces
+    struct TickOrigin {
+        SymbolId symbolId;
+        std::string_view symbol;
+        std::string_view jsonStr;
+        long long tickInitTime;
+        std::uint8_t changes; // SideChange flags
+    };
+
+    // SideChange flags between a book and the sides about to replace it
+    static std::uint8_t sideChanges(const OrderBook& book, const PriceLevels<ORDER_BOOK_MAX_DEPTH>& bids,
+                                    const PriceLevels<ORDER_BOOK_MAX_DEPTH>& asks);
+    static std::uint8_t sideChanges(const OrderBook& book, const PriceLevel& bid, const PriceLevel& ask);
+    // Drops updates whose id the book has already seen, counting every update it is given
+    bool isDuplicate(const OrderBook& book, long long updateId);
+    void bumpVersions(SymbolId id, std::uint8_t changes);
+    // The version of the side each leg trades, of its first level alone if firstLevel
+    std::array<std::uint64_t, 3> legVersions(const ArbitragePath& path, bool firstLevel) const;
 
-    void recalcStartingNotional();
+    void evaluatePaths(const TickOrigin& origin, bool timed);
+    void evaluatePath(PathState& state, const TickOrigin& origin);
+    void recalcStartingNotional(PathState& state);
 
 };
 
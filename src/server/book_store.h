@@ -0,0 +1,39 @@
+#ifndef BOOK_STORE_H
+#define BOOK_STORE_H
+
+#include "common/cache_line.h"
+#include "common/order_book.h"
+#include "common/symbol_table.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class BookStore
+ * @brief Contiguous per-symbol order books indexed by SymbolId.
+ *
+ * Each slot starts on its own cache line, so a path evaluation touches exactly the slots of its
+ * three legs and updates to one symbol never share a line with another. Slots are allocated
+ * once, up front, and overwritten in place.
+ */
+class BookStore {
+public:
+    BookStore() = default;
+
+    explicit BookStore(std::size_t symbolCount) : slots(symbolCount) {}
+
+    OrderBook& operator[](SymbolId id) { return slots[id].book; }
+    const OrderBook& operator[](SymbolId id) const { return slots[id].book; }
+
+    bool contains(SymbolId id) const { return id < slots.size(); }
+
+    std::size_t size() const { return slots.size(); }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        OrderBook book;
+    };
+
+    std::vector<Slot> slots;
+};
+
+#endif // BOOK_STORE_H
@@ -0,0 +1,199 @@
+#include "server/compute_pipeline.h"
+#include "common/thread_affinity.h"
+#include "common/trade_util.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+// Ticks taken from one queue before moving to the next, so a busy connection cannot starve the rest
+constexpr std::size_t DRAIN_BATCH = 64;
+
+} // namespace
+
+TickQueue::TickQueue(std::size_t capacity, OverflowPolicy policy)
+    : policy(policy), ring(std::max<std::size_t>(capacity, 1)), pushed(0), dropped(0), highWaterMark(0) {
+}
+
+TickQueue::Slot* TickQueue::acquireSlot() {
+    Slot* slot = ring.producerSlot();
+    while (!slot) {
+        if (policy != OverflowPolicy::Block) {
+            const long long droppedTicks = dropped.load(std::memory_order_relaxed) + 1;
+            dropped.store(droppedTicks, std::memory_order_relaxed);
+            if (policy == OverflowPolicy::Count && (droppedTicks & (droppedTicks - 1)) == 0) {
+                const std::string message = std::to_string(droppedTicks) + " ticks dropped, compute thread is behind";
+                fail(message.c_str(), "TickQueue");
+            }
+            return nullptr;
+        }
+        std::this_thread::yield();
+        slot = ring.producerSlot();
+    }
+    return slot;
+}
+
+void TickQueue::publish(Slot& slot, std::string_view frame) {
+    // assign() reuses the slot's capacity from earlier laps
+    slot.frame.assign(frame);
+    slot.publishTime = latencyNow();
+    ring.publish();
+
+    pushed.store(pushed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    const auto queued = static_cast<long long>(ring.size());
+    if (queued > highWaterMark.load(std::memory_order_relaxed)) {
+        highWaterMark.store(queued, std::memory_order_relaxed);
+    }
+}
+
+bool TickQueue::push(const OrderBookTick& tick) {
+    if (tick.symbolId == INVALID_SYMBOL_ID) {
+        return true; // Not a leg of any path, the server would ignore it
+    }
+    Slot* slot = acquireSlot();
+    if (!slot) return false;
+
+    slot->isTicker = false;
+    slot->tick = tick;
+    publish(*slot, tick.jsonStr);
+    return true;
+}
+
+bool TickQueue::push(const BookTicker& ticker) {
+    if (ticker.symbolId == INVALID_SYMBOL_ID) {
+        return true;
+    }
+    Slot* slot = acquireSlot();
+    if (!slot) return false;
+
+    slot->isTicker = true;
+    slot->ticker = ticker;
+    publish(*slot, ticker.jsonStr);
+    return true;
+}
+
+ComputePipeline::ComputePipeline(std::shared_ptr<Server> server, const PipelineConfig& config)
+    : server(std::move(server)),
+      config(config),
+      stopping(false),
+      processed(0),
+      busyNs(0),
+      lastProcessed(0),
+      lastBusyNs(0) {
+}
+
+ComputePipeline::~ComputePipeline() {
+    stop();
+}
+
+std::shared_ptr<TickQueue> ComputePipeline::addQueue() {
+    queues.push_back(std::make_shared<TickQueue>(config.queueCapacity, config.overflowPolicy));
+    return queues.back();
+}
+
+void ComputePipeline::start() {
+    if (!computeThread.joinable()) {
+        computeThread = std::thread(&ComputePipeline::run, this);
+    }
+}
+
+void ComputePipeline::stop() {
+    stopping.store(true, std::memory_order_release);
+    if (computeThread.joinable()) {
+        computeThread.join();
+    }
+}
+
+PipelineStats ComputePipeline::stats() const {
+    PipelineStats stats;
+    stats.processed = processed.load(std::memory_order_relaxed);
+    stats.busyNs = busyNs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ComputePipeline::run() {
+    if (config.computeCpu >= 0 && !pinCurrentThreadToCpu(config.computeCpu)) {
+        fail(("Unable to pin the compute thread to CPU " + std::to_string(config.computeCpu)).c_str(), "ComputePipeline");
+    }
+
+    const bool timed = server->getLatencyStats().enabled();
+    const std::int64_t reportIntervalNs = static_cast<std::int64_t>(config.reportInterval * 1e9);
+    std::int64_t lastReport = latencyNow();
+
+    for (;;) {
+        // Read the flag before draining, so ticks queued before stopping are never left behind
+        const bool stop = stopping.load(std::memory_order_acquire);
+
+        const std::int64_t passStart = latencyNow();
+        std::size_t drained = 0;
+        for (const auto& queue : queues) {
+            drained += drain(*queue, timed);
+        }
+        const std::int64_t passEnd = latencyNow();
+
+        if (drained > 0) {
+            // Only this thread writes these, relaxed loads and stores are enough
+            processed.store(processed.load(std::memory_order_relaxed) + static_cast<long long>(drained), std::memory_order_relaxed);
+            busyNs.store(busyNs.load(std::memory_order_relaxed) + (passEnd - passStart), std::memory_order_relaxed);
+        } else if (stop) {
+            return;
+        } else {
+            std::this_thread::yield();
+        }
+
+        if (reportIntervalNs > 0 && passEnd - lastReport >= reportIntervalNs) {
+            report(std::cout, (passEnd - lastReport) / 1e9);
+            lastReport = passEnd;
+        }
+    }
+}
+
+std::size_t ComputePipeline::drain(TickQueue& queue, bool timed) {
+    LatencyStats& latency = server->getLatencyStats();
+    std::size_t drained = 0;
+    while (drained < DRAIN_BATCH) {
+        TickQueue::Slot* slot = queue.ring.consumerSlot();
+        if (!slot) break;
+
+        if (timed) latency.record(LatencyStage::QueueWait, latencyNow() - slot->publishTime);
+
+        // The views still point at the producer's buffers, swap in the slot's copy of the frame
+        const std::string_view frame = slot->frame;
+        if (slot->isTicker) {
+            slot->ticker.jsonStr = frame;
+            slot->ticker.symbol = server->getSymbolTable().name(slot->ticker.symbolId);
+            server->on_update(slot->ticker);
+        } else {
+            slot->tick.jsonStr = frame;
+            slot->tick.symbol = server->getSymbolTable().name(slot->tick.symbolId);
+            server->on_update(slot->tick);
+        }
+        queue.ring.release();
+        drained++;
+    }
+    return drained;
+}
+
+void ComputePipeline::report(std::ostream& out, double windowSeconds) {
+    const double window = windowSeconds > 0 ? windowSeconds : 1;
+    const PipelineStats current = stats();
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    out << "########### COMPUTE PIPELINE (" << std::fixed << std::setprecision(1) << windowSeconds << "s) ###########\n"
+        << "compute  busy " << 100.0 * (current.busyNs - lastBusyNs) / (window * 1e9) << "%"
+        << "  ticks/s " << (current.processed - lastProcessed) / window << "\n";
+    for (std::size_t i = 0; i < queues.size(); ++i) {
+        out << "queue " << i
+            << "  pushed " << queues[i]->getPushed()
+            << "  dropped " << queues[i]->getDropped()
+            << "  high-water " << queues[i]->getHighWaterMark() << " of " << queues[i]->ring.capacity() << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+    out << std::flush;
+
+    lastProcessed = current.processed;
+    lastBusyNs = current.busyNs;
+}
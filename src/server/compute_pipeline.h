@@ -0,0 +1,144 @@
+#ifndef COMPUTE_PIPELINE_H
+#define COMPUTE_PIPELINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/order_book.h"
+#include "common/spsc_ring.h"
+#include "server/arbitrage_server.h"
+
+struct PipelineConfig {
+    std::size_t queueCapacity;     // Parsed ticks buffered between each connection and the compute thread
+    OverflowPolicy overflowPolicy; // What a connection does when its queue is full
+    int computeCpu;                // CPU the compute thread is pinned to, -1 leaves it to the OS
+    double reportInterval;         // Seconds between compute utilisation reports, 0 disables them
+
+    explicit PipelineConfig(std::size_t capacity = 4096, OverflowPolicy policy = OverflowPolicy::Block, int cpu = -1, double reportSeconds = 0)
+        : queueCapacity(capacity), overflowPolicy(policy), computeCpu(cpu), reportInterval(reportSeconds) {}
+
+    // Reads BINANCE_PIPELINE_QUEUE_CAPACITY, BINANCE_PIPELINE_OVERFLOW, BINANCE_COMPUTE_CPU and
+    // BINANCE_THROUGHPUT_REPORT_INTERVAL
+    static PipelineConfig from_env() {
+        const char* env_queue_capacity = std::getenv("BINANCE_PIPELINE_QUEUE_CAPACITY");
+        const char* env_overflow = std::getenv("BINANCE_PIPELINE_OVERFLOW");
+        const char* env_compute_cpu = std::getenv("BINANCE_COMPUTE_CPU");
+        const char* env_report_interval = std::getenv("BINANCE_THROUGHPUT_REPORT_INTERVAL");
+
+        return PipelineConfig(
+            env_queue_capacity ? std::stoul(env_queue_capacity) : 4096,
+            env_overflow ? overflowPolicyFromString(env_overflow) : OverflowPolicy::Block,
+            env_compute_cpu ? std::stoi(env_compute_cpu) : -1,
+            env_report_interval ? std::stod(env_report_interval) : 0
+        );
+    }
+};
+
+/**
+ * @class TickQueue
+ * @brief One connection's lock-free hand-off of parsed ticks to the compute thread.
+ *
+ * push() copies the tick and its frame into a preallocated ring slot, whose frame string keeps
+ * its capacity between laps, so steady state never allocates. Ticks for symbols outside every
+ * path are dropped before they are queued. The producer side must only be used from one thread
+ * or strand at a time.
+ */
+class TickQueue {
+public:
+    TickQueue(std::size_t capacity, OverflowPolicy policy);
+
+    // False if the tick was dropped because the queue is full
+    bool push(const OrderBookTick& tick);
+    bool push(const BookTicker& ticker);
+
+    long long getPushed() const { return pushed.load(std::memory_order_relaxed); }
+    long long getDropped() const { return dropped.load(std::memory_order_relaxed); }
+    long long getHighWaterMark() const { return highWaterMark.load(std::memory_order_relaxed); }
+
+private:
+    friend class ComputePipeline;
+
+    // A tick of either kind with its own copy of the frame its views point into
+    struct Slot {
+        bool isTicker = false;
+        OrderBookTick tick;
+        BookTicker ticker;
+        std::string frame;
+        std::int64_t publishTime = 0; // latencyNow() when queued
+    };
+
+    const OverflowPolicy policy;
+    SpscRing<Slot> ring;
+
+    // Written by the producer only
+    std::atomic<long long> pushed;
+    std::atomic<long long> dropped;
+    std::atomic<long long> highWaterMark;
+
+    Slot* acquireSlot();
+    void publish(Slot& slot, std::string_view frame);
+};
+
+struct PipelineStats {
+    long long processed = 0; // Ticks handed to Server::on_update
+    long long busyNs = 0;    // Time the compute thread spent processing rather than polling
+};
+
+/**
+ * @class ComputePipeline
+ * @brief Runs Server::on_update on a dedicated, optionally pinned, compute thread fed by per-connection queues.
+ *
+ * Connections only read and parse, then hand the tick over, so a slow evaluation never delays
+ * the next socket read. The compute thread owns the server: it polls every queue in turn
+ * without sleeping, keeping its core busy, and is the only caller of on_update. Ticks from one
+ * queue are processed in the order they were pushed.
+ *
+ * Every queue must be added before start(). The destructor processes whatever is still queued
+ * before the thread exits.
+ */
+class ComputePipeline {
+public:
+    ComputePipeline(std::shared_ptr<Server> server, const PipelineConfig& config);
+    ~ComputePipeline();
+
+    ComputePipeline(const ComputePipeline&) = delete;
+    ComputePipeline& operator=(const ComputePipeline&) = delete;
+
+    // A new queue for one connection to push into
+    std::shared_ptr<TickQueue> addQueue();
+
+    void start();
+
+    // Processes everything already queued, then stops the compute thread
+    void stop();
+
+    // Safe to call from any thread, counters are read individually
+    PipelineStats stats() const;
+
+    // Compute utilisation and tick rate since the previous report, plus every queue's drops and high-water mark.
+    // Called by the compute thread every report interval, and only safe elsewhere while it is not running.
+    void report(std::ostream& out, double windowSeconds);
+
+private:
+    const std::shared_ptr<Server> server;
+    const PipelineConfig config;
+    std::vector<std::shared_ptr<TickQueue>> queues;
+
+    std::atomic<bool> stopping;
+    std::atomic<long long> processed;
+    std::atomic<long long> busyNs;
+    long long lastProcessed;
+    long long lastBusyNs;
+
+    std::thread computeThread;
+
+    void run();
+    std::size_t drain(TickQueue& queue, bool timed);
+};
+
+#endif // COMPUTE_PIPELINE_H
@@ -54,9 +54,17 @@ protected:
 class StartingNotionalTest : public ::testing::Test {
 protected:
     ArbitragePath path = ArbitragePath::from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY");
-    std::unordered_map<std::string, OrderBookTick> pairToPriceMap;
+    SymbolTable symbols;
+    BookStore books;
+
+    OrderBook& book(const std::string& symbol) {
+        return books[symbols.find(symbol)];
+    }
 
     void SetUp() override {
+        path.internSymbols(symbols);
+        books = BookStore(symbols.size());
+
         // create btc usdt tick based on the example JSON above 
 
         OrderBookTick btcusdt_tick;
@@ -107,11 +115,9 @@ protected:
             PriceLevel(0.03176000, 54.27910000)
         };
 
-        pairToPriceMap = {
-            {"btcusdt", btcusdt_tick},
-            {"ethusdt", ethusdt_tick},
-            {"ethbtc", ethbtc_tick}
-        };
+        book("btcusdt") = btcusdt_tick;
+        book("ethusdt") = ethusdt_tick;
+        book("ethbtc") = ethbtc_tick;
     }
 };
 
@@ -232,7 +238,7 @@ TEST_F(TradeLegTest, GetEffectiveRateNegativeTradeSize) {
 
 TEST_F(StartingNotionalTest, CalculateStartingNotional) {
     StartingNotional expected = {3.9976446695521055, "ethusdt"};
-    StartingNotional actual = calculateStartingNotional(path,pairToPriceMap);
+    StartingNotional actual = calculateStartingNotional(path,books);
     
     EXPECT_DOUBLE_EQ(actual.notional, expected.notional);
     EXPECT_EQ(actual.bottleneckLeg, expected.bottleneckLeg);
@@ -240,7 +246,7 @@ TEST_F(StartingNotionalTest, CalculateStartingNotional) {
 
 TEST_F(StartingNotionalTest, CalculateStartingNotionalWithFirstLevelOnly) {
     StartingNotional expected = {0.03171000 * 23.57890000, "ethbtc"};
-    StartingNotional actual = calculateStartingNotionalWithFirstLevelOnly(path,pairToPriceMap);
+    StartingNotional actual = calculateStartingNotionalWithFirstLevelOnly(path,books);
 
     EXPECT_DOUBLE_EQ(actual.notional, expected.notional);
     EXPECT_EQ(actual.bottleneckLeg, expected.bottleneckLeg);
@@ -249,22 +255,109 @@ TEST_F(StartingNotionalTest, CalculateStartingNotionalWithFirstLevelOnly) {
 
 TEST_F(StartingNotionalTest, BottleneckIsLeg1) {
     // To make leg1 the bottleneck, we reduce its available quantity.
-    pairToPriceMap["btcusdt"].bids[0] = PriceLevel(117992.29000000, 0.0001);
+    book("btcusdt").bids[0] = PriceLevel(117992.29000000, 0.0001);
 
     StartingNotional expected = {0.0001, "btcusdt"};
-    StartingNotional actual = calculateStartingNotionalWithFirstLevelOnly(path, pairToPriceMap);
+    StartingNotional actual = calculateStartingNotionalWithFirstLevelOnly(path, books);
 
     EXPECT_DOUBLE_EQ(actual.notional, expected.notional);
     EXPECT_EQ(actual.bottleneckLeg, expected.bottleneckLeg);
 }
 
 TEST_F(StartingNotionalTest, BottleneckIsLeg2) {
-    pairToPriceMap["ethusdt"].asks[0] = PriceLevel(3742.11000000, 0.000001);
+    book("ethusdt").asks[0] = PriceLevel(3742.11000000, 0.000001);
     
-    const double expected_notional = (3742.11000000 * 0.000001) / pairToPriceMap.at("btcusdt").getBestBidPrice();
+    const double expected_notional = (3742.11000000 * 0.000001) / book("btcusdt").getBestBidPrice();
     StartingNotional expected = {expected_notional, "ethusdt"};
-    StartingNotional actual = calculateStartingNotionalWithFirstLevelOnly(path, pairToPriceMap);
+    StartingNotional actual = calculateStartingNotionalWithFirstLevelOnly(path, books);
 
     EXPECT_DOUBLE_EQ(actual.notional, expected.notional);
     EXPECT_EQ(actual.bottleneckLeg, expected.bottleneckLeg);
 }
+
+/*
+* Test fixture for the trade size solver, with round prices so the optimum can be worked out by hand
+*/
+class OptimalTradeSizeTest : public ::testing::Test {
+protected:
+    ArbitragePath path = ArbitragePath::from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY");
+    SymbolTable symbols;
+    BookStore books;
+
+    OrderBook& book(const std::string& symbol) {
+        return books[symbols.find(symbol)];
+    }
+
+    void SetUp() override {
+        path.internSymbols(symbols);
+        books = BookStore(symbols.size());
+
+        // 1 BTC -> 100 USDT -> 10 ETH -> 1.1 BTC on the first level, then 0.99 BTC per BTC below it
+        book("btcusdt").bids = {PriceLevel(100.0, 1.0), PriceLevel(90.0, 20.0)};
+        book("ethusdt").asks = {PriceLevel(10.0, 1000.0)};
+        book("ethbtc").bids = {PriceLevel(0.11, 1000.0)};
+
+        // The sides the path does not trade, getEffectiveRate prices nothing against a one-sided book
+        book("btcusdt").asks = {PriceLevel(101.0, 1.0)};
+        book("ethusdt").bids = {PriceLevel(9.99, 1.0)};
+        book("ethbtc").asks = {PriceLevel(0.12, 1.0)};
+    }
+
+    // PnL of trading the given starting notional, the way Server::on_update prices a single size
+    double pnlAt(double notional, double feeMultiplier) {
+        double current = notional;
+        for (const auto& leg : path.legs) {
+            current *= getEffectiveRate(leg, books[leg.symbolId], current) * feeMultiplier;
+        }
+        return current - notional;
+    }
+};
+
+TEST_F(OptimalTradeSizeTest, StopsWhereTheMarginalRateDropsBelowOne) {
+    const OptimalTradeSize actual = solveOptimalTradeSize(path, books, 1.0);
+
+    EXPECT_DOUBLE_EQ(actual.notional, 1.0);
+    EXPECT_NEAR(actual.pnl, 0.1, 1e-12);
+    // The 0.1 BTC made on the first level is lost again at 0.01 BTC per BTC on the second
+    EXPECT_NEAR(actual.breakevenNotional, 11.0, 1e-9);
+}
+
+TEST_F(OptimalTradeSizeTest, ReportsNothingWhenTheTopOfBookIsUnprofitable) {
+    book("ethbtc").bids = {PriceLevel(0.09, 1000.0)};
+
+    const OptimalTradeSize actual = solveOptimalTradeSize(path, books, 1.0);
+
+    EXPECT_EQ(actual.notional, 0.0);
+    EXPECT_EQ(actual.pnl, 0.0);
+    EXPECT_EQ(actual.breakevenNotional, 0.0);
+}
+
+TEST_F(OptimalTradeSizeTest, TakesEverythingWhenTheBookRunsOutFirst) {
+    const OptimalTradeSize actual = solveOptimalTradeSize(path, books, 1.0, 1);
+
+    EXPECT_DOUBLE_EQ(actual.notional, 1.0);
+    EXPECT_NEAR(actual.pnl, 0.1, 1e-12);
+    EXPECT_DOUBLE_EQ(actual.breakevenNotional, 1.0);
+}
+
+TEST_F(OptimalTradeSizeTest, BreakpointsFromEveryLegAndFees) {
+    book("btcusdt").bids = {PriceLevel(100.0, 0.5), PriceLevel(99.5, 1.0), PriceLevel(99.0, 2.0), PriceLevel(95.0, 50.0)};
+    book("ethusdt").asks = {PriceLevel(10.0, 3.0), PriceLevel(10.02, 5.0), PriceLevel(10.05, 20.0), PriceLevel(10.5, 1000.0)};
+    book("ethbtc").bids = {PriceLevel(0.1012, 8.0), PriceLevel(0.1008, 10.0), PriceLevel(0.1, 1000.0)};
+    const double fee = 0.9995;
+
+    const OptimalTradeSize actual = solveOptimalTradeSize(path, books, fee);
+
+    ASSERT_GT(actual.notional, 0.0);
+    EXPECT_NEAR(actual.pnl, pnlAt(actual.notional, fee), 1e-12);
+    EXPECT_NEAR(pnlAt(actual.breakevenNotional, fee), 0.0, 1e-12);
+
+    // No size on a fine grid beats the solver, and every size up to breakeven is profitable
+    for (double notional = 0.01; notional < 20.0; notional += 0.01) {
+        const double pnl = pnlAt(notional, fee);
+        EXPECT_LE(pnl, actual.pnl + 1e-12) << "at " << notional;
+        if (notional < actual.breakevenNotional - 1e-9) {
+            EXPECT_GE(pnl, -1e-12) << "at " << notional;
+        }
+    }
+}
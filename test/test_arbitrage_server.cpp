@@ -0,0 +1,236 @@
+#include "gtest/gtest.h"
+#include "server/arbitrage_server.h"
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <nlohmann/json.hpp>
+
+class ArbitrageServerTest : public ::testing::Test {
+protected:
+    const std::string outputPath = ::testing::TempDir() + "arbitrage_server_test.txt";
+
+    // Two triangles sharing btcusdt
+    const std::vector<ArbitragePath> paths = ArbitragePath::list_from_string(
+        "btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY;usdt:btcusdt:SELL,ltcbtc:SELL,ltcusdt:BUY");
+
+    void SetUp() override { std::remove(outputPath.c_str()); }
+    void TearDown() override { std::remove(outputPath.c_str()); }
+
+    static OrderBookTick makeTick(const Server& server, const std::string& symbol, double bid, double ask) {
+        OrderBookTick tick;
+        tick.symbolId = server.getSymbolTable().find(symbol);
+        tick.symbol = server.getSymbolTable().name(tick.symbolId);
+        tick.updateId = 1;
+        tick.bids = {PriceLevel(bid, 100.0)};
+        tick.asks = {PriceLevel(ask, 100.0)};
+        return tick;
+    }
+
+    // Number of results written per path
+    std::map<std::string, int> resultsByPath() const {
+        std::map<std::string, int> counts;
+        std::ifstream input(outputPath);
+        std::string line;
+        while (std::getline(input, line)) {
+            counts[nlohmann::json::parse(line).at("path").get<std::string>()]++;
+        }
+        return counts;
+    }
+};
+
+TEST_F(ArbitrageServerTest, SharesOneBookPerSymbol) {
+    Server server(paths, ServerConfig(0, 0, 1, 0, true));
+
+    EXPECT_EQ(server.getSymbolTable().size(), 5u);
+}
+
+TEST_F(ArbitrageServerTest, EvaluatesOnlyPathsContainingTheTickedSymbol) {
+    {
+        Server server(paths, ServerConfig(0, 0, 0.5, 0, true), std::make_unique<TradeFileWriter>(outputPath));
+        const std::string firstPath = paths[0].to_string();
+        const std::string secondPath = paths[1].to_string();
+
+        for (const auto& symbol : {"btcusdt", "ethusdt", "ethbtc", "ltcbtc", "ltcusdt"}) {
+            auto tick = makeTick(server, symbol, 1.0, 1.0);
+            server.on_update(tick);
+        }
+        // ltcusdt completes the second path, ethbtc the first
+        auto ethusdt = makeTick(server, "ethusdt", 1.1, 1.1);
+        ethusdt.updateId = 2;
+        server.on_update(ethusdt);
+        auto btcusdt = makeTick(server, "btcusdt", 1.1, 1.1);
+        btcusdt.updateId = 2;
+        server.on_update(btcusdt);
+    }
+
+    const auto counts = resultsByPath();
+    // First path: ethbtc, ltcbtc skipped, ltcusdt skipped, ethusdt, btcusdt
+    EXPECT_EQ(counts.at(paths[0].to_string()), 3);
+    // Second path: ltcusdt, btcusdt
+    EXPECT_EQ(counts.at(paths[1].to_string()), 2);
+}
+
+TEST_F(ArbitrageServerTest, IgnoresSymbolsOutsideEveryPath) {
+    {
+        Server server(paths, ServerConfig(0, 0, 1, 0, true), std::make_unique<TradeFileWriter>(outputPath));
+        OrderBookTick tick;
+        tick.symbol = "solusdt";
+        tick.symbolId = server.getSymbolTable().find("solusdt");
+        server.on_update(tick);
+    }
+
+    EXPECT_TRUE(resultsByPath().empty());
+}
+
+TEST_F(ArbitrageServerTest, EvaluatesBookTickersAsTheBestLevel) {
+    {
+        // Whole-book VWAPs, so a level the ticker failed to remove would show in the rate
+        Server server(paths, ServerConfig(0, 0, 1, 0, false), std::make_unique<TradeFileWriter>(outputPath));
+
+        // A deeper book first, the ticker must replace it rather than update its first level
+        OrderBookTick deep = makeTick(server, "btcusdt", 1.0, 1.0);
+        deep.bids = {PriceLevel(1.0, 100.0), PriceLevel(0.9, 100.0)};
+        server.on_update(deep);
+        for (const auto& symbol : {"ethusdt", "ethbtc"}) {
+            auto tick = makeTick(server, symbol, 1.0, 1.0);
+            server.on_update(tick);
+        }
+
+        BookTicker ticker;
+        ticker.symbolId = server.getSymbolTable().find("btcusdt");
+        ticker.symbol = "btcusdt";
+        ticker.jsonStr = "{\"ticker\":true}";
+        ticker.updateId = 2;
+        ticker.bid = PriceLevel(1.5, 10.0);
+        ticker.ask = PriceLevel(1.6, 10.0);
+        server.on_update(ticker);
+    }
+
+    std::ifstream input(outputPath);
+    std::string line;
+    std::string last;
+    while (std::getline(input, line)) {
+        last = line;
+    }
+    const auto result = nlohmann::json::parse(last);
+    EXPECT_EQ(result.at("orderBookLevels").get<std::string>(), "{\"ticker\":true}");
+    EXPECT_EQ(result.at("path").get<std::string>(), paths[0].to_string());
+    EXPECT_DOUBLE_EQ(result.at("rate1").get<double>(), 1.5);
+}
+
+TEST_F(ArbitrageServerTest, DropsDuplicateAndUnchangedTicks) {
+    {
+        Server server(paths, ServerConfig(0, 0, 1, 0, true), std::make_unique<TradeFileWriter>(outputPath));
+        for (const auto& symbol : {"btcusdt", "ethusdt", "ethbtc"}) {
+            auto tick = makeTick(server, symbol, 1.0, 1.0);
+            server.on_update(tick);
+        }
+
+        // Same update id again, then a new id carrying the same levels
+        auto replayed = makeTick(server, "ethbtc", 1.0, 1.0);
+        server.on_update(replayed);
+        replayed.updateId = 2;
+        server.on_update(replayed);
+
+        const EvaluationStats& stats = server.getEvaluationStats();
+        EXPECT_EQ(stats.ticks, 5);
+        EXPECT_EQ(stats.duplicateTicks, 1);
+        EXPECT_EQ(stats.unchangedTicks, 1);
+        EXPECT_EQ(stats.evaluations, 1);
+        EXPECT_EQ(stats.skippedEvaluations, 1);
+    }
+
+    EXPECT_EQ(resultsByPath().at(paths[0].to_string()), 1);
+}
+
+TEST_F(ArbitrageServerTest, SkipsPathsWhoseTradedSideDidNotChange) {
+    {
+        Server server(paths, ServerConfig(0, 0, 1, 0, true), std::make_unique<TradeFileWriter>(outputPath));
+        for (const auto& symbol : {"btcusdt", "ethusdt", "ethbtc", "ltcbtc", "ltcusdt"}) {
+            auto tick = makeTick(server, symbol, 1.0, 1.0);
+            server.on_update(tick);
+        }
+
+        // The first path sells btcusdt into the bids, the second buys it from the asks
+        auto asksOnly = makeTick(server, "btcusdt", 1.0, 1.2);
+        asksOnly.updateId = 2;
+        server.on_update(asksOnly);
+        EXPECT_EQ(server.getEvaluationStats().skippedEvaluations, 1);
+    }
+
+    // One result each once complete, and a second only for the path buying btcusdt
+    const auto counts = resultsByPath();
+    EXPECT_EQ(counts.at(paths[0].to_string()), 1);
+    EXPECT_EQ(counts.at(paths[1].to_string()), 2);
+}
+
+TEST_F(ArbitrageServerTest, CachedLegsMatchAFullEvaluation) {
+    const std::vector<ArbitragePath> path = {paths[0]};
+    auto deepTick = [](const Server& server, const std::string& symbol, double bid, double ask, long long id) {
+        OrderBookTick tick = makeTick(server, symbol, bid, ask);
+        tick.updateId = id;
+        tick.bids = {PriceLevel(bid, 1.0), PriceLevel(bid * 0.99, 2.0), PriceLevel(bid * 0.98, 3.0)};
+        tick.asks = {PriceLevel(ask, 1.0), PriceLevel(ask * 1.01, 2.0), PriceLevel(ask * 1.02, 3.0)};
+        return tick;
+    };
+
+    {
+        Server incremental(path, ServerConfig(0, 0, 1, 0, true), std::make_unique<TradeFileWriter>(outputPath));
+        auto btcusdt = deepTick(incremental, "btcusdt", 30000.0, 30010.0, 1);
+        auto ethusdt = deepTick(incremental, "ethusdt", 2000.0, 2001.0, 1);
+        auto ethbtc = deepTick(incremental, "ethbtc", 0.066, 0.0661, 1);
+        incremental.on_update(btcusdt);
+        incremental.on_update(ethusdt);
+        incremental.on_update(ethbtc);
+
+        // Deeper in the last leg's bids: the first-level starting notional and the first two legs stand
+        ethbtc.updateId = 2;
+        ethbtc.bids[2] = PriceLevel(0.065, 30.0);
+        incremental.on_update(ethbtc);
+
+        const EvaluationStats& stats = incremental.getEvaluationStats();
+        EXPECT_EQ(stats.evaluations, 2);
+        EXPECT_EQ(stats.startingNotionalsReused, 1);
+        EXPECT_EQ(stats.legRatesReused, 2);
+        EXPECT_EQ(stats.legRatesComputed, 4);
+    }
+    std::string incrementalResult;
+    {
+        std::ifstream input(outputPath);
+        std::string line;
+        while (std::getline(input, line)) incrementalResult = line;
+    }
+    std::remove(outputPath.c_str());
+
+    {
+        // The final books alone, evaluated from scratch
+        Server fresh(path, ServerConfig(0, 0, 1, 0, true), std::make_unique<TradeFileWriter>(outputPath));
+        auto btcusdt = deepTick(fresh, "btcusdt", 30000.0, 30010.0, 1);
+        auto ethusdt = deepTick(fresh, "ethusdt", 2000.0, 2001.0, 1);
+        auto ethbtc = deepTick(fresh, "ethbtc", 0.066, 0.0661, 2);
+        ethbtc.bids[2] = PriceLevel(0.065, 30.0);
+        fresh.on_update(btcusdt);
+        fresh.on_update(ethusdt);
+        fresh.on_update(ethbtc);
+    }
+    std::string freshResult;
+    {
+        std::ifstream input(outputPath);
+        std::string line;
+        while (std::getline(input, line)) freshResult = line;
+    }
+
+    const auto incrementalJson = nlohmann::json::parse(incrementalResult);
+    const auto freshJson = nlohmann::json::parse(freshResult);
+    for (const char* field : {"rate1", "rate2", "rate3", "unrealisedPnl", "tradedNotional", "bottleneckLeg"}) {
+        EXPECT_EQ(incrementalJson.at(field), freshJson.at(field)) << field;
+    }
+}
+
+TEST(ArbitragePathTest, RoundTripsThroughString) {
+    const std::string str = "usdt:btcusdt:SELL,ltcbtc:SELL,ltcusdt:BUY";
+
+    EXPECT_EQ(ArbitragePath::from_string(str).to_string(), str);
+    EXPECT_EQ(ArbitragePath::list_from_string(str + ";" + str + ";").size(), 2u);
+    EXPECT_THROW(ArbitragePath::list_from_string(";"), std::invalid_argument);
+}
@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+#include "common/spsc_ring.h"
+#include "file/async_result_writer.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(SpscRingTest, RoundsCapacityUpAndReportsFull) {
+    SpscRing<int> ring(3);
+    ASSERT_EQ(ring.capacity(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        int* slot = ring.producerSlot();
+        ASSERT_NE(slot, nullptr);
+        *slot = i;
+        ring.publish();
+    }
+    EXPECT_EQ(ring.producerSlot(), nullptr);
+    EXPECT_EQ(ring.size(), 4u);
+
+    EXPECT_EQ(*ring.consumerSlot(), 0);
+    ring.release();
+    EXPECT_NE(ring.producerSlot(), nullptr);
+}
+
+TEST(SpscRingTest, TransfersInOrderAcrossThreads) {
+    SpscRing<long long> ring(64);
+    const long long count = 200000;
+
+    std::thread producer([&] {
+        for (long long i = 0; i < count; ++i) {
+            long long* slot;
+            while (!(slot = ring.producerSlot())) std::this_thread::yield();
+            *slot = i;
+            ring.publish();
+        }
+    });
+
+    long long expected = 0;
+    while (expected < count) {
+        long long* slot = ring.consumerSlot();
+        if (!slot) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(*slot, expected);
+        ring.release();
+        expected++;
+    }
+    producer.join();
+    EXPECT_EQ(ring.consumerSlot(), nullptr);
+}
+
+// Keeps copies of what it is given, optionally holding the writer thread inside write()
+class RecordingWriter : public ResultWriter {
+public:
+    struct Log {
+        std::vector<std::string> paths;
+        std::vector<double> bestBids;
+        int flushes = 0;
+        std::atomic<bool> blocked{false};
+    };
+
+    explicit RecordingWriter(Log& log) : log(log) {}
+
+    void write(const ArbitrageResult& result) override {
+        while (log.blocked.load()) std::this_thread::yield();
+        log.paths.emplace_back(result.path);
+        log.bestBids.push_back(result.bids.empty() ? 0.0 : result.bids[0].price);
+    }
+
+    void flush() override { log.flushes++; }
+
+private:
+    Log& log;
+};
+
+class AsyncResultWriterTest : public ::testing::Test {
+protected:
+    RecordingWriter::Log log;
+    PriceLevels<2> bids = {PriceLevel(42.0, 1.0)};
+
+    ArbitrageResult makeResult(const std::string& path) const {
+        return ArbitrageResult("btcusdt", path, "{}", 1, 2, 0.1, 1.0, "btcusdt", false, {1.0, 1.0, 1.0}, 0.0, 0.0, 0.0, bids, PriceLevelSpan());
+    }
+};
+
+TEST_F(AsyncResultWriterTest, WritesEveryResultInOrderWhenBlocking) {
+    {
+        AsyncResultWriter writer(std::make_unique<RecordingWriter>(log), AsyncWriterConfig(2, 16, OverflowPolicy::Block));
+        for (int i = 0; i < 500; ++i) {
+            // The views only live for the call, the writer must copy them
+            const std::string path = "path" + std::to_string(i);
+            writer.write(makeResult(path));
+        }
+        EXPECT_EQ(writer.stats().dropped, 0);
+    }
+
+    ASSERT_EQ(log.paths.size(), 500u);
+    for (int i = 0; i < 500; ++i) {
+        EXPECT_EQ(log.paths[i], "path" + std::to_string(i));
+    }
+    EXPECT_EQ(log.bestBids.back(), 42.0);
+    EXPECT_GE(log.flushes, 1);
+}
+
+TEST_F(AsyncResultWriterTest, WritesEverythingWithAZeroBatchSize) {
+    {
+        // A batch of 0 would never drain the ring, and a blocking write would then spin forever
+        AsyncResultWriter writer(std::make_unique<RecordingWriter>(log), AsyncWriterConfig(2, 0, OverflowPolicy::Block));
+        for (int i = 0; i < 100; ++i) {
+            writer.write(makeResult("path" + std::to_string(i)));
+        }
+    }
+
+    ASSERT_EQ(log.paths.size(), 100u);
+    EXPECT_EQ(log.paths.back(), "path99");
+}
+
+TEST_F(AsyncResultWriterTest, DropsAndCountsWhenTheQueueIsFull) {
+    log.blocked = true;
+    AsyncWriterStats stats;
+    {
+        AsyncResultWriter writer(std::make_unique<RecordingWriter>(log), AsyncWriterConfig(4, 16, OverflowPolicy::Drop));
+        // Slots are only released once written, so a stalled writer holds the ring at 4
+        for (int i = 0; i < 10; ++i) {
+            writer.write(makeResult("path" + std::to_string(i)));
+        }
+        stats = writer.stats();
+        log.blocked = false;
+    }
+
+    EXPECT_EQ(stats.enqueued, 4);
+    EXPECT_EQ(stats.dropped, 6);
+    EXPECT_EQ(stats.highWaterMark, 4);
+    EXPECT_EQ(log.paths, (std::vector<std::string>{"path0", "path1", "path2", "path3"}));
+}
+
+TEST(OverflowPolicyTest, ParsesNames) {
+    EXPECT_EQ(overflowPolicyFromString("drop"), OverflowPolicy::Drop);
+    EXPECT_EQ(overflowPolicyFromString("count"), OverflowPolicy::Count);
+    EXPECT_EQ(overflowPolicyFromString("block"), OverflowPolicy::Block);
+    EXPECT_EQ(overflowPolicyFromString("unknown"), OverflowPolicy::Block);
+}
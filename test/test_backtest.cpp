@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include "replay/backtest.h"
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+const std::vector<ArbitragePath> PATHS = ArbitragePath::list_from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY");
+
+std::string depthFrame(const std::string& symbol, long long updateId, double bid, double ask) {
+    std::ostringstream frame;
+    frame << "{\"stream\":\"" << symbol << "@depth5@100ms\",\"data\":{\"lastUpdateId\":" << updateId
+          << ",\"bids\":[[\"" << bid << "\",\"1.5\"],[\"" << bid * 0.999 << "\",\"3.0\"]]"
+          << ",\"asks\":[[\"" << ask << "\",\"2.0\"]]}}\n";
+    return frame.str();
+}
+
+// ethbtc drifts around the btcusdt / ethusdt cross, so some ticks are opportunities at a low threshold
+std::string recording() {
+    std::string frames;
+    for (int i = 0; i < 60; ++i) {
+        frames += depthFrame("btcusdt", 3 * i + 1, 30000 + i, 30001 + i);
+        frames += depthFrame("ethusdt", 3 * i + 2, 2000 - i * 0.5, 2000.5 - i * 0.5);
+        const double cross = 2000.0 / 30000.0;
+        const double drift = (i % 5 - 2) * 0.0004;
+        frames += depthFrame("ethbtc", 3 * i + 3, cross * (1 + drift), cross * (1 + drift + 0.0001));
+    }
+    return frames;
+}
+
+// Counts what a server fed straight from ReplayEngine finds, to compare against the backtest
+class OpportunityCounter : public ResultWriter {
+public:
+    std::uint64_t opportunities = 0;
+    double pnl = 0;
+
+    void write(const ArbitrageResult& result) override {
+        if (!result.arbitrageOpportunity) return;
+        opportunities++;
+        pnl += result.unrealisedPnl;
+    }
+};
+
+} // namespace
+
+TEST(BacktestGridTest, ExpandsEveryCombination) {
+    const auto grid = parseBacktestGrid("profitThreshold=0:0.001:0.0005; takerFee=0.00075,0.001; useFirstLevelOnly=true,false");
+    ASSERT_EQ(grid.size(), 12u);
+    EXPECT_DOUBLE_EQ(grid[0].profitThreshold, 0.0);
+    EXPECT_DOUBLE_EQ(grid[11].profitThreshold, 0.001);
+    EXPECT_DOUBLE_EQ(grid[11].takerFee, 0.001);
+    EXPECT_FALSE(grid[11].useFirstLevelOnly);
+    // Parameters not in the grid keep their defaults
+    EXPECT_DOUBLE_EQ(grid[5].maxStartingNotionalFraction, 1.0);
+
+    EXPECT_EQ(parseBacktestGrid("").size(), 1u);
+    EXPECT_THROW(parseBacktestGrid("slippage=1"), std::invalid_argument);
+    EXPECT_THROW(parseBacktestGrid("takerFee=abc"), std::invalid_argument);
+    EXPECT_THROW(parseBacktestGrid("useFirstLevelOnly=yes"), std::invalid_argument);
+}
+
+TEST(BacktestTest, MatchesAServerFedFromTheRecording) {
+    const Server prototype(PATHS, BacktestParameters().toServerConfig());
+    std::istringstream input(recording());
+    const TickRecording ticks = TickRecording::load(input, prototype.getSymbolTable());
+    ASSERT_EQ(ticks.size(), 180u);
+    EXPECT_EQ(ticks.getLoadStats().parseFailures, 0);
+
+    const auto grid = parseBacktestGrid("profitThreshold=0,0.0002,0.0005;takerFee=0,0.00025;useFirstLevelOnly=true,false");
+    const std::vector<BacktestOutcome> outcomes = runBacktest(ticks, PATHS, grid, 4);
+    ASSERT_EQ(outcomes.size(), grid.size());
+
+    std::uint64_t anyOpportunities = 0;
+    for (std::size_t i = 0; i < grid.size(); ++i) {
+        auto writer = std::make_unique<OpportunityCounter>();
+        OpportunityCounter& expected = *writer;
+        auto clock = std::make_shared<ReplayClock>();
+        auto server = std::make_shared<Server>(PATHS, grid[i].toServerConfig(), std::move(writer), clock);
+        std::istringstream replayInput(recording());
+        ReplayEngine(server, clock, ReplayConfig()).run(replayInput);
+
+        EXPECT_EQ(outcomes[i].opportunities, expected.opportunities) << i;
+        EXPECT_DOUBLE_EQ(outcomes[i].totalPnl, expected.pnl) << i;
+        std::uint64_t legOpportunities = 0;
+        for (const auto& leg : outcomes[i].bottleneckLegs) legOpportunities += leg.second;
+        EXPECT_EQ(legOpportunities, outcomes[i].opportunities);
+        anyOpportunities += outcomes[i].opportunities;
+    }
+    EXPECT_GT(anyOpportunities, 0u);
+
+    // Independent servers, so the thread count changes nothing
+    const std::vector<BacktestOutcome> single = runBacktest(ticks, PATHS, grid, 1);
+    for (std::size_t i = 0; i < grid.size(); ++i) {
+        EXPECT_EQ(single[i].opportunities, outcomes[i].opportunities);
+        EXPECT_DOUBLE_EQ(single[i].totalPnl, outcomes[i].totalPnl);
+    }
+}
+
+TEST(BacktestTest, RanksByTotalPnl) {
+    std::vector<BacktestOutcome> outcomes(3);
+    outcomes[0].totalPnl = 1.0;
+    outcomes[1].totalPnl = 3.0;
+    outcomes[1].opportunities = 2;
+    outcomes[1].bottleneckLegs = {{"ethbtc", 1}, {"btcusdt", 1}};
+    outcomes[2].totalPnl = 2.0;
+    rankBacktestOutcomes(outcomes);
+    EXPECT_DOUBLE_EQ(outcomes[0].totalPnl, 3.0);
+    EXPECT_DOUBLE_EQ(outcomes[2].totalPnl, 1.0);
+
+    std::ostringstream table;
+    printBacktestOutcomes(table, outcomes, 2);
+    EXPECT_NE(table.str().find("ethbtc 50% btcusdt 50%"), std::string::npos);
+    EXPECT_EQ(table.str().find("\n3 "), std::string::npos);
+}
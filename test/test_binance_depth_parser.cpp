@@ -0,0 +1,224 @@
+#include "gtest/gtest.h"
+#include "exchange/binance/binance_client.h"
+#include "exchange/binance/binance_depth_parser.h"
+#include <string>
+
+class DepthParserTest : public ::testing::Test {
+protected:
+    const std::string frame = R"({"stream":"btcusdt@depth5@100ms","data":{"lastUpdateId":73518241221,"bids":[["117992.28000000","2.82596000"],["117992.27000000","0.00005000"],["117992.17000000","0.00907000"]],"asks":[["117992.29000000","5.61816000"],["117992.30000000","0.00433000"]]}})";
+
+    SymbolTable symbols;
+    OrderBookTick tick;
+
+    void SetUp() override {
+        symbols.intern("ethusdt");
+        symbols.intern("btcusdt");
+    }
+
+    DepthParseError parse(const std::string& str) {
+        return parseDepthFrame(str.data(), str.data() + str.size(), 42, symbols, tick);
+    }
+};
+
+TEST_F(DepthParserTest, ParsesCombinedStreamFrame) {
+    ASSERT_EQ(parse(frame), DepthParseError::None);
+
+    EXPECT_EQ(tick.symbol, "btcusdt");
+    EXPECT_EQ(tick.symbolId, symbols.find("btcusdt"));
+    EXPECT_EQ(tick.updateId, 73518241221);
+    EXPECT_EQ(tick.tickInitTime, 42);
+    EXPECT_EQ(tick.jsonStr, frame);
+    ASSERT_EQ(tick.bids.size(), 3u);
+    ASSERT_EQ(tick.asks.size(), 2u);
+    EXPECT_DOUBLE_EQ(tick.bids[0].price, 117992.28);
+    EXPECT_DOUBLE_EQ(tick.bids[2].quantity, 0.00907);
+    EXPECT_DOUBLE_EQ(tick.asks[1].price, 117992.30);
+}
+
+TEST_F(DepthParserTest, MatchesNlohmannPath) {
+    ASSERT_EQ(parse(frame), DepthParseError::None);
+    const auto json = nlohmann::json::parse(frame);
+    const OrderBookTick expected = BinanceClient::to_struct(json, frame, 42, symbols);
+
+    EXPECT_EQ(tick.symbol, expected.symbol);
+    EXPECT_EQ(tick.symbolId, expected.symbolId);
+    EXPECT_EQ(tick.updateId, expected.updateId);
+    ASSERT_EQ(tick.bids.size(), expected.bids.size());
+    ASSERT_EQ(tick.asks.size(), expected.asks.size());
+    for (size_t i = 0; i < expected.bids.size(); ++i) {
+        EXPECT_EQ(tick.bids[i].price, expected.bids[i].price);
+        EXPECT_EQ(tick.bids[i].quantity, expected.bids[i].quantity);
+    }
+    for (size_t i = 0; i < expected.asks.size(); ++i) {
+        EXPECT_EQ(tick.asks[i].price, expected.asks[i].price);
+        EXPECT_EQ(tick.asks[i].quantity, expected.asks[i].quantity);
+    }
+}
+
+TEST_F(DepthParserTest, AcceptsReorderedKeysWhitespaceAndUnknownFields) {
+    const std::string reordered = R"( { "data" : { "asks" : [ [ "2.5" , "1" ] ] , "E" : {"nested":[1,"]"]}, "bids" : [ ] , "lastUpdateId" : 7 } , "stream" : "ethbtc@depth20@100ms" } )";
+
+    ASSERT_EQ(parse(reordered), DepthParseError::None);
+    EXPECT_EQ(tick.symbol, "ethbtc");
+    EXPECT_EQ(tick.symbolId, INVALID_SYMBOL_ID);
+    EXPECT_EQ(tick.updateId, 7);
+    EXPECT_TRUE(tick.bids.empty());
+    ASSERT_EQ(tick.asks.size(), 1u);
+    EXPECT_DOUBLE_EQ(tick.asks[0].price, 2.5);
+}
+
+TEST_F(DepthParserTest, ReusesTickAcrossFrames) {
+    ASSERT_EQ(parse(frame), DepthParseError::None);
+    const std::string shallower = R"({"stream":"ethusdt@depth5@100ms","data":{"lastUpdateId":1,"bids":[["1","2"]],"asks":[["3","4"]]}})";
+
+    ASSERT_EQ(parse(shallower), DepthParseError::None);
+    EXPECT_EQ(tick.symbol, "ethusdt");
+    EXPECT_EQ(tick.bids.size(), 1u);
+    EXPECT_EQ(tick.asks.size(), 1u);
+}
+
+TEST_F(DepthParserTest, ReportsMissingFields) {
+    EXPECT_EQ(parse(R"({"data":{"lastUpdateId":1,"bids":[],"asks":[]}})"), DepthParseError::MissingStream);
+    EXPECT_EQ(parse(R"({"stream":"btcusdt@depth5"})"), DepthParseError::MissingData);
+    EXPECT_EQ(parse(R"({"stream":"btcusdt@depth5","data":{"bids":[],"asks":[]}})"), DepthParseError::MissingData);
+}
+
+TEST_F(DepthParserTest, ReportsInvalidNumbers) {
+    EXPECT_EQ(parse(R"({"stream":"a@d","data":{"lastUpdateId":"x","bids":[],"asks":[]}})"), DepthParseError::InvalidUpdateId);
+    EXPECT_EQ(parse(R"({"stream":"a@d","data":{"lastUpdateId":1,"bids":[["1.0x","2"]],"asks":[]}})"), DepthParseError::InvalidPriceLevel);
+    EXPECT_EQ(parse(R"({"stream":"a@d","data":{"lastUpdateId":1,"bids":[["1","2","3"]],"asks":[]}})"), DepthParseError::InvalidPriceLevel);
+}
+
+TEST_F(DepthParserTest, RejectsEveryTruncation) {
+    for (size_t length = 0; length < frame.size(); ++length) {
+        EXPECT_NE(parseDepthFrame(frame.data(), frame.data() + length, 0, symbols, tick), DepthParseError::None)
+            << "Truncated frame of length " << length << " was accepted";
+    }
+}
+
+TEST_F(DepthParserTest, KeepsOnlyTheBestLevelsBeyondBookDepth) {
+    std::string deep = R"({"stream":"btcusdt@depth@100ms","data":{"lastUpdateId":1,"asks":[],"bids":[)";
+    for (size_t i = 0; i < ORDER_BOOK_MAX_DEPTH + 3; ++i) {
+        deep += (i ? ",[\"" : "[\"") + std::to_string(100 - i) + "\",\"1\"]";
+    }
+    deep += "]}}";
+
+    ASSERT_EQ(parse(deep), DepthParseError::None);
+    ASSERT_EQ(tick.bids.size(), static_cast<size_t>(ORDER_BOOK_MAX_DEPTH));
+    EXPECT_DOUBLE_EQ(tick.bids[0].price, 100);
+    EXPECT_DOUBLE_EQ(tick.bids[ORDER_BOOK_MAX_DEPTH - 1].price, 100 - (ORDER_BOOK_MAX_DEPTH - 1));
+}
+
+TEST_F(DepthParserTest, ParsesDiffFrame) {
+    const std::string diffFrame = R"({"stream":"btcusdt@depth@100ms","data":{"e":"depthUpdate","E":1756639047235,"s":"BTCUSDT","U":157,"u":160,"b":[["117992.28","2.5"],["117990.00","0.00000000"]],"a":[["117992.29","1"]]}})";
+    DepthDiff diff;
+
+    ASSERT_EQ(parseDepthDiffFrame(diffFrame.data(), diffFrame.data() + diffFrame.size(), 42, symbols, diff), DepthParseError::None);
+
+    EXPECT_EQ(diff.symbol, "btcusdt");
+    EXPECT_EQ(diff.symbolId, symbols.find("btcusdt"));
+    EXPECT_EQ(diff.firstUpdateId, 157);
+    EXPECT_EQ(diff.finalUpdateId, 160);
+    EXPECT_EQ(diff.tickInitTime, 42);
+    EXPECT_EQ(diff.jsonStr, diffFrame);
+    ASSERT_EQ(diff.bids.size(), 2u);
+    ASSERT_EQ(diff.asks.size(), 1u);
+    EXPECT_DOUBLE_EQ(diff.bids[0].quantity, 2.5);
+    EXPECT_EQ(diff.bids[1].quantity, 0.0);
+    EXPECT_DOUBLE_EQ(diff.asks[0].price, 117992.29);
+
+    for (size_t length = 0; length < diffFrame.size(); ++length) {
+        EXPECT_NE(parseDepthDiffFrame(diffFrame.data(), diffFrame.data() + length, 0, symbols, diff), DepthParseError::None)
+            << "Truncated diff of length " << length << " was accepted";
+    }
+}
+
+TEST_F(DepthParserTest, KeepsEveryLevelOfADiff) {
+    std::string deep = R"({"stream":"btcusdt@depth","data":{"U":1,"u":2,"a":[],"b":[)";
+    for (size_t i = 0; i < ORDER_BOOK_MAX_DEPTH + 3; ++i) {
+        deep += (i ? ",[\"" : "[\"") + std::to_string(100 - i) + "\",\"1\"]";
+    }
+    deep += "]}}";
+    DepthDiff diff;
+
+    ASSERT_EQ(parseDepthDiffFrame(deep.data(), deep.data() + deep.size(), 0, symbols, diff), DepthParseError::None);
+    EXPECT_EQ(diff.bids.size(), static_cast<size_t>(ORDER_BOOK_MAX_DEPTH + 3));
+}
+
+TEST_F(DepthParserTest, ReportsMissingOrReversedDiffUpdateIds) {
+    DepthDiff diff;
+    const auto parseDiff = [&](const std::string& str) {
+        return parseDepthDiffFrame(str.data(), str.data() + str.size(), 0, symbols, diff);
+    };
+
+    EXPECT_EQ(parseDiff(R"({"stream":"a@depth","data":{"u":2,"b":[],"a":[]}})"), DepthParseError::MissingData);
+    EXPECT_EQ(parseDiff(R"({"stream":"a@depth","data":{"U":3,"u":2,"b":[],"a":[]}})"), DepthParseError::InvalidUpdateId);
+    // A partial frame is not a diff
+    EXPECT_EQ(parseDiff(frame), DepthParseError::MissingData);
+}
+
+TEST_F(DepthParserTest, ParsesRestSnapshot) {
+    const std::string snapshot = R"({"lastUpdateId":1027024,"bids":[["4.00000000","431.00000000"]],"asks":[["4.00000200","12.00000000"],["4.5","1"]]})";
+    DepthSnapshot parsed;
+
+    ASSERT_EQ(parseDepthSnapshot(snapshot.data(), snapshot.data() + snapshot.size(), parsed), DepthParseError::None);
+    EXPECT_EQ(parsed.lastUpdateId, 1027024);
+    ASSERT_EQ(parsed.bids.size(), 1u);
+    ASSERT_EQ(parsed.asks.size(), 2u);
+    EXPECT_DOUBLE_EQ(parsed.asks[0].price, 4.000002);
+}
+
+TEST(DepthStreamTest, TellsDiffStreamsFromPartialOnes) {
+    EXPECT_TRUE(isDiffDepthStream("btcusdt@depth"));
+    EXPECT_TRUE(isDiffDepthStream("btcusdt@depth@100ms"));
+    EXPECT_TRUE(isDiffDepthStream("/stream?streams=btcusdt@depth@100ms/ethbtc@depth@100ms"));
+    EXPECT_FALSE(isDiffDepthStream("btcusdt@depth5@100ms"));
+    EXPECT_FALSE(isDiffDepthStream("/stream?streams=btcusdt@depth20@100ms/ethbtc@depth10"));
+    EXPECT_FALSE(isDiffDepthStream("btcusdt@bookTicker"));
+}
+
+TEST_F(DepthParserTest, ParsesBookTickerFrame) {
+    const std::string tickerFrame = R"({"stream":"ethusdt@bookTicker","data":{"u":400900217,"s":"ETHUSDT","b":"3742.11","B":"55.3849","a":"3742.12","A":"125.1815"}})";
+    BookTicker ticker;
+
+    ASSERT_EQ(parseBookTickerFrame(tickerFrame.data(), tickerFrame.data() + tickerFrame.size(), 42, symbols, ticker), DepthParseError::None);
+
+    EXPECT_EQ(ticker.symbol, "ethusdt");
+    EXPECT_EQ(ticker.symbolId, symbols.find("ethusdt"));
+    EXPECT_EQ(ticker.updateId, 400900217);
+    EXPECT_EQ(ticker.tickInitTime, 42);
+    EXPECT_EQ(ticker.jsonStr, tickerFrame);
+    EXPECT_DOUBLE_EQ(ticker.bid.price, 3742.11);
+    EXPECT_DOUBLE_EQ(ticker.bid.quantity, 55.3849);
+    EXPECT_DOUBLE_EQ(ticker.ask.price, 3742.12);
+    EXPECT_DOUBLE_EQ(ticker.ask.quantity, 125.1815);
+
+    for (size_t length = 0; length < tickerFrame.size(); ++length) {
+        EXPECT_NE(parseBookTickerFrame(tickerFrame.data(), tickerFrame.data() + length, 0, symbols, ticker), DepthParseError::None)
+            << "Truncated ticker of length " << length << " was accepted";
+    }
+}
+
+TEST_F(DepthParserTest, ParsesBookTickersLaidOutDifferently) {
+    const std::string reordered = R"({ "data": {"A":"125.1815","a":"3742.12","B":"55.3849","b":"3742.11","s":"ETHUSDT","u":400900217}, "stream": "ethusdt@bookTicker" })";
+    BookTicker ticker;
+
+    ASSERT_EQ(parseBookTickerFrame(reordered.data(), reordered.data() + reordered.size(), 0, symbols, ticker), DepthParseError::None);
+    EXPECT_EQ(ticker.symbolId, symbols.find("ethusdt"));
+    EXPECT_EQ(ticker.updateId, 400900217);
+    EXPECT_DOUBLE_EQ(ticker.bid.price, 3742.11);
+    EXPECT_DOUBLE_EQ(ticker.ask.quantity, 125.1815);
+}
+
+TEST_F(DepthParserTest, ReportsIncompleteBookTickers) {
+    BookTicker ticker;
+    const auto parseTicker = [&](const std::string& str) {
+        return parseBookTickerFrame(str.data(), str.data() + str.size(), 0, symbols, ticker);
+    };
+
+    EXPECT_EQ(parseTicker(R"({"stream":"a@bookTicker","data":{"u":1,"b":"1","B":"2","a":"3"}})"), DepthParseError::MissingData);
+    EXPECT_EQ(parseTicker(R"({"stream":"a@bookTicker","data":{"u":1,"b":"1","B":"x","a":"3","A":"4"}})"), DepthParseError::InvalidPriceLevel);
+    EXPECT_EQ(parseTicker(frame), DepthParseError::MissingData);
+    EXPECT_TRUE(isBookTickerStream("/stream?streams=btcusdt@bookTicker/ethbtc@bookTicker"));
+    EXPECT_FALSE(isBookTickerStream("btcusdt@depth5@100ms"));
+}
@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+#include "file/binary_trade_file_writer.h"
+#include <cstdio>
+#include <fstream>
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+class BinaryTradeFileWriterTest : public ::testing::Test {
+protected:
+    const std::string outputPath = ::testing::TempDir() + "binary_trade_file_writer_test.bin";
+
+    PriceLevels<4> bids = {PriceLevel(100.5, 1.0), PriceLevel(100.25, 2.0), PriceLevel(100.0, 3.0)};
+    PriceLevels<4> asks = {PriceLevel(101.0, 0.5)};
+
+    void TearDown() override { std::remove(outputPath.c_str()); }
+
+    ArbitrageResult makeResult(long long i, std::string_view symbol, std::string_view path) const {
+        return ArbitrageResult(symbol, path, "{}", 1000 + i, 2000 + i, 0.5 * i, 10.0 * i, symbol, i % 2 == 0,
+                               {1.0 + i, 2.0, 3.0}, 100.0 * i, 1.5 * i, 200.0 * i, bids, asks);
+    }
+};
+
+TEST_F(BinaryTradeFileWriterTest, ReadsBackEveryRecordAcrossBlocks) {
+    {
+        // Tiny blocks so the records span several blocks and the file has to grow
+        BinaryTradeFileWriter writer(outputPath, 2, 4, 4096, 1);
+        for (long long i = 0; i < 11; ++i) {
+            writer.write(makeResult(i, i % 3 ? "btcusdt" : "ethbtc", "btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY"));
+        }
+    }
+
+    BinaryTradeFileReader reader(outputPath);
+    ASSERT_EQ(reader.size(), 11u);
+    EXPECT_EQ(reader.levelDepth(), 2u);
+    for (std::size_t i = 0; i < reader.size(); ++i) {
+        EXPECT_EQ(reader.value<std::int64_t>(BinaryColumn::TickReceiveTime, i), 1000 + static_cast<long long>(i));
+        EXPECT_EQ(reader.value<std::int64_t>(BinaryColumn::TickProcessTime, i), 2000 + static_cast<long long>(i));
+        EXPECT_DOUBLE_EQ(reader.value<double>(BinaryColumn::UnrealisedPnl, i), 0.5 * i);
+        EXPECT_DOUBLE_EQ(reader.value<double>(BinaryColumn::TradedNotional, i), 10.0 * i);
+        EXPECT_DOUBLE_EQ(reader.value<double>(BinaryColumn::Rate1, i), 1.0 + i);
+        EXPECT_DOUBLE_EQ(reader.value<double>(BinaryColumn::OptimalNotional, i), 100.0 * i);
+        EXPECT_DOUBLE_EQ(reader.value<double>(BinaryColumn::OptimalPnl, i), 1.5 * i);
+        EXPECT_DOUBLE_EQ(reader.value<double>(BinaryColumn::BreakevenNotional, i), 200.0 * i);
+        EXPECT_EQ(reader.value<std::uint8_t>(BinaryColumn::IsArbitrageOpportunity, i), i % 2 == 0 ? 1 : 0);
+        EXPECT_EQ(reader.string(reader.value<std::uint32_t>(BinaryColumn::Symbol, i)), i % 3 ? "btcusdt" : "ethbtc");
+        EXPECT_EQ(reader.string(reader.value<std::uint32_t>(BinaryColumn::Path, i)), "btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY");
+    }
+}
+
+TEST_F(BinaryTradeFileWriterTest, KeepsTopLevelsUpToDepth) {
+    {
+        BinaryTradeFileWriter writer(outputPath, 2, 8);
+        writer.write(makeResult(0, "btcusdt", "p"));
+    }
+
+    BinaryTradeFileReader reader(outputPath);
+    EXPECT_EQ(reader.value<std::uint8_t>(BinaryColumn::BidCount, 0), 2);
+    EXPECT_EQ(reader.value<std::uint8_t>(BinaryColumn::AskCount, 0), 1);
+    EXPECT_DOUBLE_EQ(reader.bid(0, 0).price, 100.5);
+    EXPECT_DOUBLE_EQ(reader.bid(0, 1).quantity, 2.0);
+    EXPECT_DOUBLE_EQ(reader.ask(0, 0).price, 101.0);
+    EXPECT_DOUBLE_EQ(reader.ask(0, 1).price, 0.0);
+}
+
+TEST_F(BinaryTradeFileWriterTest, StoresEachStringOnceAndMarksDictionaryOverflow) {
+    {
+        // Room for "btcusdt" and "p" but not the long path
+        BinaryTradeFileWriter writer(outputPath, 1, 8, 16);
+        writer.write(makeResult(0, "btcusdt", "p"));
+        writer.write(makeResult(1, "btcusdt", "a path that does not fit"));
+    }
+
+    BinaryTradeFileReader reader(outputPath);
+    EXPECT_EQ(reader.value<std::uint32_t>(BinaryColumn::Symbol, 0), reader.value<std::uint32_t>(BinaryColumn::Symbol, 1));
+    EXPECT_EQ(reader.value<std::uint32_t>(BinaryColumn::Path, 1), NO_DICTIONARY_ENTRY);
+    EXPECT_EQ(reader.string(NO_DICTIONARY_ENTRY), "");
+}
+
+TEST_F(BinaryTradeFileWriterTest, TrimsPreallocationToUsedBlocks) {
+    {
+        BinaryTradeFileWriter writer(outputPath, 1, 4, 1024, 64);
+        writer.write(makeResult(0, "btcusdt", "p"));
+    }
+
+    // Header and dictionary round up to one page
+    const BinaryTradeFileLayout layout{1, 4};
+    std::ifstream file(outputPath, std::ios::binary | std::ios::ate);
+    EXPECT_EQ(static_cast<std::size_t>(file.tellg()), 4096 + layout.blockBytes());
+}
+
+#ifndef _WIN32
+TEST_F(BinaryTradeFileWriterTest, SurvivesAFailedGrowth) {
+    const BinaryTradeFileLayout layout{1, 4};
+    {
+        BinaryTradeFileWriter writer(outputPath, 1, 4, 1024, 1);
+
+        // Cap file sizes at the preallocation, so growing past the first block fails as a full disk would
+        rlimit original{};
+        ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &original), 0);
+        const auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit capped = original;
+        capped.rlim_cur = 4096 + layout.blockBytes();
+        ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &capped), 0);
+
+        for (long long i = 0; i < 6; ++i) {
+            writer.write(makeResult(i, "btcusdt", "p"));
+        }
+
+        setrlimit(RLIMIT_FSIZE, &original);
+        std::signal(SIGXFSZ, previousHandler);
+    } // Destroying the writer must not touch the unmapped header
+
+    std::ifstream file(outputPath, std::ios::binary | std::ios::ate);
+    EXPECT_EQ(static_cast<std::size_t>(file.tellg()), 4096 + layout.blockBytes());
+}
+#endif
+
+TEST_F(BinaryTradeFileWriterTest, RejectsOtherFiles) {
+    {
+        std::ofstream text(outputPath);
+        text << R"({"path":"p"})" << "\n";
+    }
+
+    EXPECT_THROW(BinaryTradeFileReader reader(outputPath), std::invalid_argument);
+}
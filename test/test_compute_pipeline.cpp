@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+#include "server/compute_pipeline.h"
+#include "common/thread_affinity.h"
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+// Records the frame of every result per symbol, in the order they were written
+class FrameRecorder : public ResultWriter {
+public:
+    std::map<std::string, std::vector<std::string>> frames;
+    std::thread::id writerThread;
+
+    void write(const ArbitrageResult& result) override {
+        writerThread = std::this_thread::get_id();
+        frames[std::string(result.symbol)].push_back(std::string(result.jsonStr));
+    }
+};
+
+const std::vector<ArbitragePath> PATHS = ArbitragePath::list_from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY");
+
+OrderBookTick makeTick(const Server& server, const std::string& symbol, const std::string& frame) {
+    OrderBookTick tick;
+    tick.symbolId = server.getSymbolTable().find(symbol);
+    tick.symbol = symbol;
+    tick.jsonStr = frame;
+    tick.updateId = 1;
+    tick.bids = {PriceLevel(1.0, 100.0)};
+    tick.asks = {PriceLevel(1.0, 100.0)};
+    return tick;
+}
+
+} // namespace
+
+TEST(ComputePipelineTest, EvaluatesOnTheComputeThreadInOrderPerQueue) {
+    auto writer = std::make_unique<FrameRecorder>();
+    FrameRecorder& recorder = *writer;
+    auto server = std::make_shared<Server>(PATHS, ServerConfig(0, 0, 1, 0, true), std::move(writer));
+
+    constexpr int TICKS = 3000;
+    {
+        ComputePipeline pipeline(server, PipelineConfig(16));
+        std::vector<std::shared_ptr<TickQueue>> queues;
+        const std::vector<std::string> symbols = {"btcusdt", "ethusdt", "ethbtc"};
+        for (std::size_t i = 0; i < symbols.size(); ++i) {
+            queues.push_back(pipeline.addQueue());
+        }
+        pipeline.start();
+
+        std::vector<std::thread> producers;
+        for (std::size_t i = 0; i < symbols.size(); ++i) {
+            producers.emplace_back([&, i] {
+                // One buffer reused for every frame, as a connection's read buffer is
+                std::string frame;
+                for (int n = 0; n < TICKS; ++n) {
+                    frame = symbols[i] + ":" + std::to_string(n);
+                    OrderBookTick tick = makeTick(*server, symbols[i], frame);
+                    tick.updateId = n + 1;
+                    tick.bids = {PriceLevel(1.0 + n * 1e-3, 100.0)};
+                    tick.asks = {PriceLevel(1.0 + n * 1e-3, 100.0)};
+                    ASSERT_TRUE(queues[i]->push(tick));
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        pipeline.stop();
+
+        EXPECT_EQ(pipeline.stats().processed, 3 * TICKS);
+        EXPECT_GT(pipeline.stats().busyNs, 0);
+        for (const auto& queue : queues) {
+            EXPECT_EQ(queue->getDropped(), 0);
+            EXPECT_LE(queue->getHighWaterMark(), 16);
+        }
+    }
+
+    EXPECT_NE(recorder.writerThread, std::this_thread::get_id());
+    for (const auto& symbolFrames : recorder.frames) {
+        // Each result carries its own tick's frame, in push order
+        int last = -1;
+        for (const auto& frame : symbolFrames.second) {
+            ASSERT_EQ(frame.rfind(symbolFrames.first + ":", 0), 0u) << frame;
+            const int n = std::stoi(frame.substr(symbolFrames.first.size() + 1));
+            EXPECT_GT(n, last);
+            last = n;
+        }
+        EXPECT_EQ(last, TICKS - 1);
+    }
+}
+
+TEST(ComputePipelineTest, DropsWhenFullUnderTheDropPolicy) {
+    auto server = std::make_shared<Server>(PATHS, ServerConfig(0, 0, 1, 0, true));
+    ComputePipeline pipeline(server, PipelineConfig(4, OverflowPolicy::Drop));
+    auto queue = pipeline.addQueue();
+
+    // Not started, so nothing drains
+    for (int i = 0; i < 6; ++i) {
+        queue->push(makeTick(*server, "btcusdt", "{}"));
+    }
+    EXPECT_EQ(queue->getPushed(), 4);
+    EXPECT_EQ(queue->getDropped(), 2);
+    EXPECT_EQ(queue->getHighWaterMark(), 4);
+
+    // Symbols outside every path never take a slot
+    OrderBookTick unknown;
+    unknown.symbolId = INVALID_SYMBOL_ID;
+    EXPECT_TRUE(queue->push(unknown));
+    EXPECT_EQ(queue->getDropped(), 2);
+
+    pipeline.start();
+    pipeline.stop();
+    EXPECT_EQ(pipeline.stats().processed, 4);
+
+    std::ostringstream report;
+    pipeline.report(report, 1.0);
+    EXPECT_NE(report.str().find("queue 0  pushed 4  dropped 2  high-water 4 of 4"), std::string::npos);
+}
+
+TEST(ComputePipelineTest, CarriesBookTickers) {
+    auto writer = std::make_unique<FrameRecorder>();
+    FrameRecorder& recorder = *writer;
+    auto server = std::make_shared<Server>(PATHS, ServerConfig(0, 0, 1, 0, true), std::move(writer));
+    ComputePipeline pipeline(server, PipelineConfig());
+    auto queue = pipeline.addQueue();
+
+    for (const auto& symbol : {"ethusdt", "ethbtc"}) {
+        queue->push(makeTick(*server, symbol, "{}"));
+    }
+    std::string frame = "{\"ticker\":1}";
+    BookTicker ticker;
+    ticker.symbolId = server->getSymbolTable().find("btcusdt");
+    ticker.symbol = frame; // Deliberately not a symbol table view
+    ticker.jsonStr = frame;
+    ticker.updateId = 5;
+    ticker.bid = PriceLevel(1.5, 10.0);
+    ticker.ask = PriceLevel(1.6, 10.0);
+    queue->push(ticker);
+    frame.assign(frame.size(), 'x');
+
+    pipeline.start();
+    pipeline.stop();
+
+    ASSERT_EQ(recorder.frames["btcusdt"].size(), 1u);
+    EXPECT_EQ(recorder.frames["btcusdt"][0], "{\"ticker\":1}");
+}
+
+TEST(ThreadAffinityTest, ParsesCpuLists) {
+    EXPECT_EQ(parseCpuList("2,3, 5"), (std::vector<int>{2, 3, 5}));
+    EXPECT_EQ(parseCpuList("x,1,-4"), (std::vector<int>{1}));
+    EXPECT_TRUE(parseCpuList("").empty());
+    EXPECT_FALSE(pinCurrentThreadToCpu(-1));
+}
@@ -0,0 +1,141 @@
+#include "gtest/gtest.h"
+#include "exchange/binance/connection_manager.h"
+#include <atomic>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+// Counts results per path, checking that writes never overlap
+class CountingWriter : public ResultWriter {
+public:
+    std::map<std::string, int> counts;
+    std::atomic<bool> writing{false};
+    std::atomic<int> overlaps{0};
+
+    void write(const ArbitrageResult& result) override {
+        if (writing.exchange(true)) overlaps++;
+        counts[std::string(result.path)]++;
+        writing.store(false);
+    }
+};
+
+std::string symbolOf(const std::string& stream) {
+    return stream.substr(0, stream.find('@'));
+}
+
+} // namespace
+
+TEST(StreamTargetTest, SplitsAndJoinsCombinedStreams) {
+    const std::string target = "/stream?streams=btcusdt@depth5@100ms/ethbtc@depth5@100ms/ethusdt@bookTicker";
+    const auto streams = splitStreamTarget(target);
+    ASSERT_EQ(streams.size(), 3u);
+    EXPECT_EQ(streams[1], "ethbtc@depth5@100ms");
+    EXPECT_EQ(joinStreamTarget(streams), target);
+
+    EXPECT_TRUE(splitStreamTarget("/ws/btcusdt@depth").empty());
+}
+
+TEST(ShardStreamsTest, KeepsEverySymbolOnOneShard) {
+    const std::vector<std::string> streams = {
+        "btcusdt@depth20@100ms", "ethusdt@depth20@100ms", "btcusdt@bookTicker", "ethbtc@depth20@100ms",
+        "ltcusdt@depth20@100ms", "ethusdt@bookTicker", "ltcbtc@depth20@100ms"};
+    const auto shards = shardStreams(streams, 3, 1024);
+
+    ASSERT_EQ(shards.size(), 3u);
+    std::set<std::string> seen;
+    std::size_t total = 0;
+    for (const auto& shard : shards) {
+        EXPECT_FALSE(shard.empty());
+        std::set<std::string> symbols;
+        for (const auto& stream : shard) symbols.insert(symbolOf(stream));
+        for (const auto& symbol : symbols) {
+            EXPECT_TRUE(seen.insert(symbol).second) << symbol << " is on more than one shard";
+        }
+        total += shard.size();
+    }
+    EXPECT_EQ(total, streams.size());
+    // Streams keep their order within a shard
+    EXPECT_EQ(shards[0][0], "btcusdt@depth20@100ms");
+    EXPECT_EQ(shards[0][1], "btcusdt@bookTicker");
+}
+
+TEST(ShardStreamsTest, BalancesAndRespectsTheStreamLimit) {
+    std::vector<std::string> streams;
+    for (int i = 0; i < 10; ++i) {
+        streams.push_back("sym" + std::to_string(i) + "@depth5");
+    }
+
+    // Two shards would need five streams each
+    const auto limited = shardStreams(streams, 2, 4);
+    ASSERT_EQ(limited.size(), 3u);
+    for (const auto& shard : limited) {
+        EXPECT_LE(shard.size(), 4u);
+    }
+
+    // No more shards than symbols
+    EXPECT_EQ(shardStreams({"btcusdt@depth5", "btcusdt@bookTicker"}, 4, 1024).size(), 1u);
+    EXPECT_EQ(shardStreams(streams, 0, 1024).size(), 1u);
+}
+
+TEST(ConnectionManagerTest, OpensOneClientPerShard) {
+    boost::asio::io_context ioc;
+    boost::asio::ssl::context ssl_ctx(boost::asio::ssl::context::tlsv12_client);
+    auto server = std::make_shared<Server>(
+        ArbitragePath::list_from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY"), ServerConfig(0, 0, 1, 0, true));
+
+    ConnectionManager manager(ioc, ssl_ctx, ConnectionConfig(2));
+    int configured = 0;
+    // Nothing listens there and the io_context never runs, so no frames arrive
+    manager.connect("127.0.0.1", "1", "/stream?streams=btcusdt@depth5/ethusdt@depth5/ethbtc@depth5", server,
+                    [&](BinanceClient&) { configured++; });
+
+    EXPECT_EQ(configured, 2);
+    ASSERT_EQ(manager.getConnections().size(), 2u);
+    EXPECT_EQ(manager.getConnections()[0].target, "/stream?streams=btcusdt@depth5/ethbtc@depth5");
+    EXPECT_EQ(manager.getConnections()[1].target, "/stream?streams=ethusdt@depth5");
+
+    std::ostringstream report;
+    manager.report(report, 1.0);
+    EXPECT_NE(report.str().find("BINANCE CONNECTION 1  streams 1  frames/s 0.0"), std::string::npos);
+}
+
+TEST(ConnectionManagerTest, ServerSerialisesConcurrentUpdates) {
+    const auto paths = ArbitragePath::list_from_string(
+        "btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY;usdt:btcusdt:SELL,ltcbtc:SELL,ltcusdt:BUY");
+    auto writer = std::make_unique<CountingWriter>();
+    CountingWriter& counts = *writer;
+    Server server(paths, ServerConfig(0, 0, 1, 0, true), std::move(writer));
+    server.setConcurrentUpdates(true);
+
+    // One thread per symbol, as if each were on its own connection
+    const std::vector<std::string> symbols = {"btcusdt", "ethusdt", "ethbtc", "ltcbtc", "ltcusdt"};
+    constexpr int TICKS = 2000;
+    std::vector<std::thread> threads;
+    for (const auto& symbol : symbols) {
+        threads.emplace_back([&server, symbol] {
+            OrderBookTick tick;
+            tick.symbolId = server.getSymbolTable().find(symbol);
+            tick.symbol = server.getSymbolTable().name(tick.symbolId);
+            tick.bids = {PriceLevel(1.0, 100.0)};
+            tick.asks = {PriceLevel(1.0, 100.0)};
+            for (int i = 1; i <= TICKS; ++i) {
+                tick.updateId = i;
+                server.on_update(tick);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counts.overlaps.load(), 0);
+    // Each tick of a leg writes one result for the path once all three legs have a book, and the
+    // last tick of every leg comes after that
+    for (const auto& path : paths) {
+        EXPECT_GT(counts.counts[path.to_string()], 0);
+        EXPECT_LE(counts.counts[path.to_string()], 3 * TICKS);
+    }
+}
@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+#include "replay/execution_simulator.h"
+
+namespace {
+
+const std::vector<ArbitragePath> PATHS = ArbitragePath::list_from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY");
+
+OrderBookTick depthTick(const Server& server, const std::string& symbol, long long updateId, long long time,
+                        std::initializer_list<PriceLevel> bids, std::initializer_list<PriceLevel> asks) {
+    OrderBookTick tick;
+    tick.symbolId = server.getSymbolTable().find(symbol);
+    tick.updateId = updateId;
+    tick.tickInitTime = time;
+    tick.bids = bids;
+    tick.asks = asks;
+    return tick;
+}
+
+// Selling btc for usdt, usdt for eth and eth back for btc clears 0.68 / 0.6667 - 1, about 2%, from t=3000
+TickRecording crossedBooks(const Server& server) {
+    TickRecording recording;
+    recording.add(depthTick(server, "btcusdt", 1, 1000, {{30000, 1}}, {{30001, 1}}));
+    recording.add(depthTick(server, "ethusdt", 2, 2000, {{1999, 10}}, {{2000, 10}}));
+    recording.add(depthTick(server, "ethbtc", 3, 3000, {{0.068, 10}}, {{0.0681, 10}}));
+    return recording;
+}
+
+} // namespace
+
+TEST(EventSchedulerTest, OrdersByTimeThenScheduling) {
+    EventScheduler scheduler(4);
+    scheduler.schedule(30, 0, 1);
+    scheduler.schedule(10, 0, 2);
+    scheduler.schedule(30, 1, 3);
+    scheduler.schedule(20, 0, 4);
+    scheduler.schedule(10, 1, 5);
+    ASSERT_EQ(scheduler.size(), 5u);
+    EXPECT_EQ(scheduler.nextTime(), 10);
+
+    std::vector<std::uint32_t> targets;
+    while (!scheduler.empty()) targets.push_back(scheduler.pop().target);
+    EXPECT_EQ(targets, (std::vector<std::uint32_t>{2, 5, 4, 1, 3}));
+}
+
+TEST(FillLegTest, WalksLevelsUpToTheLimit) {
+    OrderBook book;
+    book.bids = {{100, 1}, {99, 2}, {98, 5}};
+    book.asks = {{101, 1}, {102, 2}};
+    const TradeLeg sell("btcusdt", false);
+    const TradeLeg buy("btcusdt", true);
+
+    const LegFill full = fillLeg(sell, book, 2.5, 0, 1.0);
+    EXPECT_DOUBLE_EQ(full.filledInput, 2.5);
+    EXPECT_DOUBLE_EQ(full.output, 100 + 1.5 * 99);
+    EXPECT_DOUBLE_EQ(full.worstPrice, 99);
+
+    // The limit stops the walk before the third level, the rest is cancelled
+    const LegFill limited = fillLeg(sell, book, 5, 99, 0.5);
+    EXPECT_DOUBLE_EQ(limited.filledInput, 3);
+    EXPECT_DOUBLE_EQ(limited.output, 0.5 * (100 + 2 * 99));
+    EXPECT_DOUBLE_EQ(fillLeg(sell, book, 5, 0, 1.0, 1).filledInput, 1);
+
+    // Inverted legs spend quote on the asks
+    const LegFill bought = fillLeg(buy, book, 101 + 102, 0, 1.0);
+    EXPECT_DOUBLE_EQ(bought.filledInput, 203);
+    EXPECT_DOUBLE_EQ(bought.output, 2);
+    EXPECT_DOUBLE_EQ(bought.worstPrice, 102);
+    EXPECT_DOUBLE_EQ(fillLeg(buy, book, 1000, 101, 1.0).filledInput, 101);
+}
+
+TEST(ExecutionSimulatorTest, RealisesTheSignalWhenBooksHoldStill) {
+    const ServerConfig serverConfig(0, 0, 1, 0, true);
+    const Server prototype(PATHS, serverConfig);
+    const TickRecording recording = crossedBooks(prototype);
+
+    for (const ExecutionMode mode : {ExecutionMode::Parallel, ExecutionMode::Sequential}) {
+        ExecutionSimulator simulator(PATHS, serverConfig, ExecutionConfig(0, 0, 0, mode));
+        const ExecutionReport report = simulator.run(recording);
+        EXPECT_EQ(report.ticks, 3u);
+        EXPECT_EQ(report.signals, 1u);
+        EXPECT_EQ(report.attempts, 1u);
+        EXPECT_EQ(report.fullyFilled, 1u);
+        EXPECT_EQ(report.partiallyFilled, 0u);
+        EXPECT_GT(report.unrealisedPnl, 0.01);
+        EXPECT_NEAR(report.realisedPnl, report.unrealisedPnl, 1e-12);
+        EXPECT_DOUBLE_EQ(report.inventoryValue, 0.0);
+        // Three orders, each arriving and reporting back
+        EXPECT_EQ(report.events, 3u + 6u);
+    }
+}
+
+TEST(ExecutionSimulatorTest, LatencyLeavesInventoryWhenTheBookMoves) {
+    const ServerConfig serverConfig(0, 0, 1, 0, true);
+    const Server prototype(PATHS, serverConfig);
+    TickRecording recording = crossedBooks(prototype);
+    // Half the ethbtc bid is gone before the orders sent at t=3000 arrive
+    recording.add(depthTick(prototype, "ethbtc", 4, 3200, {{0.068, 5}, {0.0675, 100}}, {{0.0681, 10}}));
+
+    ExecutionSimulator simulator(PATHS, serverConfig, ExecutionConfig(500, 500));
+    const ExecutionReport report = simulator.run(recording);
+    EXPECT_EQ(report.signals, 2u);
+    EXPECT_EQ(report.skippedBusy, 1u);
+    EXPECT_EQ(report.attempts, 1u);
+    EXPECT_EQ(report.partiallyFilled, 1u);
+    EXPECT_NEAR(report.legRequested[2], 10, 1e-9);
+    EXPECT_NEAR(report.legFilled[2], 5, 1e-9);
+
+    // Half the eth is sold back, the other half is left over and valued at the remaining bid
+    EXPECT_NEAR(report.realisedPnl, 5 * 0.068 - 2.0 / 3, 1e-9);
+    EXPECT_NEAR(report.inventoryValue, 5 * 0.068, 1e-9);
+    EXPECT_NEAR(report.netPnl(), report.unrealisedPnl, 1e-9);
+    EXPECT_LT(report.realisedPnl, 0);
+}
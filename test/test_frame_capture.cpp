@@ -0,0 +1,187 @@
+#include "gtest/gtest.h"
+#include "file/frame_capture.h"
+#include "replay/replay_engine.h"
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+class FrameCaptureTest : public ::testing::Test {
+protected:
+    const std::string base = ::testing::TempDir() + "frame_capture_test";
+
+    void TearDown() override {
+        std::remove((base + ".idx").c_str());
+        for (std::uint32_t i = 0; i < 64; ++i) {
+            std::remove(frameCaptureSegmentPath(base, i).c_str());
+        }
+    }
+
+    static std::string frame(int i) {
+        // Lengths vary so records need padding
+        return "{\"frame\":" + std::to_string(i) + std::string(i % 7, ' ') + "}";
+    }
+
+    // Writes count frames 1ms apart from 1s, into segments small enough that they rotate
+    void writeFrames(int count, std::size_t segmentBytes = 1024) {
+        FrameCaptureWriter writer(base, segmentBytes, 10'000'000);
+        for (int i = 0; i < count; ++i) {
+            writer.append(frame(i), 1'000'000'000 + i * 1'000'000LL);
+        }
+        EXPECT_EQ(writer.getFrames(), static_cast<std::uint64_t>(count));
+    }
+};
+
+TEST_F(FrameCaptureTest, ReadsBackEveryFrameAcrossSegments) {
+    writeFrames(200);
+
+    FrameCaptureReader reader(base + ".idx");
+    EXPECT_GT(reader.segmentCount(), 1u);
+    // One entry per 10ms of frames, plus the first frame of every segment
+    EXPECT_GE(reader.indexSize(), 20u);
+
+    CapturedFrame captured;
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(reader.next(captured)) << i;
+        EXPECT_EQ(captured.data, frame(i));
+        EXPECT_EQ(captured.receiveTimeNs, 1'000'000'000 + i * 1'000'000LL);
+    }
+    EXPECT_FALSE(reader.next(captured));
+}
+
+TEST_F(FrameCaptureTest, SeeksByReceiveTime) {
+    writeFrames(200);
+    FrameCaptureReader reader(base + ".idx");
+    CapturedFrame captured;
+
+    for (int target : {0, 1, 57, 100, 199}) {
+        reader.seek(1'000'000'000 + target * 1'000'000LL);
+        ASSERT_TRUE(reader.next(captured));
+        EXPECT_EQ(captured.data, frame(target));
+    }
+
+    // Between two frames lands on the later one
+    reader.seek(1'000'000'000 + 42 * 1'000'000LL + 1);
+    ASSERT_TRUE(reader.next(captured));
+    EXPECT_EQ(captured.data, frame(43));
+
+    reader.seek(0);
+    ASSERT_TRUE(reader.next(captured));
+    EXPECT_EQ(captured.data, frame(0));
+
+    reader.seek(5'000'000'000LL);
+    EXPECT_FALSE(reader.next(captured));
+}
+
+TEST_F(FrameCaptureTest, GivesOversizedFramesTheirOwnSegment) {
+    const std::string large(4000, 'x');
+    {
+        FrameCaptureWriter writer(base, 1024);
+        writer.append("small", 1);
+        writer.append(large, 2);
+        writer.append("small", 3);
+    }
+
+    FrameCaptureReader reader(base + ".idx");
+    EXPECT_EQ(reader.segmentCount(), 3u);
+    CapturedFrame captured;
+    ASSERT_TRUE(reader.next(captured));
+    ASSERT_TRUE(reader.next(captured));
+    EXPECT_EQ(captured.data, large);
+    ASSERT_TRUE(reader.next(captured));
+    EXPECT_EQ(captured.receiveTimeNs, 3);
+}
+
+TEST_F(FrameCaptureTest, RefusesToOverwriteAnExistingCapture) {
+    writeFrames(200);
+    const std::uint32_t segments = FrameCaptureReader(base + ".idx").segmentCount();
+
+    EXPECT_THROW(FrameCaptureWriter writer(base), std::runtime_error);
+
+    // The earlier capture is left exactly as it was
+    FrameCaptureReader reader(base + ".idx");
+    EXPECT_EQ(reader.segmentCount(), segments);
+    CapturedFrame captured;
+    int count = 0;
+    while (reader.next(captured)) ++count;
+    EXPECT_EQ(count, 200);
+}
+
+#ifndef _WIN32
+TEST_F(FrameCaptureTest, SurvivesAFailedIndexGrowth) {
+    {
+        // An entry for every frame, in segments smaller than the index
+        FrameCaptureWriter writer(base, 64 * 1024, 0);
+        writer.append(frame(0), 1'000'000'000);
+
+        // Cap file sizes at the index's preallocation, so growing it fails as a full disk would
+        rlimit original{};
+        ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &original), 0);
+        const auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit capped = original;
+        capped.rlim_cur = std::filesystem::file_size(base + ".idx");
+        ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &capped), 0);
+
+        int i = 1;
+        while (writer.getFrames() == static_cast<std::uint64_t>(i) && i < 10'000) {
+            writer.append(frame(i), 1'000'000'000 + i * 1'000'000LL);
+            ++i;
+        }
+
+        setrlimit(RLIMIT_FSIZE, &original);
+        std::signal(SIGXFSZ, previousHandler);
+        EXPECT_LT(i, 10'000);
+    } // Destroying the writer must not touch the unmapped index
+
+    FrameCaptureReader reader(base + ".idx");
+    EXPECT_GT(reader.indexSize(), 0u);
+}
+#endif
+
+TEST(CaptureSessionTest, EverySessionGetsItsOwnDirectory) {
+    const std::string directory = ::testing::TempDir() + "capture_sessions";
+    const std::string first = createCaptureSessionDirectory(directory);
+    const std::string second = createCaptureSessionDirectory(directory);
+
+    EXPECT_NE(first, second);
+    EXPECT_TRUE(std::filesystem::is_directory(first));
+    EXPECT_TRUE(std::filesystem::is_directory(second));
+    std::filesystem::remove_all(directory);
+}
+
+TEST_F(FrameCaptureTest, RejectsFilesThatAreNotCaptures) {
+    EXPECT_THROW(FrameCaptureReader(base + ".bin"), std::runtime_error);
+    {
+        MappedFile bogus(base + ".idx", MappedFile::Mode::ReadWrite, 64);
+    }
+    EXPECT_THROW(FrameCaptureReader(base + ".idx"), std::invalid_argument);
+}
+
+TEST_F(FrameCaptureTest, ReplaysACaptureFromAStartTime) {
+    const std::vector<std::string> frames = {
+        R"({"stream":"btcusdt@depth5@100ms","data":{"lastUpdateId":1,"bids":[["30000.0","1.0"]],"asks":[["30001.0","1.0"]]}})",
+        R"({"stream":"ethusdt@depth5@100ms","data":{"lastUpdateId":2,"bids":[["2000.0","1.0"]],"asks":[["2001.0","1.0"]]}})",
+        R"({"stream":"ethbtc@depth5@100ms","data":{"lastUpdateId":3,"bids":[["0.066","1.0"]],"asks":[["0.0661","1.0"]]}})",
+        R"({"stream":"btcusdt@depth5@100ms","data":{"lastUpdateId":4,"bids":[["30002.0","1.0"]],"asks":[["30003.0","1.0"]]}})"};
+    {
+        FrameCaptureWriter writer(base);
+        for (std::size_t i = 0; i < frames.size(); ++i) {
+            writer.append(frames[i], 1'000 * static_cast<std::int64_t>(i + 1));
+        }
+    }
+
+    auto clock = std::make_shared<ReplayClock>();
+    auto server = std::make_shared<Server>(
+        ArbitragePath::list_from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY"), ServerConfig(0, 0, 1, 0, true), clock);
+    ReplayEngine engine(server, clock, ReplayConfig());
+
+    FrameCaptureReader reader(base + ".idx");
+    const ReplayStats stats = engine.run(reader, 2'000);
+    EXPECT_EQ(stats.framesRead, 3);
+    EXPECT_EQ(stats.ticksDispatched, 3);
+    EXPECT_EQ(stats.parseFailures, 0);
+}
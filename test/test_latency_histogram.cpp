@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+#include "common/latency_histogram.h"
+#include "common/latency_stats.h"
+#include <sstream>
+
+TEST(LatencyHistogramTest, CountsSmallValuesExactly) {
+    LatencyHistogram histogram;
+    for (int v = 1; v <= 50; ++v) {
+        histogram.record(v);
+    }
+
+    EXPECT_EQ(histogram.count(), 50u);
+    EXPECT_EQ(histogram.valueAtPercentile(50), 25u);
+    EXPECT_EQ(histogram.valueAtPercentile(100), 50u);
+    EXPECT_EQ(histogram.max(), 50u);
+}
+
+TEST(LatencyHistogramTest, KeepsRelativeErrorWithinSubBucketPrecision) {
+    for (std::uint64_t value : {64ull, 100ull, 1234ull, 98765ull, 5000000ull, 123456789012ull}) {
+        const std::size_t index = LatencyHistogram::bucketIndex(value);
+        const std::uint64_t upper = LatencyHistogram::bucketUpperBound(index);
+
+        EXPECT_GE(upper, value);
+        EXPECT_LE(static_cast<double>(upper - value) / value, 1.0 / LatencyHistogram::SUB_BUCKETS) << value;
+        EXPECT_EQ(LatencyHistogram::bucketIndex(upper), index) << value;
+    }
+}
+
+TEST(LatencyHistogramTest, ReportsTailPercentiles) {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 990; ++i) histogram.record(1000);
+    for (int i = 0; i < 9; ++i) histogram.record(50000);
+    histogram.record(2000000);
+
+    EXPECT_NEAR(static_cast<double>(histogram.valueAtPercentile(50)), 1000, 1000 / 64.0);
+    EXPECT_NEAR(static_cast<double>(histogram.valueAtPercentile(99.9)), 50000, 50000 / 64.0);
+    EXPECT_EQ(histogram.valueAtPercentile(100), 2000000u);
+}
+
+TEST(LatencyHistogramTest, ClampsNegativeAndHugeValues) {
+    LatencyHistogram histogram;
+    histogram.record(-5);
+    histogram.record(1ll << 50);
+
+    EXPECT_EQ(histogram.count(), 2u);
+    EXPECT_EQ(histogram.valueAtPercentile(0), 0u);
+    EXPECT_EQ(histogram.max(), 1ull << 50);
+}
+
+TEST(LatencyHistogramTest, MergesAndResets) {
+    LatencyHistogram a;
+    LatencyHistogram b;
+    a.record(10);
+    b.record(20);
+    b.record(30);
+
+    a.merge(b);
+    EXPECT_EQ(a.count(), 3u);
+    EXPECT_EQ(a.max(), 30u);
+
+    a.reset();
+    EXPECT_EQ(a.count(), 0u);
+    EXPECT_EQ(a.valueAtPercentile(50), 0u);
+}
+
+TEST(LatencyStatsTest, DumpsOnlyStagesThatRecorded) {
+    LatencyStats stats("TEST", 1);
+    stats.record(LatencyStage::Parse, 800);
+    stats.record(LatencyStage::EffectiveRates, 150);
+
+    std::ostringstream out;
+    stats.dump(out, 1.0);
+
+    EXPECT_NE(out.str().find("parse"), std::string::npos);
+    EXPECT_NE(out.str().find("effective rates"), std::string::npos);
+    EXPECT_EQ(out.str().find("writer flush"), std::string::npos);
+    EXPECT_TRUE(stats.enabled());
+    EXPECT_FALSE(LatencyStats("OFF", 0).enabled());
+}
@@ -0,0 +1,260 @@
+#include "gtest/gtest.h"
+#include "exchange/binance/local_order_book.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace {
+
+DepthDiff makeDiff(long long first, long long last, std::vector<PriceLevel> bids, std::vector<PriceLevel> asks) {
+    DepthDiff diff;
+    diff.symbolId = 0;
+    diff.symbol = "btcusdt";
+    diff.firstUpdateId = first;
+    diff.finalUpdateId = last;
+    diff.bids = std::move(bids);
+    diff.asks = std::move(asks);
+    return diff;
+}
+
+DepthSnapshot makeSnapshot(long long lastUpdateId) {
+    DepthSnapshot snapshot;
+    snapshot.lastUpdateId = lastUpdateId;
+    snapshot.bids = {PriceLevel(100.0, 1.0), PriceLevel(99.0, 2.0), PriceLevel(98.0, 3.0)};
+    snapshot.asks = {PriceLevel(101.0, 1.5), PriceLevel(102.0, 2.5)};
+    return snapshot;
+}
+
+// Hands out queued snapshots and counts the requests
+class QueuedSnapshots : public SnapshotProvider {
+public:
+    std::vector<DepthSnapshot> queue;
+    int fetches = 0;
+
+    bool fetch(std::string_view, DepthSnapshot& snapshot) override {
+        fetches++;
+        if (queue.empty()) return false;
+        snapshot = queue.front();
+        queue.erase(queue.begin());
+        return true;
+    }
+};
+
+} // namespace
+
+TEST(BookSideTest, KeepsLevelsSortedBestFirst) {
+    BookSide<std::less<double>> bids;
+    BookSide<std::greater<double>> asks;
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> tick(1, 200);
+    for (int i = 0; i < 500; ++i) {
+        const double price = tick(rng);
+        const double quantity = i % 5 == 0 ? 0.0 : i;
+        bids.set(price, quantity);
+        asks.set(price, quantity);
+    }
+
+    ASSERT_FALSE(bids.empty());
+    ASSERT_EQ(bids.size(), asks.size());
+    for (std::size_t i = 1; i < bids.size(); ++i) {
+        EXPECT_GT(bids.level(i - 1).price, bids.level(i).price);
+        EXPECT_LT(asks.level(i - 1).price, asks.level(i).price);
+    }
+}
+
+TEST(BookSideTest, UpdatesAndRemovesLevels) {
+    BookSide<std::less<double>> bids;
+    bids.set(100.0, 1.0);
+    bids.set(99.0, 2.0);
+    bids.set(100.0, 3.0);
+    bids.set(98.0, 0.0); // Removing a missing level is a no-op
+
+    ASSERT_EQ(bids.size(), 2u);
+    EXPECT_EQ(bids.level(0).quantity, 3.0);
+
+    bids.set(100.0, 0.0);
+    ASSERT_EQ(bids.size(), 1u);
+    EXPECT_EQ(bids.level(0).price, 99.0);
+}
+
+TEST(BookSideTest, CopiesOnlyTheBestLevelsThatFit) {
+    BookSide<std::greater<double>> asks;
+    for (int i = 0; i < 10; ++i) {
+        asks.set(100.0 + i, 1.0);
+    }
+
+    PriceLevels<4> best;
+    asks.copyBest(best);
+    ASSERT_EQ(best.size(), 4u);
+    EXPECT_EQ(best[0].price, 100.0);
+    EXPECT_EQ(best[3].price, 103.0);
+}
+
+TEST(LocalOrderBookTest, NeedsASnapshotFirst) {
+    LocalOrderBook book;
+    EXPECT_EQ(book.apply(makeDiff(1, 2, {}, {})), DiffResult::OutOfSync);
+    EXPECT_FALSE(book.isSynced());
+}
+
+TEST(LocalOrderBookTest, AppliesDiffsThatFollowTheSnapshot) {
+    LocalOrderBook book;
+    book.load(makeSnapshot(100));
+
+    // Already in the snapshot
+    EXPECT_EQ(book.apply(makeDiff(90, 100, {PriceLevel(100.0, 9.0)}, {})), DiffResult::Stale);
+    // The first diff straddles the snapshot, then each continues from the last
+    EXPECT_EQ(book.apply(makeDiff(95, 105, {PriceLevel(100.0, 0.0)}, {PriceLevel(100.5, 4.0)})), DiffResult::Applied);
+    EXPECT_EQ(book.apply(makeDiff(106, 110, {PriceLevel(99.5, 7.0)}, {PriceLevel(102.0, 0.0)})), DiffResult::Applied);
+    EXPECT_EQ(book.lastUpdateId(), 110);
+
+    OrderBook published;
+    book.copyTo(published);
+    EXPECT_EQ(published.updateId, 110);
+    ASSERT_EQ(published.bids.size(), 3u);
+    EXPECT_EQ(published.bids[0].price, 99.5);
+    EXPECT_EQ(published.bids[1].price, 99.0);
+    ASSERT_EQ(published.asks.size(), 2u);
+    EXPECT_EQ(published.asks[0].price, 100.5);
+    EXPECT_EQ(published.asks[1].price, 101.0);
+}
+
+TEST(LocalOrderBookTest, DetectsGaps) {
+    LocalOrderBook book;
+    book.load(makeSnapshot(100));
+    EXPECT_EQ(book.apply(makeDiff(102, 105, {}, {})), DiffResult::OutOfSync);
+    EXPECT_FALSE(book.isSynced());
+
+    book.load(makeSnapshot(100));
+    ASSERT_EQ(book.apply(makeDiff(101, 105, {}, {})), DiffResult::Applied);
+    EXPECT_EQ(book.apply(makeDiff(107, 110, {}, {})), DiffResult::OutOfSync);
+    // Refused until the next snapshot, even if it would have followed on
+    EXPECT_EQ(book.apply(makeDiff(106, 110, {}, {})), DiffResult::OutOfSync);
+}
+
+TEST(LocalOrderBooksTest, SyncsFromASnapshotAndPublishesTicks) {
+    auto snapshots = std::make_shared<QueuedSnapshots>();
+    snapshots->queue = {makeSnapshot(100)};
+    LocalOrderBooks books(snapshots);
+    OrderBookTick tick;
+
+    DepthDiff diff = makeDiff(99, 101, {PriceLevel(100.0, 5.0)}, {});
+    diff.tickInitTime = 77;
+    ASSERT_TRUE(books.apply(diff, tick));
+    EXPECT_EQ(snapshots->fetches, 1);
+    EXPECT_EQ(tick.symbolId, 0u);
+    EXPECT_EQ(tick.symbol, "btcusdt");
+    EXPECT_EQ(tick.tickInitTime, 77);
+    EXPECT_EQ(tick.updateId, 101);
+    EXPECT_EQ(tick.bids[0].quantity, 5.0);
+
+    ASSERT_TRUE(books.apply(makeDiff(102, 102, {}, {PriceLevel(101.0, 0.0)}), tick));
+    EXPECT_EQ(tick.asks[0].price, 102.0);
+    EXPECT_EQ(snapshots->fetches, 1);
+    EXPECT_EQ(books.getResyncCount(), 1);
+}
+
+TEST(LocalOrderBooksTest, ResyncsAfterAGap) {
+    auto snapshots = std::make_shared<QueuedSnapshots>();
+    snapshots->queue = {makeSnapshot(100), makeSnapshot(120)};
+    LocalOrderBooks books(snapshots);
+    OrderBookTick tick;
+
+    ASSERT_TRUE(books.apply(makeDiff(101, 101, {}, {}), tick));
+    // Missed 102 to 114, the newer snapshot already contains this diff
+    ASSERT_TRUE(books.apply(makeDiff(115, 118, {PriceLevel(100.0, 8.0)}, {}), tick));
+    EXPECT_EQ(tick.updateId, 120);
+    EXPECT_EQ(tick.bids[0].quantity, 1.0);
+    EXPECT_EQ(books.getResyncCount(), 2);
+    ASSERT_NE(books.find(0), nullptr);
+    EXPECT_EQ(books.find(0)->lastUpdateId(), 120);
+}
+
+TEST(LocalOrderBooksTest, PublishesNothingWithoutASnapshot) {
+    auto snapshots = std::make_shared<QueuedSnapshots>();
+    LocalOrderBooks books(snapshots);
+    OrderBookTick tick;
+
+    EXPECT_FALSE(books.apply(makeDiff(1, 2, {}, {}), tick));
+    EXPECT_EQ(books.find(0), nullptr);
+
+    // A snapshot older than the diff leaves the gap open
+    snapshots->queue = {makeSnapshot(0)};
+    EXPECT_FALSE(books.apply(makeDiff(5, 6, {}, {}), tick));
+    EXPECT_EQ(books.find(0), nullptr);
+
+    DepthDiff unknown = makeDiff(1, 2, {}, {});
+    unknown.symbolId = INVALID_SYMBOL_ID;
+    EXPECT_FALSE(books.apply(unknown, tick));
+}
+
+TEST(LocalOrderBooksTest, DoesNotLoadSnapshotsOlderThanTheGap) {
+    auto snapshots = std::make_shared<QueuedSnapshots>();
+    snapshots->queue = {makeSnapshot(100), makeSnapshot(100), makeSnapshot(100), makeSnapshot(120)};
+    LocalOrderBooks books(snapshots);
+    OrderBookTick tick;
+
+    ASSERT_TRUE(books.apply(makeDiff(101, 101, {}, {}), tick));
+    EXPECT_FALSE(books.apply(makeDiff(110, 111, {}, {}), tick));
+    EXPECT_FALSE(books.apply(makeDiff(112, 113, {}, {}), tick));
+    EXPECT_EQ(snapshots->fetches, 3);
+    EXPECT_EQ(books.getResyncCount(), 1);
+    EXPECT_EQ(books.find(0), nullptr);
+
+    ASSERT_TRUE(books.apply(makeDiff(114, 121, {}, {}), tick));
+    EXPECT_EQ(books.getResyncCount(), 2);
+    EXPECT_EQ(books.find(0)->lastUpdateId(), 121);
+}
+
+TEST(SnapshotProviderTest, ReadsSnapshotFiles) {
+    const std::string directory = ::testing::TempDir();
+    const std::string path = directory + "/localbooktestusdt.json";
+    {
+        std::ofstream file(path);
+        file << R"({"lastUpdateId":42,"bids":[["1.5","2"]],"asks":[["1.6","3"]]})";
+    }
+
+    FileSnapshotProvider provider(directory);
+    DepthSnapshot snapshot;
+    ASSERT_TRUE(provider.fetch("localbooktestusdt", snapshot));
+    EXPECT_EQ(snapshot.lastUpdateId, 42);
+    ASSERT_EQ(snapshot.bids.size(), 1u);
+    EXPECT_EQ(snapshot.asks[0].quantity, 3.0);
+
+    EXPECT_FALSE(provider.fetch("missingsymbol", snapshot));
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotProviderTest, ParsesEachFileOnceUntilItChanges) {
+    const std::string directory = ::testing::TempDir();
+    const std::string path = directory + "/cachedbooktestusdt.json";
+    const auto write = [&path](const char* content) {
+        std::ofstream file(path, std::ios::trunc);
+        file << content;
+    };
+    write(R"({"lastUpdateId":42,"bids":[["1.5","2"]],"asks":[["1.6","3"]]})");
+    const auto modified = std::filesystem::last_write_time(path);
+
+    FileSnapshotProvider provider(directory);
+    DepthSnapshot snapshot;
+    ASSERT_TRUE(provider.fetch("cachedbooktestusdt", snapshot));
+    EXPECT_EQ(snapshot.lastUpdateId, 42);
+
+    // Same size and modification time, so the parsed copy is handed out again
+    write(R"({"lastUpdateId":43,"bids":[["1.5","2"]],"asks":[["1.6","3"]]})");
+    std::filesystem::last_write_time(path, modified);
+    ASSERT_TRUE(provider.fetch("cachedbooktestusdt", snapshot));
+    EXPECT_EQ(snapshot.lastUpdateId, 42);
+
+    std::filesystem::last_write_time(path, modified + std::chrono::seconds(1));
+    ASSERT_TRUE(provider.fetch("cachedbooktestusdt", snapshot));
+    EXPECT_EQ(snapshot.lastUpdateId, 43);
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotProviderTest, ReportsUnreachableEndpoints) {
+    HttpSnapshotProvider provider("127.0.0.1", "1");
+    DepthSnapshot snapshot;
+    EXPECT_FALSE(provider.fetch("btcusdt", snapshot));
+}
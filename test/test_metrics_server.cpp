@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+#include "exchange/binance/connection_manager.h"
+#include "file/async_result_writer.h"
+#include "metrics/metrics_server.h"
+#include "mock/mock_binance_server.h"
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+namespace {
+
+namespace http = boost::beast::http;
+
+http::response<http::string_body> get(unsigned short port, const std::string& target) {
+    boost::asio::io_context ioc;
+    boost::beast::tcp_stream stream(ioc);
+    stream.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), port));
+    http::request<http::string_body> request(http::verb::get, target, 11);
+    request.set(http::field::host, "127.0.0.1");
+    http::write(stream, request);
+
+    boost::beast::flat_buffer buffer;
+    http::response<http::string_body> response;
+    http::read(stream, buffer, response);
+    return response;
+}
+
+// Value of the sample whose name and labels are exactly series, -1 if there is none
+double sampleValue(const std::string& text, const std::string& series) {
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, series.size() + 1, series + " ") == 0) return std::stod(line.substr(series.size() + 1));
+    }
+    return -1;
+}
+
+} // namespace
+
+TEST(MetricsServerTest, ServesMetricsOnLoopback) {
+    MetricsServer metrics(0, [](std::ostream& out) { out << "# TYPE test_metric counter\ntest_metric 1\n"; });
+    metrics.start();
+
+    const auto response = get(metrics.port(), "/metrics");
+    EXPECT_EQ(response.result(), http::status::ok);
+    EXPECT_EQ(response[http::field::content_type], "text/plain; version=0.0.4; charset=utf-8");
+    EXPECT_EQ(sampleValue(response.body(), "test_metric"), 1);
+
+    EXPECT_EQ(get(metrics.port(), "/").result(), http::status::not_found);
+    EXPECT_EQ(metrics.scrapes(), 1u);
+    metrics.stop();
+}
+
+TEST(MetricsServerTest, ExportsServerAndWriterCounters) {
+    const std::string path = ::testing::TempDir() + "metrics_results.txt";
+    std::remove(path.c_str());
+    const auto paths = ArbitragePath::list_from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY");
+    Server server(paths, ServerConfig(0, 0, 1, 0, true), makeResultWriter(ResultFileFormat::Text, path, AsyncWriterConfig()));
+
+    long long updateId = 1;
+    for (const char* symbol : {"btcusdt", "ethusdt", "ethbtc", "btcusdt"}) {
+        OrderBookTick tick;
+        tick.symbol = symbol;
+        tick.symbolId = server.getSymbolTable().find(symbol);
+        tick.updateId = updateId++;
+        tick.bids.emplace_back(100.0 + updateId, 1.0);
+        tick.asks.emplace_back(101.0 + updateId, 1.0);
+        server.on_update(tick);
+    }
+
+    std::ostringstream out;
+    writeMetrics(out, server, nullptr);
+    const std::string text = out.str();
+
+    EXPECT_EQ(sampleValue(text, "arbitrage_ticks_total"), 4);
+    EXPECT_EQ(sampleValue(text, "arbitrage_evaluations_total"), server.getEvaluationStats().evaluations);
+    EXPECT_EQ(sampleValue(text, "arbitrage_skipped_evaluations_total"), server.getEvaluationStats().skippedEvaluations);
+    EXPECT_GE(sampleValue(text, "arbitrage_opportunities_total"), 0);
+    EXPECT_GE(sampleValue(text, "arbitrage_writer_bytes_total"), 0);
+    EXPECT_GE(sampleValue(text, "arbitrage_writer_queue_depth"), 0);
+    EXPECT_EQ(sampleValue(text, "arbitrage_writer_dropped_total"), 0);
+    EXPECT_EQ(text.find("arbitrage_connection_"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(MetricsServerTest, CountsFramesPerStream) {
+    boost::asio::io_context mock_ioc;
+    MockBinanceServer mock(mock_ioc, MockServerConfig("127.0.0.1", 0, true, 2000));
+    mock.start();
+    std::thread mock_thread([&mock_ioc] { mock_ioc.run(); });
+
+    boost::asio::io_context bot_ioc;
+    boost::asio::ssl::context ctx(boost::asio::ssl::context::tlsv12_client);
+    ConnectionManager connections(bot_ioc, ctx, ConnectionConfig(1, 1));
+    const auto paths = ArbitragePath::list_from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY");
+    const auto server = std::make_shared<Server>(paths, ServerConfig(0, 0, 1, 0, true));
+    connections.connect("127.0.0.1", std::to_string(mock.port()),
+                        "/stream?streams=btcusdt@depth5@100ms/ethusdt@depth5@100ms/ethbtc@depth5@100ms", server,
+                        [](BinanceClient&) {});
+    const ConnectionCounters& counters = connections.getConnections()[0].client->getCounters();
+
+    MetricsServer metrics(0, [&](std::ostream& out) { writeMetrics(out, *server, &connections); });
+    metrics.start();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    boost::asio::steady_timer check(bot_ioc);
+    std::function<void(boost::beast::error_code)> onCheck = [&](boost::beast::error_code) {
+        if (counters.frames.load() >= 150 || std::chrono::steady_clock::now() > deadline) {
+            bot_ioc.stop();
+            return;
+        }
+        check.expires_after(std::chrono::milliseconds(10));
+        check.async_wait(onCheck);
+    };
+    onCheck({});
+    connections.run();
+
+    mock.stop();
+    mock_ioc.stop();
+    mock_thread.join();
+
+    const std::string text = get(metrics.port(), "/metrics").body();
+    const std::string connection = "{connection=\"" + connections.getConnections()[0].client->getName() + "\"";
+    const double frames = sampleValue(text, "arbitrage_connection_frames_total" + connection + "}");
+    EXPECT_GE(frames, 150);
+    EXPECT_EQ(sampleValue(text, "arbitrage_connection_parse_errors_total" + connection + "}"), 0);
+    EXPECT_EQ(sampleValue(text, "arbitrage_connection_reconnects_total" + connection + "}"), 0);
+
+    // The mock round-robins the streams, and every frame parsed counts against its own
+    double streamFrames = 0;
+    for (const char* stream : {"btcusdt@depth5@100ms", "ethusdt@depth5@100ms", "ethbtc@depth5@100ms"}) {
+        const double count = sampleValue(text, "arbitrage_stream_frames_total" + connection + ",stream=\"" + stream + "\"}");
+        EXPECT_GE(count, frames / 3 - 1) << stream;
+        streamFrames += count;
+    }
+    EXPECT_EQ(streamFrames, frames);
+    EXPECT_EQ(sampleValue(text, "arbitrage_ticks_total"), frames);
+}
@@ -0,0 +1,203 @@
+#include "gtest/gtest.h"
+#include "exchange/binance/connection_manager.h"
+#include "mock/mock_binance_server.h"
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+
+namespace {
+
+const std::vector<std::string> STREAMS = {"btcusdt@depth5@100ms", "ethusdt@depth20@100ms", "ethbtc@bookTicker"};
+
+// Counts ticks that reached a result, after the connection has parsed them
+class CountingWriter : public ResultWriter {
+public:
+    std::atomic<std::uint64_t> results{0};
+
+    void write(const ArbitrageResult&) override { results++; }
+};
+
+} // namespace
+
+TEST(MockFrameTest, ReadsAndStampsUpdateIds) {
+    std::string depth = R"({"stream":"btcusdt@depth5@100ms","data":{"lastUpdateId":160,"bids":[["1.0","2.0"]],"asks":[]}})";
+    EXPECT_EQ(frameStreamName(depth), "btcusdt@depth5@100ms");
+    EXPECT_EQ(frameUpdateId(depth), 160);
+    ASSERT_TRUE(stampUpdateId(depth, 1234567890123LL));
+    EXPECT_EQ(frameUpdateId(depth), 1234567890123LL);
+    EXPECT_NE(depth.find(R"("bids":[["1.0","2.0"]])"), std::string::npos);
+
+    std::string ticker = R"({"stream":"ethusdt@bookTicker","data":{"u": 400900217,"s":"ETHUSDT","b":"1","B":"2","a":"3","A":"4"}})";
+    EXPECT_EQ(frameUpdateId(ticker), 400900217);
+    ASSERT_TRUE(stampUpdateId(ticker, 7));
+    EXPECT_EQ(frameUpdateId(ticker), 7);
+
+    std::string other = R"({"result":null,"id":1})";
+    EXPECT_EQ(frameStreamName(other), "");
+    EXPECT_EQ(frameUpdateId(other), -1);
+    EXPECT_FALSE(stampUpdateId(other, 1));
+}
+
+TEST(MockFeedTest, SyntheticFramesParseAsTheirStreams) {
+    SymbolTable symbols;
+    symbols.intern("btcusdt");
+    symbols.intern("ethusdt");
+    symbols.intern("ethbtc");
+    MockFeed feed(STREAMS, 10, 1);
+    ASSERT_FALSE(feed.empty());
+
+    OrderBookTick tick;
+    BookTicker ticker;
+    for (long long id = 1; id <= 6; ++id) {
+        const std::string& frame = feed.next(id);
+        const std::string& stream = STREAMS[(id - 1) % STREAMS.size()];
+        EXPECT_EQ(frameStreamName(frame), stream);
+        if (isBookTickerStream(stream)) {
+            ASSERT_EQ(parseBookTickerFrame(frame.data(), frame.data() + frame.size(), 0, symbols, ticker), DepthParseError::None) << frame;
+            EXPECT_EQ(ticker.updateId, id);
+            EXPECT_LT(ticker.bid.price, ticker.ask.price);
+        } else {
+            ASSERT_EQ(parseDepthFrame(frame.data(), frame.data() + frame.size(), 0, symbols, tick), DepthParseError::None) << frame;
+            EXPECT_EQ(tick.updateId, id);
+            // Never more levels than the stream's @depthN asks for
+            EXPECT_EQ(tick.bids.size(), stream == STREAMS[0] ? 5u : 10u);
+            EXPECT_LT(tick.bids[0].price, tick.asks[0].price);
+            EXPECT_GT(tick.bids[0].price, tick.bids[1].price);
+        }
+    }
+}
+
+TEST(MockFeedTest, RecordedFramesAreFilteredToTheSubscription) {
+    const auto recorded = std::make_shared<std::vector<std::string>>(std::vector<std::string>{
+        R"({"stream":"btcusdt@depth5@100ms","data":{"lastUpdateId":1,"bids":[],"asks":[]}})",
+        R"({"stream":"ltcusdt@depth5@100ms","data":{"lastUpdateId":2,"bids":[],"asks":[]}})",
+        R"({"stream":"ethbtc@bookTicker","data":{"u":3,"s":"ETHBTC","b":"1","B":"1","a":"2","A":"1"}})"});
+
+    MockFeed feed(STREAMS, recorded);
+    EXPECT_EQ(frameStreamName(feed.next(10)), "btcusdt@depth5@100ms");
+    EXPECT_EQ(frameStreamName(feed.next(11)), "ethbtc@bookTicker");
+    const std::string& again = feed.next(12);
+    EXPECT_EQ(frameStreamName(again), "btcusdt@depth5@100ms");
+    EXPECT_EQ(frameUpdateId(again), 12);
+
+    EXPECT_TRUE(MockFeed({"xrpusdt@depth5@100ms"}, recorded).empty());
+}
+
+TEST(MockBinanceServerTest, ServesPlainWebsocketClients) {
+    boost::asio::io_context ioc;
+    MockBinanceServer mock(ioc, MockServerConfig("127.0.0.1", 0, false, 1000));
+    mock.start();
+    std::thread mock_thread([&ioc] { ioc.run(); });
+
+    boost::asio::io_context client_ioc;
+    boost::beast::websocket::stream<boost::beast::tcp_stream> ws(client_ioc);
+    boost::beast::get_lowest_layer(ws).connect(
+        boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), mock.port()));
+    ws.handshake("127.0.0.1", joinStreamTarget({STREAMS[0], STREAMS[2]}));
+
+    long long lastUpdateId = 0;
+    for (int i = 0; i < 4; ++i) {
+        boost::beast::flat_buffer buffer;
+        ws.read(buffer);
+        const std::string frame = boost::beast::buffers_to_string(buffer.data());
+        EXPECT_EQ(frameStreamName(frame), i % 2 == 0 ? STREAMS[0] : STREAMS[2]);
+        EXPECT_GT(frameUpdateId(frame), lastUpdateId);
+        lastUpdateId = frameUpdateId(frame);
+    }
+    ws.close(boost::beast::websocket::close_code::normal);
+
+    mock.stop();
+    ioc.stop();
+    mock_thread.join();
+    EXPECT_EQ(mock.getStats().connections.load(), 1u);
+    EXPECT_GE(mock.getStats().frames.load(), 4u);
+}
+
+TEST(MockBinanceServerTest, FeedsBinanceClientOverTls) {
+    boost::asio::io_context mock_ioc;
+    MockBinanceServer mock(mock_ioc, MockServerConfig("127.0.0.1", 0, true, 2000));
+    mock.start();
+    std::thread mock_thread([&mock_ioc] { mock_ioc.run(); });
+
+    const auto paths = ArbitragePath::list_from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY");
+    auto writer = std::make_unique<CountingWriter>();
+    CountingWriter& results = *writer;
+    const auto server = std::make_shared<Server>(paths, ServerConfig(0, 0, 1, 0, true), std::move(writer));
+
+    boost::asio::io_context bot_ioc;
+    boost::asio::ssl::context ctx(boost::asio::ssl::context::tlsv12_client);
+    auto client = std::make_shared<BinanceClient>(bot_ioc, ctx, "MOCK TEST");
+    client->set_callback(server);
+    client->async_connect("127.0.0.1", std::to_string(mock.port()),
+                          "/stream?streams=btcusdt@depth5@100ms/ethusdt@depth5@100ms/ethbtc@depth5@100ms");
+
+    // Runs until a few hundred frames have arrived, or gives up after five seconds
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (client->getCounters().frames.load() < 300 && std::chrono::steady_clock::now() < deadline) {
+        bot_ioc.run_for(std::chrono::milliseconds(50));
+    }
+
+    mock.stop();
+    mock_ioc.stop();
+    mock_thread.join();
+
+    const ConnectionCounters& counters = client->getCounters();
+    EXPECT_GE(counters.frames.load(), 300u);
+    EXPECT_EQ(counters.parseErrors.load(), 0u);
+    EXPECT_EQ(counters.updates.load(), counters.frames.load());
+    EXPECT_GT(results.results.load(), 0u);
+}
+
+TEST(TransportConfigTest, RejectsUnknownCiphers) {
+    boost::asio::ssl::context ctx(boost::asio::ssl::context::tlsv12_client);
+    EXPECT_NO_THROW(BinanceClient::configure_tls(ctx, TransportConfig()));
+    EXPECT_NO_THROW(BinanceClient::configure_tls(ctx, TransportConfig(true, 0, false, 0, "ECDHE-ECDSA-AES128-GCM-SHA256")));
+    EXPECT_THROW(BinanceClient::configure_tls(ctx, TransportConfig(true, 0, false, 0, "NOT-A-CIPHER")), std::invalid_argument);
+}
+
+TEST(TransportConfigTest, BusyPollingConnectionsReadTheMock) {
+    boost::asio::io_context mock_ioc;
+    MockBinanceServer mock(mock_ioc, MockServerConfig("127.0.0.1", 0, true, 2000));
+    mock.start();
+    std::thread mock_thread([&mock_ioc] { mock_ioc.run(); });
+
+    // Every option away from its default, the cipher one the mock's certificate can use
+    const TransportConfig transport(false, 1 << 20, true, 1 << 16, "ECDHE-ECDSA-AES128-GCM-SHA256", true);
+    boost::asio::io_context bot_ioc;
+    boost::asio::ssl::context ctx(boost::asio::ssl::context::tlsv12_client);
+    BinanceClient::configure_tls(ctx, transport);
+    ConnectionManager connections(bot_ioc, ctx, ConnectionConfig(1, 1));
+    connections.set_transport(transport);
+
+    const auto paths = ArbitragePath::list_from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY");
+    const auto server = std::make_shared<Server>(paths, ServerConfig(0, 0, 1, 0, true));
+    connections.connect("127.0.0.1", std::to_string(mock.port()),
+                        "/stream?streams=btcusdt@depth5@100ms/ethusdt@depth5@100ms/ethbtc@depth5@100ms", server,
+                        [](BinanceClient&) {});
+    const ConnectionCounters& counters = connections.getConnections()[0].client->getCounters();
+
+    // Stops the busy-polling thread once enough frames are in, or after five seconds
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    boost::asio::steady_timer check(bot_ioc);
+    std::function<void(boost::beast::error_code)> onCheck = [&](boost::beast::error_code) {
+        if (counters.frames.load() >= 200 || std::chrono::steady_clock::now() > deadline) {
+            bot_ioc.stop();
+            return;
+        }
+        check.expires_after(std::chrono::milliseconds(10));
+        check.async_wait(onCheck);
+    };
+    onCheck({});
+    connections.run();
+
+    mock.stop();
+    mock_ioc.stop();
+    mock_thread.join();
+
+    EXPECT_GE(counters.frames.load(), 200u);
+    EXPECT_EQ(counters.parseErrors.load(), 0u);
+    EXPECT_EQ(counters.reconnects.load(), 0u);
+}
@@ -0,0 +1,204 @@
+#include "gtest/gtest.h"
+#include "common/price_level_kernels.h"
+#include "server/arbitrage_calculator.h"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Levels = PriceLevels<64>;
+
+const std::vector<KernelIsa> ALL_ISAS = {KernelIsa::Scalar, KernelIsa::Sse2, KernelIsa::Avx2};
+
+// The left-to-right loops the calculator ran before the kernels, kept as the reference
+LevelSums sequentialSums(const Levels& levels) {
+    LevelSums sums = {0.0, 0.0};
+    for (const auto& level : levels) {
+        sums.quantity += level.quantity;
+        sums.notional += level.price * level.quantity;
+    }
+    return sums;
+}
+
+double sequentialVwapBid(const Levels& levels, double desired_quantity) {
+    double total_price_x_quantity = 0.0;
+    double total_quantity_filled = 0.0;
+    double remaining = desired_quantity;
+    for (const auto& level : levels) {
+        if (remaining <= 0) break;
+        const double fill = std::min(level.quantity, remaining);
+        total_price_x_quantity += level.price * fill;
+        total_quantity_filled += fill;
+        remaining -= fill;
+    }
+    if (desired_quantity - total_quantity_filled > std::numeric_limits<double>::epsilon() * desired_quantity) return 0.0;
+    return total_price_x_quantity / total_quantity_filled;
+}
+
+double sequentialVwapAsk(const Levels& levels, double old_currency) {
+    const double EPSILON = std::numeric_limits<double>::epsilon() * old_currency;
+    double acquired = 0.0;
+    double spent = 0.0;
+    double remaining = old_currency;
+    for (const auto& level : levels) {
+        const double cost = level.price * level.quantity;
+        if (remaining >= cost) {
+            acquired += level.quantity;
+            spent += cost;
+            remaining -= cost;
+        } else {
+            acquired += remaining / level.price;
+            spent += remaining;
+            remaining = 0.0;
+            break;
+        }
+        if (remaining <= EPSILON) {
+            remaining = 0.0;
+            break;
+        }
+    }
+    return acquired > 0.0 && remaining <= EPSILON ? spent / acquired : 0.0;
+}
+
+// A side of the given depth with prices walking away from 100 and the odd empty level
+Levels randomSide(std::mt19937& rng, std::size_t depth) {
+    std::uniform_real_distribution<double> tick(0.001, 0.5);
+    std::uniform_real_distribution<double> quantity(0.0001, 25.0);
+    Levels levels;
+    double price = 100.0;
+    for (std::size_t i = 0; i < depth; ++i) {
+        price += tick(rng);
+        levels.emplace_back(price, i % 7 == 3 ? 0.0 : quantity(rng));
+    }
+    return levels;
+}
+
+void expectNear(double actual, double expected) {
+    EXPECT_NEAR(actual, expected, 1e-12 * std::max(1.0, std::abs(expected)));
+}
+
+} // namespace
+
+TEST(PriceLevelKernelsTest, ScalarAndSse2AreAlwaysAvailable) {
+    EXPECT_TRUE(isSupported(KernelIsa::Scalar));
+    EXPECT_TRUE(isSupported(activeLevelKernels().isa));
+    EXPECT_EQ(levelKernels(KernelIsa::Scalar).isa, KernelIsa::Scalar);
+}
+
+TEST(PriceLevelKernelsTest, SumsMatchEveryIsaAndTheSequentialLoop) {
+    std::mt19937 rng(7);
+    for (std::size_t depth = 0; depth <= Levels::capacity(); ++depth) {
+        const Levels levels = randomSide(rng, depth);
+        const LevelSums scalar = levelKernels(KernelIsa::Scalar).sumOf(levels);
+        const LevelSums sequential = sequentialSums(levels);
+        expectNear(scalar.quantity, sequential.quantity);
+        expectNear(scalar.notional, sequential.notional);
+
+        for (const KernelIsa isa : ALL_ISAS) {
+            if (!isSupported(isa)) continue;
+            const LevelSums sums = levelKernels(isa).sumOf(levels);
+            EXPECT_EQ(sums.quantity, scalar.quantity) << to_string(isa) << " at depth " << depth;
+            EXPECT_EQ(sums.notional, scalar.notional) << to_string(isa) << " at depth " << depth;
+        }
+    }
+}
+
+TEST(PriceLevelKernelsTest, FillSearchMatchesEveryIsaAndTheSequentialLoop) {
+    std::mt19937 rng(11);
+    for (std::size_t depth = 1; depth <= Levels::capacity(); ++depth) {
+        const Levels levels = randomSide(rng, depth);
+        const LevelSums total = sequentialSums(levels);
+
+        for (const FillTarget by : {FillTarget::Quantity, FillTarget::Notional}) {
+            const double whole = by == FillTarget::Quantity ? total.quantity : total.notional;
+            for (const double fraction : {0.01, 0.3, 0.77, 0.999, 1.5}) {
+                const double target = whole * fraction;
+
+                // First level whose running total reaches the target
+                std::size_t index = 0;
+                LevelSums before = {0.0, 0.0};
+                for (; index < levels.size(); ++index) {
+                    const LevelSums through = {before.quantity + levels[index].quantity,
+                                               before.notional + levels[index].price * levels[index].quantity};
+                    if ((by == FillTarget::Quantity ? through.quantity : through.notional) >= target) break;
+                    before = through;
+                }
+
+                const FillLevel scalar = levelKernels(KernelIsa::Scalar).findFillOf(levels, target, by);
+                EXPECT_EQ(scalar.index, index) << "depth " << depth << " fraction " << fraction;
+                expectNear(scalar.quantityBefore, before.quantity);
+                expectNear(scalar.notionalBefore, before.notional);
+
+                for (const KernelIsa isa : ALL_ISAS) {
+                    if (!isSupported(isa)) continue;
+                    const FillLevel fill = levelKernels(isa).findFillOf(levels, target, by);
+                    EXPECT_EQ(fill.index, scalar.index) << to_string(isa);
+                    EXPECT_EQ(fill.quantityBefore, scalar.quantityBefore) << to_string(isa);
+                    EXPECT_EQ(fill.notionalBefore, scalar.notionalBefore) << to_string(isa);
+                }
+            }
+        }
+    }
+}
+
+TEST(PriceLevelKernelsTest, IgnoresStaleLevelsPastTheSize) {
+    Levels levels;
+    for (std::size_t i = 0; i < 8; ++i) {
+        levels.emplace_back(std::numeric_limits<double>::quiet_NaN(), 1e300);
+    }
+    levels = {PriceLevel(10.0, 1.0), PriceLevel(11.0, 2.0), PriceLevel(12.0, 3.0)};
+
+    for (const KernelIsa isa : ALL_ISAS) {
+        if (!isSupported(isa)) continue;
+        const LevelSums sums = levelKernels(isa).sumOf(levels);
+        EXPECT_EQ(sums.quantity, 6.0) << to_string(isa);
+        EXPECT_EQ(sums.notional, 68.0) << to_string(isa);
+
+        const FillLevel fill = levelKernels(isa).findFillOf(levels, 7.0, FillTarget::Quantity);
+        EXPECT_EQ(fill.index, 3u) << to_string(isa);
+        EXPECT_EQ(fill.quantityBefore, 6.0) << to_string(isa);
+    }
+}
+
+TEST(PriceLevelKernelsTest, VwapsMatchTheSequentialLoops) {
+    std::mt19937 rng(13);
+    for (std::size_t depth = 1; depth <= Levels::capacity(); ++depth) {
+        const Levels levels = randomSide(rng, depth);
+        const LevelSums total = sequentialSums(levels);
+
+        // Exactly the whole side is left out, whether the rounded total covers it depends on summation order
+        for (const double fraction : {0.001, 0.25, 0.5, 0.9, 1.0 - 1e-9, 1.01}) {
+            const double quantity = total.quantity * fraction;
+            const double quote = total.notional * fraction;
+            const double bid = calculateVwapBid(levels, quantity);
+            const double sequentialBid = sequentialVwapBid(levels, quantity);
+            // The sequential loop's fills can round to more than an epsilon short of a size the side
+            // covers, and it then wrongly reported no liquidity. The kernels fill the last level exactly.
+            if (sequentialBid > 0 || fraction > 1) {
+                expectNear(bid, sequentialBid);
+            } else {
+                EXPECT_GT(bid, 0.0) << "depth " << depth << " fraction " << fraction;
+            }
+            expectNear(calculateVwapAsk(levels, quote), sequentialVwapAsk(levels, quote));
+        }
+    }
+}
+
+TEST(PriceLevelsTest, StoresLevelsAsSeparateArrays) {
+    Levels levels = {PriceLevel(1.0, 2.0), PriceLevel(3.0, 4.0)};
+    levels[1] = PriceLevel(5.0, 6.0);
+    levels[0].quantity = 7.0;
+
+    EXPECT_EQ(levels.priceData()[1], 5.0);
+    EXPECT_EQ(levels.quantityData()[0], 7.0);
+    EXPECT_EQ(Levels::PADDED_CAPACITY % PRICE_LEVEL_LANES, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(levels.priceData()) % (PRICE_LEVEL_LANES * sizeof(double)), 0u);
+
+    std::vector<double> prices;
+    for (const auto& level : PriceLevelSpan(levels)) {
+        prices.push_back(level.price);
+    }
+    EXPECT_EQ(prices, (std::vector<double>{1.0, 5.0}));
+}
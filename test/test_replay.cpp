@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include "replay/replay_engine.h"
+#include <sstream>
+#include <memory>
+
+class ReplayEngineTest : public ::testing::Test {
+protected:
+    const std::string btcusdtFrame = R"({"stream":"btcusdt@depth5@100ms","data":{"lastUpdateId":1,"bids":[["117992.28000000","2.82596000"]],"asks":[["117992.29000000","5.61816000"]]}})";
+    const std::string ethusdtFrame = R"({"stream":"ethusdt@depth5@100ms","data":{"lastUpdateId":2,"bids":[["3742.11000000","55.38490000"]],"asks":[["3742.12000000","125.18150000"]]}})";
+    const std::string ethbtcFrame = R"({"stream":"ethbtc@depth5@100ms","data":{"lastUpdateId":3,"bids":[["0.03171000","23.57890000"]],"asks":[["0.03172000","15.37580000"]]}})";
+
+    std::shared_ptr<ReplayClock> clock = std::make_shared<ReplayClock>();
+    std::shared_ptr<Server> server = std::make_shared<Server>(
+        ArbitragePath::list_from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY"),
+        ServerConfig(0, 0, 1, 0, true),
+        clock);
+
+    // Wraps a raw frame the way TradeFileWriter records it
+    static std::string asRecord(const std::string& frame, long long receiveTime) {
+        nlohmann::json record;
+        record["orderBookLevels"] = frame;
+        record["tickReceiveTime"] = receiveTime;
+        return record.dump();
+    }
+};
+
+TEST_F(ReplayEngineTest, ReplaysRawFramesOnePerLine) {
+    std::istringstream input(btcusdtFrame + "\n" + ethusdtFrame + "\n" + ethbtcFrame + "\n");
+    ReplayEngine engine(server, clock, ReplayConfig());
+
+    const ReplayStats stats = engine.run(input);
+
+    EXPECT_EQ(stats.framesRead, 3);
+    EXPECT_EQ(stats.ticksDispatched, 3);
+    EXPECT_EQ(stats.parseFailures, 0);
+}
+
+TEST_F(ReplayEngineTest, ReplaysJsonArrayOfFrames) {
+    std::istringstream input("[" + btcusdtFrame + "," + ethusdtFrame + "," + ethbtcFrame + "]");
+    ReplayEngine engine(server, clock, ReplayConfig());
+
+    const ReplayStats stats = engine.run(input);
+
+    EXPECT_EQ(stats.ticksDispatched, 3);
+    EXPECT_EQ(stats.parseFailures, 0);
+}
+
+TEST_F(ReplayEngineTest, ReplaysTradeFileWriterRecords) {
+    std::istringstream input(asRecord(btcusdtFrame, 1000) + "\n" + asRecord(ethusdtFrame, 2000) + "\n");
+    ReplayEngine engine(server, clock, ReplayConfig());
+
+    const ReplayStats stats = engine.run(input);
+
+    EXPECT_EQ(stats.ticksDispatched, 2);
+    EXPECT_GE(clock->now(), 2000);
+}
+
+TEST_F(ReplayEngineTest, ReplaysBookTickerFrames) {
+    const std::string ticker = R"({"stream":"ethbtc@bookTicker","data":{"u":4,"s":"ETHBTC","b":"0.03171","B":"23.5","a":"0.03172","A":"15.3"}})";
+    std::istringstream input(btcusdtFrame + "\n" + ethusdtFrame + "\n" + ticker + "\n");
+    ReplayEngine engine(server, clock, ReplayConfig(0, DepthParserMode::Json));
+
+    const ReplayStats stats = engine.run(input);
+
+    EXPECT_EQ(stats.ticksDispatched, 3);
+    EXPECT_EQ(stats.parseFailures, 0);
+}
+
+TEST_F(ReplayEngineTest, CountsMalformedLinesAsParseFailures) {
+    std::istringstream input(btcusdtFrame + "\nnot json\n" + R"({"stream":"ethbtc@depth5@100ms"})" + "\n");
+    ReplayEngine engine(server, clock, ReplayConfig());
+
+    const ReplayStats stats = engine.run(input);
+
+    EXPECT_EQ(stats.framesRead, 3);
+    EXPECT_EQ(stats.ticksDispatched, 1);
+    EXPECT_EQ(stats.parseFailures, 2);
+}
+
+TEST(ReplayClockTest, AdvancesFromRecordedTime) {
+    ReplayClock clock;
+    clock.rebase(1756639047235882600);
+
+    EXPECT_GE(clock.now(), 1756639047235882600);
+    EXPECT_LT(clock.now(), 1756639047235882600 + 1000000000LL);
+}
@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "analysis/result_analysis.h"
+#include <sstream>
+
+namespace {
+
+std::string resultLine(const std::string& path, bool opportunity, long long receiveTime, double pnl, double notional) {
+    std::ostringstream line;
+    // Keys inside orderBookLevels must not be mistaken for the result's own
+    line << "{\"bottleneckLeg\":\"btcusdt\",\"isArbitrageOpportunity\":" << (opportunity ? "true" : "false")
+         << ",\"orderBookLevels\":\"{\\\"tickReceiveTime\\\":1,\\\"unrealisedPnl\\\":99}\""
+         << ",\"path\":\"" << path << "\",\"tickProcessTime\":" << receiveTime + 1000
+         << ",\"tickReceiveTime\":" << receiveTime << ",\"tradedNotional\":" << notional
+         << ",\"unrealisedPnl\":" << pnl << "}\n";
+    return line.str();
+}
+
+// Two paths interleaved: A has runs at 1-3 and 7-8, B one run at 4-6
+std::string sampleResults() {
+    std::string results;
+    long long time = 1'000'000'000;
+    const bool a[] = {true, true, true, false, false, false, true, true, false};
+    const bool b[] = {false, false, false, true, true, true, false, false, false};
+    for (int i = 0; i < 9; ++i) {
+        results += resultLine("A", a[i], time, a[i] ? 0.1 * (i + 1) : -0.1, 10.0);
+        time += 500'000'000;
+        results += resultLine("B", b[i], time, b[i] ? 0.2 : -0.2, 20.0);
+        time += 500'000'000;
+    }
+    return results;
+}
+
+} // namespace
+
+TEST(ResultAnalysisTest, CountsOpportunitiesAndConsecutiveGroups) {
+    const std::string results = sampleResults() + "not json\n";
+    const ResultAnalysis analysis = analyzeResults(results.data(), results.data() + results.size(), 1);
+
+    EXPECT_EQ(analysis.dataPoints, 18u);
+    EXPECT_EQ(analysis.opportunities, 8u);
+    EXPECT_EQ(analysis.malformedLines, 1u);
+    EXPECT_EQ(analysis.latency.count(), 18u);
+    EXPECT_EQ(analysis.latency.max(), 1000u);
+
+    ASSERT_EQ(analysis.groups.size(), 3u);
+    const OpportunityGroup& first = analysis.groups[0];
+    EXPECT_EQ(first.count, 3u);
+    EXPECT_DOUBLE_EQ(first.returnPercent(), 1.0);
+    EXPECT_DOUBLE_EQ(first.durationSeconds(), 2.0);
+    EXPECT_DOUBLE_EQ(first.averageReturnPercent(), 2.0);
+    EXPECT_EQ(analysis.groups[1].count, 3u);
+    EXPECT_DOUBLE_EQ(analysis.groups[1].averageNotional(), 20.0);
+    EXPECT_EQ(analysis.groups[2].count, 2u);
+
+    EXPECT_NEAR(analysis.pnlSum, 0.1 + 0.2 + 0.3 + 3 * 0.2 + 0.7 + 0.8, 1e-12);
+    EXPECT_DOUBLE_EQ(analysis.maxPnl, 0.8);
+}
+
+TEST(ResultAnalysisTest, SameResultOnAnyNumberOfChunks) {
+    const std::string results = sampleResults();
+    const ResultAnalysis single = analyzeResults(results.data(), results.data() + results.size(), 1);
+
+    // More chunks than lines too, so runs are split at every possible boundary
+    for (std::size_t threads : {2, 3, 5, 8, 40}) {
+        const ResultAnalysis split = analyzeResults(results.data(), results.data() + results.size(), threads);
+        EXPECT_EQ(split.chunks, threads);
+        EXPECT_EQ(split.dataPoints, single.dataPoints);
+        EXPECT_EQ(split.opportunities, single.opportunities);
+        EXPECT_EQ(split.latency.count(), single.latency.count());
+        ASSERT_EQ(split.groups.size(), single.groups.size()) << threads << " chunks";
+        for (std::size_t i = 0; i < single.groups.size(); ++i) {
+            EXPECT_EQ(split.groups[i].count, single.groups[i].count);
+            EXPECT_EQ(split.groups[i].firstReceiveTime, single.groups[i].firstReceiveTime);
+            EXPECT_EQ(split.groups[i].lastReceiveTime, single.groups[i].lastReceiveTime);
+            EXPECT_DOUBLE_EQ(split.groups[i].firstPnl, single.groups[i].firstPnl);
+            EXPECT_NEAR(split.groups[i].pnlSum, single.groups[i].pnlSum, 1e-12);
+        }
+    }
+}
+
+TEST(ResultAnalysisTest, PrintsTheGatherDataSummary) {
+    const std::string results = sampleResults();
+    std::ostringstream out;
+    printResultAnalysis(out, analyzeResults(results.data(), results.data() + results.size(), 2));
+
+    EXPECT_NE(out.str().find("Number of data points: 18"), std::string::npos);
+    EXPECT_NE(out.str().find("Number of arbitrage opportunities: 8"), std::string::npos);
+    EXPECT_NE(out.str().find("Number of distinct arbitrage opportunities: 3"), std::string::npos);
+    EXPECT_NE(out.str().find("Average Traded Notional: 13.33333"), std::string::npos);
+}
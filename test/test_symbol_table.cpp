@@ -0,0 +1,58 @@
+#include "gtest/gtest.h"
+#include "common/symbol_table.h"
+#include "common/trade_leg.h"
+#include "server/book_store.h"
+#include <cstdint>
+#include <string>
+
+TEST(SymbolTableTest, AssignsDenseIdsInInsertionOrder) {
+    SymbolTable symbols;
+
+    EXPECT_EQ(symbols.intern("btcusdt"), 0u);
+    EXPECT_EQ(symbols.intern("ethusdt"), 1u);
+    EXPECT_EQ(symbols.intern("btcusdt"), 0u);
+    EXPECT_EQ(symbols.size(), 2u);
+    EXPECT_EQ(symbols.name(1), "ethusdt");
+}
+
+TEST(SymbolTableTest, FindsOnlyInternedSymbols) {
+    SymbolTable symbols;
+    symbols.intern("ethbtc");
+
+    EXPECT_EQ(symbols.find("ethbtc"), 0u);
+    EXPECT_EQ(symbols.find("ethbt"), INVALID_SYMBOL_ID);
+    EXPECT_EQ(symbols.find(""), INVALID_SYMBOL_ID);
+}
+
+TEST(SymbolTableTest, KeepsIdsStableAcrossRehash) {
+    SymbolTable symbols;
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_EQ(symbols.intern("sym" + std::to_string(i)), static_cast<SymbolId>(i));
+    }
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_EQ(symbols.find("sym" + std::to_string(i)), static_cast<SymbolId>(i));
+    }
+}
+
+TEST(SymbolTableTest, InternsPathLegs) {
+    SymbolTable symbols;
+    symbols.intern("ethbtc");
+    ArbitragePath path = ArbitragePath::from_string("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY");
+
+    path.internSymbols(symbols);
+
+    EXPECT_EQ(path.getFirstLeg().symbolId, 1u);
+    EXPECT_EQ(path.getSecondLeg().symbolId, 2u);
+    EXPECT_EQ(path.getThirdLeg().symbolId, 0u);
+}
+
+TEST(BookStoreTest, SlotsStartOnSeparateCacheLines) {
+    BookStore books(3);
+
+    for (SymbolId id = 0; id < books.size(); ++id) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&books[id]) % CACHE_LINE_SIZE, 0u);
+        EXPECT_FALSE(books[id].hasUpdate());
+    }
+    EXPECT_TRUE(books.contains(2));
+    EXPECT_FALSE(books.contains(INVALID_SYMBOL_ID));
+}
@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include "discovery/triangle_discovery.h"
+#include <algorithm>
+#include <set>
+#include <sstream>
+
+class TriangleDiscoveryTest : public ::testing::Test {
+protected:
+    const std::vector<SymbolInfo> symbols = {
+        SymbolInfo("btcusdt", "btc", "usdt"),
+        SymbolInfo("ethusdt", "eth", "usdt"),
+        SymbolInfo("ethbtc", "eth", "btc"),
+        SymbolInfo("ltcbtc", "ltc", "btc"),
+        SymbolInfo("ltcusdt", "ltc", "usdt"),
+        SymbolInfo("dogeeur", "doge", "eur"),
+    };
+
+    static std::set<std::string> asStrings(const std::vector<ArbitragePath>& paths) {
+        std::set<std::string> strings;
+        for (const auto& path : paths) {
+            strings.insert(path.to_string());
+        }
+        return strings;
+    }
+};
+
+TEST_F(TriangleDiscoveryTest, MatchesHandWrittenPaths) {
+    const TriangleDiscovery discovery(symbols);
+
+    const auto fromBtc = asStrings(discovery.findPaths({"btc"}));
+    const auto fromUsdt = asStrings(discovery.findPaths({"usdt"}));
+
+    // The paths used by scripts/runBtcUsdtEthBtcBot.sh and scripts/runUsdtBtcLtcUsdtBot.sh
+    EXPECT_EQ(fromBtc.count("btc:btcusdt:BUY,ethusdt:SELL,ethbtc:BUY"), 1u);
+    EXPECT_EQ(fromUsdt.count("usdt:btcusdt:SELL,ltcbtc:SELL,ltcusdt:BUY"), 1u);
+}
+
+TEST_F(TriangleDiscoveryTest, FindsBothDirectionsOfEveryTriangle) {
+    const TriangleDiscovery discovery(symbols);
+
+    const auto paths = asStrings(discovery.findPaths({"usdt"}));
+
+    EXPECT_EQ(paths, (std::set<std::string>{
+        "usdt:btcusdt:SELL,ethbtc:SELL,ethusdt:BUY",
+        "usdt:ethusdt:SELL,ethbtc:BUY,btcusdt:BUY",
+        "usdt:btcusdt:SELL,ltcbtc:SELL,ltcusdt:BUY",
+        "usdt:ltcusdt:SELL,ltcbtc:BUY,btcusdt:BUY",
+    }));
+}
+
+TEST_F(TriangleDiscoveryTest, SkipsUnknownAndRepeatedStartCurrencies) {
+    const TriangleDiscovery discovery(symbols);
+
+    EXPECT_TRUE(discovery.findPaths({"xyz", "doge"}).empty());
+    EXPECT_EQ(discovery.findPaths({"USDT", "usdt"}).size(), 4u);
+    EXPECT_EQ(discovery.findPaths({"usdt", "btc", "eth"}).size(), 10u);
+}
+
+TEST_F(TriangleDiscoveryTest, SubscribesToEachSymbolOnce) {
+    const TriangleDiscovery discovery(symbols);
+    const auto paths = discovery.findPaths({"btc"});
+
+    const std::string target = TriangleDiscovery::streamTarget(paths, "@depth5@100ms");
+
+    EXPECT_EQ(target.rfind("/stream?streams=", 0), 0u);
+    for (const auto& symbol : {"btcusdt", "ethusdt", "ethbtc", "ltcbtc", "ltcusdt"}) {
+        EXPECT_EQ(target.find(std::string(symbol) + "@depth5@100ms"), target.rfind(std::string(symbol) + "@depth5@100ms"));
+        EXPECT_NE(target.find(std::string(symbol) + "@depth5@100ms"), std::string::npos) << symbol;
+    }
+    EXPECT_EQ(target.find("dogeeur"), std::string::npos);
+}
+
+TEST_F(TriangleDiscoveryTest, ScalesToAFullExchange) {
+    // Star around 3 quote currencies, every base listed against all of them, like Binance spot
+    std::vector<SymbolInfo> exchange;
+    const std::vector<std::string> quotes = {"usdt", "btc", "eth"};
+    for (int i = 0; i < 1000; ++i) {
+        const std::string base = "c" + std::to_string(i);
+        for (const auto& quote : quotes) {
+            exchange.emplace_back(base + quote, base, quote);
+        }
+    }
+    exchange.emplace_back("btcusdt", "btc", "usdt");
+    exchange.emplace_back("ethusdt", "eth", "usdt");
+    exchange.emplace_back("ethbtc", "eth", "btc");
+
+    const TriangleDiscovery discovery(exchange);
+    const auto paths = discovery.findPaths({"usdt"});
+
+    // Each base forms a triangle with usdt and each of btc and eth, in two directions, plus usdt/btc/eth itself
+    EXPECT_EQ(paths.size(), 1000u * 2 * 2 + 2);
+    EXPECT_EQ(discovery.symbolCount(), 3003u);
+}
+
+TEST(LoadSymbolInfoTest, ReadsExchangeInfoAndSkipsHaltedSymbols) {
+    std::istringstream input(R"({"timezone":"UTC","symbols":[
+        {"symbol":"BTCUSDT","status":"TRADING","baseAsset":"BTC","quoteAsset":"USDT"},
+        {"symbol":"LUNABTC","status":"BREAK","baseAsset":"LUNA","quoteAsset":"BTC"}]})");
+
+    const auto symbols = loadSymbolInfo(input);
+
+    ASSERT_EQ(symbols.size(), 1u);
+    EXPECT_EQ(symbols[0].symbol, "btcusdt");
+    EXPECT_EQ(symbols[0].baseAsset, "btc");
+    EXPECT_EQ(symbols[0].quoteAsset, "usdt");
+}
+
+TEST(LoadSymbolInfoTest, RejectsMalformedFiles) {
+    std::istringstream notJson("symbols");
+    std::istringstream missingQuote(R"([{"symbol":"BTCUSDT","baseAsset":"BTC"}])");
+
+    EXPECT_THROW(loadSymbolInfo(notJson), std::invalid_argument);
+    EXPECT_THROW(loadSymbolInfo(missingQuote), std::invalid_argument);
+}
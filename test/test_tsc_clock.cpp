@@ -0,0 +1,61 @@
+#include "gtest/gtest.h"
+#include "common/tsc_clock.h"
+#include <cstdlib>
+
+namespace {
+
+long long systemNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+TEST(TscClockTest, StartsOnTheSystemClock) {
+    for (const bool allowTsc : {true, false}) {
+        const TscClock clock(std::chrono::milliseconds(0), allowTsc);
+        EXPECT_LT(std::llabs(clock.now() - systemNow()), 5000000) << allowTsc;
+    }
+}
+
+TEST(TscClockTest, FallsBackToSteadyClockNanoseconds) {
+    const TscClock clock(std::chrono::milliseconds(0), false);
+
+    EXPECT_FALSE(clock.usesTsc());
+    EXPECT_DOUBLE_EQ(clock.ticksPerSecond(), 1e9);
+    const std::uint64_t ticks = clock.ticks();
+    EXPECT_EQ(clock.toEpochNs(ticks + 1000) - clock.toEpochNs(ticks), 1000);
+}
+
+TEST(TscClockTest, ConvertsEarlierReadingsOnTheCurrentCalibration) {
+    TscClock clock(std::chrono::milliseconds(0));
+    const std::uint64_t ticks = clock.ticks();
+    const long long stamped = clock.now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    clock.recalibrate();
+
+    const long long elapsed = clock.now() - clock.toEpochNs(ticks);
+    EXPECT_GE(elapsed, 20000000);
+    EXPECT_LT(elapsed, 1000000000);
+    EXPECT_LT(std::llabs(clock.toEpochNs(ticks) - stamped), 100000);
+}
+
+TEST(TscClockTest, StaysMonotonicAcrossRecalibrations) {
+    TscClock clock(std::chrono::milliseconds(0));
+    long long previous = clock.now();
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            const long long now = clock.now();
+            ASSERT_GE(now, previous);
+            previous = now;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        clock.recalibrate();
+    }
+    EXPECT_LT(std::llabs(clock.now() - systemNow()), 5000000);
+}
+
+TEST(TscClockTest, MakesTheConfiguredClock) {
+    EXPECT_NE(dynamic_cast<const TscClock*>(makeClock(ClockConfig(true, std::chrono::milliseconds(10))).get()), nullptr);
+    EXPECT_NE(dynamic_cast<const SystemClock*>(makeClock(ClockConfig(false)).get()), nullptr);
+}